@@ -1,4 +1,4 @@
-// Copyright 2017-2024 the openage authors. See copying.md for legal info.
+// Copyright 2017-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -14,6 +14,8 @@
 #include "log/message.h"
 
 #include "curve/keyframe_container.h"
+#include "curve/reader.h"
+#include "curve/snapshot_slot.h"
 #include "event/evententity.h"
 #include "time/time.h"
 #include "util/fixed_point.h"
@@ -39,7 +41,8 @@ public:
 		_id{id},
 		_idstr{idstr},
 		loop{loop},
-		last_element{this->container.size()} {}
+		last_element{this->container.size()},
+		published{std::make_shared<const KeyframeContainer<T>>(this->container)} {}
 
 	virtual ~BaseCurve() = default;
 
@@ -48,7 +51,15 @@ public:
 	// TODO: if copying is enabled again, these members have to be reassigned: _id, _idstr, last_element
 	BaseCurve(const BaseCurve &) = delete;
 
-	BaseCurve(BaseCurve &&) = default;
+	BaseCurve(BaseCurve &&other) :
+		EventEntity(std::move(other)),
+		container{std::move(other.container)},
+		_id{other._id},
+		_idstr{other._idstr},
+		loop{other.loop},
+		last_element{other.last_element},
+		last_sync{other.last_sync},
+		published{std::move(other.published)} {}
 
 	virtual T get(const time::time_t &t) const = 0;
 
@@ -97,6 +108,18 @@ public:
 	 */
 	virtual void erase(const time::time_t &at);
 
+	/**
+	 * Erase all keyframes that are not required to get values at t >= \p time.
+	 *
+	 * After compaction, the curve still returns the same values for
+	 * t >= \p time. Values for earlier times are lost.
+	 *
+	 * Does not trigger changes on dependent event entities.
+	 *
+	 * @param time Retention horizon.
+	 */
+	void compact(const time::time_t &time);
+
 	/**
 	 * Integrity check, for debugging/testing reasons only.
 	 */
@@ -108,6 +131,9 @@ public:
 	 *
 	 * The operation may insert new keyframes at \p start on the curve.
 	 *
+	 * Repeated syncs from the same curve are incremental, i.e. only keyframes
+	 * that changed since the last sync are copied.
+	 *
 	 * @param other Curve that keyframes are copied from.
 	 * @param start Start time at which keyframes are replaced (default = -INF).
 	 *              Using the default value replaces ALL keyframes of \p this with
@@ -123,6 +149,9 @@ public:
 	 *
 	 * The operation may insert new keyframes at \p start on the curve.
 	 *
+	 * Repeated syncs from the same curve are incremental, i.e. only keyframes
+	 * that changed since the last sync are copied and converted.
+	 *
 	 * @param other Curve that keyframes are copied from.
 	 * @param converter Function that converts the value type of \p other to the
 	 *                  value type of \p this.
@@ -135,6 +164,24 @@ public:
 	          const std::function<T(const O &)> &converter,
 	          const time::time_t &start = time::TIME_MIN);
 
+	/**
+	 * Copy keyframes from the snapshot of a curve reader (with a different element type)
+	 * to this curve. After syncing, this curve and the reader are guaranteed to return
+	 * the same values for t >= start.
+	 *
+	 * Like syncing from a curve, repeated syncs from snapshots of the same curve
+	 * are incremental.
+	 *
+	 * @param other Reader whose snapshot keyframes are copied from.
+	 * @param converter Function that converts the value type of \p other to the
+	 *                  value type of \p this.
+	 * @param start Start time at which keyframes are replaced (default = -INF).
+	 */
+	template <typename O>
+	void sync(Reader<O> &other,
+	          const std::function<T(const O &)> &converter,
+	          const time::time_t &start = time::TIME_MIN);
+
 	/**
 	 * Get the identifier of this curve.
 	 *
@@ -156,6 +203,31 @@ public:
 		return this->_idstr;
 	}
 
+	/**
+	 * Publish the current keyframes of the curve for readers on other threads.
+	 *
+	 * Stores an immutable snapshot of the keyframes that is picked up by
+	 * \p Reader::update(). Changes to the curve are not visible to readers
+	 * until they are published.
+	 *
+	 * The snapshot shares the keyframe chunks with the curve, so only the
+	 * chunk pointers are copied. Chunks that the curve changes afterwards
+	 * are copied on their first change.
+	 *
+	 * Should be called by the writing thread after a batch of changes.
+	 */
+	void publish();
+
+	/**
+	 * Create a read cursor for sampling the published keyframes of this curve
+	 * from another thread.
+	 *
+	 * @return Reader for this curve.
+	 */
+	Reader<T> reader() const {
+		return Reader<T>{*this};
+	}
+
 	/**
 	 * Get a string representation of the curve.
 	 */
@@ -171,6 +243,23 @@ public:
 	}
 
 protected:
+	/**
+	 * Get the value at a given time from a keyframe container.
+	 *
+	 * Implements the sampling of the curve type for the curve's own keyframes
+	 * and for published snapshots. Must not access the state of the curve.
+	 *
+	 * @param container Keyframes that are sampled.
+	 * @param time Requested time.
+	 * @param hint Index of the last accessed keyframe. Updated to the
+	 *             keyframe found for \p time.
+	 *
+	 * @return Value at \p time.
+	 */
+	virtual T sample(const KeyframeContainer<T> &container,
+	                 const time::time_t &time,
+	                 typename KeyframeContainer<T>::elem_ptr &hint) const = 0;
+
 	/**
 	 * Stores all the keyframes
 	 */
@@ -195,6 +284,19 @@ protected:
 	 * Cache the index of the last accessed element (usually the end).
 	 */
 	mutable typename KeyframeContainer<T>::elem_ptr last_element;
+
+	/**
+	 * State of the last sync for incremental syncs.
+	 */
+	typename KeyframeContainer<T>::sync_state last_sync;
+
+private:
+	friend class Reader<T>;
+
+	/**
+	 * Last keyframe snapshot published for readers.
+	 */
+	SnapshotSlot<KeyframeContainer<T>> published;
 };
 
 
@@ -241,6 +343,27 @@ void BaseCurve<T>::erase(const time::time_t &at) {
 }
 
 
+template <typename T>
+void BaseCurve<T>::compact(const time::time_t &time) {
+	auto erased = this->container.compact(time);
+
+	// the erased keyframes were at [1, erased], so move the
+	// hint along with the remaining keyframes
+	if (this->last_element > erased) {
+		this->last_element -= erased;
+	}
+	else if (this->last_element > 0) {
+		this->last_element = 1;
+	}
+}
+
+
+template <typename T>
+void BaseCurve<T>::publish() {
+	this->published.store(std::make_shared<const KeyframeContainer<T>>(this->container));
+}
+
+
 template <typename T>
 std::pair<time::time_t, const T> BaseCurve<T>::frame(const time::time_t &time) const {
 	auto e = this->container.last(time, this->container.size());
@@ -284,13 +407,14 @@ template <typename T>
 void BaseCurve<T>::sync(const BaseCurve<T> &other,
                         const time::time_t &start) {
 	// Copy keyframes between containers for t >= start
-	this->last_element = this->container.sync(other.container, start);
+	this->last_element = this->container.sync(other.container, start, &this->last_sync);
 
 	// Check if this->get() returns the same value as other->get() for t = start
 	// If not, insert a new keyframe at start
 	auto get_other = other.get(start);
 	if (this->get(start) != get_other) {
 		this->set_insert(start, get_other);
+		this->container.sync_changed_at_start(this->last_sync);
 	}
 
 	this->changes(start);
@@ -303,13 +427,34 @@ void BaseCurve<T>::sync(const BaseCurve<O> &other,
                         const std::function<T(const O &)> &converter,
                         const time::time_t &start) {
 	// Copy keyframes between containers for t >= start
-	this->last_element = this->container.sync(other.get_container(), converter, start);
+	this->last_element = this->container.sync(other.get_container(), converter, start, &this->last_sync);
 
 	// Check if this->get() returns the same value as other->get() for t = start
 	// If not, insert a new keyframe at start
 	auto get_other = converter(other.get(start));
 	if (this->get(start) != get_other) {
 		this->set_insert(start, get_other);
+		this->container.sync_changed_at_start(this->last_sync);
+	}
+
+	this->changes(start);
+}
+
+
+template <typename T>
+template <typename O>
+void BaseCurve<T>::sync(Reader<O> &other,
+                        const std::function<T(const O &)> &converter,
+                        const time::time_t &start) {
+	// Copy keyframes between containers for t >= start
+	this->last_element = this->container.sync(other.get_container(), converter, start, &this->last_sync);
+
+	// Check if this->get() returns the same value as other.get() for t = start
+	// If not, insert a new keyframe at start
+	auto get_other = converter(other.get(start));
+	if (this->get(start) != get_other) {
+		this->set_insert(start, get_other);
+		this->container.sync_changed_at_start(this->last_sync);
 	}
 
 	this->changes(start);
@@ -1,4 +1,4 @@
-// Copyright 2017-2024 the openage authors. See copying.md for legal info.
+// Copyright 2017-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -48,14 +48,27 @@ public:
 	 * Return, if existing, the time and value of keyframe with time < t
 	 */
 	std::optional<std::pair<time::time_t, T>> get_previous(const time::time_t &t) const;
+
+protected:
+	T sample(const KeyframeContainer<T> &container,
+	         const time::time_t &time,
+	         typename KeyframeContainer<T>::elem_ptr &hint) const override;
 };
 
 
 template <typename T>
 T Discrete<T>::get(const time::time_t &time) const {
-	auto e = this->container.last(time, this->last_element);
-	this->last_element = e; // TODO if Caching?
-	return this->container.get(e).val();
+	return this->sample(this->container, time, this->last_element);
+}
+
+
+template <typename T>
+T Discrete<T>::sample(const KeyframeContainer<T> &container,
+                      const time::time_t &time,
+                      typename KeyframeContainer<T>::elem_ptr &hint) const {
+	auto e = container.last(time, hint);
+	hint = e;
+	return container.get(e).val();
 }
 
 
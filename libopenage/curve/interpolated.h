@@ -1,8 +1,15 @@
-// Copyright 2019-2024 the openage authors. See copying.md for legal info.
+// Copyright 2019-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <span>
+#include <vector>
+
 #include "curve/base_curve.h"
+#include "curve/reader.h"
+#include "error/error.h"
 #include "time/time.h"
 #include "util/fixed_point.h"
 
@@ -35,34 +42,300 @@ public:
 	 */
 
 	T get(const time::time_t &) const override;
+
+	/**
+	 * Get the values at multiple times.
+	 *
+	 * Walks over the keyframes once, so this is faster than calling \p get()
+	 * for every time.
+	 *
+	 * @param times Requested times. Must be sorted in ascending order.
+	 * @param out Output buffer for the values. Must have at least the size of \p times.
+	 */
+	void get_many(std::span<const time::time_t> times, std::span<T> out) const;
+
+	/**
+	 * Get the values of multiple curves at the same time.
+	 *
+	 * Samples the curves in blocks. For every block, the keyframes around \p time
+	 * are looked up first, then all values of the block are interpolated in loops
+	 * over contiguous arrays, which the compiler can vectorize. Also avoids the
+	 * virtual call of \p get() for every curve.
+	 *
+	 * @param curves Curves that are sampled.
+	 * @param time Requested time.
+	 * @param out Output buffer for the values. Must have at least the size of \p curves.
+	 */
+	static void get_all(std::span<const Interpolated<T> *const> curves,
+	                    const time::time_t &time,
+	                    std::span<T> out);
+
+	/**
+	 * Get the values of multiple curve readers at the same time.
+	 *
+	 * Samples the current snapshots of the readers in blocks like
+	 * \p get_all() for curves. Unbound readers return their fallback value.
+	 *
+	 * @param readers Readers that are sampled. Bound readers must read interpolated curves.
+	 * @param time Requested time.
+	 * @param out Output buffer for the values. Must have at least the size of \p readers.
+	 */
+	static void get_all(std::span<Reader<T> *const> readers,
+	                    const time::time_t &time,
+	                    std::span<T> out);
+
+protected:
+	T sample(const KeyframeContainer<T> &container,
+	         const time::time_t &time,
+	         typename KeyframeContainer<T>::elem_ptr &hint) const override;
+
+	/**
+	 * Interpolate the value at a given time.
+	 *
+	 * @param container Keyframes that are interpolated.
+	 * @param e Last keyframe with a time <= \p time.
+	 * @param time Requested time.
+	 *
+	 * @return Interpolated value at \p time.
+	 */
+	static T interpolate(const KeyframeContainer<T> &container,
+	                     typename KeyframeContainer<T>::elem_ptr e,
+	                     const time::time_t &time);
+
+private:
+	/**
+	 * Keyframe segments of a block of samples.
+	 *
+	 * Start values, end values and times are stored in separate arrays,
+	 * so that the interpolation loops over contiguous memory.
+	 */
+	class sample_block {
+	public:
+		/**
+		 * Maximum number of samples in a block.
+		 */
+		static constexpr size_t size = 64;
+
+		sample_block();
+
+		/**
+		 * Add a sample by looking up the keyframes around \p time.
+		 *
+		 * @param container Keyframes that are sampled.
+		 * @param hint Lookup hint for \p container. Updated to the found keyframe.
+		 * @param time Requested time.
+		 */
+		void push(const KeyframeContainer<T> &container,
+		          typename KeyframeContainer<T>::elem_ptr &hint,
+		          const time::time_t &time);
+
+		/**
+		 * Add a sample with a constant value.
+		 *
+		 * @param value Value of the sample.
+		 */
+		void push_constant(const T &value);
+
+		/**
+		 * Interpolate the values of all samples and clear the block.
+		 *
+		 * @param out Output buffer for the values of the samples.
+		 */
+		void flush(T *out);
+
+	private:
+		/**
+		 * Values at the start of the sampled segments.
+		 */
+		std::vector<T> start;
+
+		/**
+		 * Values at the end of the sampled segments.
+		 */
+		std::vector<T> end;
+
+		/**
+		 * Time between the segment start and the requested time.
+		 */
+		std::array<double, size> offset;
+
+		/**
+		 * Length of the segments.
+		 */
+		std::array<double, size> interval;
+	};
 };
 
 
 template <typename T>
 T Interpolated<T>::get(const time::time_t &time) const {
-	const auto e = this->container.last(time, this->last_element);
+	return this->sample(this->container, time, this->last_element);
+}
+
+
+template <typename T>
+T Interpolated<T>::sample(const KeyframeContainer<T> &container,
+                          const time::time_t &time,
+                          typename KeyframeContainer<T>::elem_ptr &hint) const {
+	const auto e = container.last(time, hint);
+	hint = e;
+
+	return interpolate(container, e, time);
+}
+
+
+template <typename T>
+void Interpolated<T>::get_many(std::span<const time::time_t> times, std::span<T> out) const {
+	ENSURE(out.size() >= times.size(),
+	       "output buffer for " << times.size() << " values has size " << out.size());
+
+	auto e = this->last_element;
+	for (size_t i = 0; i < times.size(); ++i) {
+		// times are sorted, so the previous keyframe is a good hint
+		e = this->container.last(times[i], e);
+		out[i] = interpolate(this->container, e, times[i]);
+	}
 	this->last_element = e;
+}
+
+
+template <typename T>
+void Interpolated<T>::get_all(std::span<const Interpolated<T> *const> curves,
+                              const time::time_t &time,
+                              std::span<T> out) {
+	ENSURE(out.size() >= curves.size(),
+	       "output buffer for " << curves.size() << " values has size " << out.size());
+
+	sample_block block;
+	for (size_t first = 0; first < curves.size(); first += sample_block::size) {
+		size_t count = std::min(sample_block::size, curves.size() - first);
+		for (size_t i = 0; i < count; ++i) {
+			const auto *curve = curves[first + i];
+			block.push(curve->container, curve->last_element, time);
+		}
+		block.flush(out.data() + first);
+	}
+}
+
+
+template <typename T>
+void Interpolated<T>::get_all(std::span<Reader<T> *const> readers,
+                              const time::time_t &time,
+                              std::span<T> out) {
+	ENSURE(out.size() >= readers.size(),
+	       "output buffer for " << readers.size() << " values has size " << out.size());
+
+	sample_block block;
+	for (size_t first = 0; first < readers.size(); first += sample_block::size) {
+		size_t count = std::min(sample_block::size, readers.size() - first);
+		for (size_t i = 0; i < count; ++i) {
+			auto *reader = readers[first + i];
+			if (reader->is_bound()) [[likely]] {
+				block.push(*reader->snapshot, reader->hint, time);
+			}
+			else {
+				block.push_constant(reader->fallback);
+			}
+		}
+		block.flush(out.data() + first);
+	}
+}
+
+
+template <typename T>
+Interpolated<T>::sample_block::sample_block() {
+	this->start.reserve(size);
+	this->end.reserve(size);
+}
+
+
+template <typename T>
+void Interpolated<T>::sample_block::push(const KeyframeContainer<T> &container,
+                                         typename KeyframeContainer<T>::elem_ptr &hint,
+                                         const time::time_t &time) {
+	const auto e = container.last(time, hint);
+	hint = e;
+
+	auto nxt = e;
+	++nxt;
 
+	const auto &current = container.get(e);
+	if (nxt == container.size()) {
+		this->push_constant(current.val());
+		return;
+	}
+
+	const auto &next = container.get(nxt);
+	auto offset = time - current.time();
+	auto interval = next.time() - current.time();
+
+	// same cases as in interpolate()
+	if (offset == 0 or interval == 0) {
+		this->push_constant(current.val());
+		return;
+	}
+
+	size_t idx = this->start.size();
+	this->start.push_back(current.val());
+	this->end.push_back(next.val());
+	this->offset[idx] = offset.to_double();
+	this->interval[idx] = interval.to_double();
+}
+
+
+template <typename T>
+void Interpolated<T>::sample_block::push_constant(const T &value) {
+	size_t idx = this->start.size();
+	this->start.push_back(value);
+	this->end.push_back(value);
+	this->offset[idx] = 0.0;
+	this->interval[idx] = 1.0;
+}
+
+
+template <typename T>
+void Interpolated<T>::sample_block::flush(T *out) {
+	const size_t count = this->start.size();
+
+	std::array<double, size> elapsed_frac;
+	for (size_t i = 0; i < count; ++i) {
+		elapsed_frac[i] = this->offset[i] / this->interval[i];
+	}
+
+	// constant samples have equal start and end values, so they stay unchanged
+	for (size_t i = 0; i < count; ++i) {
+		out[i] = this->start[i] + (this->end[i] - this->start[i]) * elapsed_frac[i];
+	}
+
+	this->start.clear();
+	this->end.clear();
+}
+
+
+template <typename T>
+T Interpolated<T>::interpolate(const KeyframeContainer<T> &container,
+                               typename KeyframeContainer<T>::elem_ptr e,
+                               const time::time_t &time) {
 	auto nxt = e;
 	++nxt;
 
 	time::time_t interval = 0;
 
-	auto offset = time - this->container.get(e).time();
+	auto offset = time - container.get(e).time();
 
-	if (nxt != this->container.size()) {
-		interval = this->container.get(nxt).time() - this->container.get(e).time();
+	if (nxt != container.size()) {
+		interval = container.get(nxt).time() - container.get(e).time();
 	}
 
 	// here, offset > interval will never hold.
 	// otherwise the underlying storage is broken.
 
 	// If the next element is at the same time, just return the value of this one.
-	if (nxt == this->container.size() // use the last curve value
+	if (nxt == container.size() // use the last curve value
 	    || offset == 0 // values equal -> don't need to interpolate
 	    || interval == 0) { // values at the same time -> division-by-zero-error
 
-		return this->container.get(e).val();
+		return container.get(e).val();
 	}
 	else {
 		// Interpolation between time(now) and time(next) that has elapsed
@@ -72,8 +345,8 @@ T Interpolated<T>::get(const time::time_t &time) const {
 		// TODO: nxt->value - e->value will produce wrong results if
 		//       the nxt->value < e->value and curve element type is unsigned
 		//       Example: nxt = 2, e = 4; type = uint8_t ==> 2 - 4 = 254
-		auto diff_value = (this->container.get(nxt).val() - this->container.get(e).val()) * elapsed_frac;
-		return this->container.get(e).val() + diff_value;
+		auto diff_value = (container.get(nxt).val() - container.get(e).val()) * elapsed_frac;
+		return container.get(e).val() + diff_value;
 	}
 }
 
@@ -1,9 +1,15 @@
-// Copyright 2017-2018 the openage authors. See copying.md for legal info.
+// Copyright 2017-2026 the openage authors. See copying.md for legal info.
 
 #include "keyframe_container.h"
 
+#include <atomic>
+
+
 namespace openage::curve {
 
-// nothing to see here, keep walking (to the header)
+size_t next_history_id() {
+	static std::atomic<size_t> next_id{1};
+	return next_id.fetch_add(1, std::memory_order_relaxed);
+}
 
-} // openage::curve
+} // namespace openage::curve
@@ -1,19 +1,30 @@
-// Copyright 2017-2024 the openage authors. See copying.md for legal info.
+// Copyright 2017-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <functional>
 #include <iostream>
 #include <list>
 
 #include "curve/keyframe.h"
+#include "curve/keyframe_storage.h"
 #include "time/time.h"
 #include "util/fixed_point.h"
 
 
 namespace openage::curve {
 
+/**
+ * Get a new unique identifier for the modification history of a keyframe container.
+ *
+ * @return Unique history ID.
+ */
+size_t next_history_id();
+
+
 /**
  * A timely ordered list with several management functions
  *
@@ -22,8 +33,11 @@ namespace openage::curve {
  * non-accurate timing functionality, this means, that for getting a value, not
  * the exact timestamp has to be known, it will always return the one closest,
  * less or equal to the requested one.
+ *
+ * @tparam T Value type of the keyframes.
+ * @tparam L Memory layout of the keyframes (see \p keyframe_layout_for).
  **/
-template <typename T>
+template <typename T, keyframe_layout L = keyframe_layout_for<T>::value>
 class KeyframeContainer {
 public:
 	/**
@@ -34,19 +48,62 @@ public:
 
 	/**
 	 * The underlaying container type.
+	 *
+	 * Copies of the container share the keyframe chunks of the storage
+	 * until they are modified, so copying a container is cheap.
+	 */
+	using container_t = ChunkedKeyframeStorage<T, L>;
+
+	/**
+	 * Reference to an element in the container.
 	 */
-	using container_t = std::vector<keyframe_t>;
+	using keyframe_ref = typename container_t::const_reference;
 
 	/**
 	 * The index type to access elements in the container
 	 */
-	using elem_ptr = typename container_t::size_type;
+	using elem_ptr = size_t;
 
 	/**
 	 * The iterator type to access elements in the container
 	 */
 	using iterator = typename container_t::const_iterator;
 
+	/**
+	 * Bookkeeping for incremental syncs from another container.
+	 *
+	 * Stores which state of the source container was copied by the
+	 * last sync, so that the next sync only has to copy keyframes
+	 * that were changed since.
+	 */
+	struct sync_state {
+		/**
+		 * History ID of the source container.
+		 */
+		size_t source_history = 0;
+
+		/**
+		 * Modification sequence number of the source at the last sync.
+		 */
+		size_t source_seq = 0;
+
+		/**
+		 * Modification sequence number of the synced container after the last sync.
+		 */
+		size_t target_seq = 0;
+
+		/**
+		 * Start time of the last sync.
+		 */
+		time::time_t start = time::TIME_MIN;
+
+		/**
+		 * Whether keyframes at \p start were changed after the last sync.
+		 * If true, the next incremental sync must have a later start time.
+		 */
+		bool changed_at_start = false;
+	};
+
 	/**
 	 * Create a new container.
 	 *
@@ -69,6 +126,18 @@ public:
 	 */
 	KeyframeContainer(const T &defaultval);
 
+	/**
+	 * Copy a container.
+	 *
+	 * The copy shares the modification history of \p other until
+	 * it is modified, so syncs from (unmodified) copies can be incremental.
+	 */
+	KeyframeContainer(const KeyframeContainer &other);
+	KeyframeContainer &operator=(const KeyframeContainer &other);
+
+	KeyframeContainer(KeyframeContainer &&) = default;
+	KeyframeContainer &operator=(KeyframeContainer &&) = default;
+
 	/**
 	 * Return the number of elements in this container.
 	 * One element is always added at -Inf by default,
@@ -76,13 +145,16 @@ public:
 	 */
 	size_t size() const;
 
-	const keyframe_t &get(const elem_ptr &idx) const {
+	keyframe_ref get(const elem_ptr &idx) const {
 		return this->container.at(idx);
 	}
 
 	/**
 	 * Get the last element in the curve which is at or before the given time.
 	 * (i.e. elem->time <= time). Given a hint where to start the search.
+	 *
+	 * The search time is logarithmic in the distance between \p hint and
+	 * the result, so a good hint makes the lookup O(1).
 	 */
 	elem_ptr last(const time::time_t &time,
 	              const elem_ptr &hint) const;
@@ -93,7 +165,8 @@ public:
 	 *
 	 * The usage of this method is discouraged - except if there is absolutely
 	 * no chance for you to have a hint (or the container is known to be nearly
-	 * empty)
+	 * empty). The search starts at the end of the container and takes
+	 * O(log n) steps.
 	 */
 	elem_ptr last(const time::time_t &time) const {
 		return this->last(time, this->container.size());
@@ -226,6 +299,20 @@ public:
 	 */
 	elem_ptr erase(elem_ptr it);
 
+	/**
+	 * Erase all elements that are not required to look up values at
+	 * t >= \p time.
+	 *
+	 * The default element at -INF and the last element with t <= \p time
+	 * are kept, so lookups for t >= \p time return the same elements as
+	 * before. Lookups for earlier times return the default element.
+	 *
+	 * @param time Retention horizon.
+	 *
+	 * @return Number of erased elements.
+	 */
+	size_t compact(const time::time_t &time);
+
 	/**
 	 * Erase all elements with given time.
 	 * Variant without hint, starts the search at the end of the container.
@@ -270,51 +357,162 @@ public:
 	 * Essentially, the container is reset to the state immediately after construction.
 	 */
 	void clear() {
-		this->container.erase(++this->begin(), this->end());
+		this->container.erase(1, this->container.size());
+		this->modified(1);
 	}
 
+	/**
+	 * Get the modification sequence number of the container.
+	 *
+	 * The number changes whenever the keyframes are modified.
+	 *
+	 * @return Modification sequence number.
+	 */
+	size_t modification_seq() const {
+		return this->seq;
+	}
+
+	/**
+	 * Get the number of leading keyframes that have not been modified since
+	 * the container had the given modification sequence number.
+	 *
+	 * Only the last few modifications are tracked. For older sequence numbers,
+	 * the container is treated as fully modified.
+	 *
+	 * @param history History ID of the container at \p since.
+	 * @param since Modification sequence number.
+	 *
+	 * @return Number of unmodified keyframes at the front of the container.
+	 */
+	elem_ptr unmodified_since(size_t history, size_t since) const;
+
 	/**
 	 * Copy keyframes from another container to this container.
 	 *
 	 * Replaces all keyframes beginning at t >= start with keyframes from \p other.
 	 *
+	 * If a sync state is passed, keyframes that were already copied by the
+	 * last sync and have not been changed since are kept.
+	 *
 	 * @param other Curve that keyframes are copied from.
-	 * @param converter Function that converts the value type of \p other to the
-	 *                  value type of \p this.
 	 * @param start Start time at which keyframes are replaced (default = -INF).
 	 *              Using the default value replaces ALL keyframes of \p this with
 	 *              the keyframes of \p other.
+	 * @param state State of the last sync from \p other (optional). Updated by the sync.
 	 */
-	elem_ptr sync(const KeyframeContainer<T> &other,
-	              const time::time_t &start = time::TIME_MIN);
+	elem_ptr sync(const KeyframeContainer &other,
+	              const time::time_t &start = time::TIME_MIN,
+	              sync_state *state = nullptr);
 
 	/**
 	 * Copy keyframes from another container (with a different element type) to this container.
 	 *
 	 * Replaces all keyframes beginning at t >= start with keyframes from \p other.
 	 *
+	 * If a sync state is passed, keyframes that were already copied by the
+	 * last sync and have not been changed since are kept. \p converter is
+	 * only called for the keyframes that are copied.
+	 *
 	 * @param other Curve that keyframes are copied from.
 	 * @param converter Function that converts the value type of \p other to the
 	 *                  value type of \p this.
 	 * @param start Start time at which keyframes are replaced (default = -INF).
 	 *              Using the default value replaces ALL keyframes of \p this with
 	 *              the keyframes of \p other.
+	 * @param state State of the last sync from \p other (optional). Updated by the sync.
 	 */
-	template <typename O>
-	elem_ptr sync(const KeyframeContainer<O> &other,
+	template <typename O, keyframe_layout OL>
+	elem_ptr sync(const KeyframeContainer<O, OL> &other,
 	              const std::function<T(const O &)> &converter,
-	              const time::time_t &start = time::TIME_MIN);
+	              const time::time_t &start = time::TIME_MIN,
+	              sync_state *state = nullptr);
+
+	/**
+	 * Record that the keyframes at the start time of the last sync have been
+	 * changed after the sync.
+	 *
+	 * Keeps \p state valid for incremental syncs with a later start time.
+	 *
+	 * @param state State of the last sync.
+	 */
+	void sync_changed_at_start(sync_state &state) const {
+		state.target_seq = this->seq;
+		state.changed_at_start = true;
+	}
 
 	/**
 	 * Debugging method to be used from gdb to understand bugs better.
 	 */
 	void dump() const {
-		for (auto &e : container) {
-			std::cout << "Element: time: " << e.time << " v: " << e.value << std::endl;
+		for (const auto &e : this->container) {
+			std::cout << "Element: time: " << e.time() << " v: " << e.val() << std::endl;
 		}
 	}
 
 private:
+	template <typename O, keyframe_layout OL>
+	friend class KeyframeContainer;
+
+	/**
+	 * Number of modifications that are tracked for incremental syncs.
+	 */
+	static constexpr size_t change_log_size = 16;
+
+	/**
+	 * Record a modification of the container.
+	 *
+	 * @param from Index of the first keyframe that was changed.
+	 */
+	void modified(elem_ptr from);
+
+	/**
+	 * Prepare an (incremental) sync from another container.
+	 *
+	 * Erases all keyframes that have to be replaced by keyframes of \p other.
+	 *
+	 * @param other Container that keyframes are copied from.
+	 * @param start Start time at which keyframes are replaced.
+	 * @param state State of the last sync from \p other (may be nullptr).
+	 *
+	 * @return Index of the first keyframe in \p other that has to be copied.
+	 */
+	template <typename O, keyframe_layout OL>
+	elem_ptr sync_prepare(const KeyframeContainer<O, OL> &other,
+	                      const time::time_t &start,
+	                      const sync_state *state);
+
+	/**
+	 * Record a finished sync from another container.
+	 *
+	 * @param other Container that keyframes were copied from.
+	 * @param start Start time at which keyframes were replaced.
+	 * @param size_before Number of keyframes before the sync.
+	 * @param keep Number of keyframes that were kept by the sync.
+	 * @param state State of the sync (may be nullptr).
+	 */
+	template <typename O, keyframe_layout OL>
+	void sync_finish(const KeyframeContainer<O, OL> &other,
+	                 const time::time_t &start,
+	                 elem_ptr size_before,
+	                 elem_ptr keep,
+	                 sync_state *state);
+
+	/**
+	 * Find the last element with a time before \p time.
+	 *
+	 * The search starts at \p hint and gallops (exponentially growing
+	 * steps) towards the result before finishing with a search in the
+	 * remaining range.
+	 *
+	 * @tparam inclusive If true, elements with a time equal to \p time are before it.
+	 * @param hint Index to start the search at. May be the container size.
+	 * @param time Searched time.
+	 *
+	 * @return Index of the last element before \p time, or 0 if there is none.
+	 */
+	template <bool inclusive>
+	elem_ptr gallop(const elem_ptr &hint, const time::time_t &time) const;
+
 	/**
 	 * Erase elements with this time.
 	 * The iterator has to point to the last element of the same-time group.
@@ -326,31 +524,114 @@ private:
 	 * The data store.
 	 */
 	container_t container;
+
+	/**
+	 * Identifies the modification history of the container.
+	 *
+	 * Copies share the history ID of the original until they are modified.
+	 */
+	size_t history;
+
+	/**
+	 * Whether this container is an unmodified copy of another container.
+	 */
+	bool shared_history;
+
+	/**
+	 * Modification sequence number. Incremented on every modification.
+	 */
+	size_t seq;
+
+	/**
+	 * Index of the first changed keyframe for the last modifications.
+	 * The modification with sequence number `s` is stored at `s % change_log_size`.
+	 */
+	std::array<elem_ptr, change_log_size> changes;
 };
 
 
-template <typename T>
-KeyframeContainer<T>::KeyframeContainer() {
+template <typename T, keyframe_layout L>
+KeyframeContainer<T, L>::KeyframeContainer() :
+	history{next_history_id()},
+	shared_history{false},
+	seq{0},
+	changes{} {
 	// Create a default element at -Inf, that can always be dereferenced - so
 	// there will by definition never be a element that cannot be dereferenced
 	this->container.push_back(keyframe_t(time::TIME_MIN, T()));
 }
 
 
-template <typename T>
-KeyframeContainer<T>::KeyframeContainer(const T &defaultval) {
+template <typename T, keyframe_layout L>
+KeyframeContainer<T, L>::KeyframeContainer(const T &defaultval) :
+	history{next_history_id()},
+	shared_history{false},
+	seq{0},
+	changes{} {
 	// Create a default element at -Inf, that can always be dereferenced - so
 	// there will by definition never be a element that cannot be dereferenced
 	this->container.push_back(keyframe_t(time::TIME_MIN, defaultval));
 }
 
 
-template <typename T>
-size_t KeyframeContainer<T>::size() const {
+template <typename T, keyframe_layout L>
+KeyframeContainer<T, L>::KeyframeContainer(const KeyframeContainer &other) :
+	container{other.container},
+	history{other.history},
+	shared_history{true},
+	seq{other.seq},
+	changes{other.changes} {}
+
+
+template <typename T, keyframe_layout L>
+KeyframeContainer<T, L> &KeyframeContainer<T, L>::operator=(const KeyframeContainer &other) {
+	this->container = other.container;
+	this->history = other.history;
+	this->shared_history = true;
+	this->seq = other.seq;
+	this->changes = other.changes;
+
+	return *this;
+}
+
+
+template <typename T, keyframe_layout L>
+size_t KeyframeContainer<T, L>::size() const {
 	return this->container.size();
 }
 
 
+template <typename T, keyframe_layout L>
+void KeyframeContainer<T, L>::modified(elem_ptr from) {
+	if (this->shared_history) [[unlikely]] {
+		// the copy diverges from the original, so it needs its own history
+		this->history = next_history_id();
+		this->shared_history = false;
+	}
+
+	++this->seq;
+	this->changes[this->seq % change_log_size] = from;
+}
+
+
+template <typename T, keyframe_layout L>
+typename KeyframeContainer<T, L>::elem_ptr
+KeyframeContainer<T, L>::unmodified_since(size_t history, size_t since) const {
+	if (history != this->history or since > this->seq
+	    or this->seq - since > change_log_size) {
+		// unknown state of the container
+		return 0;
+	}
+
+	elem_ptr unmodified = this->container.size();
+	for (size_t s = since + 1; s <= this->seq; ++s) {
+		unmodified = std::min(unmodified, this->changes[s % change_log_size]);
+	}
+
+	return unmodified;
+}
+
+
 /*
  * Select the last element that is <= a given time.
  * If there is multiple elements with the same time, return the last of them.
@@ -359,29 +640,11 @@ size_t KeyframeContainer<T>::size() const {
  * Intuitively, this function returns the element that set the last value
  * that determines the curve value for a searched time.
  */
-template <typename T>
-typename KeyframeContainer<T>::elem_ptr
-KeyframeContainer<T>::last(const time::time_t &time,
-                           const KeyframeContainer<T>::elem_ptr &hint) const {
-	elem_ptr at = hint;
-	const elem_ptr end = this->container.size();
-
-	if (at != end and this->container.at(at).time() <= time) {
-		// walk to the right until the time is larget than the searched
-		while (at != end and this->container.at(at).time() <= time) {
-			++at;
-		}
-		// go one back, because we want the last element that is <= time
-		--at;
-	}
-	else { // idx == end or idx->time > time
-		// walk to the left until the element time is smaller than the searched time
-		while (at > 0 and (at == end or this->container.at(at).time() > time)) {
-			--at;
-		}
-	}
-
-	return at;
+template <typename T, keyframe_layout L>
+typename KeyframeContainer<T, L>::elem_ptr
+KeyframeContainer<T, L>::last(const time::time_t &time,
+                              const KeyframeContainer<T, L>::elem_ptr &hint) const {
+	return this->gallop<true>(hint, time);
 }
 
 
@@ -393,54 +656,106 @@ KeyframeContainer<T>::last(const time::time_t &time,
  * Intuitively, this function returns the element that comes right before the
  * first element that matches the search time.
  */
-template <typename T>
-typename KeyframeContainer<T>::elem_ptr
-KeyframeContainer<T>::last_before(const time::time_t &time,
-                                  const KeyframeContainer<T>::elem_ptr &hint) const {
-	elem_ptr at = hint;
+template <typename T, keyframe_layout L>
+typename KeyframeContainer<T, L>::elem_ptr
+KeyframeContainer<T, L>::last_before(const time::time_t &time,
+                                     const KeyframeContainer<T, L>::elem_ptr &hint) const {
+	return this->gallop<false>(hint, time);
+}
+
+
+/*
+ * Exponential search starting at the hint.
+ *
+ * `is_before` partitions the (sorted) container: it returns true for a prefix
+ * of the elements and false for the rest. We want the last element of that
+ * prefix.
+ *
+ * Starting from the hint, the step width is doubled until the partition point
+ * is bracketed, which is then located by the storage in the bracket.
+ * For a hint at distance d from the result this needs O(log d) comparisons,
+ * so good hints stay O(1) and bad hints degrade to O(log n) instead of O(n).
+ */
+template <typename T, keyframe_layout L>
+template <bool inclusive>
+typename KeyframeContainer<T, L>::elem_ptr
+KeyframeContainer<T, L>::gallop(const elem_ptr &hint, const time::time_t &time) const {
 	const elem_ptr end = this->container.size();
 
-	if (at != end and this->container.at(at).time() < time) {
-		// walk to the right until the time is larget than the searched
-		while (at != end and this->container.at(at).time() <= time) {
-			++at;
+	auto is_before = [&time](const time::time_t &t) {
+		if constexpr (inclusive) {
+			return t <= time;
+		}
+		else {
+			return t < time;
+		}
+	};
+
+	// lo: index known to be in the prefix
+	// hi: index known to be after the prefix (or end)
+	elem_ptr lo;
+	elem_ptr hi;
+
+	if (hint < end and is_before(this->container.time(hint))) {
+		// gallop to the right until an element after the prefix is found
+		lo = hint;
+		elem_ptr step = 1;
+		while (true) {
+			hi = (end - lo > step) ? lo + step : end;
+			if (hi == end or not is_before(this->container.time(hi))) {
+				break;
+			}
+			lo = hi;
+			step *= 2;
 		}
-		// go one back, because we want the last element that is <= time
-		--at;
 	}
-	else { // idx == end or idx->time > time
-		// walk to the left until the element time is smaller than the searched time
-		while (at > 0 and (at == end or this->container.at(at).time() >= time)) {
-			--at;
+	else {
+		// gallop to the left until an element in the prefix is found
+		hi = std::min(hint, end);
+		elem_ptr step = 1;
+		while (true) {
+			if (hi == 0) {
+				// not even the first element is in the prefix
+				return 0;
+			}
+			lo = (hi > step) ? hi - step : 0;
+			if (is_before(this->container.time(lo))) {
+				break;
+			}
+			hi = lo;
+			step *= 2;
 		}
 	}
 
-	return at;
+	// search for the first element after the prefix in (lo, hi)
+	return this->container.template partition_point<inclusive>(lo + 1, hi, time) - 1;
 }
 
 
 /*
  * Determine where to insert based on time, and insert.
  */
-template <typename T>
-typename KeyframeContainer<T>::elem_ptr
-KeyframeContainer<T>::insert_before(const KeyframeContainer<T>::keyframe_t &e,
-                                    const KeyframeContainer<T>::elem_ptr &hint) {
+template <typename T, keyframe_layout L>
+typename KeyframeContainer<T, L>::elem_ptr
+KeyframeContainer<T, L>::insert_before(const KeyframeContainer<T, L>::keyframe_t &e,
+                                       const KeyframeContainer<T, L>::elem_ptr &hint) {
 	elem_ptr at = this->last(e.time(), hint);
 
 	if (at == this->container.size()) {
 		this->container.push_back(e);
+		this->modified(at);
 		return at;
 	}
 
 	// seek over all same-time elements, so we can insert before the first one
-	while (this->container.at(at).time() == e.time() and at > 0) {
+	while (this->container.time(at) == e.time() and at > 0) {
 		at--;
 	}
 
 	++at;
 
-	this->container.insert(this->begin() + at, e);
+	this->container.insert(at, e);
+	this->modified(at);
 	return at;
 }
 
@@ -448,11 +763,11 @@ KeyframeContainer<T>::insert_before(const KeyframeContainer<T>::keyframe_t &e,
 /*
  * Determine where to insert based on time, and insert, overwriting value(s) with same time.
  */
-template <typename T>
-typename KeyframeContainer<T>::elem_ptr
-KeyframeContainer<T>::insert_overwrite(const KeyframeContainer<T>::keyframe_t &e,
-                                       const KeyframeContainer<T>::elem_ptr &hint,
-                                       bool overwrite_all) {
+template <typename T, keyframe_layout L>
+typename KeyframeContainer<T, L>::elem_ptr
+KeyframeContainer<T, L>::insert_overwrite(const KeyframeContainer<T, L>::keyframe_t &e,
+                                          const KeyframeContainer<T, L>::elem_ptr &hint,
+                                          bool overwrite_all) {
 	elem_ptr at = this->last(e.time(), hint);
 	const elem_ptr end = this->container.size();
 
@@ -462,14 +777,15 @@ KeyframeContainer<T>::insert_overwrite(const KeyframeContainer<T>::keyframe_t &e
 	else if (at != end) {
 		// overwrite the same-time element
 		if (this->get(at).time() == e.time()) {
-			this->container.erase(this->begin() + at);
+			this->container.erase(at);
 		}
 		else {
 			++at;
 		}
 	}
 
-	this->container.insert(this->begin() + at, e);
+	this->container.insert(at, e);
+	this->modified(at);
 	return at;
 }
 
@@ -478,10 +794,10 @@ KeyframeContainer<T>::insert_overwrite(const KeyframeContainer<T>::keyframe_t &e
  * Determine where to insert based on time, and insert.
  * If there is a time conflict, insert after the existing element.
  */
-template <typename T>
-typename KeyframeContainer<T>::elem_ptr
-KeyframeContainer<T>::insert_after(const KeyframeContainer<T>::keyframe_t &e,
-                                   const KeyframeContainer<T>::elem_ptr &hint) {
+template <typename T, keyframe_layout L>
+typename KeyframeContainer<T, L>::elem_ptr
+KeyframeContainer<T, L>::insert_after(const KeyframeContainer<T, L>::keyframe_t &e,
+                                      const KeyframeContainer<T, L>::elem_ptr &hint) {
 	elem_ptr at = this->last(e.time(), hint);
 	const elem_ptr end = this->container.size();
 
@@ -489,7 +805,8 @@ KeyframeContainer<T>::insert_after(const KeyframeContainer<T>::keyframe_t &e,
 		++at;
 	}
 
-	this->container.insert(this->begin() + at, e);
+	this->container.insert(at, e);
+	this->modified(at);
 	return at;
 }
 
@@ -497,14 +814,17 @@ KeyframeContainer<T>::insert_after(const KeyframeContainer<T>::keyframe_t &e,
 /*
  * Go from the end to the last_valid element, and call erase on all of them
  */
-template <typename T>
-typename KeyframeContainer<T>::elem_ptr
-KeyframeContainer<T>::erase_after(KeyframeContainer<T>::elem_ptr last_valid) {
+template <typename T, keyframe_layout L>
+typename KeyframeContainer<T, L>::elem_ptr
+KeyframeContainer<T, L>::erase_after(KeyframeContainer<T, L>::elem_ptr last_valid) {
 	// exclude the last_valid element from deletion
 	if (last_valid != this->container.size()) {
 		// Delete everything to the end.
 		const elem_ptr delete_start = last_valid + 1;
-		this->container.erase(this->begin() + delete_start, this->end());
+		if (delete_start < this->container.size()) {
+			this->container.erase(delete_start, this->container.size());
+			this->modified(delete_start);
+		}
 	}
 
 	return last_valid;
@@ -514,69 +834,147 @@ KeyframeContainer<T>::erase_after(KeyframeContainer<T>::elem_ptr last_valid) {
 /*
  * Delete the element from the list and call delete on it.
  */
-template <typename T>
-typename KeyframeContainer<T>::elem_ptr
-KeyframeContainer<T>::erase(KeyframeContainer<T>::elem_ptr e) {
-	this->container.erase(this->begin() + e);
+template <typename T, keyframe_layout L>
+typename KeyframeContainer<T, L>::elem_ptr
+KeyframeContainer<T, L>::erase(KeyframeContainer<T, L>::elem_ptr e) {
+	this->container.erase(e);
+	this->modified(e);
 	return e;
 }
 
 
-template <typename T>
-typename KeyframeContainer<T>::elem_ptr
-KeyframeContainer<T>::sync(const KeyframeContainer<T> &other,
-                           const time::time_t &start) {
-	// Delete elements after start time
-	elem_ptr at = this->last_before(start, this->container.size());
-	at = this->erase_after(at);
+template <typename T, keyframe_layout L>
+size_t KeyframeContainer<T, L>::compact(const time::time_t &time) {
+	// the element that determines the value at the horizon
+	elem_ptr horizon = this->last(time, this->container.size());
 
-	auto at_other = 1; // always skip the first element (because it's the default value)
+	// always keep the default element at -INF
+	if (horizon <= 1) {
+		return 0;
+	}
 
-	// Copy all elements from other with time >= start
-	for (size_t i = at_other; i < other.size(); i++) {
-		if (other.get(i).time() >= start) {
-			at = this->insert_after(other.get(i), at);
-		}
+	this->container.erase(1, horizon);
+	this->modified(1);
+	return horizon - 1;
+}
+
+
+template <typename T, keyframe_layout L>
+typename KeyframeContainer<T, L>::elem_ptr
+KeyframeContainer<T, L>::sync(const KeyframeContainer<T, L> &other,
+                              const time::time_t &start,
+                              sync_state *state) {
+	const elem_ptr size_before = this->container.size();
+	const elem_ptr copy_from = this->sync_prepare(other, start, state);
+	const elem_ptr keep = this->container.size();
+
+	// Append all elements from other that have to be copied
+	this->container.append(other.container, copy_from);
+
+	this->sync_finish(other, start, size_before, keep, state);
+
+	return this->container.size();
+}
+
+
+template <typename T, keyframe_layout L>
+template <typename O, keyframe_layout OL>
+typename KeyframeContainer<T, L>::elem_ptr
+KeyframeContainer<T, L>::sync(const KeyframeContainer<O, OL> &other,
+                              const std::function<T(const O &)> &converter,
+                              const time::time_t &start,
+                              sync_state *state) {
+	const elem_ptr size_before = this->container.size();
+	const elem_ptr copy_from = this->sync_prepare(other, start, state);
+	const elem_ptr keep = this->container.size();
+
+	// Append all elements from other that have to be copied
+	this->container.reserve(this->container.size() + other.size() - copy_from);
+	for (size_t i = copy_from; i < other.size(); i++) {
+		const auto &elem = other.get(i);
+		this->container.push_back(keyframe_t{elem.time(), converter(elem.val())});
 	}
 
+	this->sync_finish(other, start, size_before, keep, state);
+
 	return this->container.size();
 }
 
 
-template <typename T>
-template <typename O>
-typename KeyframeContainer<T>::elem_ptr
-KeyframeContainer<T>::sync(const KeyframeContainer<O> &other,
-                           const std::function<T(const O &)> &converter,
-                           const time::time_t &start) {
-	// Delete elements after start time
-	elem_ptr at = this->last_before(start, this->container.size());
-	at = this->erase_after(at);
+template <typename T, keyframe_layout L>
+template <typename O, keyframe_layout OL>
+typename KeyframeContainer<T, L>::elem_ptr
+KeyframeContainer<T, L>::sync_prepare(const KeyframeContainer<O, OL> &other,
+                                      const time::time_t &start,
+                                      const sync_state *state) {
+	// First element of other with time >= start
+	// always skip the first element (because it's the default value)
+	const elem_ptr other_start = other.last_before(start, other.size()) + 1;
+
+	// First element of this with time >= start
+	const elem_ptr this_start = this->last_before(start, this->container.size()) + 1;
+
+	// Elements of other that are already copied to this container.
+	// The elements at t >= start of this container are copies of the elements
+	// of other at the last sync if this container was not changed since and
+	// start did not move backwards.
+	elem_ptr copy_from = other_start;
+	if (state != nullptr
+	    and state->target_seq == this->seq
+	    and (start > state->start
+	         or (start == state->start and not state->changed_at_start))) {
+		auto unmodified = other.unmodified_since(state->source_history, state->source_seq);
+		copy_from = std::max(other_start, std::min(unmodified, other.size()));
+	}
+
+	// Delete elements after start time, except for the copies that are still valid
+	elem_ptr keep = this_start + (copy_from - other_start);
+	if (keep > this->container.size()) [[unlikely]] {
+		// should not happen, but stay correct by copying everything
+		keep = this_start;
+		copy_from = other_start;
+	}
+
+	this->container.erase(keep, this->container.size());
 
-	auto at_other = 1; // always skip the first element (because it's the default value)
+	return copy_from;
+}
 
-	// Copy all elements from other with time >= start
-	for (size_t i = at_other; i < other.size(); i++) {
-		if (other.get(i).time() >= start) {
-			at = this->insert_after(keyframe_t(other.get(i).time(), converter(other.get(i).val())), at);
-		}
+
+template <typename T, keyframe_layout L>
+template <typename O, keyframe_layout OL>
+void KeyframeContainer<T, L>::sync_finish(const KeyframeContainer<O, OL> &other,
+                                          const time::time_t &start,
+                                          elem_ptr size_before,
+                                          elem_ptr keep,
+                                          sync_state *state) {
+	if (keep != size_before or keep != this->container.size()) {
+		this->modified(keep);
 	}
 
-	return this->container.size();
+	if (state != nullptr) {
+		state->source_history = other.history;
+		state->source_seq = other.seq;
+		state->target_seq = this->seq;
+		state->start = start;
+		state->changed_at_start = false;
+	}
 }
 
 
-template <typename T>
-typename KeyframeContainer<T>::elem_ptr
-KeyframeContainer<T>::erase_group(const time::time_t &time,
-                                  const KeyframeContainer<T>::elem_ptr &last_elem) {
+template <typename T, keyframe_layout L>
+typename KeyframeContainer<T, L>::elem_ptr
+KeyframeContainer<T, L>::erase_group(const time::time_t &time,
+                                     const KeyframeContainer<T, L>::elem_ptr &last_elem) {
 	size_t at = last_elem;
 
 	// if the time what we're looking for
 	// erase elements until all element with that time are purged
-	while (at != this->container.size() and this->container.at(at).time() == time) {
-		this->container.erase(this->container.begin() + at);
+	bool erased = false;
+	while (at != this->container.size() and this->container.time(at) == time) {
+		this->container.erase(at);
 		--at;
+		erased = true;
 	}
 
 	// we have to cancel one --at in order to return
@@ -585,6 +983,10 @@ KeyframeContainer<T>::erase_group(const time::time_t &time,
 		++at;
 	}
 
+	if (erased) {
+		this->modified(at);
+	}
+
 	return at;
 }
 
@@ -0,0 +1,107 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#include "keyframe_storage.h"
+
+#include <bit>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define OPENAGE_KEYFRAME_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+
+namespace openage::curve::detail {
+
+namespace {
+
+using scan_fn_t = size_t (*)(const int64_t *, size_t, int64_t, bool);
+
+
+size_t scan_times_scalar(const int64_t *times, size_t count, int64_t needle, bool inclusive) {
+	size_t idx = 0;
+	if (inclusive) {
+		while (idx < count and times[idx] <= needle) {
+			++idx;
+		}
+	}
+	else {
+		while (idx < count and times[idx] < needle) {
+			++idx;
+		}
+	}
+	return idx;
+}
+
+
+#ifdef OPENAGE_KEYFRAME_SCAN_X86
+
+__attribute__((target("avx2"))) size_t scan_times_avx2(const int64_t *times, size_t count, int64_t needle, bool inclusive) {
+	// with t > needle - 1 == t >= needle, both cases only need cmpgt
+	const __m256i needles = _mm256_set1_epi64x(inclusive ? needle : needle - 1);
+
+	size_t idx = 0;
+	if (inclusive or needle != INT64_MIN) {
+		for (; idx + 4 <= count; idx += 4) {
+			__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(times + idx));
+
+			// mask of the elements that are not before the needle
+			__m256i after = _mm256_cmpgt_epi64(block, needles);
+			auto mask = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(after)));
+			if (mask != 0) {
+				return idx + std::countr_zero(mask);
+			}
+		}
+	}
+
+	return idx + scan_times_scalar(times + idx, count - idx, needle, inclusive);
+}
+
+
+__attribute__((target("sse4.2"))) size_t scan_times_sse42(const int64_t *times, size_t count, int64_t needle, bool inclusive) {
+	const __m128i needles = _mm_set1_epi64x(inclusive ? needle : needle - 1);
+
+	size_t idx = 0;
+	if (inclusive or needle != INT64_MIN) {
+		for (; idx + 2 <= count; idx += 2) {
+			__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(times + idx));
+
+			// mask of the elements that are not before the needle
+			__m128i after = _mm_cmpgt_epi64(block, needles);
+			auto mask = static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(after)));
+			if (mask != 0) {
+				return idx + std::countr_zero(mask);
+			}
+		}
+	}
+
+	return idx + scan_times_scalar(times + idx, count - idx, needle, inclusive);
+}
+
+#endif
+
+
+/**
+ * Select the fastest scan that the CPU supports.
+ */
+scan_fn_t select_scan() {
+#ifdef OPENAGE_KEYFRAME_SCAN_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		return scan_times_avx2;
+	}
+	if (__builtin_cpu_supports("sse4.2")) {
+		return scan_times_sse42;
+	}
+#endif
+	return scan_times_scalar;
+}
+
+} // namespace
+
+
+size_t scan_times(const int64_t *times, size_t count, int64_t needle, bool inclusive) {
+	static const scan_fn_t scan = select_scan();
+	return scan(times, count, needle, inclusive);
+}
+
+} // namespace openage::curve::detail
@@ -0,0 +1,779 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "curve/keyframe.h"
+#include "time/time.h"
+#include "util/fixed_point.h"
+
+
+namespace openage::curve {
+
+/**
+ * Memory layout of the keyframes in a keyframe container.
+ */
+enum class keyframe_layout {
+	/**
+	 * One array of keyframes, i.e. times and values are interleaved.
+	 */
+	interleaved,
+
+	/**
+	 * Separate arrays for times and values (structure of arrays).
+	 * Time lookups only touch the time array.
+	 */
+	split,
+};
+
+
+/**
+ * Keyframe layout used by curves with the value type \p T.
+ *
+ * Specialize this template to select the layout for a value type.
+ * By default, times and values of scalar types are split, so that lookups
+ * don't have to load the values into the cache. Larger values are
+ * interleaved with their times, so that reading the found value
+ * doesn't touch another array.
+ */
+template <typename T>
+struct keyframe_layout_for {
+	static constexpr keyframe_layout value = std::is_scalar_v<T>
+	                                             ? keyframe_layout::split
+	                                             : keyframe_layout::interleaved;
+};
+
+/**
+ * Fixed-point numbers are scalars, too.
+ */
+template <typename int_type, unsigned int fractional_bits>
+struct keyframe_layout_for<util::FixedPoint<int_type, fractional_bits>> {
+	static constexpr keyframe_layout value = keyframe_layout::split;
+};
+
+/**
+ * `std::vector<bool>` can't return references to its elements,
+ * so boolean keyframes are always interleaved.
+ */
+template <>
+struct keyframe_layout_for<bool> {
+	static constexpr keyframe_layout value = keyframe_layout::interleaved;
+};
+
+
+/**
+ * Storage for the keyframes of a keyframe container.
+ *
+ * Implements the memory layout of the keyframes. Elements are accessed
+ * by index, ordering is handled by the keyframe container.
+ *
+ * @tparam T Value type of the keyframes.
+ * @tparam L Memory layout of the keyframes.
+ */
+template <typename T, keyframe_layout L>
+class KeyframeStorage;
+
+
+namespace detail {
+
+/**
+ * Get the first index in [0, \p count) whose time is not before \p needle.
+ *
+ * Compares multiple times at once with AVX2 or SSE4.2 instructions if the
+ * CPU supports them. The instructions are selected at runtime, so the
+ * build doesn't have to enable them.
+ *
+ * @param times Raw values of the keyframe times.
+ * @param count Number of times.
+ * @param needle Raw value of the searched time.
+ * @param inclusive If true, times equal to \p needle are before it.
+ *
+ * @return Index of the first time not before \p needle, or \p count if there is none.
+ */
+size_t scan_times(const int64_t *times, size_t count, int64_t needle, bool inclusive);
+
+} // namespace detail
+
+
+/**
+ * Keyframe storage with interleaved times and values.
+ */
+template <typename T>
+class KeyframeStorage<T, keyframe_layout::interleaved> {
+public:
+	using keyframe_t = Keyframe<T>;
+	using const_reference = const keyframe_t &;
+	using const_iterator = typename std::vector<keyframe_t>::const_iterator;
+
+	size_t size() const {
+		return this->keyframes.size();
+	}
+
+	const time::time_t &time(size_t idx) const {
+		return this->keyframes[idx].time();
+	}
+
+	const_reference get(size_t idx) const {
+		return this->keyframes[idx];
+	}
+
+	const_reference at(size_t idx) const {
+		return this->keyframes.at(idx);
+	}
+
+	const_iterator begin() const {
+		return this->keyframes.begin();
+	}
+
+	const_iterator end() const {
+		return this->keyframes.end();
+	}
+
+	void reserve(size_t size) {
+		this->keyframes.reserve(size);
+	}
+
+	void push_back(const keyframe_t &keyframe) {
+		this->keyframes.push_back(keyframe);
+	}
+
+	void insert(size_t idx, const keyframe_t &keyframe) {
+		this->keyframes.insert(this->keyframes.begin() + idx, keyframe);
+	}
+
+	void erase(size_t idx) {
+		this->keyframes.erase(this->keyframes.begin() + idx);
+	}
+
+	void erase(size_t first, size_t last) {
+		this->keyframes.erase(this->keyframes.begin() + first,
+		                      this->keyframes.begin() + last);
+	}
+
+	/**
+	 * Append the keyframes of another storage starting at index \p from.
+	 */
+	void append(const KeyframeStorage &other, size_t from) {
+		this->keyframes.insert(this->keyframes.end(),
+		                       other.keyframes.begin() + from,
+		                       other.keyframes.end());
+	}
+
+	/**
+	 * Get the first index in [\p first, \p last) whose keyframe time is not before \p time.
+	 *
+	 * @tparam inclusive If true, times equal to \p time are before it.
+	 */
+	template <bool inclusive>
+	size_t partition_point(size_t first, size_t last, const time::time_t &time) const {
+		auto it = std::partition_point(
+			this->keyframes.begin() + first,
+			this->keyframes.begin() + last,
+			[&time](const keyframe_t &e) {
+				if constexpr (inclusive) {
+					return e.time() <= time;
+				}
+				else {
+					return e.time() < time;
+				}
+			});
+		return it - this->keyframes.begin();
+	}
+
+private:
+	/**
+	 * Keyframes.
+	 */
+	std::vector<keyframe_t> keyframes;
+};
+
+
+/**
+ * Reference to a keyframe in a storage with split times and values.
+ */
+template <typename T>
+class SplitKeyframeRef {
+public:
+	SplitKeyframeRef(const time::time_t &time, const T &value) :
+		timestamp{&time},
+		value{&value} {}
+
+	const time::time_t &time() const {
+		return *this->timestamp;
+	}
+
+	const T &val() const {
+		return *this->value;
+	}
+
+	/**
+	 * Allows `iterator->val()` on iterators that return references by value.
+	 */
+	const SplitKeyframeRef *operator->() const {
+		return this;
+	}
+
+private:
+	const time::time_t *timestamp;
+	const T *value;
+};
+
+
+/**
+ * Keyframe storage with separate arrays for times and values.
+ */
+template <typename T>
+class KeyframeStorage<T, keyframe_layout::split> {
+	static_assert(sizeof(time::time_t) == sizeof(int64_t)
+	                  and std::is_standard_layout_v<time::time_t>,
+	              "time search expects times to be stored as raw 64-bit integers");
+	static_assert(not std::is_same_v<T, bool>,
+	              "std::vector<bool> can't be used for split keyframe storage");
+
+public:
+	using keyframe_t = Keyframe<T>;
+	using const_reference = SplitKeyframeRef<T>;
+
+	/**
+	 * Iterator over the keyframes. Dereferencing returns a keyframe reference by value.
+	 */
+	class const_iterator {
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = SplitKeyframeRef<T>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = SplitKeyframeRef<T>;
+		using reference = SplitKeyframeRef<T>;
+
+		const_iterator() = default;
+		const_iterator(const KeyframeStorage *storage, size_t idx) :
+			storage{storage},
+			idx{idx} {}
+
+		reference operator*() const {
+			return this->storage->get(this->idx);
+		}
+
+		pointer operator->() const {
+			return this->storage->get(this->idx);
+		}
+
+		reference operator[](difference_type n) const {
+			return this->storage->get(this->idx + n);
+		}
+
+		const_iterator &operator++() {
+			++this->idx;
+			return *this;
+		}
+
+		const_iterator operator++(int) {
+			auto old = *this;
+			++this->idx;
+			return old;
+		}
+
+		const_iterator &operator--() {
+			--this->idx;
+			return *this;
+		}
+
+		const_iterator operator--(int) {
+			auto old = *this;
+			--this->idx;
+			return old;
+		}
+
+		const_iterator &operator+=(difference_type n) {
+			this->idx += n;
+			return *this;
+		}
+
+		const_iterator &operator-=(difference_type n) {
+			this->idx -= n;
+			return *this;
+		}
+
+		const_iterator operator+(difference_type n) const {
+			return {this->storage, this->idx + n};
+		}
+
+		const_iterator operator-(difference_type n) const {
+			return {this->storage, this->idx - n};
+		}
+
+		difference_type operator-(const const_iterator &other) const {
+			return static_cast<difference_type>(this->idx) - static_cast<difference_type>(other.idx);
+		}
+
+		bool operator==(const const_iterator &other) const {
+			return this->idx == other.idx;
+		}
+
+		auto operator<=>(const const_iterator &other) const {
+			return this->idx <=> other.idx;
+		}
+
+	private:
+		const KeyframeStorage *storage = nullptr;
+		size_t idx = 0;
+	};
+
+	size_t size() const {
+		return this->times.size();
+	}
+
+	const time::time_t &time(size_t idx) const {
+		return this->times[idx];
+	}
+
+	const_reference get(size_t idx) const {
+		return {this->times[idx], this->values[idx]};
+	}
+
+	const_reference at(size_t idx) const {
+		if (idx >= this->times.size()) [[unlikely]] {
+			throw std::out_of_range{"keyframe index out of range"};
+		}
+		return this->get(idx);
+	}
+
+	const_iterator begin() const {
+		return {this, 0};
+	}
+
+	const_iterator end() const {
+		return {this, this->times.size()};
+	}
+
+	void reserve(size_t size) {
+		this->times.reserve(size);
+		this->values.reserve(size);
+	}
+
+	void push_back(const keyframe_t &keyframe) {
+		this->times.push_back(keyframe.time());
+		this->values.push_back(keyframe.val());
+	}
+
+	void insert(size_t idx, const keyframe_t &keyframe) {
+		this->times.insert(this->times.begin() + idx, keyframe.time());
+		this->values.insert(this->values.begin() + idx, keyframe.val());
+	}
+
+	void erase(size_t idx) {
+		this->times.erase(this->times.begin() + idx);
+		this->values.erase(this->values.begin() + idx);
+	}
+
+	void erase(size_t first, size_t last) {
+		this->times.erase(this->times.begin() + first, this->times.begin() + last);
+		this->values.erase(this->values.begin() + first, this->values.begin() + last);
+	}
+
+	/**
+	 * Append the keyframes of another storage starting at index \p from.
+	 */
+	void append(const KeyframeStorage &other, size_t from) {
+		this->times.insert(this->times.end(), other.times.begin() + from, other.times.end());
+		this->values.insert(this->values.end(), other.values.begin() + from, other.values.end());
+	}
+
+	/**
+	 * Get the first index in [\p first, \p last) whose keyframe time is not before \p time.
+	 *
+	 * Narrows the range with a binary search and scans the remaining
+	 * times with \p detail::scan_times().
+	 *
+	 * @tparam inclusive If true, times equal to \p time are before it.
+	 */
+	template <bool inclusive>
+	size_t partition_point(size_t first, size_t last, const time::time_t &time) const {
+		const auto *raw = reinterpret_cast<const int64_t *>(this->times.data());
+		const int64_t needle = time.get_raw_value();
+
+		auto is_before = [needle](int64_t t) {
+			if constexpr (inclusive) {
+				return t <= needle;
+			}
+			else {
+				return t < needle;
+			}
+		};
+
+		while (last - first > linear_search_size) {
+			size_t mid = first + (last - first) / 2;
+			if (is_before(raw[mid])) {
+				first = mid + 1;
+			}
+			else {
+				last = mid;
+			}
+		}
+
+		return first + detail::scan_times(raw + first, last - first, needle, inclusive);
+	}
+
+private:
+	/**
+	 * Ranges up to this size are searched linearly.
+	 */
+	static constexpr size_t linear_search_size = 16;
+
+	/**
+	 * Times of the keyframes.
+	 */
+	std::vector<time::time_t> times;
+
+	/**
+	 * Values of the keyframes.
+	 */
+	std::vector<T> values;
+};
+
+
+/**
+ * Keyframe storage that stores the keyframes in chunks of a fixed size.
+ *
+ * Copies of the storage share their chunks until one of them modifies a
+ * chunk (copy-on-write). Copying the storage only copies the chunk pointers,
+ * and modifying the copy afterwards only copies the chunks that are changed.
+ * Curves are mostly changed at their end, so snapshots of a curve share
+ * all but the last chunks with the curve.
+ *
+ * Shared chunks are never modified, so copies can be read by other threads
+ * while the original is changed.
+ *
+ * @tparam T Value type of the keyframes.
+ * @tparam L Memory layout of the keyframes in a chunk.
+ */
+template <typename T, keyframe_layout L>
+class ChunkedKeyframeStorage {
+public:
+	using chunk_t = KeyframeStorage<T, L>;
+	using keyframe_t = Keyframe<T>;
+	using const_reference = typename chunk_t::const_reference;
+
+	/**
+	 * Maximum number of keyframes in a chunk.
+	 */
+	static constexpr size_t chunk_size = 64;
+
+	/**
+	 * Iterator over the keyframes.
+	 */
+	class const_iterator {
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = keyframe_t;
+		using difference_type = std::ptrdiff_t;
+		using reference = const_reference;
+		using pointer = std::conditional_t<std::is_reference_v<reference>,
+		                                   const keyframe_t *,
+		                                   reference>;
+
+		const_iterator() = default;
+		const_iterator(const ChunkedKeyframeStorage *storage, size_t idx) :
+			storage{storage},
+			idx{idx} {}
+
+		reference operator*() const {
+			return this->storage->get(this->idx);
+		}
+
+		pointer operator->() const {
+			if constexpr (std::is_reference_v<reference>) {
+				return &this->storage->get(this->idx);
+			}
+			else {
+				return this->storage->get(this->idx);
+			}
+		}
+
+		reference operator[](difference_type n) const {
+			return this->storage->get(this->idx + n);
+		}
+
+		const_iterator &operator++() {
+			++this->idx;
+			return *this;
+		}
+
+		const_iterator operator++(int) {
+			auto old = *this;
+			++this->idx;
+			return old;
+		}
+
+		const_iterator &operator--() {
+			--this->idx;
+			return *this;
+		}
+
+		const_iterator operator--(int) {
+			auto old = *this;
+			--this->idx;
+			return old;
+		}
+
+		const_iterator &operator+=(difference_type n) {
+			this->idx += n;
+			return *this;
+		}
+
+		const_iterator &operator-=(difference_type n) {
+			this->idx -= n;
+			return *this;
+		}
+
+		const_iterator operator+(difference_type n) const {
+			return {this->storage, this->idx + n};
+		}
+
+		const_iterator operator-(difference_type n) const {
+			return {this->storage, this->idx - n};
+		}
+
+		difference_type operator-(const const_iterator &other) const {
+			return static_cast<difference_type>(this->idx) - static_cast<difference_type>(other.idx);
+		}
+
+		bool operator==(const const_iterator &other) const {
+			return this->idx == other.idx;
+		}
+
+		auto operator<=>(const const_iterator &other) const {
+			return this->idx <=> other.idx;
+		}
+
+	private:
+		const ChunkedKeyframeStorage *storage = nullptr;
+		size_t idx = 0;
+	};
+
+	size_t size() const {
+		return this->count;
+	}
+
+	const time::time_t &time(size_t idx) const {
+		return this->chunks[idx / chunk_size]->time(idx % chunk_size);
+	}
+
+	const_reference get(size_t idx) const {
+		return this->chunks[idx / chunk_size]->get(idx % chunk_size);
+	}
+
+	const_reference at(size_t idx) const {
+		if (idx >= this->count) [[unlikely]] {
+			throw std::out_of_range{"keyframe index out of range"};
+		}
+		return this->get(idx);
+	}
+
+	const_iterator begin() const {
+		return {this, 0};
+	}
+
+	const_iterator end() const {
+		return {this, this->count};
+	}
+
+	void reserve(size_t size) {
+		this->chunks.reserve((size + chunk_size - 1) / chunk_size);
+	}
+
+	void push_back(const keyframe_t &keyframe) {
+		if (this->count % chunk_size == 0) {
+			this->chunks.push_back(std::make_shared<chunk_t>());
+		}
+		this->unique_chunk(this->chunks.size() - 1).push_back(keyframe);
+		++this->count;
+	}
+
+	void insert(size_t idx, const keyframe_t &keyframe) {
+		if (idx == this->count) {
+			this->push_back(keyframe);
+			return;
+		}
+
+		size_t chunk = idx / chunk_size;
+		if (chunk == this->chunks.size() - 1 and this->count % chunk_size != 0) {
+			// the last chunk has space left
+			this->unique_chunk(chunk).insert(idx % chunk_size, keyframe);
+			++this->count;
+			return;
+		}
+
+		auto tail = this->take_tail(idx);
+		this->push_back(keyframe);
+		for (const auto &moved : tail) {
+			this->push_back(moved);
+		}
+	}
+
+	void erase(size_t idx) {
+		this->erase(idx, idx + 1);
+	}
+
+	void erase(size_t first, size_t last) {
+		if (first >= last) {
+			return;
+		}
+
+		if (last == this->count) {
+			this->truncate(first);
+			return;
+		}
+
+		size_t chunk = first / chunk_size;
+		if (chunk == this->chunks.size() - 1) {
+			// only the last chunk is changed
+			this->unique_chunk(chunk).erase(first % chunk_size, last - chunk * chunk_size);
+			this->count -= last - first;
+			return;
+		}
+
+		auto tail = this->take_tail(last);
+		this->truncate(first);
+		for (const auto &moved : tail) {
+			this->push_back(moved);
+		}
+	}
+
+	/**
+	 * Append the keyframes of another storage starting at index \p from.
+	 *
+	 * Chunks that line up with the chunks of this storage are shared
+	 * instead of copied.
+	 */
+	void append(const ChunkedKeyframeStorage &other, size_t from) {
+		while (from < other.count) {
+			if (this->count % chunk_size == 0 and from % chunk_size == 0) {
+				const auto &chunk = other.chunks[from / chunk_size];
+				this->chunks.push_back(chunk);
+				this->count += chunk->size();
+				from += chunk->size();
+			}
+			else {
+				auto keyframe = other.get(from);
+				this->push_back(keyframe_t{keyframe.time(), keyframe.val()});
+				++from;
+			}
+		}
+	}
+
+	/**
+	 * Get the first index in [\p first, \p last) whose keyframe time is not before \p time.
+	 *
+	 * Finds the chunk of the index with a binary search over the chunks
+	 * and searches the chunk with its own search.
+	 *
+	 * @tparam inclusive If true, times equal to \p time are before it.
+	 */
+	template <bool inclusive>
+	size_t partition_point(size_t first, size_t last, const time::time_t &time) const {
+		if (first >= last) {
+			return first;
+		}
+
+		auto is_before = [&time](const time::time_t &t) {
+			if constexpr (inclusive) {
+				return t <= time;
+			}
+			else {
+				return t < time;
+			}
+		};
+
+		// first chunk whose last keyframe in the range is not before the time
+		size_t lo = first / chunk_size;
+		size_t hi = (last - 1) / chunk_size + 1;
+		while (lo < hi) {
+			size_t mid = lo + (hi - lo) / 2;
+			size_t mid_last = std::min(last, (mid + 1) * chunk_size) - 1;
+			if (is_before(this->time(mid_last))) {
+				lo = mid + 1;
+			}
+			else {
+				hi = mid;
+			}
+		}
+
+		if (lo * chunk_size >= last) {
+			return last;
+		}
+
+		size_t chunk_start = lo * chunk_size;
+		size_t chunk_first = std::max(first, chunk_start) - chunk_start;
+		size_t chunk_last = std::min(last, chunk_start + chunk_size) - chunk_start;
+		return chunk_start
+		       + this->chunks[lo]->template partition_point<inclusive>(chunk_first, chunk_last, time);
+	}
+
+private:
+	/**
+	 * Get a chunk for modification. Copies the chunk if it is shared.
+	 *
+	 * @param chunk Index of the chunk.
+	 */
+	chunk_t &unique_chunk(size_t chunk) {
+		auto &ptr = this->chunks[chunk];
+		if (ptr.use_count() != 1) {
+			ptr = std::make_shared<chunk_t>(*ptr);
+		}
+		else {
+			// the last other owner may have released the chunk on another
+			// thread, so its reads must happen before the modification
+			std::atomic_thread_fence(std::memory_order_acquire);
+		}
+		return *ptr;
+	}
+
+	/**
+	 * Remove all keyframes from index \p size to the end.
+	 */
+	void truncate(size_t size) {
+		this->chunks.resize((size + chunk_size - 1) / chunk_size);
+		if (size % chunk_size != 0) {
+			auto &chunk = this->unique_chunk(this->chunks.size() - 1);
+			chunk.erase(size % chunk_size, chunk.size());
+		}
+		this->count = size;
+	}
+
+	/**
+	 * Remove all keyframes from index \p from to the end and return them.
+	 */
+	std::vector<keyframe_t> take_tail(size_t from) {
+		std::vector<keyframe_t> tail;
+		tail.reserve(this->count - from);
+		for (size_t i = from; i < this->count; ++i) {
+			auto keyframe = this->get(i);
+			tail.emplace_back(keyframe.time(), keyframe.val());
+		}
+		this->truncate(from);
+		return tail;
+	}
+
+	/**
+	 * Chunks of the keyframes. All chunks except the last one are full.
+	 */
+	std::vector<std::shared_ptr<chunk_t>> chunks;
+
+	/**
+	 * Number of keyframes.
+	 */
+	size_t count = 0;
+};
+
+} // namespace openage::curve
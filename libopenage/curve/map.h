@@ -1,7 +1,8 @@
-// Copyright 2017-2023 the openage authors. See copying.md for legal info.
+// Copyright 2017-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
+#include <functional>
 #include <iostream>
 #include <optional>
 #include <unordered_map>
@@ -70,8 +71,18 @@ public:
 	void kill(const time::time_t &,
 	          const MapFilterIterator<val_t, val_t, UnorderedMap> &);
 
-	// remove all dead elements before that point in time
-	void clean(const time::time_t &);
+	/**
+	 * Erase all elements that are dead at t <= time.
+	 *
+	 * These elements are not accessible at t >= time, so the map behaves
+	 * the same for accesses at t >= time after compaction.
+	 *
+	 * @param time Retention horizon.
+	 * @param compact_value Called for every remaining value, e.g. to compact
+	 *                      curves stored in the map (optional).
+	 */
+	void compact(const time::time_t &time,
+	             const std::function<void(val_t &)> &compact_value = nullptr);
 
 	/**
 	 * gdb helper method.
@@ -200,8 +211,17 @@ void UnorderedMap<key_t, val_t>::kill(const time::time_t &time,
 }
 
 template <typename key_t, typename val_t>
-void UnorderedMap<key_t, val_t>::clean(const time::time_t &) {
-	// TODO save everything to a file and be happy.
+void UnorderedMap<key_t, val_t>::compact(const time::time_t &time,
+                                         const std::function<void(val_t &)> &compact_value) {
+	std::erase_if(this->container, [&time](const auto &item) {
+		return item.second.dead <= time;
+	});
+
+	if (compact_value) {
+		for (auto &item : this->container) {
+			compact_value(item.second.value);
+		}
+	}
 }
 
 } // namespace openage::curve
@@ -1,7 +1,8 @@
-// Copyright 2017-2024 the openage authors. See copying.md for legal info.
+// Copyright 2017-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
 #include <iostream>
 #include <iterator>
@@ -189,6 +190,16 @@ public:
 	 */
 	void clear(const time::time_t &time);
 
+	/**
+	 * Erase all elements that are dead at t <= time.
+	 *
+	 * These elements are not accessible at t >= time, so the queue behaves
+	 * the same for accesses at t >= time after compaction.
+	 *
+	 * @param time Retention horizon.
+	 */
+	void compact(const time::time_t &time);
+
 	/**
 	 * Print the queue to stdout.
 	 */
@@ -469,5 +480,25 @@ void Queue<T>::clear(const time::time_t &time) {
 }
 
 
+template <typename T>
+void Queue<T>::compact(const time::time_t &time) {
+	auto is_dead = [&time](const queue_wrapper &e) {
+		return e.dead() <= time;
+	};
+
+	// the cached front position moves by the number of erased elements before it
+	auto erased_before_front = std::count_if(this->container.begin(),
+	                                         std::next(this->container.begin(), this->front_start),
+	                                         is_dead);
+
+	this->container.erase(std::remove_if(this->container.begin(),
+	                                     this->container.end(),
+	                                     is_dead),
+	                      this->container.end());
+
+	this->front_start -= erased_before_front;
+}
+
+
 } // namespace curve
 } // namespace openage
@@ -0,0 +1,181 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "curve/keyframe_container.h"
+#include "time/time.h"
+
+
+namespace openage::curve {
+
+template <typename T>
+class BaseCurve;
+
+template <typename T>
+class Interpolated;
+
+/**
+ * Read cursor for sampling a curve from another thread.
+ *
+ * A reader samples the last keyframe snapshot that was published by the
+ * curve's writer with \p BaseCurve::publish(). Snapshots are immutable,
+ * so sampling never races with writes on the curve. Fetching a snapshot
+ * is lock-free (see \p SnapshotSlot).
+ * The reader holds its own lookup hint instead of using the shared
+ * hint of the curve.
+ *
+ * Readers are not thread-safe themselves, i.e. every thread should use
+ * its own reader. The curve must outlive all of its readers.
+ */
+template <typename T>
+class Reader {
+public:
+	/**
+	 * Create a reader that is not bound to a curve.
+	 *
+	 * The reader returns \p fallback until a bound reader is assigned to it.
+	 *
+	 * @param fallback Value returned by \p get() while the reader is unbound.
+	 */
+	explicit Reader(const T &fallback = T());
+
+	/**
+	 * Create a reader for a curve.
+	 *
+	 * The reader starts with the latest published snapshot of the curve.
+	 *
+	 * @param curve Curve that is read.
+	 */
+	explicit Reader(const BaseCurve<T> &curve);
+
+	~Reader() = default;
+
+	/**
+	 * Fetch the latest snapshot published by the curve.
+	 *
+	 * Should be called once before sampling a batch of values
+	 * (e.g. once per frame), so that all samples are taken from
+	 * the same snapshot.
+	 *
+	 * @return true if a new snapshot was fetched, else false.
+	 */
+	bool update();
+
+	/**
+	 * Get the value of the curve at a given time.
+	 *
+	 * Uses the same sampling as the curve's \p get(), but samples
+	 * the current snapshot of the reader. Unbound readers return
+	 * their fallback value.
+	 *
+	 * @param time Requested time.
+	 *
+	 * @return Value of the curve at \p time.
+	 */
+	T get(const time::time_t &time);
+
+	/**
+	 * Check whether the reader is bound to a curve.
+	 *
+	 * @return true if the reader can be sampled, else false.
+	 */
+	bool is_bound() const {
+		return this->curve != nullptr;
+	}
+
+	/**
+	 * Get the keyframes of the current snapshot.
+	 *
+	 * @return Keyframe container of the snapshot.
+	 */
+	const KeyframeContainer<T> &get_container() const {
+		return *this->snapshot;
+	}
+
+private:
+	friend class Interpolated<T>;
+
+	/**
+	 * Curve that is read.
+	 */
+	const BaseCurve<T> *curve;
+
+	/**
+	 * Version of the snapshot in the publication slot of the curve.
+	 */
+	uint64_t version;
+
+	/**
+	 * Keyframe snapshot that is currently sampled.
+	 */
+	std::shared_ptr<const KeyframeContainer<T>> snapshot;
+
+	/**
+	 * Index of the last accessed keyframe in the snapshot.
+	 */
+	typename KeyframeContainer<T>::elem_ptr hint;
+
+	/**
+	 * Value returned while the reader is not bound to a curve.
+	 *
+	 * Bound readers store the first keyframe value of the curve,
+	 * so that value types don't need a default constructor.
+	 */
+	T fallback;
+};
+
+
+template <typename T>
+Reader<T>::Reader(const T &fallback) :
+	curve{nullptr},
+	version{0},
+	snapshot{nullptr},
+	hint{0},
+	fallback{fallback} {}
+
+
+template <typename T>
+Reader<T>::Reader(const BaseCurve<T> &curve) :
+	curve{&curve},
+	version{0},
+	snapshot{curve.published.load(this->version)},
+	hint{0},
+	fallback{this->snapshot->get(0).val()} {}
+
+
+template <typename T>
+bool Reader<T>::update() {
+	if (this->curve == nullptr) [[unlikely]] {
+		return false;
+	}
+
+	if (this->curve->published.get_version() == this->version) {
+		return false;
+	}
+
+	this->snapshot = this->curve->published.load(this->version);
+
+	// keyframes are usually only appended, so the old position
+	// stays a good hint for the new snapshot
+	if (this->hint >= this->snapshot->size()) {
+		this->hint = this->snapshot->size() - 1;
+	}
+
+	return true;
+}
+
+
+template <typename T>
+T Reader<T>::get(const time::time_t &time) {
+	if (this->curve == nullptr) [[unlikely]] {
+		return this->fallback;
+	}
+
+	return this->curve->sample(*this->snapshot, time, this->hint);
+}
+
+} // namespace openage::curve
@@ -0,0 +1,154 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+
+
+namespace openage::curve {
+
+/**
+ * Publication slot for immutable snapshots that are stored by one writer
+ * thread and loaded by any number of reader threads.
+ *
+ * The slot is a versioned double buffer: the writer fills the buffer
+ * that is not visible to readers and then makes it visible by
+ * incrementing the version. The lowest bit of the version selects the
+ * visible buffer.
+ *
+ * Readers announce themselves in a per-buffer counter and check that the
+ * version did not change before copying the snapshot pointer. Loading
+ * never blocks; a reader only retries if the writer published in between.
+ * The writer waits for readers that are still copying the pointer of the
+ * buffer it wants to refill, which only happens if it publishes twice
+ * while a reader copies a pointer.
+ *
+ * Only uses atomic integers, so no lock is taken by the standard library.
+ *
+ * @tparam T Type of the snapshots.
+ */
+template <typename T>
+class SnapshotSlot {
+public:
+	/**
+	 * Create a slot.
+	 *
+	 * @param initial Snapshot that is visible before the first \p store().
+	 */
+	explicit SnapshotSlot(std::shared_ptr<const T> initial) :
+		buffers{std::move(initial), nullptr},
+		version{0},
+		readers{0, 0} {}
+
+	/**
+	 * Move the visible snapshot of another slot.
+	 *
+	 * Must not be used while other threads access \p other.
+	 */
+	SnapshotSlot(SnapshotSlot &&other) :
+		SnapshotSlot{other.load()} {}
+
+	SnapshotSlot(const SnapshotSlot &) = delete;
+	SnapshotSlot &operator=(const SnapshotSlot &) = delete;
+	SnapshotSlot &operator=(SnapshotSlot &&) = delete;
+
+	~SnapshotSlot() = default;
+
+	/**
+	 * Make a new snapshot visible to readers.
+	 *
+	 * Must only be called by the writer thread.
+	 *
+	 * @param snapshot New snapshot.
+	 */
+	void store(std::shared_ptr<const T> snapshot) {
+		// only the writer changes the version
+		uint64_t current = this->version.load(std::memory_order_relaxed);
+		size_t next = (current + 1) & 1;
+
+		// readers that fetched an old version may still copy
+		// the pointer in the buffer that is refilled
+		while (this->readers[next].load(std::memory_order_seq_cst) != 0) {
+			std::this_thread::yield();
+		}
+
+		this->buffers[next] = std::move(snapshot);
+		this->version.store(current + 1, std::memory_order_seq_cst);
+	}
+
+	/**
+	 * Get the visible snapshot.
+	 *
+	 * Can be called from any thread.
+	 *
+	 * @return Last stored snapshot.
+	 */
+	std::shared_ptr<const T> load() const {
+		uint64_t loaded;
+		return this->load(loaded);
+	}
+
+	/**
+	 * Get the visible snapshot and its version.
+	 *
+	 * Can be called from any thread.
+	 *
+	 * @param loaded_version Set to the version of the returned snapshot.
+	 *
+	 * @return Last stored snapshot.
+	 */
+	std::shared_ptr<const T> load(uint64_t &loaded_version) const {
+		while (true) {
+			uint64_t current = this->version.load(std::memory_order_seq_cst);
+			size_t idx = current & 1;
+
+			// announce the reader before checking the version again, so that
+			// the writer either waits for the reader or the reader sees the
+			// version of a refilled buffer
+			this->readers[idx].fetch_add(1, std::memory_order_seq_cst);
+			if (this->version.load(std::memory_order_seq_cst) == current) [[likely]] {
+				auto snapshot = this->buffers[idx];
+				this->readers[idx].fetch_sub(1, std::memory_order_seq_cst);
+
+				loaded_version = current;
+				return snapshot;
+			}
+			this->readers[idx].fetch_sub(1, std::memory_order_seq_cst);
+		}
+	}
+
+	/**
+	 * Get the version of the visible snapshot.
+	 *
+	 * Can be used to check for a new snapshot without copying the pointer.
+	 *
+	 * @return Current version. Incremented on every \p store().
+	 */
+	uint64_t get_version() const {
+		return this->version.load(std::memory_order_acquire);
+	}
+
+private:
+	/**
+	 * Buffers for the visible and the next snapshot.
+	 */
+	std::array<std::shared_ptr<const T>, 2> buffers;
+
+	/**
+	 * Number of stored snapshots. The lowest bit is the index of
+	 * the visible buffer.
+	 */
+	std::atomic<uint64_t> version;
+
+	/**
+	 * Number of readers copying the pointer of each buffer.
+	 */
+	mutable std::array<std::atomic<uint32_t>, 2> readers;
+};
+
+} // namespace openage::curve
@@ -0,0 +1,214 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "coord/phys.h"
+#include "curve/keyframe_container.h"
+#include "log/log.h"
+#include "time/time.h"
+#include "util/timer.h"
+
+
+namespace openage::curve::tests {
+
+namespace {
+
+/**
+ * Create a container with one keyframe per time unit in [0, size).
+ */
+KeyframeContainer<int> make_container(size_t size) {
+	KeyframeContainer<int> c;
+	for (size_t i = 0; i < size; i++) {
+		c.insert_after(time::time_t::from_int(i), static_cast<int>(i));
+	}
+	return c;
+}
+
+/**
+ * Run a number of lookups on a container and log the average time per lookup.
+ *
+ * @param c Container to search.
+ * @param name Description of the lookup pattern.
+ * @param times Searched times.
+ * @param hints Hints for each searched time.
+ */
+void bench_lookups(const KeyframeContainer<int> &c,
+                   const char *name,
+                   const std::vector<time::time_t> &times,
+                   const std::vector<size_t> &hints) {
+	util::Timer timer;
+	size_t checksum = 0;
+
+	timer.start();
+	for (size_t i = 0; i < times.size(); i++) {
+		checksum += c.last(times[i], hints[i]);
+	}
+	timer.stop();
+
+	log::log(INFO << "keyframes: " << c.size()
+	              << ", " << name
+	              << ": " << static_cast<double>(timer.getval()) / times.size()
+	              << " ns/lookup (checksum " << checksum << ")");
+}
+
+/**
+ * Run lookups of interpolated values like \p Continuous::get() and log
+ * the average time per lookup.
+ *
+ * @param layout_name Description of the keyframe layout.
+ * @param size Number of keyframes.
+ * @param times Searched times.
+ */
+template <keyframe_layout L>
+void bench_interpolated(const char *layout_name,
+                        size_t size,
+                        const std::vector<time::time_t> &times) {
+	KeyframeContainer<coord::phys3, L> c{coord::phys3{0, 0, 0}};
+	for (size_t i = 0; i < size; i++) {
+		auto pos = coord::phys_t::from_int(i);
+		c.insert_after(time::time_t::from_int(i), coord::phys3{pos, pos * 2, 0});
+	}
+
+	util::Timer timer;
+	coord::phys_t checksum = 0;
+	size_t hint = c.size();
+
+	timer.start();
+	for (const auto &t : times) {
+		hint = c.last(t, hint);
+		auto elem = c.get(hint);
+		if (hint + 1 < c.size()) {
+			auto nxt = c.get(hint + 1);
+			double frac = (t - elem.time()).to_double() / (nxt.time() - elem.time()).to_double();
+			checksum += (elem.val() + (nxt.val() - elem.val()) * frac).ne;
+		}
+		else {
+			checksum += elem.val().ne;
+		}
+	}
+	timer.stop();
+
+	log::log(INFO << "phys3 keyframes: " << size
+	              << ", " << layout_name
+	              << ": " << static_cast<double>(timer.getval()) / times.size()
+	              << " ns/lookup (checksum " << checksum << ")");
+}
+
+
+/**
+ * Run lookups of discrete values like \p Discrete::get() and log
+ * the average time per lookup.
+ *
+ * @param layout_name Description of the keyframe layout.
+ * @param size Number of keyframes.
+ * @param times Searched times.
+ */
+template <keyframe_layout L>
+void bench_discrete(const char *layout_name,
+                    size_t size,
+                    const std::vector<time::time_t> &times) {
+	KeyframeContainer<std::string, L> c;
+	for (size_t i = 0; i < size; i++) {
+		c.insert_after(time::time_t::from_int(i), "animation/" + std::to_string(i) + ".sprite");
+	}
+
+	util::Timer timer;
+	size_t checksum = 0;
+	size_t hint = c.size();
+
+	timer.start();
+	for (const auto &t : times) {
+		hint = c.last(t, hint);
+		checksum += c.get(hint).val().size();
+	}
+	timer.stop();
+
+	log::log(INFO << "string keyframes: " << size
+	              << ", " << layout_name
+	              << ": " << static_cast<double>(timer.getval()) / times.size()
+	              << " ns/lookup (checksum " << checksum << ")");
+}
+
+} // namespace
+
+
+/**
+ * Benchmark the keyframe lookup for containers of 10^3 to 10^6 keyframes.
+ *
+ * Compares lookups without a hint, with a random (cold) hint
+ * and with the hint of the previous lookup (warm, like a curve
+ * that is sampled at increasing times).
+ */
+void benchmark_keyframe_lookup() {
+	constexpr size_t lookups = 100000;
+
+	std::mt19937_64 rng{42};
+
+	for (size_t size = 1000; size <= 1000000; size *= 10) {
+		auto c = make_container(size);
+		std::uniform_int_distribution<size_t> dist{0, size - 1};
+
+		std::vector<time::time_t> random_times;
+		std::vector<size_t> random_hints;
+		std::vector<size_t> no_hints;
+		random_times.reserve(lookups);
+		random_hints.reserve(lookups);
+		no_hints.reserve(lookups);
+		for (size_t i = 0; i < lookups; i++) {
+			random_times.push_back(time::time_t::from_int(dist(rng)));
+			random_hints.push_back(dist(rng));
+			no_hints.push_back(c.size());
+		}
+
+		std::vector<time::time_t> sequential_times;
+		std::vector<size_t> sequential_hints;
+		sequential_times.reserve(lookups);
+		sequential_hints.reserve(lookups);
+		for (size_t i = 0; i < lookups; i++) {
+			// sample a few times between each pair of keyframes
+			auto t = time::time_t::from_int(i % size) + time::time_t::from_double(0.25 * (i % 4));
+			sequential_times.push_back(t);
+			sequential_hints.push_back(i == 0 ? 0 : c.last(sequential_times[i - 1]));
+		}
+
+		bench_lookups(c, "no hint", random_times, no_hints);
+		bench_lookups(c, "random hint", random_times, random_hints);
+		bench_lookups(c, "previous hint", sequential_times, sequential_hints);
+	}
+}
+
+
+/**
+ * Benchmark the interleaved and split keyframe layouts for the value types
+ * of \p Continuous<coord::phys3> and \p Discrete<std::string> curves.
+ *
+ * Uses lookups at random times, so that the hints are bad and
+ * the keyframes don't stay in the cache.
+ */
+void benchmark_keyframe_layout() {
+	constexpr size_t lookups = 100000;
+
+	std::mt19937_64 rng{42};
+
+	for (size_t size = 1000; size <= 1000000; size *= 10) {
+		std::uniform_real_distribution<double> dist{0, static_cast<double>(size)};
+
+		std::vector<time::time_t> times;
+		times.reserve(lookups);
+		for (size_t i = 0; i < lookups; i++) {
+			times.push_back(time::time_t::from_double(dist(rng)));
+		}
+
+		bench_interpolated<keyframe_layout::interleaved>("interleaved", size, times);
+		bench_interpolated<keyframe_layout::split>("split", size, times);
+		bench_discrete<keyframe_layout::interleaved>("interleaved", size, times);
+		bench_discrete<keyframe_layout::split>("split", size, times);
+	}
+}
+
+
+} // namespace openage::curve::tests
@@ -1,4 +1,4 @@
-// Copyright 2017-2024 the openage authors. See copying.md for legal info.
+// Copyright 2017-2026 the openage authors. See copying.md for legal info.
 
 #include <algorithm>
 #include <deque>
@@ -243,10 +243,60 @@ void test_queue() {
 }
 
 
+void test_compact() {
+	auto loop = std::make_shared<event::EventLoop>();
+
+	// queue: [0:1, 2:2, 4:3, 10:4]
+	Queue<int> q{loop, 0};
+	q.insert(0, 1);
+	q.insert(2, 2);
+	q.insert(4, 3);
+	q.insert(10, 4);
+
+	// kill 1 at t=3 and 2 at t=5
+	TESTEQUALS(q.pop_front(3), 1);
+	TESTEQUALS(q.pop_front(5), 2);
+
+	// only the element killed at t=3 is dead at the horizon
+	q.compact(4);
+	TESTEQUALS(q.front(4), 2);
+	TESTEQUALS(q.front(5), 3);
+	TESTEQUALS(q.pop_front(11), 3);
+	TESTEQUALS(q.pop_front(11), 4);
+	TESTEQUALS(q.empty(11), true);
+
+	// everything is dead after t=11
+	q.compact(11);
+	TESTEQUALS(q.empty(0), true);
+	TESTEQUALS(q.empty(11), true);
+
+	q.insert(12, 5);
+	TESTEQUALS(q.front(12), 5);
+
+	// map: 0 alive in [0, 10), 1 alive in [5, inf)
+	UnorderedMap<int, int> map;
+	map.insert(0, 10, 0, 0);
+	map.insert(5, 1, 1);
+
+	map.compact(5);
+	TESTEQUALS(map.at(5, 0).has_value(), true);
+	TESTEQUALS(map.at(5, 1).has_value(), true);
+
+	int visited = 0;
+	map.compact(10, [&visited](int &) {
+		visited += 1;
+	});
+	TESTEQUALS(visited, 1);
+	TESTEQUALS(map.at(5, 0).has_value(), false);
+	TESTEQUALS(map.at(10, 1).has_value(), true);
+}
+
+
 void container() {
 	test_map();
 	test_list();
 	test_queue();
+	test_compact();
 }
 
 
@@ -1,15 +1,24 @@
-// Copyright 2017-2024 the openage authors. See copying.md for legal info.
+// Copyright 2017-2026 the openage authors. See copying.md for legal info.
 
+#include <algorithm>
+#include <cstdint>
 #include <iterator>
 #include <list>
+#include <functional>
 #include <memory>
+#include <random>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "curve/continuous.h"
 #include "curve/discrete.h"
 #include "curve/discrete_mod.h"
 #include "curve/keyframe.h"
 #include "curve/keyframe_container.h"
+#include "curve/keyframe_storage.h"
+#include "curve/reader.h"
 #include "curve/segmented.h"
 #include "event/event_loop.h"
 #include "testing/testing.h"
@@ -18,6 +27,180 @@
 
 namespace openage::curve::tests {
 
+namespace {
+
+static_assert(keyframe_layout_for<int>::value == keyframe_layout::split);
+static_assert(keyframe_layout_for<time::time_t>::value == keyframe_layout::split);
+static_assert(keyframe_layout_for<bool>::value == keyframe_layout::interleaved);
+static_assert(keyframe_layout_for<std::string>::value == keyframe_layout::interleaved);
+
+
+/**
+ * Check the time scan against a linear search, including the edges of
+ * the vector blocks and the extreme needles.
+ */
+void check_scan_times() {
+	std::vector<int64_t> times;
+	for (int64_t i = 0; i < 37; ++i) {
+		times.push_back(i / 3 * 10);
+	}
+	times.front() = INT64_MIN;
+	times.back() = INT64_MAX;
+
+	std::vector<int64_t> needles{INT64_MIN, INT64_MAX, -1, 0, 1};
+	for (int64_t t = 5; t < 130; t += 5) {
+		needles.push_back(t);
+	}
+
+	for (size_t first = 0; first < 4; ++first) {
+		for (size_t count = 0; first + count <= times.size(); ++count) {
+			const int64_t *begin = times.data() + first;
+			for (int64_t needle : needles) {
+				size_t incl = std::find_if(begin, begin + count, [needle](int64_t t) { return t > needle; }) - begin;
+				size_t excl = std::find_if(begin, begin + count, [needle](int64_t t) { return t >= needle; }) - begin;
+				TESTEQUALS(detail::scan_times(begin, count, needle, true), incl);
+				TESTEQUALS(detail::scan_times(begin, count, needle, false), excl);
+			}
+		}
+	}
+}
+
+
+/**
+ * Check lookups with far away hints on a bigger container against linear scans.
+ */
+template <keyframe_layout L>
+void check_far_hints() {
+	KeyframeContainer<int, L> c;
+
+	// [-inf:0, 0:0, 0:1, 1:2, 2:3, 2:4, 3:5, ...]
+	// every even time has two keyframes
+	int value = 0;
+	for (int t = 0; t < 300; t++) {
+		c.insert_after(t, value++);
+		if (t % 2 == 0) {
+			c.insert_after(t, value++);
+		}
+	}
+	TESTEQUALS(c.size(), 451);
+
+	for (size_t hint = 0; hint <= c.size(); hint += 7) {
+		for (int t = -1; t <= 301; t++) {
+			// reference results by linear scan
+			size_t expected_last = 0;
+			size_t expected_before = 0;
+			for (size_t i = 0; i < c.size(); i++) {
+				if (c.get(i).time() <= t) {
+					expected_last = i;
+				}
+				if (c.get(i).time() < t) {
+					expected_before = i;
+				}
+			}
+
+			TESTEQUALS(c.last(t, hint), expected_last);
+			TESTEQUALS(c.last_before(t, hint), expected_before);
+		}
+	}
+}
+
+/**
+ * Check chunked keyframe storage operations and copies against a plain vector.
+ */
+template <keyframe_layout L>
+void check_chunked_storage() {
+	using storage_t = ChunkedKeyframeStorage<int, L>;
+	constexpr size_t chunk_size = storage_t::chunk_size;
+
+	storage_t storage;
+	std::vector<Keyframe<int>> expected;
+
+	auto check = [](const storage_t &checked, const std::vector<Keyframe<int>> &reference) {
+		TESTEQUALS(checked.size(), reference.size());
+		for (size_t i = 0; i < reference.size(); i++) {
+			TESTEQUALS(checked.get(i).time(), reference[i].time());
+			TESTEQUALS(checked.get(i).val(), reference[i].val());
+		}
+	};
+
+	// copies must keep their keyframes while the original is changed
+	std::vector<std::pair<storage_t, std::vector<Keyframe<int>>>> copies;
+
+	std::mt19937 rng{3};
+	int value = 0;
+	for (int round = 0; round < 2000; round++) {
+		size_t idx = expected.empty() ? 0 : rng() % (expected.size() + 1);
+
+		// keep the times sorted by using the neighbour times
+		auto time_at = [&](size_t i) {
+			if (expected.empty()) {
+				return time::time_t::from_int(0);
+			}
+			if (i >= expected.size()) {
+				return expected.back().time() + 1;
+			}
+			return expected[i].time();
+		};
+
+		switch (rng() % 6) {
+		case 0:
+		case 1:
+		case 2: {
+			Keyframe<int> keyframe{time_at(expected.size()), value++};
+			storage.push_back(keyframe);
+			expected.push_back(keyframe);
+		} break;
+		case 3: {
+			Keyframe<int> keyframe{time_at(idx), value++};
+			storage.insert(idx, keyframe);
+			expected.insert(expected.begin() + idx, keyframe);
+		} break;
+		case 4:
+			if (idx < expected.size()) {
+				size_t last = std::min(expected.size(), idx + rng() % (2 * chunk_size));
+				storage.erase(idx, last);
+				expected.erase(expected.begin() + idx, expected.begin() + last);
+			}
+			break;
+		case 5:
+			if (copies.size() < 20) {
+				copies.emplace_back(storage, expected);
+			}
+			break;
+		}
+	}
+	check(storage, expected);
+	for (const auto &[copy, reference] : copies) {
+		check(copy, reference);
+	}
+
+	// appending lines up chunks with the source
+	storage_t appended;
+	appended.append(storage, 0);
+	check(appended, expected);
+
+	// partition points against linear scans
+	for (int t = -1; t <= expected.back().time().to_int() + 1; t++) {
+		size_t first = rng() % expected.size();
+		size_t last = first + rng() % (expected.size() - first + 1);
+
+		size_t expected_incl = first;
+		size_t expected_excl = first;
+		while (expected_incl < last and expected[expected_incl].time() <= t) {
+			expected_incl++;
+		}
+		while (expected_excl < last and expected[expected_excl].time() < t) {
+			expected_excl++;
+		}
+
+		TESTEQUALS(storage.template partition_point<true>(first, last, t), expected_incl);
+		TESTEQUALS(storage.template partition_point<false>(first, last, t), expected_excl);
+	}
+}
+
+} // namespace
+
+
 void curve_types() {
 	// Check the base container type
 	{
@@ -184,6 +367,63 @@ void curve_types() {
 		TESTEQUALS(c.size(), 1);
 	}
 
+	// Check the scan of the keyframe times
+	check_scan_times();
+
+	// Check lookups with far away hints on a bigger container
+	check_far_hints<keyframe_layout::interleaved>();
+	check_far_hints<keyframe_layout::split>();
+
+	// Check the chunked storage with copy-on-write chunks
+	check_chunked_storage<keyframe_layout::interleaved>();
+	check_chunked_storage<keyframe_layout::split>();
+
+	// Check compaction of the keyframe history
+	{
+		auto f = std::make_shared<event::EventLoop>();
+		Continuous<int> c(f, 0);
+		c.set_insert(0, 0);
+		c.set_insert(10, 10);
+		c.set_insert(20, 0);
+		c.set_insert(30, 30);
+
+		// keep the keyframe at t=10 for interpolation between 10 and 20
+		c.compact(15);
+		TESTEQUALS(c.get_container().size(), 4);
+		TESTEQUALS(c.get(15), 5);
+		TESTEQUALS(c.get(20), 0);
+		TESTEQUALS(c.get(25), 15);
+		TESTEQUALS(c.get(40), 30);
+		TESTNOEXCEPT(c.check_integrity());
+
+		// compacting at a keyframe keeps only that keyframe before the horizon
+		c.compact(30);
+		TESTEQUALS(c.get_container().size(), 2);
+		TESTEQUALS(c.get(30), 30);
+		TESTEQUALS(c.get(40), 30);
+
+		// the curve can still be modified afterwards
+		c.set_last(40, 40);
+		TESTEQUALS(c.get(35), 35);
+		TESTEQUALS(c.get(40), 40);
+
+		Discrete<int> d(f, 0);
+		d.set_insert(1, 1);
+		d.set_insert(2, 2);
+		d.set_insert(2, 3);
+		d.set_insert(3, 4);
+
+		// keep the last keyframe of the same-time group at t=2
+		d.compact(2);
+		TESTEQUALS(d.get_container().size(), 3);
+		TESTEQUALS(d.get(2), 3);
+		TESTEQUALS(d.get(3), 4);
+
+		// compaction before the first keyframe does nothing
+		d.compact(-10);
+		TESTEQUALS(d.get_container().size(), 3);
+	}
+
 	// Check the Simple Continuous type
 	{
 		auto f = std::make_shared<event::EventLoop>();
@@ -386,6 +626,257 @@ void curve_types() {
 		TESTEQUALS(c.get(1), 0);
 		TESTEQUALS(c.get(5), 0);
 	}
+
+	// check batched sampling
+	{
+		auto f = std::make_shared<event::EventLoop>();
+		Continuous<float> c(f, 0);
+		Segmented<float> d(f, 1);
+		c.set_insert(0, 0);
+		c.set_insert(10, 10);
+		c.set_insert(20, 0);
+		d.set_insert(0, 5);
+		d.set_insert_jump(10, 15, 0);
+
+		std::vector<time::time_t> times{-1, 0, 2.5, 10, 15, 20, 25};
+		std::vector<float> values(times.size());
+		c.get_many(times, values);
+		for (size_t i = 0; i < times.size(); i++) {
+			TESTEQUALS_FLOAT(values[i], c.get(times[i]), 1e-7);
+		}
+
+		std::vector<const Interpolated<float> *> curves{&c, &d, &c};
+		std::vector<float> at_five(curves.size());
+		Interpolated<float>::get_all(curves, 5, at_five);
+		TESTEQUALS_FLOAT(at_five[0], 5, 1e-7);
+		TESTEQUALS_FLOAT(at_five[1], 10, 1e-7);
+		TESTEQUALS_FLOAT(at_five[2], 5, 1e-7);
+
+		std::vector<float> too_small(1);
+		TESTTHROWS(c.get_many(times, too_small));
+
+		// more curves than fit into one sample block
+		std::vector<std::unique_ptr<Continuous<float>>> many;
+		std::vector<const Interpolated<float> *> many_curves;
+		for (int i = 0; i < 150; i++) {
+			auto &curve = many.emplace_back(std::make_unique<Continuous<float>>(f, 2 + i));
+			curve->set_insert(0, i);
+			curve->set_insert(i % 7, 2 * i);
+			curve->set_insert(10, -i);
+			curve->publish();
+			many_curves.push_back(curve.get());
+		}
+
+		for (auto t : times) {
+			std::vector<float> many_values(many_curves.size());
+			Interpolated<float>::get_all(many_curves, t, many_values);
+			for (size_t i = 0; i < many_curves.size(); i++) {
+				TESTEQUALS_FLOAT(many_values[i], many_curves[i]->get(t), 1e-5);
+			}
+		}
+
+		// readers, including an unbound one
+		c.publish();
+		d.publish();
+		std::vector<Reader<float>> readers;
+		readers.push_back(c.reader());
+		readers.emplace_back(-3.0f);
+		readers.push_back(d.reader());
+		for (auto &curve : many) {
+			readers.push_back(curve->reader());
+		}
+		std::vector<Reader<float> *> reader_ptrs;
+		for (auto &reader : readers) {
+			reader_ptrs.push_back(&reader);
+		}
+
+		for (auto t : times) {
+			std::vector<float> read_values(reader_ptrs.size());
+			Interpolated<float>::get_all(reader_ptrs, t, read_values);
+			TESTEQUALS_FLOAT(read_values[0], c.get(t), 1e-7);
+			TESTEQUALS_FLOAT(read_values[1], -3, 1e-7);
+			TESTEQUALS_FLOAT(read_values[2], d.get(t), 1e-7);
+			for (size_t i = 0; i < many.size(); i++) {
+				TESTEQUALS_FLOAT(read_values[i + 3], many[i]->get(t), 1e-5);
+			}
+		}
+
+		std::vector<float> no_values;
+		TESTTHROWS(Interpolated<float>::get_all(reader_ptrs, 0, no_values));
+	}
+
+	// check readers of published snapshots
+	{
+		auto f = std::make_shared<event::EventLoop>();
+		Continuous<int> c(f, 0);
+		Discrete<std::string> d(f, 1);
+
+		auto rc = c.reader();
+		auto rd = d.reader();
+		TESTEQUALS(rc.get(5), 0);
+		TESTEQUALS(rd.get(5), "");
+
+		c.set_insert(0, 0);
+		c.set_insert(10, 10);
+		d.set_insert(2, "a");
+
+		// nothing is visible before publishing
+		TESTEQUALS(rc.update(), false);
+		TESTEQUALS(rc.get(5), 0);
+
+		c.publish();
+		d.publish();
+		TESTEQUALS(rc.update(), true);
+		TESTEQUALS(rd.update(), true);
+		TESTEQUALS(rc.update(), false);
+		TESTEQUALS(rc.get(5), 5);
+		TESTEQUALS(rd.get(1), "");
+		TESTEQUALS(rd.get(5), "a");
+
+		// the snapshot stays valid while the curve changes
+		c.set_last(0, 100);
+		TESTEQUALS(rc.get(5), 5);
+		TESTEQUALS(rc.get_container().size(), 3);
+		TESTEQUALS(c.get(5), 100);
+
+		// sample concurrently to the writer
+		Reader<int> unbound{7};
+		TESTEQUALS(unbound.is_bound(), false);
+		TESTEQUALS(unbound.update(), false);
+		TESTEQUALS(unbound.get(5), 7);
+
+		Continuous<int> w(f, 2);
+		auto rw = w.reader();
+		std::thread writer{[&w]() {
+			for (int i = 1; i <= 1000; i++) {
+				w.set_last(i, i);
+				w.publish();
+			}
+		}};
+
+		auto read_all = [](Reader<int> &reader) {
+			bool monotonic = true;
+			int last = 0;
+			while (last < 1000) {
+				reader.update();
+				auto val = reader.get(1000);
+				monotonic &= (val >= last);
+				last = val;
+			}
+			return monotonic;
+		};
+
+		// readers on several threads
+		std::vector<Reader<int>> thread_readers;
+		for (int i = 0; i < 3; i++) {
+			thread_readers.push_back(w.reader());
+		}
+		std::vector<char> thread_monotonic(thread_readers.size(), false);
+		std::vector<std::thread> reader_threads;
+		for (size_t i = 0; i < thread_readers.size(); i++) {
+			reader_threads.emplace_back([&, i]() {
+				thread_monotonic[i] = read_all(thread_readers[i]);
+			});
+		}
+
+		bool monotonic = read_all(rw);
+		writer.join();
+		for (auto &thread : reader_threads) {
+			thread.join();
+		}
+
+		TESTEQUALS(monotonic, true);
+		TESTEQUALS(rw.get(500), 500);
+		for (auto thread_mono : thread_monotonic) {
+			TESTEQUALS(static_cast<bool>(thread_mono), true);
+		}
+		TESTEQUALS(rw.update(), false);
+	}
+
+	// check incremental syncs against full syncs
+	{
+		KeyframeContainer<int> source;
+		KeyframeContainer<int> incremental;
+		KeyframeContainer<int>::sync_state state;
+
+		std::mt19937 rng{7};
+		int start = 0;
+		for (int round = 0; round < 500; round++) {
+			// modify the source, mostly close to the sync start
+			for (int i = 0; i < 3; i++) {
+				auto t = time::time_t::from_int(start + static_cast<int>(rng() % 20) - 5);
+				switch (rng() % 5) {
+				case 0:
+				case 1:
+					source.insert_after(t, round);
+					break;
+				case 2:
+					source.insert_overwrite(t, round);
+					break;
+				case 3:
+					source.erase(t);
+					break;
+				default:
+					source.erase_after(source.last(t));
+					break;
+				}
+			}
+			if (rng() % 50 == 0) {
+				source.compact(time::time_t::from_int(start - 5));
+			}
+
+			// modifications of the synced container invalidate the sync state
+			if (rng() % 20 == 0) {
+				incremental.insert_after(time::time_t::from_int(start + 1), -1);
+			}
+
+			start += rng() % 3;
+
+			KeyframeContainer<int> full{incremental};
+			full.sync(source, time::time_t::from_int(start));
+			incremental.sync(source, time::time_t::from_int(start), &state);
+
+			bool equal = (full.size() == incremental.size());
+			for (size_t i = 0; equal and i < full.size(); i++) {
+				equal = (full.get(i).time() == incremental.get(i).time()
+				         and full.get(i).val() == incremental.get(i).val());
+			}
+			TESTEQUALS(equal, true);
+		}
+	}
+
+	// check that incremental syncs only convert new keyframes
+	{
+		auto f = std::make_shared<event::EventLoop>();
+		Discrete<int> source(f, 0);
+		Discrete<std::string> target(f, 1);
+
+		size_t conversions = 0;
+		std::function<std::string(const int &)> convert = [&conversions](const int &val) {
+			conversions += 1;
+			return std::to_string(val);
+		};
+
+		for (int i = 1; i <= 10; i++) {
+			source.set_insert(i, i);
+		}
+		target.sync(source, convert, 0);
+		TESTEQUALS(target.get(7), "7");
+
+		source.set_insert(11, 11);
+		conversions = 0;
+		target.sync(source, convert, 5);
+
+		// the new keyframe and the value at the start time
+		TESTEQUALS(conversions, 2);
+		TESTEQUALS(target.get(7), "7");
+		TESTEQUALS(target.get(11), "11");
+
+		// syncs without changes do not copy anything
+		auto seq = target.get_container().modification_seq();
+		target.sync(source, convert, 6);
+		TESTEQUALS(target.get_container().modification_seq(), seq);
+	}
 }
 
 } // namespace openage::curve::tests
@@ -1,4 +1,4 @@
-// Copyright 2013-2020 the openage authors. See copying.md for legal info.
+// Copyright 2013-2026 the openage authors. See copying.md for legal info.
 
 #include "cvar.h"
 
@@ -24,6 +24,11 @@ bool CVarManager::create(const std::string &name,
 }
 
 
+bool CVarManager::remove(const std::string &name) {
+	return this->store.erase(name) > 0;
+}
+
+
 std::string CVarManager::get(const std::string &name) const {
 	auto it = this->store.find(name);
 	if (it != this->store.end()) {
@@ -1,4 +1,4 @@
-// Copyright 2016-2024 the openage authors. See copying.md for legal info.
+// Copyright 2016-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -51,6 +51,13 @@ public:
 	bool create(const std::string &name,
 	            const std::pair<get_func, set_func> &accessors);
 
+	/**
+	 * Removes a configuration entry.
+	 * Must be called before the objects used by its accessors are destroyed.
+	 * @returns if the entry existed.
+	 */
+	bool remove(const std::string &name);
+
 	/**
 	 * Gets the value of a config entry.
 	 * Internally calls the stored get function.
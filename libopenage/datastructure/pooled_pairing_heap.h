@@ -0,0 +1,446 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+/** @file
+ * This file contains a pairing heap whose nodes are stored in a pool
+ * owned by the heap.
+ *
+ * It implements the same operations as `PairingHeap`, but the nodes are
+ * linked intrusively by 32-bit indices into the pool instead of
+ * shared pointers. Inserting does not allocate (once the pool is large
+ * enough) and no reference counts have to be updated when the heap
+ * is restructured.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "../error/error.h"
+
+
+namespace openage::datastructure {
+
+
+/**
+ * Pairing heap with pool-allocated nodes.
+ *
+ * Elements are identified by handles that stay valid until the element
+ * is removed from the heap. Handles of removed elements are reused
+ * for new elements.
+ *
+ * References returned by `top()` and `get()` are invalidated when
+ * an element is pushed, because the pool may grow.
+ */
+template <typename T,
+          typename compare = std::less<T>>
+class PooledPairingHeap final {
+public:
+	using this_type = PooledPairingHeap<T, compare>;
+	using cmp_t = compare;
+
+	/**
+	 * Handle of an element in the heap.
+	 */
+	using handle_t = uint32_t;
+
+	/**
+	 * Handle that never refers to an element.
+	 */
+	static constexpr handle_t invalid_handle = std::numeric_limits<handle_t>::max();
+
+	/**
+	 * create a empty heap.
+	 */
+	PooledPairingHeap() :
+		node_count{0},
+		root_node{invalid_handle},
+		free_node{invalid_handle} {
+	}
+
+	~PooledPairingHeap() = default;
+
+	/**
+	 * adds the given item to the heap.
+	 * O(1)
+	 */
+	handle_t push(const T &item) {
+		handle_t node = this->acquire(item);
+		this->push_node(node);
+		return node;
+	}
+
+	/**
+	 * moves the given item to the heap.
+	 * O(1)
+	 */
+	handle_t push(T &&item) {
+		handle_t node = this->acquire(std::move(item));
+		this->push_node(node);
+		return node;
+	}
+
+	/**
+	 * returns and removes the smallest item on the heap.
+	 */
+	T pop() {
+		if (this->root_node == invalid_handle) {
+			throw Error{MSG(err) << "Can't pop an empty heap!"};
+		}
+
+		handle_t node = this->remove_root();
+		T ret = std::move(*this->nodes[node].data);
+		this->release(node);
+
+		return ret;
+	}
+
+	/**
+	 * Remove an element from the heap.
+	 *
+	 * If the item is the current root, just pop().
+	 * else, cut the node from its parent, merge its children
+	 * and link them to the root.
+	 *
+	 * O(pop)
+	 */
+	void unlink_node(handle_t node) {
+		if (node == this->root_node) {
+			this->remove_root();
+		}
+		else {
+			this->cut(node);
+			this->root_insert(this->merge_children(node));
+			this->node_count -= 1;
+		}
+
+		this->release(node);
+	}
+
+	/**
+	 * Returns the smallest item on the heap.
+	 * O(1)
+	 */
+	const T &top() const {
+		return *this->nodes[this->root_node].data;
+	}
+
+	/**
+	 * Returns the handle of the smallest item on the heap.
+	 * O(1)
+	 */
+	handle_t top_node() const {
+		return this->root_node;
+	}
+
+	/**
+	 * Get the item of an element in the heap.
+	 */
+	const T &get(handle_t node) const {
+		return *this->nodes[node].data;
+	}
+
+	/**
+	 * Get the item of an element in the heap.
+	 *
+	 * If the ordering of the item is changed, `decrease` or `update`
+	 * must be called afterwards.
+	 */
+	T &get(handle_t node) {
+		return *this->nodes[node].data;
+	}
+
+	/**
+	 * You must call this after the node data decreased.
+	 * This cuts the subtree and links the subtree again.
+	 * If the node value _increased_ and you call this,
+	 * the heap is corrupted.
+	 * Also known as the decrease_key operation.
+	 *
+	 * O(1)
+	 */
+	void decrease(handle_t node) {
+		if (node != this->root_node) [[likely]] {
+			// cut out the node and its subtree
+			this->cut(node);
+			this->root_node = this->link(node, this->root_node);
+		}
+		// decreasing the root node won't change it, so we do nothing.
+	}
+
+	/**
+	 * After a change, call this to reorganize the given node.
+	 * Support increase and decrease of values.
+	 *
+	 * Use `decrease` instead when you know the value decreased.
+	 *
+	 * O(pop)
+	 */
+	void update(handle_t node) {
+		if (node != this->root_node) [[likely]] {
+			this->cut(node);
+			this->root_insert(this->merge_children(node));
+		}
+		else {
+			this->root_node = this->merge_children(node);
+		}
+
+		this->root_insert(node);
+	}
+
+	/**
+	 * Preallocate nodes for the given number of elements.
+	 */
+	void reserve(size_t size) {
+		this->nodes.reserve(size);
+	}
+
+	/**
+	 * erase all elements on the heap.
+	 * The allocated nodes are kept for reuse.
+	 */
+	void clear() {
+		this->nodes.clear();
+		this->node_count = 0;
+		this->root_node = invalid_handle;
+		this->free_node = invalid_handle;
+	}
+
+	/**
+	 * @returns the number of nodes stored on the heap.
+	 */
+	size_t size() const {
+		return this->node_count;
+	}
+
+	/**
+	 * @returns whether there are no nodes stored on the heap.
+	 */
+	bool empty() const {
+		return this->node_count == 0;
+	}
+
+private:
+	/**
+	 * Heap node in the pool.
+	 */
+	struct node_t {
+		/**
+		 * Stored item. Empty if the node is unused.
+		 */
+		std::optional<T> data;
+
+		/**
+		 * Most recently attached child.
+		 */
+		handle_t first_child;
+
+		/**
+		 * Previous sibling, or the parent for the first child.
+		 */
+		handle_t prev;
+
+		/**
+		 * Next sibling, or the next unused node in the free list.
+		 */
+		handle_t next;
+	};
+
+	/**
+	 * Get a node from the free list or the end of the pool
+	 * and store the item in it.
+	 */
+	template <typename U>
+	handle_t acquire(U &&item) {
+		handle_t node;
+		if (this->free_node != invalid_handle) {
+			node = this->free_node;
+			this->free_node = this->nodes[node].next;
+		}
+		else {
+			ENSURE(this->nodes.size() < invalid_handle, "heap node pool is full");
+			node = static_cast<handle_t>(this->nodes.size());
+			this->nodes.emplace_back();
+		}
+
+		node_t &n = this->nodes[node];
+		n.data.emplace(std::forward<U>(item));
+		n.first_child = invalid_handle;
+		n.prev = invalid_handle;
+		n.next = invalid_handle;
+
+		return node;
+	}
+
+	/**
+	 * Destroy the item of a node and put the node on the free list.
+	 */
+	void release(handle_t node) {
+		node_t &n = this->nodes[node];
+		n.data.reset();
+		n.next = this->free_node;
+		this->free_node = node;
+	}
+
+	/**
+	 * This method decides which node becomes the new root node
+	 * by comparing `a` with `b`. Both must be roots of a tree.
+	 * The new root is returned, it has the other node as child.
+	 */
+	handle_t link(handle_t a, handle_t b) {
+		handle_t new_root = b;
+		handle_t new_child = a;
+		if (this->cmp(*this->nodes[a].data, *this->nodes[b].data)) {
+			new_root = a;
+			new_child = b;
+		}
+
+		node_t &root = this->nodes[new_root];
+		node_t &child = this->nodes[new_child];
+
+		// first child is the most recently attached one
+		child.prev = new_root;
+		child.next = root.first_child;
+		if (root.first_child != invalid_handle) {
+			this->nodes[root.first_child].prev = new_child;
+		}
+		root.first_child = new_child;
+
+		return new_root;
+	}
+
+	/**
+	 * Cut a node from its parent and siblings,
+	 * but keep its children. The node must not be the root.
+	 */
+	void cut(handle_t node) {
+		node_t &n = this->nodes[node];
+		node_t &prev = this->nodes[n.prev];
+
+		if (prev.first_child == node) {
+			// prev is our parent, make the next sibling the first child
+			prev.first_child = n.next;
+		}
+		else {
+			prev.next = n.next;
+		}
+
+		if (n.next != invalid_handle) {
+			this->nodes[n.next].prev = n.prev;
+		}
+
+		n.prev = invalid_handle;
+		n.next = invalid_handle;
+	}
+
+	/**
+	 * Remove the children of a node and link them to a single tree
+	 * with two-pass pairing.
+	 *
+	 * @return Root of the new tree, or `invalid_handle` if the node has no children.
+	 */
+	handle_t merge_children(handle_t node) {
+		handle_t current_sibling = this->nodes[node].first_child;
+		this->nodes[node].first_child = invalid_handle;
+
+		if (current_sibling == invalid_handle) {
+			return invalid_handle;
+		}
+
+		// 1. link children pairwise from left to right, last node may be alone
+		this->pairs.clear();
+		while (current_sibling != invalid_handle) {
+			handle_t link0 = current_sibling;
+			handle_t link1 = this->nodes[link0].next;
+
+			this->nodes[link0].prev = invalid_handle;
+			this->nodes[link0].next = invalid_handle;
+
+			if (link1 != invalid_handle) {
+				current_sibling = this->nodes[link1].next;
+
+				this->nodes[link1].prev = invalid_handle;
+				this->nodes[link1].next = invalid_handle;
+
+				this->pairs.push_back(this->link(link0, link1));
+			}
+			else {
+				this->pairs.push_back(link0);
+				current_sibling = invalid_handle;
+			}
+		}
+
+		// 2. then link the pairs to the last one, from right to left
+		handle_t root = this->pairs.back();
+		for (size_t i = this->pairs.size() - 1; i-- > 0;) {
+			root = this->link(this->pairs[i], root);
+		}
+
+		return root;
+	}
+
+	/**
+	 * Remove the root node from the heap.
+	 * The node is not released.
+	 *
+	 * @return Handle of the removed node.
+	 */
+	handle_t remove_root() {
+		handle_t node = this->root_node;
+		this->root_node = this->merge_children(node);
+		this->node_count -= 1;
+
+		return node;
+	}
+
+	/**
+	 * adds the given node to the heap.
+	 * O(1)
+	 */
+	void push_node(handle_t node) {
+		this->root_insert(node);
+		this->node_count += 1;
+	}
+
+	/**
+	 * insert a tree into the heap.
+	 */
+	void root_insert(handle_t node) {
+		if (node == invalid_handle) [[unlikely]] {
+			return;
+		}
+
+		if (this->root_node == invalid_handle) [[unlikely]] {
+			this->root_node = node;
+		}
+		else {
+			this->root_node = this->link(this->root_node, node);
+		}
+	}
+
+	compare cmp;
+	size_t node_count;
+	handle_t root_node;
+
+	/**
+	 * Head of the list of unused nodes in the pool.
+	 */
+	handle_t free_node;
+
+	/**
+	 * Node pool.
+	 */
+	std::vector<node_t> nodes;
+
+	/**
+	 * Scratch buffer for the pair roots in `merge_children`.
+	 */
+	std::vector<handle_t> pairs;
+};
+
+} // namespace openage::datastructure
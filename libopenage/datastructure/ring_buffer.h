@@ -0,0 +1,172 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+
+namespace openage::datastructure {
+
+/**
+ * Bounded lock-free ring buffer for one producer thread.
+ *
+ * Only one thread may push, but any number of threads may pop. This allows
+ * the producer to make room by discarding the oldest element while a
+ * consumer is reading from the buffer.
+ *
+ * Every slot has a sequence number that tells whether it holds an element
+ * for the current lap around the buffer, so a slot is only overwritten
+ * after its element has been moved out completely.
+ *
+ * @tparam T Element type. Must be default-constructible and move-assignable.
+ */
+template <typename T>
+class RingBuffer {
+public:
+	/**
+	 * Create a new ring buffer.
+	 *
+	 * @param capacity Minimum number of elements. Rounded up to a power of two.
+	 */
+	explicit RingBuffer(size_t capacity) :
+		slots{std::make_unique<slot[]>(std::bit_ceil(std::max<size_t>(capacity, 2)))},
+		mask{std::bit_ceil(std::max<size_t>(capacity, 2)) - 1},
+		head{0},
+		tail{0} {
+		for (size_t i = 0; i <= this->mask; ++i) {
+			this->slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	~RingBuffer() = default;
+
+	RingBuffer(const RingBuffer &) = delete;
+	RingBuffer &operator=(const RingBuffer &) = delete;
+
+	/**
+	 * Add an element at the end of the buffer.
+	 *
+	 * Must only be called by the producer thread.
+	 *
+	 * @param value Element. Only moved from if it was added.
+	 *
+	 * @return true if the element was added, false if the buffer is full.
+	 */
+	bool try_push(T &&value) {
+		size_t pos = this->head.load(std::memory_order_relaxed);
+		slot &target = this->slots[pos & this->mask];
+
+		if (target.sequence.load(std::memory_order_acquire) != pos) {
+			// the slot still holds an element of the previous lap
+			return false;
+		}
+
+		target.value = std::move(value);
+		target.sequence.store(pos + 1, std::memory_order_release);
+		this->head.store(pos + 1, std::memory_order_relaxed);
+
+		return true;
+	}
+
+	/**
+	 * Remove the element at the front of the buffer.
+	 *
+	 * Can be called by any thread.
+	 *
+	 * @param value Output for the element.
+	 *
+	 * @return true if an element was removed, false if the buffer is empty.
+	 */
+	bool try_pop(T &value) {
+		size_t pos = this->tail.load(std::memory_order_relaxed);
+		while (true) {
+			slot &source = this->slots[pos & this->mask];
+			size_t sequence = source.sequence.load(std::memory_order_acquire);
+			auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+
+			if (diff == 0) {
+				// the slot holds the front element, claim it
+				if (this->tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					value = std::move(source.value);
+					source.sequence.store(pos + this->mask + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0) {
+				return false;
+			}
+			else {
+				// another consumer claimed the element
+				pos = this->tail.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/**
+	 * Check if the buffer is empty.
+	 *
+	 * The result may be outdated when other threads use the buffer.
+	 *
+	 * @return true if there are no elements, else false.
+	 */
+	bool empty() const {
+		return this->tail.load(std::memory_order_relaxed)
+		       == this->head.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * Get the maximum number of elements in the buffer.
+	 *
+	 * @return Capacity of the buffer.
+	 */
+	size_t capacity() const {
+		return this->mask + 1;
+	}
+
+private:
+	/**
+	 * Storage for one element.
+	 */
+	struct slot {
+		/**
+		 * Position of the element in the buffer + 1 if the slot holds an element,
+		 * else the position of the next element that can be stored in the slot.
+		 */
+		std::atomic<size_t> sequence;
+
+		/**
+		 * Stored element.
+		 */
+		T value;
+	};
+
+	/**
+	 * Slots of the buffer.
+	 */
+	std::unique_ptr<slot[]> slots;
+
+	/**
+	 * Capacity - 1, for wrapping positions.
+	 */
+	const size_t mask;
+
+	/**
+	 * Position of the next pushed element. Only written by the producer.
+	 *
+	 * Producer and consumers write to different cache lines.
+	 */
+	alignas(64) std::atomic<size_t> head;
+
+	/**
+	 * Position of the next popped element.
+	 */
+	alignas(64) std::atomic<size_t> tail;
+};
+
+} // namespace openage::datastructure
@@ -1,17 +1,27 @@
-// Copyright 2014-2023 the openage authors. See copying.md for legal info.
+// Copyright 2014-2026 the openage authors. See copying.md for legal info.
 
 #include "tests.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
+#include <random>
+#include <thread>
 #include <utility>
+#include <vector>
 
+#include "log/log.h"
 #include "testing/testing.h"
+#include "util/timer.h"
 
 #include "datastructure/concurrent_queue.h"
 #include "datastructure/constexpr_map.h"
 #include "datastructure/pairing_heap.h"
+#include "datastructure/pooled_pairing_heap.h"
+#include "datastructure/ring_buffer.h"
+#include "datastructure/work_stealing_deque.h"
 
 
 namespace openage::datastructure::tests {
@@ -152,6 +162,238 @@ void pairing_heap() {
 }
 
 
+void pooled_pairing_heap_0() {
+	PooledPairingHeap<int> heap{};
+
+	TESTEQUALS(heap.size(), 0);
+
+	heap.push(0);
+	heap.push(1);
+	heap.push(2);
+	heap.push(3);
+	heap.push(4);
+
+	// state: 01234
+	TESTEQUALS(heap.size(), 5);
+	TESTEQUALS(heap.top(), 0);
+
+	TESTEQUALS(heap.pop(), 0);
+	TESTEQUALS(heap.pop(), 1);
+	TESTEQUALS(heap.pop(), 2);
+	TESTEQUALS(heap.pop(), 3);
+
+	TESTEQUALS(heap.size(), 1);
+
+	// nodes of the popped elements are reused
+	heap.push(0);
+	heap.push(10);
+
+	// state: 0 4 10
+	TESTEQUALS(heap.pop(), 0);
+	TESTEQUALS(heap.pop(), 4);
+	TESTEQUALS(heap.pop(), 10);
+	TESTEQUALS(heap.size(), 0);
+	TESTEQUALS(heap.empty(), true);
+}
+
+
+void pooled_pairing_heap_1() {
+	PooledPairingHeap<heap_elem> heap{};
+	heap.push(heap_elem{1});
+	auto node_u1 = heap.push(heap_elem{2});
+	auto node_u2 = heap.push(heap_elem{3});
+	auto node_u3 = heap.push(heap_elem{4});
+
+	// 1 2 3 4
+	heap.get(node_u1).data = 0;
+	heap.decrease(node_u1);
+	TESTEQUALS(heap.top().data, 0);
+	TESTEQUALS(heap.top_node(), node_u1);
+
+	// 0 1 3 4 -> 0 1 4 5
+	heap.get(node_u2).data = 5;
+	heap.update(node_u2);
+
+	// 0 1 4 5 -> 0 1 5
+	heap.unlink_node(node_u3);
+	TESTEQUALS(heap.size(), 3);
+
+	TESTEQUALS(heap.pop().data, 0);
+	TESTEQUALS(heap.pop().data, 1);
+	TESTEQUALS(heap.pop().data, 5);
+}
+
+
+void pooled_pairing_heap_2() {
+	// compare against a sorted vector with random operations
+	std::mt19937 rng{1337};
+	std::uniform_int_distribution<int> value{0, 1000};
+
+	PooledPairingHeap<heap_elem> heap{};
+	std::vector<PooledPairingHeap<heap_elem>::handle_t> handles;
+
+	for (int round = 0; round < 2000; round++) {
+		std::uniform_int_distribution<size_t> pick{0, handles.size()};
+		size_t idx = pick(rng);
+
+		switch (rng() % 5) {
+		case 0:
+		case 1:
+			handles.push_back(heap.push(heap_elem{value(rng)}));
+			break;
+		case 2:
+			if (idx < handles.size()) {
+				auto &elem = heap.get(handles[idx]);
+				elem.data -= std::min(elem.data, value(rng));
+				heap.decrease(handles[idx]);
+			}
+			break;
+		case 3:
+			if (idx < handles.size()) {
+				heap.get(handles[idx]).data = value(rng);
+				heap.update(handles[idx]);
+			}
+			break;
+		case 4:
+			if (idx < handles.size()) {
+				heap.unlink_node(handles[idx]);
+				handles.erase(std::begin(handles) + idx);
+			}
+			break;
+		}
+
+		TESTEQUALS(heap.size(), handles.size());
+	}
+
+	std::vector<int> expected;
+	for (auto handle : handles) {
+		expected.push_back(heap.get(handle).data);
+	}
+	std::sort(std::begin(expected), std::end(expected));
+
+	for (int data : expected) {
+		TESTEQUALS(heap.pop().data, data);
+	}
+	TESTEQUALS(heap.empty(), true);
+
+	heap.push(heap_elem{1});
+	heap.clear();
+	TESTEQUALS(heap.size(), 0);
+}
+
+
+// exported test
+void pooled_pairing_heap() {
+	pooled_pairing_heap_0();
+	pooled_pairing_heap_1();
+	pooled_pairing_heap_2();
+}
+
+
+namespace {
+
+/**
+ * Run pushes, decrease-key operations and pops on a heap
+ * and log the average time per operation.
+ *
+ * @param name Name of the heap implementation.
+ * @param values Pushed values.
+ * @param decreases Indices of the elements that are decreased.
+ * @param push Push a value and return the element handle.
+ * @param decrease Decrease the value of an element handle by 1.
+ */
+template <typename heap_t, typename handle_t, typename push_t, typename decrease_t>
+void bench_heap(const char *name,
+                const std::vector<int> &values,
+                const std::vector<size_t> &decreases,
+                push_t push,
+                decrease_t decrease) {
+	heap_t heap;
+	std::vector<handle_t> handles;
+	handles.reserve(values.size());
+	util::Timer timer;
+	int64_t checksum = 0;
+
+	timer.start();
+	for (int value : values) {
+		handles.push_back(push(heap, value));
+	}
+	timer.stop();
+	auto push_time = timer.getval();
+
+	timer.reset(false);
+	for (size_t idx : decreases) {
+		decrease(heap, handles[idx]);
+	}
+	timer.stop();
+	auto decrease_time = timer.getval();
+
+	timer.reset(false);
+	while (not heap.empty()) {
+		checksum += heap.pop().data;
+	}
+	timer.stop();
+	auto pop_time = timer.getval();
+
+	log::log(INFO << name << " with " << values.size() << " elements: "
+	              << static_cast<double>(push_time) / values.size() << " ns/push, "
+	              << static_cast<double>(decrease_time) / decreases.size() << " ns/decrease, "
+	              << static_cast<double>(pop_time) / values.size() << " ns/pop"
+	              << " (checksum " << checksum << ")");
+}
+
+} // namespace
+
+
+/**
+ * Benchmark push, decrease-key and pop throughput of the shared_ptr based
+ * and the pooled pairing heap for 10^3 to 10^5 elements.
+ */
+void benchmark_pairing_heap() {
+	std::mt19937_64 rng{42};
+
+	for (size_t size = 1000; size <= 100000; size *= 10) {
+		std::uniform_int_distribution<int> value{0, 1 << 30};
+		std::uniform_int_distribution<size_t> pick{0, size - 1};
+
+		std::vector<int> values;
+		std::vector<size_t> decreases;
+		values.reserve(size);
+		decreases.reserve(size);
+		for (size_t i = 0; i < size; i++) {
+			values.push_back(value(rng));
+			decreases.push_back(pick(rng));
+		}
+
+		using shared_heap_t = PairingHeap<heap_elem>;
+		bench_heap<shared_heap_t, shared_heap_t::element_t>(
+			"shared_ptr heap",
+			values,
+			decreases,
+			[](shared_heap_t &heap, int value) {
+				return heap.push(heap_elem{value});
+			},
+			[](shared_heap_t &heap, const shared_heap_t::element_t &node) {
+				node->data.data -= 1;
+				heap.decrease(node);
+			});
+
+		using pooled_heap_t = PooledPairingHeap<heap_elem>;
+		bench_heap<pooled_heap_t, pooled_heap_t::handle_t>(
+			"pooled heap",
+			values,
+			decreases,
+			[](pooled_heap_t &heap, int value) {
+				return heap.push(heap_elem{value});
+			},
+			[](pooled_heap_t &heap, pooled_heap_t::handle_t node) {
+				heap.get(node).data -= 1;
+				heap.decrease(node);
+			});
+	}
+}
+
+
 // exported test
 void constexpr_map() {
 	static_assert(create_const_map<int, int>().size() == 0, "wrong size");
@@ -352,4 +594,136 @@ void concurrent_queue() {
 	concurrent_queue_copy_move_elements_compilation();
 }
 
+void ring_buffer_single_thread() {
+	RingBuffer<int> buffer{3};
+	TESTEQUALS(buffer.capacity(), 4u);
+	buffer.empty() or TESTFAIL;
+
+	int value = 0;
+	(not buffer.try_pop(value)) or TESTFAIL;
+
+	// fill and empty the buffer a few times to wrap around
+	for (int lap = 0; lap < 3; ++lap) {
+		for (int i = 0; i < 4; ++i) {
+			buffer.try_push(lap * 10 + i) or TESTFAIL;
+		}
+		(not buffer.try_push(42)) or TESTFAIL;
+		(not buffer.empty()) or TESTFAIL;
+
+		for (int i = 0; i < 4; ++i) {
+			buffer.try_pop(value) or TESTFAIL;
+			TESTEQUALS(value, lap * 10 + i);
+		}
+		(not buffer.try_pop(value)) or TESTFAIL;
+		buffer.empty() or TESTFAIL;
+	}
+}
+
+void ring_buffer_concurrent() {
+	constexpr int count = 100000;
+	RingBuffer<int> buffer{64};
+
+	// the producer drops the oldest element when the buffer is full,
+	// so both threads pop from the buffer
+	std::vector<int> consumed;
+	std::thread consumer{[&]() {
+		int value;
+		while (true) {
+			if (buffer.try_pop(value)) {
+				if (value < 0) {
+					break;
+				}
+				consumed.push_back(value);
+			}
+		}
+	}};
+
+	int discarded;
+	for (int i = 0; i < count; ++i) {
+		int value = i;
+		while (not buffer.try_push(std::move(value))) {
+			buffer.try_pop(discarded);
+		}
+	}
+	int end = -1;
+	while (not buffer.try_push(std::move(end))) {
+		std::this_thread::yield();
+	}
+
+	consumer.join();
+
+	// elements are popped in order and never twice
+	for (size_t i = 1; i < consumed.size(); ++i) {
+		(consumed[i - 1] < consumed[i]) or TESTFAIL;
+	}
+	(consumed.size() <= count) or TESTFAIL;
+}
+
+// exported test
+void ring_buffer() {
+	ring_buffer_single_thread();
+	ring_buffer_concurrent();
+}
+
+void work_stealing_deque() {
+	constexpr int count = 100000;
+	constexpr int thief_count = 3;
+
+	// the owner pops the newest element, thieves steal the oldest
+	{
+		WorkStealingDeque<int> deque{2};
+		int values[4] = {0, 1, 2, 3};
+		for (int &value : values) {
+			deque.push(&value);
+		}
+		TESTEQUALS(deque.steal(), &values[0]);
+		TESTEQUALS(deque.pop(), &values[3]);
+		TESTEQUALS(deque.pop(), &values[2]);
+		TESTEQUALS(deque.steal(), &values[1]);
+		TESTEQUALS(deque.pop(), nullptr);
+		TESTEQUALS(deque.steal(), nullptr);
+		deque.empty() or TESTFAIL;
+	}
+
+	// every element is taken exactly once while the deque grows
+	std::vector<int> values(count);
+	std::vector<std::atomic<int>> taken(count);
+	WorkStealingDeque<int> deque{16};
+	std::atomic<bool> done{false};
+
+	auto take = [&](int *value) {
+		if (value != nullptr) {
+			taken[value - values.data()]++;
+		}
+	};
+
+	std::vector<std::thread> thieves;
+	for (int i = 0; i < thief_count; i++) {
+		thieves.emplace_back([&]() {
+			while (not done.load() or not deque.empty()) {
+				take(deque.steal());
+			}
+		});
+	}
+
+	for (int i = 0; i < count; i++) {
+		deque.push(&values[i]);
+		if (i % 3 == 0) {
+			take(deque.pop());
+		}
+	}
+	while (not deque.empty()) {
+		take(deque.pop());
+	}
+	done.store(true);
+
+	for (auto &thief : thieves) {
+		thief.join();
+	}
+
+	for (auto &counter : taken) {
+		TESTEQUALS(counter.load(), 1);
+	}
+}
+
 } // namespace openage::datastructure::tests
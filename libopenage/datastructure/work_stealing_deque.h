@@ -0,0 +1,219 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+namespace openage::datastructure {
+
+/**
+ * Lock-free Chase-Lev work-stealing deque of pointers.
+ *
+ * The owner thread pushes and pops elements at the bottom, other threads
+ * steal elements from the top. The owner therefore works on the newest
+ * elements, which are likely still in its cache, and thieves take the
+ * oldest ones.
+ *
+ * The buffer grows when it is full. Old buffers are kept until the deque
+ * is destroyed, because thieves may still read from them.
+ *
+ * See "Correct and Efficient Work-Stealing for Weak Memory Models"
+ * (Lê et al., 2013) for the memory orderings.
+ *
+ * @tparam T Element type. The deque stores T *.
+ */
+template <typename T>
+class WorkStealingDeque {
+public:
+	/**
+	 * Create a new deque.
+	 *
+	 * @param capacity Initial capacity. Rounded up to a power of two.
+	 */
+	explicit WorkStealingDeque(size_t capacity = 256) :
+		top{0},
+		bottom{0},
+		buffer{nullptr},
+		buffers{} {
+		size_t size = 2;
+		while (size < capacity) {
+			size *= 2;
+		}
+
+		this->buffers.push_back(std::make_unique<ring>(size));
+		this->buffer.store(this->buffers.back().get(), std::memory_order_relaxed);
+	}
+
+	~WorkStealingDeque() = default;
+
+	WorkStealingDeque(const WorkStealingDeque &) = delete;
+	WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+	/**
+	 * Add an element at the bottom.
+	 *
+	 * Must only be called by the owner thread.
+	 *
+	 * @param value Element.
+	 */
+	void push(T *value) {
+		int64_t b = this->bottom.load(std::memory_order_relaxed);
+		int64_t t = this->top.load(std::memory_order_acquire);
+		ring *buf = this->buffer.load(std::memory_order_relaxed);
+
+		if (b - t > static_cast<int64_t>(buf->mask)) [[unlikely]] {
+			buf = this->grow(buf, t, b);
+		}
+
+		buf->put(b, value);
+
+		// the paper uses a release fence and a relaxed store here,
+		// a release store is as cheap and understood by ThreadSanitizer
+		this->bottom.store(b + 1, std::memory_order_release);
+	}
+
+	/**
+	 * Remove the element at the bottom.
+	 *
+	 * Must only be called by the owner thread.
+	 *
+	 * @return The newest element, or nullptr if the deque is empty.
+	 */
+	T *pop() {
+		int64_t b = this->bottom.load(std::memory_order_relaxed) - 1;
+		ring *buf = this->buffer.load(std::memory_order_relaxed);
+		this->bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t t = this->top.load(std::memory_order_relaxed);
+
+		if (t > b) {
+			// empty
+			this->bottom.store(b + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		T *value = buf->get(b);
+		if (t == b) {
+			// last element, race against thieves for it
+			if (not this->top.compare_exchange_strong(t, t + 1,
+			                                          std::memory_order_seq_cst,
+			                                          std::memory_order_relaxed)) {
+				value = nullptr;
+			}
+			this->bottom.store(b + 1, std::memory_order_relaxed);
+		}
+
+		return value;
+	}
+
+	/**
+	 * Remove the element at the top.
+	 *
+	 * Can be called by any thread.
+	 *
+	 * @return The oldest element, or nullptr if the deque is empty or
+	 *         another thread took the element first.
+	 */
+	T *steal() {
+		int64_t t = this->top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t b = this->bottom.load(std::memory_order_acquire);
+
+		if (t >= b) {
+			return nullptr;
+		}
+
+		ring *buf = this->buffer.load(std::memory_order_acquire);
+		T *value = buf->get(t);
+		if (not this->top.compare_exchange_strong(t, t + 1,
+		                                          std::memory_order_seq_cst,
+		                                          std::memory_order_relaxed)) {
+			return nullptr;
+		}
+
+		return value;
+	}
+
+	/**
+	 * Check if the deque is empty.
+	 *
+	 * The result may be outdated when other threads use the deque.
+	 *
+	 * @return true if there are no elements, else false.
+	 */
+	bool empty() const {
+		int64_t t = this->top.load(std::memory_order_relaxed);
+		int64_t b = this->bottom.load(std::memory_order_relaxed);
+		return t >= b;
+	}
+
+private:
+	/**
+	 * Circular buffer of elements.
+	 */
+	struct ring {
+		explicit ring(size_t size) :
+			mask{size - 1},
+			slots{std::make_unique<std::atomic<T *>[]>(size)} {}
+
+		T *get(int64_t index) const {
+			return this->slots[index & this->mask].load(std::memory_order_relaxed);
+		}
+
+		void put(int64_t index, T *value) {
+			this->slots[index & this->mask].store(value, std::memory_order_relaxed);
+		}
+
+		/**
+		 * Size - 1, for wrapping indices.
+		 */
+		const size_t mask;
+
+		/**
+		 * Elements. Atomic because thieves read them while the owner writes.
+		 */
+		std::unique_ptr<std::atomic<T *>[]> slots;
+	};
+
+	/**
+	 * Replace the buffer by one of twice the size.
+	 */
+	ring *grow(ring *old, int64_t t, int64_t b) {
+		auto bigger = std::make_unique<ring>((old->mask + 1) * 2);
+		for (int64_t i = t; i < b; ++i) {
+			bigger->put(i, old->get(i));
+		}
+
+		ring *result = bigger.get();
+		this->buffers.push_back(std::move(bigger));
+		this->buffer.store(result, std::memory_order_release);
+		return result;
+	}
+
+	/**
+	 * Index of the oldest element. Thieves and the owner write to it.
+	 */
+	alignas(64) std::atomic<int64_t> top;
+
+	/**
+	 * Index after the newest element. Only written by the owner.
+	 */
+	alignas(64) std::atomic<int64_t> bottom;
+
+	/**
+	 * Current buffer.
+	 */
+	std::atomic<ring *> buffer;
+
+	/**
+	 * All buffers that were used, including the current one.
+	 */
+	std::vector<std::unique_ptr<ring>> buffers;
+};
+
+} // namespace openage::datastructure
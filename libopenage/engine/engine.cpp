@@ -1,4 +1,4 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2026 the openage authors. See copying.md for legal info.
 
 #include "engine.h"
 
@@ -25,9 +25,7 @@ Engine::Engine(mode mode,
 	         << "launching engine with root directory"
 	         << root_dir);
 
-	// read and apply the configuration files
 	this->cvar_manager = std::make_shared<cvar::CVarManager>(this->root_dir["cfg"]);
-	cvar_manager->load_all();
 
 	// time loop
 	this->time_loop = std::make_shared<time::TimeLoop>();
@@ -39,6 +37,10 @@ Engine::Engine(mode mode,
 	                                                               this->time_loop);
 	this->simulation->set_modpacks(mods);
 
+	// read and apply the configuration files
+	// after the subsystems have registered their cvars
+	this->cvar_manager->load_all();
+
 	// presenter (optional)
 	if (this->run_mode == mode::FULL) {
 		this->presenter = std::make_shared<presenter::Presenter>(this->root_dir,
@@ -1,4 +1,4 @@
-// Copyright 2015-2023 the openage authors. See copying.md for legal info.
+// Copyright 2015-2026 the openage authors. See copying.md for legal info.
 
 /*
  * This file holds handlers for std::terminate and SIGSEGV.
@@ -22,6 +22,7 @@
 #include <unistd.h>
 #endif
 
+#include "log/async_logger.h"
 #include "util/init.h"
 #include "util/language.h"
 #include "util/signal.h"
@@ -71,6 +72,9 @@ util::OnDeInit restore_handlers([]() {
 	// terminate() is accidentially triggered from here.
 	std::set_terminate(old_terminate_handler);
 
+	// print the buffered log messages that lead to the crash first
+	log::AsyncLogger::instance().flush();
+
 	std::cout << "\n\x1b[31;1mFATAL: terminate has been called\x1b[m" << std::endl;
 
 	if (std::exception_ptr e_ptr = std::current_exception()) {
@@ -132,6 +136,8 @@ void exit_handler() {
 		return;
 	}
 
+	log::AsyncLogger::instance().flush();
+
 	std::cout << "\x1b[31;1mexit() was called in an illegal place\x1b[m\n"
 			  << std::endl;
 }
@@ -1,4 +1,4 @@
-// Copyright 2017-2023 the openage authors. See copying.md for legal info.
+// Copyright 2017-2026 the openage authors. See copying.md for legal info.
 
 #include "event.h"
 
@@ -9,6 +9,7 @@
 #include "log/log.h"
 #include "log/message.h"
 
+#include "event/event_pool.h"
 #include "event/evententity.h"
 #include "event/eventhandler.h"
 #include "time/time.h"
@@ -29,22 +30,29 @@ Event::Event(const std::shared_ptr<EventEntity> &entity,
                            std::hash<std::string>()(eventhandler->id()))} {}
 
 
+std::shared_ptr<Event> Event::create(const std::shared_ptr<EventEntity> &trgt,
+                                     const std::shared_ptr<EventHandler> &eventhandler,
+                                     const EventHandler::param_map &params) {
+	return std::allocate_shared<Event>(PoolAllocator<Event>{}, trgt, eventhandler, params);
+}
+
 void Event::depend_on(const std::shared_ptr<EventEntity> &dependency) {
 	// TODO: do REPEAT and TRIGGER listen to changes (i.e. have dependents)?
 	// if not, exclude them here and return early.
 
-	log::log(DBG << "Registering dependency event from EventHandler "
-	             << this->get_eventhandler()->id()
-	             << " to EventEntity " << dependency->idstr());
+	LOG_DBG("Registering dependency event from EventHandler "
+	        << this->get_eventhandler()->id()
+	        << " to EventEntity " << dependency->idstr());
 
 	dependency->add_dependent(this->shared_from_this());
+	this->dependencies.emplace_back(dependency);
 }
 
 
 void Event::cancel(const time::time_t reference_time) {
-	log::log(DBG << "Canceling event from EventHandler "
-	             << this->get_eventhandler()->id()
-	             << " for time t=" << this->get_time());
+	LOG_DBG("Canceling event from EventHandler "
+	        << this->get_eventhandler()->id()
+	        << " for time t=" << this->get_time());
 
 	// remove the target which releases the event in the next loop iteration
 	this->entity.reset();
@@ -1,9 +1,10 @@
-// Copyright 2017-2024 the openage authors. See copying.md for legal info.
+// Copyright 2017-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
 #include <cstddef>
 #include <memory>
+#include <vector>
 
 #include "event/eventhandler.h"
 #include "time/time.h"
@@ -24,6 +25,14 @@ public:
 	      const std::shared_ptr<EventHandler> &eventhandler,
 	      const EventHandler::param_map &params);
 
+	/**
+	 * Create a new event. The memory of freed events is reused for new ones,
+	 * see PoolAllocator.
+	 */
+	static std::shared_ptr<Event> create(const std::shared_ptr<EventEntity> &trgt,
+	                                     const std::shared_ptr<EventHandler> &eventhandler,
+	                                     const EventHandler::param_map &params);
+
 	const std::weak_ptr<EventEntity> &get_entity() const {
 		return this->entity;
 	}
@@ -62,6 +71,13 @@ public:
 	 */
 	void depend_on(const std::shared_ptr<EventEntity> &dependency);
 
+	/**
+	 * Get the event entities this event depends on.
+	 */
+	const std::vector<std::weak_ptr<EventEntity>> &get_dependencies() const {
+		return this->dependencies;
+	}
+
 	/**
 	 * Cancel the event.
 	 */
@@ -100,6 +116,9 @@ private:
 	/** The actor that this event refers to. */
 	std::weak_ptr<EventEntity> entity;
 
+	/** Event entities this event depends on. */
+	std::vector<std::weak_ptr<EventEntity>> dependencies;
+
 	/** Type of this event. */
 	std::shared_ptr<EventHandler> eventhandler;
 
@@ -1,9 +1,11 @@
-// Copyright 2017-2023 the openage authors. See copying.md for legal info.
+// Copyright 2017-2026 the openage authors. See copying.md for legal info.
 
 #include "event_loop.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -16,11 +18,50 @@
 #include "event/eventhandler.h"
 #include "event/eventqueue.h"
 #include "event/eventstore.h"
+#include "job/job_manager.h"
 #include "util/fixed_point.h"
 
+#include "config.h"
+
 
 namespace openage::event {
 
+namespace {
+
+/**
+ * Events that are executed together on one thread during parallel execution.
+ */
+struct Partition {
+	/** Indices of the events in the batch, in queue order. */
+	std::vector<size_t> events;
+
+	/** Calls into the loop made by the event handlers, applied afterwards. */
+	std::vector<std::function<void()>> deferred;
+};
+
+#if HAVE_THREAD_LOCAL_STORAGE
+/** Loop whose events the current thread executes in parallel. */
+thread_local const EventLoop *parallel_loop = nullptr;
+
+/** Partition that the current thread executes. */
+thread_local Partition *parallel_partition = nullptr;
+#endif
+
+/**
+ * Returns the partition that the current thread executes for the given loop,
+ * or nullptr if the thread doesn't execute events in parallel.
+ */
+Partition *current_partition([[maybe_unused]] const EventLoop *loop) {
+#if HAVE_THREAD_LOCAL_STORAGE
+	if (parallel_loop == loop) {
+		return parallel_partition;
+	}
+#endif
+	return nullptr;
+}
+
+} // namespace
+
 
 void EventLoop::add_event_handler(const std::shared_ptr<EventHandler> eventhandler) {
 	std::unique_lock lock{this->mutex};
@@ -34,7 +75,12 @@ std::shared_ptr<Event> EventLoop::create_event(const std::string name,
                                                const std::shared_ptr<State> state,
                                                const time::time_t reference_time,
                                                const EventHandler::param_map params) {
-	std::unique_lock lock{this->mutex};
+	// the thread in reach_time() holds the mutex and waits for parallel handlers
+	Partition *partition = current_partition(this);
+	std::unique_lock lock{this->mutex, std::defer_lock};
+	if (partition == nullptr) {
+		lock.lock();
+	}
 
 	auto it = classstore.find(name);
 	if (it == classstore.end()) {
@@ -42,7 +88,17 @@ std::shared_ptr<Event> EventLoop::create_event(const std::string name,
 		                     << name << ", which does not exist."};
 	}
 
-	return this->queue.create_event(target, it->second, state, reference_time, params);
+	if (partition != nullptr) {
+		auto event = Event::create(target, it->second, params);
+		partition->deferred.emplace_back([this, event, state, reference_time]() {
+			this->queue.add_event(event, state, reference_time);
+		});
+		return event;
+	}
+
+	auto event = this->queue.create_event(target, it->second, state, reference_time, params);
+	this->notify();
+	return event;
 }
 
 
@@ -51,6 +107,19 @@ std::shared_ptr<Event> EventLoop::create_event(const std::shared_ptr<EventHandle
                                                const std::shared_ptr<State> state,
                                                const time::time_t reference_time,
                                                const EventHandler::param_map params) {
+	if (Partition *partition = current_partition(this)) {
+		// the class store is only changed when the events are added
+		auto it = this->classstore.find(eventhandler->id());
+		auto event = Event::create(target,
+		                           it == this->classstore.end() ? eventhandler : it->second,
+		                           params);
+		partition->deferred.emplace_back([this, event, state, reference_time]() {
+			this->classstore.emplace(event->get_eventhandler()->id(), event->get_eventhandler());
+			this->queue.add_event(event, state, reference_time);
+		});
+		return event;
+	}
+
 	std::unique_lock lock{this->mutex};
 
 	auto it = this->classstore.find(eventhandler->id());
@@ -64,7 +133,9 @@ std::shared_ptr<Event> EventLoop::create_event(const std::shared_ptr<EventHandle
 		}
 	}
 
-	return this->queue.create_event(target, it->second, state, reference_time, params);
+	auto event = this->queue.create_event(target, it->second, state, reference_time, params);
+	this->notify();
+	return event;
 }
 
 
@@ -72,6 +143,21 @@ void EventLoop::reach_time(const time::time_t &time_until,
                            const std::shared_ptr<State> &state) {
 	std::unique_lock lock{this->mutex};
 
+	// events created by the handlers don't need to wake up anyone
+	this->reaching_time = true;
+	try {
+		this->settle(time_until, state);
+	}
+	catch (...) {
+		this->reaching_time = false;
+		throw;
+	}
+	this->reaching_time = false;
+}
+
+
+void EventLoop::settle(const time::time_t &time_until,
+                       const std::shared_ptr<State> &state) {
 	// TODO detect infinite loops (is this a halting problem?)
 	// this happens when the events don't settle:
 	// at least one processed event adds another event so
@@ -89,12 +175,12 @@ void EventLoop::reach_time(const time::time_t &time_until,
 			break;
 		}
 
-		log::log(SPAM << "Loop: Attempt " << attempts << " to reach t=" << time_until);
+		LOG_SPAM("Loop: Attempt " << attempts << " to reach t=" << time_until);
 		this->update_changes(state);
 		cnt = this->execute_events(time_until, state);
 
-		log::log(SPAM << "Loop: to reach t=" << time_until
-		              << ", n=" << cnt << " events were executed");
+		LOG_SPAM("Loop: to reach t=" << time_until
+		         << ", n=" << cnt << " events were executed");
 
 		attempts += 1;
 	}
@@ -103,20 +189,21 @@ void EventLoop::reach_time(const time::time_t &time_until,
 	// Swap in the end of the execution, else we might skip changes that happen
 	// in the main loop for one frame - which is bad btw.
 	this->queue.swap_changesets();
-	log::log(SPAM << "Loop: t=" << time_until << " was reached! ========");
+	LOG_SPAM("Loop: t=" << time_until << " was reached! ========");
 }
 
 
 int EventLoop::execute_events(const time::time_t &time_until,
                               const std::shared_ptr<State> &state) {
-	log::log(SPAM << "Loop: Pending events in the queue (# = "
-	              << this->queue.get_event_queue().size() << "):");
+	LOG_SPAM("Loop: Pending events in the queue (# = "
+	         << this->queue.get_event_queue().size() << "):");
 
-	{
+	// sorting a copy of the queue is too expensive for every call
+	if (LOG_ENABLED(spam)) [[unlikely]] {
 		size_t i = 0;
 		for (const auto &e : this->queue.get_event_queue().get_sorted_events()) {
-			log::log(SPAM << "  event "
-			              << i << ": t=" << e->get_time() << ": " << e->get_eventhandler()->id());
+			LOG_SPAM("  event "
+			         << i << ": t=" << e->get_time() << ": " << e->get_eventhandler()->id());
 			i++;
 		}
 	}
@@ -130,63 +217,308 @@ int EventLoop::execute_events(const time::time_t &time_until,
 			break;
 		}
 
-		auto target = event->get_entity().lock();
+		if (this->job_manager != nullptr and event->get_eventhandler()->is_parallel_safe()) {
+			// take the parallel events that are executed together with this one
+			std::vector<std::shared_ptr<Event>> batch{event};
+			time::time_t window_end = std::min(time_until, event->get_time() + this->parallel_window);
 
-		if (target) {
-			log::log(DBG << "Loop: invoking event \"" << event->get_eventhandler()->id()
-			             << "\" on target \"" << target->idstr()
-			             << "\" for time t=" << event->get_time());
+			std::shared_ptr<Event> next;
+			while ((next = this->queue.take_event(window_end)) != nullptr) {
+				if (not next->get_eventhandler()->is_parallel_safe()) {
+					break;
+				}
+				batch.push_back(std::move(next));
+			}
 
-			this->active_event = event;
+			cnt += this->execute_parallel(batch, state);
 
-			// apply the event effects
-			event->get_eventhandler()->invoke(
-				*this, target, state, event->get_time(), event->get_params());
+			// the first sequential event ends the batch
+			if (next == nullptr) {
+				continue;
+			}
+			event = std::move(next);
+		}
 
-			this->active_event = nullptr;
-			cnt += 1;
+		cnt += this->execute_event(event, state);
+	}
+	return cnt;
+}
 
-			// if the event is REPEAT, readd the event.
-			if (event->get_eventhandler()->type == EventHandler::trigger_type::REPEAT) {
-				time::time_t new_time = event->get_eventhandler()->predict_invoke_time(
-					target, state, event->get_time());
 
-				if (new_time != time::TIME_MIN) {
-					event->set_time(new_time);
+int EventLoop::execute_event(const std::shared_ptr<Event> &event,
+                             const std::shared_ptr<State> &state) {
+	auto target = event->get_entity().lock();
+
+	if (not target) {
+		// The element was already removed from the queue, so we can safely
+		// kill it by ignoring it.
+		LOG_DBG("Loop: event \"" << event->get_eventhandler()->id()
+		        << "\" ignored because its target does not exist anymore "
+		        << "\" for time t=" << event->get_time());
+		return 0;
+	}
+
+	LOG_DBG("Loop: invoking event \"" << event->get_eventhandler()->id()
+	        << "\" on target \"" << target->idstr()
+	        << "\" for time t=" << event->get_time());
 
-					log::log(DBG << "Loop: repeating event \"" << event->get_eventhandler()->id()
-					             << "\" on target \"" << target->idstr()
-					             << "\" will be reenqueued for time t=" << event->get_time());
+	this->active_event = event;
 
-					this->queue.reenqueue(event);
+	// apply the event effects
+	event->get_eventhandler()->invoke(
+		*this, target, state, event->get_time(), event->get_params());
+
+	this->active_event = nullptr;
+
+	this->repeat_event(event, target, state);
+	return 1;
+}
+
+
+int EventLoop::execute_parallel(const std::vector<std::shared_ptr<Event>> &batch,
+                                const std::shared_ptr<State> &state) {
+	std::vector<std::shared_ptr<EventEntity>> targets(batch.size());
+
+	// union-find over the events, events that touch the same entity are joined.
+	// the smallest index is the root, which keeps the partition order stable.
+	std::vector<size_t> roots(batch.size());
+	auto find = [&roots](size_t idx) {
+		while (roots[idx] != idx) {
+			roots[idx] = roots[roots[idx]];
+			idx = roots[idx];
+		}
+		return idx;
+	};
+
+	std::unordered_map<size_t, size_t> entity_events;
+	auto claim = [&](size_t idx, const EventEntity &entity) {
+		auto [it, inserted] = entity_events.emplace(entity.id(), idx);
+		if (not inserted) {
+			size_t a = find(it->second);
+			size_t b = find(idx);
+			roots[std::max(a, b)] = std::min(a, b);
+		}
+	};
+
+	for (size_t i = 0; i < batch.size(); i++) {
+		roots[i] = i;
+		targets[i] = batch[i]->get_entity().lock();
+		if (not targets[i]) {
+			continue;
+		}
+
+		claim(i, *targets[i]);
+		for (const auto &dependency : batch[i]->get_dependencies()) {
+			if (auto entity = dependency.lock()) {
+				claim(i, *entity);
+			}
+		}
+	}
+
+	std::vector<Partition> partitions;
+	std::vector<size_t> partition_index(batch.size(), batch.size());
+	for (size_t i = 0; i < batch.size(); i++) {
+		if (not targets[i]) {
+			LOG_DBG("Loop: event \"" << batch[i]->get_eventhandler()->id()
+			        << "\" ignored because its target does not exist anymore "
+			        << "\" for time t=" << batch[i]->get_time());
+			continue;
+		}
+
+		size_t root = find(i);
+		if (partition_index[root] == batch.size()) {
+			partition_index[root] = partitions.size();
+			partitions.emplace_back();
+		}
+		partitions[partition_index[root]].events.push_back(i);
+	}
+
+	if (partitions.size() < 2) {
+		int cnt = 0;
+		for (const auto &event : batch) {
+			cnt += this->execute_event(event, state);
+		}
+		return cnt;
+	}
+
+	LOG_DBG("Loop: executing " << batch.size() << " events in "
+	        << partitions.size() << " partitions in parallel");
+
+	this->job_manager->parallel_for(0, partitions.size(), 1, [&](size_t begin, size_t end) {
+		for (size_t p = begin; p < end; p++) {
+#if HAVE_THREAD_LOCAL_STORAGE
+			parallel_loop = this;
+			parallel_partition = &partitions[p];
+#endif
+			try {
+				for (size_t idx : partitions[p].events) {
+					const auto &event = batch[idx];
+					event->get_eventhandler()->invoke(
+						*this, targets[idx], state, event->get_time(), event->get_params());
 				}
 			}
+			catch (...) {
+#if HAVE_THREAD_LOCAL_STORAGE
+				parallel_loop = nullptr;
+				parallel_partition = nullptr;
+#endif
+				throw;
+			}
+#if HAVE_THREAD_LOCAL_STORAGE
+			parallel_loop = nullptr;
+			parallel_partition = nullptr;
+#endif
 		}
-		else {
-			// The element was already removed from the queue, so we can safely
-			// kill it by ignoring it.
-			log::log(DBG << "Loop: event \"" << event->get_eventhandler()->id()
-			             << "\" ignored because its target does not exist anymore "
-			             << "\" for time t=" << event->get_time());
+	});
+
+	// apply the effects in the same order in every run
+	int cnt = 0;
+	for (auto &partition : partitions) {
+		for (const auto &apply : partition.deferred) {
+			apply();
+		}
+		for (size_t idx : partition.events) {
+			this->repeat_event(batch[idx], targets[idx], state);
+			cnt += 1;
 		}
 	}
 	return cnt;
 }
 
 
+void EventLoop::repeat_event(const std::shared_ptr<Event> &event,
+                             const std::shared_ptr<EventEntity> &target,
+                             const std::shared_ptr<State> &state) {
+	// if the event is REPEAT, readd the event.
+	if (event->get_eventhandler()->type != EventHandler::trigger_type::REPEAT) {
+		return;
+	}
+
+	time::time_t new_time = event->get_eventhandler()->predict_invoke_time(
+		target, state, event->get_time());
+
+	if (new_time != time::TIME_MIN) {
+		event->set_time(new_time);
+
+		LOG_DBG("Loop: repeating event \"" << event->get_eventhandler()->id()
+		        << "\" on target \"" << target->idstr()
+		        << "\" will be reenqueued for time t=" << event->get_time());
+
+		this->queue.reenqueue(event);
+	}
+}
+
+
 void EventLoop::create_change(const std::shared_ptr<Event> evnt,
                               const time::time_t changes_at) {
+	if (Partition *partition = current_partition(this)) {
+		partition->deferred.emplace_back([this, evnt, changes_at]() {
+			this->queue.add_change(evnt, changes_at);
+		});
+		return;
+	}
+
 	std::unique_lock lock{this->mutex};
 
 	this->queue.add_change(evnt, changes_at);
+	this->notify();
+}
+
+
+time::time_t EventLoop::next_event_time() {
+	std::unique_lock lock{this->mutex};
+
+	if (not this->queue.get_changes().empty()) {
+		return time::TIME_MIN;
+	}
+
+	return this->queue.next_event_time();
+}
+
+
+void EventLoop::set_wakeup(const std::function<void()> &wakeup) {
+	std::unique_lock lock{this->mutex};
+
+	this->wakeup = wakeup;
+}
+
+
+void EventLoop::batch(const std::function<void()> &fn) {
+	// parallel event handlers already defer their calls into the loop
+	if (current_partition(this) != nullptr) {
+		fn();
+		return;
+	}
+
+	std::unique_lock lock{this->mutex};
+
+	auto finish = [this]() {
+		this->batch_depth -= 1;
+		if (this->batch_depth > 0) {
+			return;
+		}
+
+		this->queue.end_bulk();
+		if (this->batch_pending) {
+			this->batch_pending = false;
+			this->notify();
+		}
+	};
+
+	if (this->batch_depth == 0) {
+		this->queue.begin_bulk();
+	}
+	this->batch_depth += 1;
+	try {
+		fn();
+	}
+	catch (...) {
+		// events added before the exception are still in the queue
+		finish();
+		throw;
+	}
+	finish();
+}
+
+
+void EventLoop::set_parallel_execution(const std::shared_ptr<job::JobManager> &job_manager,
+                                       const time::time_t &window) {
+	ENSURE(window >= time::TIME_ZERO, "parallel event window must not be negative");
+
+	std::unique_lock lock{this->mutex};
+
+#if HAVE_THREAD_LOCAL_STORAGE
+	this->job_manager = job_manager;
+#else
+	if (job_manager != nullptr) {
+		log::log(MSG(warn) << "Parallel event execution requires thread local storage, "
+		                   << "events are executed sequentially");
+	}
+#endif
+	this->parallel_window = window;
+}
+
+
+void EventLoop::notify() {
+	// batch() notifies once when it is done
+	if (this->batch_depth > 0) {
+		this->batch_pending = true;
+		return;
+	}
+
+	// the thread in reach_time() holds the mutex,
+	// so this can only be an event handler of that thread
+	if (not this->reaching_time and this->wakeup) {
+		this->wakeup();
+	}
 }
 
 
 void EventLoop::update_changes(const std::shared_ptr<State> &state) {
-	log::log(SPAM << "Loop: " << this->queue.get_changes().size()
-	              << " target changes have to be processed");
+	LOG_SPAM("Loop: " << this->queue.get_changes().size()
+	         << " target changes have to be processed");
 
-	size_t i = 0;
+	[[maybe_unused]] size_t i = 0;
 
 	// Some EventEntity has changed, so all depending events were
 	// added to the EventQueue as changes.
@@ -194,7 +526,8 @@ void EventLoop::update_changes(const std::shared_ptr<State> &state) {
 	for (const auto &change : this->queue.get_changes()) {
 		auto evnt = change.evnt.lock();
 		if (evnt) {
-			log::log(DBG << "  change " << i++ << ": " << evnt->get_eventhandler()->id());
+			LOG_DBG("  change " << i << ": " << evnt->get_eventhandler()->id());
+			i += 1;
 			switch (evnt->get_eventhandler()->type) {
 			case EventHandler::trigger_type::ONCE:
 			case EventHandler::trigger_type::DEPENDENCY: {
@@ -205,21 +538,21 @@ void EventLoop::update_changes(const std::shared_ptr<State> &state) {
 					                            ->predict_invoke_time(entity, state, change.time);
 
 					if (new_time != time::TIME_MIN) {
-						log::log(DBG << "Loop: due to a change, rescheduling event of '"
-						             << evnt->get_eventhandler()->id()
-						             << "' on entity '" << entity->idstr()
-						             << "' at time t=" << change.time
-						             << " to NEW TIME t=" << new_time);
+						LOG_DBG("Loop: due to a change, rescheduling event of '"
+						        << evnt->get_eventhandler()->id()
+						        << "' on entity '" << entity->idstr()
+						        << "' at time t=" << change.time
+						        << " to NEW TIME t=" << new_time);
 
 						evnt->set_time(new_time);
 
 						this->queue.enqueue(evnt);
 					}
 					else {
-						log::log(DBG << "Loop: due to a change, canceled execution of '"
-						             << evnt->get_eventhandler()->id()
-						             << "' on entity '" << entity->idstr()
-						             << "' at time t=" << change.time);
+						LOG_DBG("Loop: due to a change, canceled execution of '"
+						        << evnt->get_eventhandler()->id()
+						        << "' on entity '" << entity->idstr()
+						        << "' at time t=" << change.time);
 
 						this->queue.remove(evnt);
 					}
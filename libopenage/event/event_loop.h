@@ -1,17 +1,24 @@
-// Copyright 2017-2024 the openage authors. See copying.md for legal info.
+// Copyright 2017-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
+#include <cstddef>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "event/eventhandler.h"
 #include "event/eventqueue.h"
 #include "time/time.h"
 
 
+namespace openage::job {
+class JobManager;
+} // namespace openage::job
+
 namespace openage::event {
 
 // The demo wants to display internal details
@@ -111,6 +118,60 @@ public:
 	void create_change(const std::shared_ptr<Event> event,
 	                   const time::time_t changes_at);
 
+	/**
+	 * Get the time at which reach_time() has work to do next.
+	 *
+	 * @return Time of the earliest queued event, time::TIME_MIN if changes
+	 *         are pending, or time::TIME_MAX if there is nothing to do.
+	 */
+	time::time_t next_event_time();
+
+	/**
+	 * Set a function that is called when an event or a change is added by
+	 * another thread than the one running reach_time(), e.g. to wake up a
+	 * thread that sleeps until the next event.
+	 *
+	 * @param wakeup Function called on new events. Must not call into this loop.
+	 */
+	void set_wakeup(const std::function<void()> &wakeup);
+
+	/**
+	 * Run a function that adds many events or changes at once, e.g. when
+	 * spawning game entities in bulk.
+	 *
+	 * The loop is locked only once for the whole function. Events that are
+	 * added to the queue are inserted together when the outermost batch ends,
+	 * with storage allocated once for all of them. The wakeup function is
+	 * called at most once afterwards instead of once per event.
+	 *
+	 * @param fn Function that adds events to this loop.
+	 */
+	void batch(const std::function<void()> &fn);
+
+	/**
+	 * Execute events on different targets in parallel on the worker threads
+	 * of a job manager.
+	 *
+	 * When the next event's handler is parallel safe (see
+	 * EventHandler::is_parallel_safe()), all following parallel safe events
+	 * up to \p window later are taken from the queue. They are grouped into
+	 * partitions of events whose targets and dependencies overlap, and the
+	 * partitions are executed concurrently. Events of a partition are executed
+	 * in queue order.
+	 *
+	 * Events and changes that the handlers create meanwhile are added to the
+	 * queue after all partitions have been executed, in partition order, so
+	 * the result does not depend on the thread scheduling. For this, events
+	 * created by a parallel handler are returned before they are set up,
+	 * and are not executed if no execution is scheduled for them.
+	 *
+	 * @param job_manager Job manager whose workers execute the events.
+	 *                    \p nullptr executes all events on the calling thread.
+	 * @param window Time span in which events are executed together.
+	 */
+	void set_parallel_execution(const std::shared_ptr<job::JobManager> &job_manager,
+	                            const time::time_t &window = time::TIME_ZERO);
+
 	/**
 	 * Get the event queue.
 	 *
@@ -121,6 +182,16 @@ public:
 	}
 
 private:
+	/**
+	 * Execute events and changes until no more events happen before
+	 * a given point in time. Called by reach_time().
+	 *
+	 * @param time_until Maximum time until which events are executed.
+	 * @param state Global state.
+	 */
+	void settle(const time::time_t &time_until,
+	            const std::shared_ptr<State> &state);
+
 	/**
 	 *  Execute events in the queue with execution time <= a given point in time.
 	 *
@@ -132,6 +203,40 @@ private:
 	int execute_events(const time::time_t &time_until,
 	                   const std::shared_ptr<State> &state);
 
+	/**
+	 * Execute a single event and reenqueue it if it repeats.
+	 *
+	 * @param event Event taken from the queue.
+	 * @param state Global state.
+	 *
+	 * @returns number of events processed
+	 */
+	int execute_event(const std::shared_ptr<Event> &event,
+	                  const std::shared_ptr<State> &state);
+
+	/**
+	 * Execute events taken from the queue in parallel where their targets
+	 * and dependencies don't overlap.
+	 *
+	 * @param batch Events taken from the queue, in queue order.
+	 * @param state Global state.
+	 *
+	 * @returns number of events processed
+	 */
+	int execute_parallel(const std::vector<std::shared_ptr<Event>> &batch,
+	                     const std::shared_ptr<State> &state);
+
+	/**
+	 * Reenqueue an executed event if its event handler is REPEAT.
+	 *
+	 * @param event Executed event.
+	 * @param target Target of the event.
+	 * @param state Global state.
+	 */
+	void repeat_event(const std::shared_ptr<Event> &event,
+	                  const std::shared_ptr<EventEntity> &target,
+	                  const std::shared_ptr<State> &state);
+
 	/**
 	 * Call all the time change functions. This is constant on the state!
 	 *
@@ -139,6 +244,12 @@ private:
 	 */
 	void update_changes(const std::shared_ptr<State> &state);
 
+	/**
+	 * Call the wakeup function if the current change doesn't come from
+	 * reach_time(). The mutex must be held.
+	 */
+	void notify();
+
 	/**
 	 * Here we do the bookkeeping of registered event handleres.
 	 */
@@ -155,6 +266,37 @@ private:
 	 */
 	std::shared_ptr<Event> active_event;
 
+	/**
+	 * Called when an event or change is added outside of reach_time().
+	 */
+	std::function<void()> wakeup;
+
+	/**
+	 * Whether reach_time() is running. Events created meanwhile come from
+	 * event handlers and don't need a wakeup.
+	 */
+	bool reaching_time = false;
+
+	/**
+	 * Number of nested batch() calls that are running.
+	 */
+	size_t batch_depth = 0;
+
+	/**
+	 * Whether events were added during batch() that need a wakeup.
+	 */
+	bool batch_pending = false;
+
+	/**
+	 * Executes events in parallel. nullptr if events are executed sequentially.
+	 */
+	std::shared_ptr<job::JobManager> job_manager;
+
+	/**
+	 * Time span in which parallel events are executed together.
+	 */
+	time::time_t parallel_window = time::TIME_ZERO;
+
 	/**
 	 * Mutex for protecting threaded access.
 	 */
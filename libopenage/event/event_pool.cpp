@@ -0,0 +1,3 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#include "event_pool.h"
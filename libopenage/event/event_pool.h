@@ -0,0 +1,113 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "config.h"
+
+
+namespace openage::event {
+
+/**
+ * Allocator that recycles the memory of freed objects.
+ *
+ * Freed single objects are kept in a cache of the freeing thread and
+ * handed out again for the next allocations of that thread. Together
+ * with std::allocate_shared, this lets short-lived events reuse the
+ * memory of events that were executed before, instead of going
+ * through malloc for every event.
+ *
+ * @tparam T Allocated type.
+ */
+template <typename T>
+class PoolAllocator {
+public:
+	using value_type = T;
+
+	/**
+	 * Maximum number of cached blocks per thread.
+	 */
+	static constexpr size_t max_cached = 1024;
+
+	PoolAllocator() noexcept = default;
+
+	template <typename U>
+	PoolAllocator(const PoolAllocator<U> &) noexcept {}
+
+	T *allocate(size_t n) {
+#if HAVE_THREAD_LOCAL_STORAGE
+		if (n == 1) {
+			if (BlockCache *cache = BlockCache::local()) {
+				if (not cache->blocks.empty()) {
+					T *block = cache->blocks.back();
+					cache->blocks.pop_back();
+					return block;
+				}
+			}
+		}
+#endif
+		return std::allocator<T>{}.allocate(n);
+	}
+
+	void deallocate(T *block, size_t n) noexcept {
+#if HAVE_THREAD_LOCAL_STORAGE
+		if (n == 1) {
+			BlockCache *cache = BlockCache::local();
+			if (cache != nullptr and cache->blocks.size() < max_cached) {
+				try {
+					cache->blocks.push_back(block);
+					return;
+				}
+				catch (...) {
+					// the block is freed instead
+				}
+			}
+		}
+#endif
+		std::allocator<T>{}.deallocate(block, n);
+	}
+
+	template <typename U>
+	bool operator==(const PoolAllocator<U> &) const noexcept {
+		return true;
+	}
+
+private:
+#if HAVE_THREAD_LOCAL_STORAGE
+	/**
+	 * Freed blocks of the current thread.
+	 */
+	struct BlockCache {
+		~BlockCache() {
+			for (T *block : this->blocks) {
+				std::allocator<T>{}.deallocate(block, 1);
+			}
+			destroyed = true;
+		}
+
+		/**
+		 * Get the cache of the current thread, or nullptr if the thread
+		 * is exiting and the cache has already been destroyed.
+		 */
+		static BlockCache *local() {
+			if (destroyed) {
+				return nullptr;
+			}
+			thread_local BlockCache cache;
+			return &cache;
+		}
+
+		std::vector<T *> blocks;
+
+		/**
+		 * Whether the cache of this thread was destroyed.
+		 */
+		static thread_local inline bool destroyed = false;
+	};
+#endif
+};
+
+} // namespace openage::event
@@ -1,4 +1,4 @@
-// Copyright 2017-2023 the openage authors. See copying.md for legal info.
+// Copyright 2017-2026 the openage authors. See copying.md for legal info.
 
 #include "evententity.h"
 
@@ -21,8 +21,8 @@ void EventEntity::changes(const time::time_t &time) {
 	// that subscribed on this entity.
 
 	if (this->parent_notifier or this->dependents.size()) {
-		log::log(DBG << "Target: processing change request at t=" << time
-		             << " for EventEntity " << this->idstr() << "...");
+		LOG_DBG("Target: processing change request at t=" << time
+		        << " for EventEntity " << this->idstr() << "...");
 	}
 
 	if (this->parent_notifier != nullptr) {
@@ -39,8 +39,8 @@ void EventEntity::changes(const time::time_t &time) {
 				// Enqueue a change so that change events,
 				// which depend on this target, will be retriggered
 
-				log::log(DBG << "Target: change at t=" << time
-				             << " for EventEntity " << this->idstr() << " registered");
+				LOG_DBG("Target: change at t=" << time
+				        << " for EventEntity " << this->idstr() << " registered");
 				this->loop->create_change(dependent, time);
 				++it;
 				break;
@@ -85,9 +85,9 @@ void EventEntity::trigger(const time::time_t &last_valid_time) {
 		auto dependent = it->lock();
 		if (dependent) {
 			if (dependent->get_eventhandler()->type == EventHandler::trigger_type::TRIGGER) {
-				log::log(DBG << "Target: trigger creates a change for "
-				             << dependent->get_eventhandler()->id()
-				             << " at t=" << last_valid_time);
+				LOG_DBG("Target: trigger creates a change for "
+				        << dependent->get_eventhandler()->id()
+				        << " at t=" << last_valid_time);
 
 				loop->create_change(dependent, last_valid_time);
 			}
@@ -106,14 +106,14 @@ void EventEntity::add_dependent(const std::shared_ptr<Event> &event) {
 }
 
 void EventEntity::show_dependents() const {
-	log::log(DBG << "Dependent list:");
+	LOG_DBG("Dependent list:");
 	for (auto &dep : this->dependents) {
 		auto dependent = dep.lock();
 		if (dependent) {
-			log::log(DBG << " - " << dependent->get_eventhandler()->id());
+			LOG_DBG(" - " << dependent->get_eventhandler()->id());
 		}
 		else {
-			log::log(DBG << " - ** outdated old reference **");
+			LOG_DBG(" - ** outdated old reference **");
 		}
 	}
 }
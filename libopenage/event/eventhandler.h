@@ -1,15 +1,11 @@
-// Copyright 2017-2023 the openage authors. See copying.md for legal info.
+// Copyright 2017-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
-#include <any>
-#include <initializer_list>
 #include <memory>
 #include <string>
-#include <typeinfo>
-#include <unordered_map>
-#include <utility>
 
+#include "event/param_map.h"
 #include "time/time.h"
 
 
@@ -71,61 +67,7 @@ public:
 	/**
 	 * Storage for parameters for an event handler.
 	 */
-	class param_map {
-	public:
-		using map_t = std::unordered_map<std::string, std::any>;
-
-		param_map() {}
-		param_map(std::initializer_list<map_t::value_type> l) :
-			map(l) {}
-		param_map(const map_t &map) :
-			map{std::move(map)} {}
-
-		/**
-		 * Returns the value, if it exists and is the right type.
-		 * defaultval if not.
-		 */
-		template <typename T>
-		T get(const std::string &key, const T &defaultval = T()) const {
-			auto it = this->map.find(key);
-			if (it != this->map.end() && this->check_type<T>(it)) {
-				return std::any_cast<T>(it->second);
-			}
-			else {
-				return defaultval;
-			}
-		}
-
-		/**
-		 * Check if the map contains the given key.
-		 */
-		bool contains(const std::string &key) const {
-			return map.find(key) != map.end();
-		}
-
-		/**
-		 * Check if the type of a map entry is correct.
-		 */
-		template <typename Type>
-		bool check_type(const std::string &key) const {
-			auto it = map.find(key);
-			if (it != map.end()) {
-				return this->check_type<Type>(it);
-			}
-			return false;
-		}
-
-	private:
-		template <typename T>
-		bool check_type(const map_t::const_iterator &it) const {
-			return it->second.type() == typeid(T);
-		}
-
-		/**
-		 * Data storage.
-		 */
-		const map_t map;
-	};
+	using param_map = ParamMap;
 
 	/**
 	 * Constructor to be constructed with the unique identifier
@@ -184,6 +126,20 @@ public:
 	                                         const std::shared_ptr<State> &state,
 	                                         const time::time_t &at) = 0;
 
+	/**
+	 * Whether events of this event handler may be invoked concurrently with
+	 * events on other targets, see EventLoop::set_parallel_execution().
+	 *
+	 * This requires that `invoke` only modifies the target and the event
+	 * entities that the event depends on, only reads other parts of the state,
+	 * and only calls `create_event` and `create_change` on the loop.
+	 *
+	 * @return true if events can be invoked in parallel, false by default.
+	 */
+	virtual bool is_parallel_safe() const {
+		return false;
+	}
+
 private:
 	/**
 	 * String identifier for this event handler.
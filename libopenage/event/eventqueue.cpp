@@ -1,4 +1,4 @@
-// Copyright 2017-2023 the openage authors. See copying.md for legal info.
+// Copyright 2017-2026 the openage authors. See copying.md for legal info.
 
 #include "eventqueue.h"
 
@@ -24,7 +24,29 @@ std::shared_ptr<Event> EventQueue::create_event(const std::shared_ptr<EventEntit
                                                 const std::shared_ptr<State> &state,
                                                 const time::time_t &reference_time,
                                                 const EventHandler::param_map &params) {
-	auto event = std::make_shared<Event>(trgt, cls, params);
+	auto event = Event::create(trgt, cls, params);
+
+	if (not this->add_event(event, state, reference_time)) {
+		return {};
+	}
+
+	return event;
+}
+
+
+bool EventQueue::add_event(const std::shared_ptr<Event> &event,
+                           const std::shared_ptr<State> &state,
+                           const time::time_t &reference_time) {
+	const auto &cls = event->get_eventhandler();
+
+	// the event may have been canceled before it was added
+	auto target = event->get_entity().lock();
+	if (not target) {
+		LOG_DBG("Queue: ignoring insertion of event "
+		        << cls->id() << " because its target does not exist anymore.");
+
+		return false;
+	}
 
 	cls->setup_event(event, state);
 
@@ -32,14 +54,13 @@ std::shared_ptr<Event> EventQueue::create_event(const std::shared_ptr<EventEntit
 	case EventHandler::trigger_type::DEPENDENCY:
 	case EventHandler::trigger_type::REPEAT:
 	case EventHandler::trigger_type::ONCE:
-		event->set_time(event->get_eventhandler()
-		                    ->predict_invoke_time(trgt, state, reference_time));
+		event->set_time(cls->predict_invoke_time(target, state, reference_time));
 
 		if (event->get_time() == time::TIME_MIN) {
-			log::log(DBG << "Queue: ignoring insertion of event "
-			             << event->get_eventhandler()->id() << " because no execution was scheduled.");
+			LOG_DBG("Queue: ignoring insertion of event "
+			        << cls->id() << " because no execution was scheduled.");
 
-			return {};
+			return false;
 		}
 		break;
 
@@ -49,7 +70,7 @@ std::shared_ptr<Event> EventQueue::create_event(const std::shared_ptr<EventEntit
 		break;
 	}
 
-	log::log(DBG << "Queue: inserting event " << event->get_eventhandler()->id() << " into queue to be executed at t=" << event->get_time());
+	LOG_DBG("Queue: inserting event " << event->get_eventhandler()->id() << " into queue to be executed at t=" << event->get_time());
 
 	// store the event
 	// or enqueue it for execution
@@ -69,10 +90,15 @@ std::shared_ptr<Event> EventQueue::create_event(const std::shared_ptr<EventEntit
 	case EventHandler::trigger_type::REPEAT:
 	case EventHandler::trigger_type::ONCE:
 	default:
-		this->event_queue.push(event);
+		if (this->bulk) {
+			this->bulk_events.push_back(event);
+		}
+		else {
+			this->event_queue.push(event);
+		}
 	}
 
-	return event;
+	return true;
 }
 
 
@@ -81,6 +107,27 @@ EventQueue::EventQueue() :
 	future_changes(&changeset_B) {}
 
 
+void EventQueue::begin_bulk() {
+	this->bulk = true;
+}
+
+
+void EventQueue::end_bulk() {
+	this->flush_bulk();
+	this->bulk = false;
+}
+
+
+void EventQueue::flush_bulk() {
+	if (this->bulk_events.empty()) {
+		return;
+	}
+
+	this->event_queue.push(this->bulk_events);
+	this->bulk_events.clear();
+}
+
+
 void EventQueue::add_change(const std::shared_ptr<Event> &event,
                             const time::time_t &changed_at) {
 	const time::time_t event_previous_changed = event->get_last_changed();
@@ -93,9 +140,9 @@ void EventQueue::add_change(const std::shared_ptr<Event> &event,
 		if (it != changes->end()) {
 			// Is the new change dated _before_ the old one?
 			if (changed_at < it->time) {
-				log::log(DBG << "Queue: adjusting time in change queue: moving event of "
-				             << event->get_eventhandler()->id()
-				             << " to earlier time");
+				LOG_DBG("Queue: adjusting time in change queue: moving event of "
+				        << event->get_eventhandler()->id()
+				        << " to earlier time");
 
 				// Save the element
 				Change change = *it;
@@ -108,25 +155,25 @@ void EventQueue::add_change(const std::shared_ptr<Event> &event,
 			}
 			else {
 				// this change is to be ignored
-				log::log(DBG << "Queue: skipping change for " << event->get_eventhandler()->id()
-				             << " at " << changed_at
-				             << " because there was already an earlier one at t=" << it->time);
+				LOG_DBG("Queue: skipping change for " << event->get_eventhandler()->id()
+				        << " at " << changed_at
+				        << " because there was already an earlier one at t=" << it->time);
 			}
 		}
 		else {
 			// the change was not in the to be changed list
 			this->changes->emplace(event, changed_at);
-			log::log(DBG << "Queue: inserting change for event from "
-			             << event->get_eventhandler()->id()
-			             << " to be applied at t=" << changed_at);
+			LOG_DBG("Queue: inserting change for event from "
+			        << event->get_eventhandler()->id()
+			        << " to be applied at t=" << changed_at);
 		}
 	}
 	else {
 		// the event has been triggered in this round already, so skip it this time
 		this->future_changes->emplace(event, changed_at);
-		log::log(DBG << "Queue: ignoring change at t=" << changed_at
-		             << " for event for handler " << event->get_eventhandler()->id()
-		             << " because it's already processed as change at t=" << event_previous_changed);
+		LOG_DBG("Queue: ignoring change at t=" << changed_at
+		        << " for event for handler " << event->get_eventhandler()->id()
+		        << " because it's already processed as change at t=" << event_previous_changed);
 	}
 
 	event->set_last_changed(changed_at);
@@ -137,11 +184,13 @@ void EventQueue::remove(const std::shared_ptr<Event> &evnt) {
 	// TODO: remove the event from the other storages.
 	//       this would require changes to dependent events and triggers.
 	//       (to stop being a dependent event or allow being triggered)
+	this->flush_bulk();
 	this->event_queue.erase(evnt);
 }
 
 
 void EventQueue::enqueue(const std::shared_ptr<Event> &evnt) {
+	this->flush_bulk();
 	if (this->event_queue.contains(evnt)) {
 		this->event_queue.update(evnt);
 	}
@@ -162,6 +211,7 @@ const EventStore &EventQueue::get_event_queue() const {
 
 
 std::shared_ptr<Event> EventQueue::take_event(const time::time_t &max_time) {
+	this->flush_bulk();
 	if (this->event_queue.size() == 0) {
 		return nullptr;
 	}
@@ -182,6 +232,16 @@ std::shared_ptr<Event> EventQueue::take_event(const time::time_t &max_time) {
 }
 
 
+time::time_t EventQueue::next_event_time() {
+	this->flush_bulk();
+	if (this->event_queue.empty()) {
+		return time::TIME_MAX;
+	}
+
+	return this->event_queue.top()->get_time();
+}
+
+
 const EventQueue::change_set &EventQueue::get_changes() const {
 	return *this->changes;
 }
@@ -1,10 +1,11 @@
-// Copyright 2017-2023 the openage authors. See copying.md for legal info.
+// Copyright 2017-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
 #include <cstddef>
 #include <memory>
 #include <unordered_set>
+#include <vector>
 
 #include "event/eventhandler.h"
 #include "event/eventstore.h"
@@ -70,6 +71,32 @@ public:
 	                                    const time::time_t &reference_time,
 	                                    const EventHandler::param_map &params);
 
+	/**
+	 * Set up an event that was created for a target and add it to the queue.
+	 *
+	 * Like `create_event`, but for event objects that already exist.
+	 *
+	 * @return true if the event was added, false if no execution was scheduled.
+	 */
+	bool add_event(const std::shared_ptr<Event> &event,
+	               const std::shared_ptr<State> &state,
+	               const time::time_t &reference_time);
+
+	/**
+	 * Collect the events that are added from now on, and insert them into
+	 * the queue together in \p end_bulk().
+	 *
+	 * Collected events are inserted early when the queue is accessed
+	 * meanwhile, so they behave like events that were inserted directly.
+	 * Only \p get_event_queue() doesn't contain them yet.
+	 */
+	void begin_bulk();
+
+	/**
+	 * Insert the events collected since \p begin_bulk() into the queue.
+	 */
+	void end_bulk();
+
 	/**
 	 * Remove the given event from the queue.
 	 */
@@ -105,6 +132,13 @@ public:
 	 */
 	std::shared_ptr<Event> take_event(const time::time_t &max_time);
 
+	/**
+	 * Get the time of the next event in the `event_queue`.
+	 *
+	 * @return Time of the earliest event, or time::TIME_MAX if the queue is empty.
+	 */
+	time::time_t next_event_time();
+
 	/**
 	 * Get the change_set to process changes.
 	 */
@@ -151,6 +185,21 @@ private:
 	 * The universe timeline processes through this queue.
 	 */
 	EventStore event_queue;
+
+	/**
+	 * Insert the events collected for a bulk insertion into \p event_queue.
+	 */
+	void flush_bulk();
+
+	/**
+	 * Whether a bulk insertion is running.
+	 */
+	bool bulk = false;
+
+	/**
+	 * Events collected for a bulk insertion.
+	 */
+	std::vector<std::shared_ptr<Event>> bulk_events;
 };
 
 } // namespace openage::event
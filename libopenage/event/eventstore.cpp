@@ -1,4 +1,4 @@
-// Copyright 2018-2023 the openage authors. See copying.md for legal info.
+// Copyright 2018-2026 the openage authors. See copying.md for legal info.
 
 #include "eventstore.h"
 
@@ -18,7 +18,7 @@ void EventStore::push(const std::shared_ptr<Event> &event) {
 		throw Error{ERR << "inserting nullptr event to queue"};
 	}
 
-	heap_t::element_t order = this->heap.push(event);
+	heap_t::handle_t order = this->heap.push(event);
 	this->events.emplace(event, order);
 
 	ENSURE(this->heap.size() == this->events.size(),
@@ -26,6 +26,16 @@ void EventStore::push(const std::shared_ptr<Event> &event) {
 }
 
 
+void EventStore::push(const std::vector<std::shared_ptr<Event>> &events) {
+	this->heap.reserve(this->heap.size() + events.size());
+	this->events.reserve(this->events.size() + events.size());
+
+	for (const auto &event : events) {
+		this->push(event);
+	}
+}
+
+
 std::shared_ptr<Event> EventStore::pop() {
 	ENSURE(this->heap.size() == this->events.size(),
 	       "heap and event set are inconsistent 0");
@@ -1,4 +1,4 @@
-// Copyright 2018-2023 the openage authors. See copying.md for legal info.
+// Copyright 2018-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -7,7 +7,7 @@
 #include <unordered_map>
 #include <vector>
 
-#include "datastructure/pairing_heap.h"
+#include "datastructure/pooled_pairing_heap.h"
 #include "event/event.h"
 #include "util/misc.h"
 
@@ -22,11 +22,16 @@ class EventStore {
 public:
 	// TODO: don't store a double-sharedpointer.
 	//       instead, use the event-sharedpointer directly.
-	using heap_t = datastructure::PairingHeap<std::shared_ptr<Event>,
-	                                          util::SharedPtrLess<Event>>;
-	using elemmap_t = std::unordered_map<std::shared_ptr<Event>, heap_t::element_t>;
+	using heap_t = datastructure::PooledPairingHeap<std::shared_ptr<Event>,
+	                                                util::SharedPtrLess<Event>>;
+	using elemmap_t = std::unordered_map<std::shared_ptr<Event>, heap_t::handle_t>;
 
 	void push(const std::shared_ptr<Event> &event);
+
+	/**
+	 * Insert multiple events. Storage for all of them is allocated at once.
+	 */
+	void push(const std::vector<std::shared_ptr<Event>> &events);
 	std::shared_ptr<Event> pop();
 	const std::shared_ptr<Event> &top();
 	bool erase(const std::shared_ptr<Event> &event);
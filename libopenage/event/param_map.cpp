@@ -0,0 +1,139 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#include "param_map.h"
+
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+
+namespace openage::event {
+
+namespace {
+
+/**
+ * Hash for looking up names with string views.
+ */
+struct name_hash {
+	using is_transparent = void;
+
+	size_t operator()(std::string_view name) const {
+		return std::hash<std::string_view>{}(name);
+	}
+};
+
+/**
+ * Interned parameter names.
+ */
+class ParamKeys {
+public:
+	param_key_t intern(std::string_view name) {
+		if (auto key = this->find(name)) {
+			return key.value();
+		}
+
+		std::unique_lock lock{this->mutex};
+		auto it = this->keys.emplace(name, this->keys.size()).first;
+		return it->second;
+	}
+
+	std::optional<param_key_t> find(std::string_view name) {
+		std::shared_lock lock{this->mutex};
+		auto it = this->keys.find(name);
+		if (it == this->keys.end()) {
+			return std::nullopt;
+		}
+		return it->second;
+	}
+
+private:
+	std::unordered_map<std::string, param_key_t, name_hash, std::equal_to<>> keys;
+	std::shared_mutex mutex;
+};
+
+ParamKeys &param_keys() {
+	static ParamKeys keys;
+	return keys;
+}
+
+} // namespace
+
+
+param_key_t intern_param_key(std::string_view name) {
+	return param_keys().intern(name);
+}
+
+
+std::optional<param_key_t> find_param_key(std::string_view name) {
+	return param_keys().find(name);
+}
+
+
+ParamMap::ParamMap(std::initializer_list<param> params) {
+	for (const auto &p : params) {
+		this->add(p.key, p.value);
+	}
+}
+
+
+bool ParamMap::contains(const std::string &key) const {
+	return this->find(key) != nullptr;
+}
+
+
+bool ParamMap::contains(const ParamKey &key) const {
+	return this->find(key.get_id()) != nullptr;
+}
+
+
+size_t ParamMap::size() const {
+	return this->inline_used + this->more_entries.size();
+}
+
+
+void ParamMap::add(param_key_t key, const ParamValue &value) {
+	// like in a map, the first value of a key is kept
+	if (this->find(key) != nullptr) {
+		return;
+	}
+
+	if (this->inline_used < inline_count) {
+		this->inline_entries[this->inline_used] = entry{key, value};
+		this->inline_used += 1;
+	}
+	else {
+		this->more_entries.push_back(entry{key, value});
+	}
+}
+
+
+const ParamValue *ParamMap::find(const std::string &key) const {
+	if (this->size() == 0) {
+		return nullptr;
+	}
+
+	auto id = find_param_key(key);
+	if (not id) {
+		return nullptr;
+	}
+
+	return this->find(id.value());
+}
+
+
+const ParamValue *ParamMap::find(param_key_t key) const {
+	for (size_t i = 0; i < this->inline_used; i++) {
+		if (this->inline_entries[i].key == key) {
+			return &this->inline_entries[i].value;
+		}
+	}
+	for (const auto &entry : this->more_entries) {
+		if (entry.key == key) {
+			return &entry.value;
+		}
+	}
+	return nullptr;
+}
+
+} // namespace openage::event
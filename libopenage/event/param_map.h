@@ -0,0 +1,407 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+
+namespace openage::event {
+
+/**
+ * Id of an interned parameter name.
+ */
+using param_key_t = uint32_t;
+
+/**
+ * Get the id of a parameter name. Names are interned on first use.
+ *
+ * @param name Parameter name.
+ *
+ * @return Id of the name.
+ */
+param_key_t intern_param_key(std::string_view name);
+
+/**
+ * Get the id of a parameter name without interning it.
+ *
+ * @param name Parameter name.
+ *
+ * @return Id of the name, or nothing if no parameter has this name yet.
+ */
+std::optional<param_key_t> find_param_key(std::string_view name);
+
+
+/**
+ * Interned parameter name.
+ *
+ * Interning a name takes a global lock, so frequently used names should
+ * be interned once and the key reused, e.g. as a static constant at the
+ * call site:
+ *
+ *     static const event::ParamKey owner_key{"owner"};
+ *     auto owner = params.get<player_id_t>(owner_key);
+ */
+class ParamKey {
+public:
+	/**
+	 * Intern a parameter name.
+	 *
+	 * @param name Parameter name.
+	 */
+	explicit ParamKey(std::string_view name) :
+		id{intern_param_key(name)} {}
+
+	/**
+	 * Get the id of the interned name.
+	 */
+	param_key_t get_id() const {
+		return this->id;
+	}
+
+private:
+	/**
+	 * Id of the interned name.
+	 */
+	param_key_t id;
+};
+
+
+/**
+ * Type-erased value of an event parameter.
+ *
+ * Like std::any, but values of up to \p inline_size bytes are stored
+ * in the object itself instead of on the heap.
+ */
+class ParamValue {
+public:
+	/**
+	 * Size of values that are stored without heap allocation.
+	 */
+	static constexpr size_t inline_size = 32;
+
+	/**
+	 * Alignment of the inline storage.
+	 */
+	static constexpr size_t inline_align = 16;
+
+	/**
+	 * Create an empty value.
+	 */
+	ParamValue() = default;
+
+	/**
+	 * Create a value holding a copy of \p value.
+	 */
+	template <typename T, typename V = std::decay_t<T>>
+		requires(not std::is_same_v<V, ParamValue>)
+	explicit ParamValue(T &&value) :
+		ops{&ops_for<V>} {
+		if constexpr (is_inline<V>()) {
+			new (this->storage) V(std::forward<T>(value));
+		}
+		else {
+			this->heap = new V(std::forward<T>(value));
+		}
+	}
+
+	ParamValue(const ParamValue &other) {
+		if (other.ops != nullptr) {
+			other.ops->copy(other, *this);
+			this->ops = other.ops;
+		}
+	}
+
+	ParamValue(ParamValue &&other) noexcept {
+		if (other.ops != nullptr) {
+			other.ops->move(other, *this);
+			this->ops = std::exchange(other.ops, nullptr);
+		}
+	}
+
+	ParamValue &operator=(const ParamValue &other) {
+		if (this != &other) {
+			ParamValue copy{other};
+			*this = std::move(copy);
+		}
+		return *this;
+	}
+
+	ParamValue &operator=(ParamValue &&other) noexcept {
+		if (this != &other) {
+			this->reset();
+			if (other.ops != nullptr) {
+				other.ops->move(other, *this);
+				this->ops = std::exchange(other.ops, nullptr);
+			}
+		}
+		return *this;
+	}
+
+	~ParamValue() {
+		this->reset();
+	}
+
+	/**
+	 * Check if the value has type \p T.
+	 */
+	template <typename T>
+	bool holds() const {
+		return this->ops != nullptr
+		       and (this->ops == &ops_for<T> or this->ops->type() == typeid(T));
+	}
+
+	/**
+	 * Get the value. Must only be called if holds<T>() is true.
+	 */
+	template <typename T>
+	const T &get() const {
+		if constexpr (is_inline<T>()) {
+			return *std::launder(reinterpret_cast<const T *>(this->storage));
+		}
+		else {
+			return *static_cast<const T *>(this->heap);
+		}
+	}
+
+	/**
+	 * Check if the value is empty.
+	 */
+	bool empty() const {
+		return this->ops == nullptr;
+	}
+
+private:
+	/**
+	 * Operations on the stored type.
+	 */
+	struct operations {
+		const std::type_info &(*type)();
+		void (*copy)(const ParamValue &from, ParamValue &to);
+		void (*move)(ParamValue &from, ParamValue &to) noexcept;
+		void (*destroy)(ParamValue &value) noexcept;
+	};
+
+	/**
+	 * Check if values of type \p T are stored inline.
+	 */
+	template <typename T>
+	static constexpr bool is_inline() {
+		return sizeof(T) <= inline_size
+		       and alignof(T) <= inline_align
+		       and std::is_nothrow_move_constructible_v<T>;
+	}
+
+	/**
+	 * Operations of the stored type, nullptr if the value is empty.
+	 */
+	const operations *ops = nullptr;
+
+	union {
+		/**
+		 * Storage of small values.
+		 */
+		alignas(inline_align) std::byte storage[inline_size];
+
+		/**
+		 * Large values on the heap.
+		 */
+		void *heap;
+	};
+
+	/**
+	 * Operations for values of type \p T.
+	 */
+	template <typename T>
+	static constexpr operations ops_for{
+		[]() -> const std::type_info & {
+			return typeid(T);
+		},
+		[](const ParamValue &from, ParamValue &to) {
+			if constexpr (is_inline<T>()) {
+				new (to.storage) T(from.get<T>());
+			}
+			else {
+				to.heap = new T(from.get<T>());
+			}
+		},
+		[](ParamValue &from, ParamValue &to) noexcept {
+			if constexpr (is_inline<T>()) {
+				T &value = *std::launder(reinterpret_cast<T *>(from.storage));
+				new (to.storage) T(std::move(value));
+				value.~T();
+			}
+			else {
+				to.heap = std::exchange(from.heap, nullptr);
+			}
+		},
+		[](ParamValue &value) noexcept {
+			if constexpr (is_inline<T>()) {
+				std::launder(reinterpret_cast<T *>(value.storage))->~T();
+			}
+			else {
+				delete static_cast<T *>(value.heap);
+			}
+		},
+	};
+
+	/**
+	 * Destroy the stored value.
+	 */
+	void reset() {
+		if (this->ops != nullptr) {
+			this->ops->destroy(*this);
+			this->ops = nullptr;
+		}
+	}
+};
+
+
+/**
+ * Storage for parameters of an event.
+ *
+ * Parameter names are interned to integer ids, and up to \p inline_count
+ * parameters are stored in the map itself, so creating and copying small
+ * parameter maps does not allocate.
+ */
+class ParamMap {
+public:
+	/**
+	 * Number of parameters stored without heap allocation.
+	 */
+	static constexpr size_t inline_count = 4;
+
+	/**
+	 * Named parameter for constructing a map.
+	 */
+	class param {
+	public:
+		template <typename T>
+		param(std::string_view name, T &&value) :
+			key{intern_param_key(name)},
+			value{std::forward<T>(value)} {}
+
+		template <typename T>
+		param(const ParamKey &key, T &&value) :
+			key{key.get_id()},
+			value{std::forward<T>(value)} {}
+
+	private:
+		param_key_t key;
+		ParamValue value;
+
+		friend class ParamMap;
+	};
+
+	ParamMap() = default;
+	ParamMap(std::initializer_list<param> params);
+
+	/**
+	 * Returns the value, if it exists and is the right type.
+	 * defaultval if not.
+	 *
+	 * Looking up a name takes a global lock, prefer the \p ParamKey
+	 * overload in frequently called code.
+	 */
+	template <typename T>
+	T get(const std::string &key, const T &defaultval = T()) const {
+		return get_value(this->find(key), defaultval);
+	}
+
+	/**
+	 * Returns the value, if it exists and is the right type.
+	 * defaultval if not.
+	 */
+	template <typename T>
+	T get(const ParamKey &key, const T &defaultval = T()) const {
+		return get_value(this->find(key.get_id()), defaultval);
+	}
+
+	/**
+	 * Check if the map contains the given key.
+	 */
+	bool contains(const std::string &key) const;
+	bool contains(const ParamKey &key) const;
+
+	/**
+	 * Check if the type of a map entry is correct.
+	 */
+	template <typename Type>
+	bool check_type(const std::string &key) const {
+		const ParamValue *value = this->find(key);
+		return value != nullptr and value->holds<Type>();
+	}
+
+	template <typename Type>
+	bool check_type(const ParamKey &key) const {
+		const ParamValue *value = this->find(key.get_id());
+		return value != nullptr and value->holds<Type>();
+	}
+
+	/**
+	 * Get the number of parameters.
+	 */
+	size_t size() const;
+
+private:
+	struct entry {
+		param_key_t key = 0;
+		ParamValue value;
+	};
+
+	/**
+	 * Get a value if it has the right type, defaultval if not.
+	 */
+	template <typename T>
+	static T get_value(const ParamValue *value, const T &defaultval) {
+		if (value != nullptr and value->holds<T>()) {
+			return value->get<T>();
+		}
+		return defaultval;
+	}
+
+	/**
+	 * Add a parameter, unless there already is one with the same name.
+	 */
+	void add(param_key_t key, const ParamValue &value);
+
+	/**
+	 * Find the value of a parameter.
+	 *
+	 * @return Value, or nullptr if there is no parameter with this name.
+	 */
+	const ParamValue *find(const std::string &key) const;
+
+	/**
+	 * Find the value of a parameter by its name id.
+	 *
+	 * @return Value, or nullptr if there is no parameter with this id.
+	 */
+	const ParamValue *find(param_key_t key) const;
+
+	/**
+	 * Number of used inline entries.
+	 */
+	size_t inline_used = 0;
+
+	/**
+	 * The first parameters.
+	 */
+	entry inline_entries[inline_count];
+
+	/**
+	 * Parameters that don't fit into the inline entries.
+	 */
+	std::vector<entry> more_entries;
+};
+
+} // namespace openage::event
@@ -1,5 +1,8 @@
-// Copyright 2017-2023 the openage authors. See copying.md for legal info.
+// Copyright 2017-2026 the openage authors. See copying.md for legal info.
 
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <compare>
 #include <cstring>
 #include <iostream>
@@ -7,7 +10,9 @@
 #include <memory>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include "log/log.h"
 #include "log/message.h"
@@ -18,7 +23,10 @@
 #include "event/evententity.h"
 #include "event/eventhandler.h"
 #include "event/state.h"
+#include "job/job_manager.h"
+#include "time/clock.h"
 #include "time/time.h"
+#include "time/time_loop.h"
 #include "util/fixed_point.h"
 
 
@@ -591,6 +599,425 @@ void eventtrigger() {
 		loop->create_event("EventParameterMap", state->objectA, gstate, 1, {{"testInt", 1}, {"testStdString", "stdstring"s}, {"testString", "string"}});
 		loop->reach_time(10, gstate);
 	}
+
+	log::log(DBG << "------------- [ Starting Test: Parameter storage ] ------------");
+	{
+		// more parameters than stored inline, and a value stored on the heap
+		std::array<int64_t, 16> large{};
+		large.fill(3);
+		EventHandler::param_map params{{"a", 1},
+		                               {"b", 2.5},
+		                               {"c", std::string{"c"}},
+		                               {"d", std::vector<int>(100, 7)},
+		                               {"e", large},
+		                               {"a", 5}};
+
+		// the first value of a key is kept
+		TESTEQUALS(params.size(), 5);
+		TESTEQUALS(params.get<int>("a"), 1);
+		TESTEQUALS(params.get<double>("b"), 2.5);
+
+		auto copy = params;
+		auto moved = std::move(params);
+		TESTEQUALS(copy.get<std::string>("c"), "c");
+		TESTEQUALS(copy.get<std::vector<int>>("d").size(), 100);
+		auto moved_large = moved.get<std::array<int64_t, 16>>("e");
+		TESTEQUALS(moved_large[15], 3);
+		TESTEQUALS(moved.check_type<int>("e"), false);
+
+		// interned keys find the same entries as the names
+		const ParamKey key_a{"a"};
+		const ParamKey key_e{"e"};
+		const ParamKey key_missing{"not_a_param"};
+		TESTEQUALS(key_a.get_id(), ParamKey{"a"}.get_id());
+		TESTEQUALS(copy.get<int>(key_a), 1);
+		TESTEQUALS(copy.contains(key_e), true);
+		TESTEQUALS(copy.check_type<int>(key_e), false);
+		TESTEQUALS(copy.contains(key_missing), false);
+		TESTEQUALS(copy.get<int>(key_missing, 4), 4);
+
+		EventHandler::param_map by_key{{key_a, 7}, {"b", 1.5}};
+		TESTEQUALS(by_key.get<int>("a"), 7);
+		TESTEQUALS(by_key.get<double>(ParamKey{"b"}), 1.5);
+	}
+
+	log::log(DBG << "------------- [ Starting Test: Event pool ] ------------");
+	{
+		auto loop = std::make_shared<EventLoop>();
+		auto state = std::make_shared<TestState>(loop);
+		auto handler = std::make_shared<EventTypeTestClass>("pooled", EventHandler::trigger_type::ONCE);
+
+		// the memory of a freed event is used for the next one
+		auto event = Event::create(state->objectA, handler, {});
+		const Event *first = event.get();
+		event.reset();
+		event = Event::create(state->objectB, handler, {{"param", 1}});
+		TESTEQUALS(event.get(), first);
+		TESTEQUALS(event->get_params().get<int>("param"), 1);
+	}
+}
+
+
+/**
+ * Creates a follow-up event when it is invoked.
+ */
+class FollowUpEventHandler : public EventHandler {
+public:
+	FollowUpEventHandler() :
+		EventHandler("follow_up", EventHandler::trigger_type::ONCE) {}
+
+	void setup_event(const std::shared_ptr<Event> & /*event*/,
+	                 const std::shared_ptr<State> & /*state*/) override {}
+
+	void invoke(EventLoop &loop,
+	            const std::shared_ptr<EventEntity> &target,
+	            const std::shared_ptr<State> &state,
+	            const time::time_t &time,
+	            const EventHandler::param_map & /*param*/) override {
+		loop.create_event("once", target, state, time + 1);
+	}
+
+	time::time_t predict_invoke_time(const std::shared_ptr<EventEntity> & /*target*/,
+	                                 const std::shared_ptr<State> & /*state*/,
+	                                 const time::time_t &at) override {
+		return at;
+	}
+};
+
+
+void loop_wakeup() {
+	using namespace std::chrono_literals;
+
+	log::log(DBG << "------------- [ Starting Test: Next event and wakeups ] ------------");
+	{
+		auto loop = std::make_shared<EventLoop>();
+		loop->add_event_handler(std::make_shared<EventTypeTestClass>(
+			"once",
+			EventHandler::trigger_type::ONCE));
+		loop->add_event_handler(std::make_shared<FollowUpEventHandler>());
+
+		int wakeups = 0;
+		loop->set_wakeup([&wakeups]() {
+			wakeups += 1;
+		});
+
+		auto state = std::make_shared<TestState>(loop);
+		auto gstate = std::static_pointer_cast<State>(state);
+		TESTEQUALS(loop->next_event_time(), time::TIME_MAX);
+
+		// events from outside of the loop wake it up
+		loop->create_event("follow_up", state->objectA, gstate, 3);
+		TESTEQUALS(wakeups, 1);
+		TESTEQUALS(loop->next_event_time(), 3);
+
+		// events created by handlers don't, "once" is always predicted for t=10
+		loop->reach_time(3, gstate);
+		TESTEQUALS(wakeups, 1);
+		TESTEQUALS(loop->next_event_time(), 10);
+	}
+
+	log::log(DBG << "------------- [ Starting Test: Batched wakeups ] ------------");
+	{
+		auto loop = std::make_shared<EventLoop>();
+		loop->add_event_handler(std::make_shared<FollowUpEventHandler>());
+
+		int wakeups = 0;
+		loop->set_wakeup([&wakeups]() {
+			wakeups += 1;
+		});
+
+		auto state = std::make_shared<TestState>(loop);
+		auto gstate = std::static_pointer_cast<State>(state);
+
+		// all events of a batch, including nested ones, wake up the loop once
+		loop->batch([&]() {
+			loop->create_event("follow_up", state->objectA, gstate, 5);
+			loop->create_event("follow_up", state->objectB, gstate, 4);
+			TESTEQUALS(wakeups, 0);
+
+			// the events are inserted into the queue together at the end
+			loop->batch([&]() {
+				loop->create_event("follow_up", state->objectA, gstate, 6);
+			});
+			TESTEQUALS(wakeups, 0);
+			TESTEQUALS(loop->get_queue().get_event_queue().size(), 0);
+		});
+		TESTEQUALS(wakeups, 1);
+		TESTEQUALS(loop->get_queue().get_event_queue().size(), 3);
+		TESTEQUALS(loop->next_event_time(), 4);
+
+		// accessing the queue during a batch inserts the collected events
+		loop->batch([&]() {
+			loop->create_event("follow_up", state->objectB, gstate, 2);
+			TESTEQUALS(loop->next_event_time(), 2);
+			TESTEQUALS(loop->get_queue().get_event_queue().size(), 4);
+			loop->create_event("follow_up", state->objectB, gstate, 8);
+		});
+		TESTEQUALS(wakeups, 2);
+		TESTEQUALS(loop->get_queue().get_event_queue().size(), 5);
+
+		// batches without events don't wake up the loop
+		loop->batch([]() {});
+		TESTEQUALS(wakeups, 2);
+
+		// events added before an exception are still inserted and wake up the loop
+		auto failing = [&]() {
+			loop->create_event("follow_up", state->objectB, gstate, 1);
+			throw Error{ERR << "batch failed"};
+		};
+		TESTTHROWS(loop->batch(failing));
+		TESTEQUALS(wakeups, 3);
+		TESTEQUALS(loop->next_event_time(), 1);
+
+		// the loop can be used normally after the batches
+		loop->create_event("follow_up", state->objectA, gstate, 7);
+		TESTEQUALS(wakeups, 4);
+		TESTEQUALS(loop->get_queue().get_event_queue().size(), 7);
+	}
+
+	log::log(DBG << "------------- [ Starting Test: Sleeping clock ] ------------");
+	{
+		// the time loop sleeps as well and updates the clock in between
+		time::TimeLoop time_loop;
+		std::thread time_thread{[&time_loop]() {
+			time_loop.run();
+		}};
+		time::Clock &clock = *time_loop.get_clock();
+		while (clock.get_state() != time::ClockState::RUNNING) {
+			std::this_thread::yield();
+		}
+
+		// starting the clock is a wakeup itself
+		auto begin = time::simclock_t::now();
+		clock.wait_until(time::TIME_MAX, 10s);
+		(time::simclock_t::now() - begin < 1s) or TESTFAIL;
+
+		// sleep until the simulation time is reached
+		auto target = clock.get_time() + time::time_t::from_double(0.1);
+		begin = time::simclock_t::now();
+		clock.wait_until(target, 10s);
+		auto slept = time::simclock_t::now() - begin;
+		(clock.get_time() >= target) or TESTFAIL;
+		(slept >= 90ms and slept < 1s) or TESTFAILMSG("slept for " << (slept / 1ms) << "ms");
+
+		// without a due event, only a wakeup ends the sleep
+		std::thread waker{[&clock]() {
+			std::this_thread::sleep_for(20ms);
+			clock.wake();
+		}};
+		begin = time::simclock_t::now();
+		clock.wait_until(time::TIME_MAX, 10s);
+		(time::simclock_t::now() - begin < 1s) or TESTFAIL;
+		waker.join();
+
+		// the clock must be updated before it stops advancing
+		TESTTHROWS(time_loop.set_update_interval(0ms));
+		TESTTHROWS(time_loop.set_update_interval(clock.get_max_tick_time()));
+		time_loop.set_update_interval(clock.get_max_tick_time() - 1ms);
+		target = clock.get_time() + time::time_t::from_double(0.2);
+		clock.wait_until(target, 10s);
+		(clock.get_time() >= target) or TESTFAIL;
+
+		// a paused clock doesn't reach any time
+		clock.pause();
+		clock.wait_until(time::TIME_MIN, 10s);
+		begin = time::simclock_t::now();
+		clock.wait_until(time::TIME_MIN, 50ms);
+		(time::simclock_t::now() - begin >= 40ms) or TESTFAIL;
+
+		time_loop.stop();
+		time_thread.join();
+	}
+}
+
+
+
+/**
+ * State with many objects for the parallel execution test.
+ */
+class ParallelTestState : public State {
+public:
+	ParallelTestState(const std::shared_ptr<EventLoop> &loop, int count) :
+		State(loop) {
+		for (int i = 0; i < count; i++) {
+			this->objects.push_back(std::make_shared<TestState::TestObject>(loop, i));
+		}
+	}
+
+	std::vector<std::shared_ptr<TestState::TestObject>> objects;
+
+	/** Sums of all numbers, seen by the sequential event. */
+	std::vector<int> sums;
+};
+
+
+/**
+ * Counts up the number of its target until t=10. Events on even objects
+ * depend on the next odd object, which joins them into one partition.
+ * Every third invocation creates a bonus event on the target.
+ */
+class ParallelCountHandler : public EventHandler {
+public:
+	ParallelCountHandler() :
+		EventHandler("parallel.count", EventHandler::trigger_type::REPEAT) {}
+
+	void setup_event(const std::shared_ptr<Event> &event,
+	                 const std::shared_ptr<State> &gstate) override {
+		auto state = std::dynamic_pointer_cast<ParallelTestState>(gstate);
+		auto target = event->get_entity().lock();
+		if (target->id() % 2 == 0) {
+			event->depend_on(state->objects.at(target->id() + 1));
+		}
+	}
+
+	void invoke(EventLoop &loop,
+	            const std::shared_ptr<EventEntity> &target,
+	            const std::shared_ptr<State> &state,
+	            const time::time_t &time,
+	            const EventHandler::param_map & /*param*/) override {
+		auto object = std::dynamic_pointer_cast<TestState::TestObject>(target);
+		object->set_number(object->number + 1, time);
+
+		// the bonuses are in the hundreds
+		if (object->number % 100 % 3 == 0) {
+			loop.create_event("parallel.bonus", target, state, time);
+		}
+	}
+
+	time::time_t predict_invoke_time(const std::shared_ptr<EventEntity> & /*target*/,
+	                                 const std::shared_ptr<State> & /*state*/,
+	                                 const time::time_t &at) override {
+		if (at >= 10) {
+			return time::TIME_MIN;
+		}
+		return at + 1;
+	}
+
+	bool is_parallel_safe() const override {
+		return true;
+	}
+};
+
+
+/**
+ * Adds a bonus to the number of its target.
+ */
+class ParallelBonusHandler : public EventHandler {
+public:
+	ParallelBonusHandler() :
+		EventHandler("parallel.bonus", EventHandler::trigger_type::ONCE) {}
+
+	void setup_event(const std::shared_ptr<Event> & /*event*/,
+	                 const std::shared_ptr<State> & /*state*/) override {}
+
+	void invoke(EventLoop & /*loop*/,
+	            const std::shared_ptr<EventEntity> &target,
+	            const std::shared_ptr<State> & /*state*/,
+	            const time::time_t & /*time*/,
+	            const EventHandler::param_map & /*param*/) override {
+		auto object = std::dynamic_pointer_cast<TestState::TestObject>(target);
+		object->number += 100;
+	}
+
+	time::time_t predict_invoke_time(const std::shared_ptr<EventEntity> & /*target*/,
+	                                 const std::shared_ptr<State> & /*state*/,
+	                                 const time::time_t &at) override {
+		return at + time::time_t::from_double(0.5);
+	}
+
+	bool is_parallel_safe() const override {
+		return true;
+	}
+};
+
+
+/**
+ * Reads the numbers of all objects, so it must not run in parallel.
+ */
+class SumHandler : public EventHandler {
+public:
+	SumHandler() :
+		EventHandler("parallel.sum", EventHandler::trigger_type::REPEAT) {}
+
+	void setup_event(const std::shared_ptr<Event> & /*event*/,
+	                 const std::shared_ptr<State> & /*state*/) override {}
+
+	void invoke(EventLoop & /*loop*/,
+	            const std::shared_ptr<EventEntity> & /*target*/,
+	            const std::shared_ptr<State> &gstate,
+	            const time::time_t & /*time*/,
+	            const EventHandler::param_map & /*param*/) override {
+		auto state = std::dynamic_pointer_cast<ParallelTestState>(gstate);
+		int sum = 0;
+		for (const auto &object : state->objects) {
+			sum += object->number;
+		}
+		state->sums.push_back(sum);
+	}
+
+	time::time_t predict_invoke_time(const std::shared_ptr<EventEntity> & /*target*/,
+	                                 const std::shared_ptr<State> & /*state*/,
+	                                 const time::time_t &at) override {
+		if (at >= 10) {
+			return time::TIME_MIN;
+		}
+		return at + 1;
+	}
+};
+
+
+/**
+ * Runs the events of the parallel execution test and returns the state.
+ */
+std::shared_ptr<ParallelTestState> run_parallel_events(const std::shared_ptr<job::JobManager> &manager) {
+	constexpr int object_count = 64;
+
+	auto loop = std::make_shared<EventLoop>();
+	loop->add_event_handler(std::make_shared<ParallelCountHandler>());
+	loop->add_event_handler(std::make_shared<ParallelBonusHandler>());
+	loop->add_event_handler(std::make_shared<SumHandler>());
+	loop->set_parallel_execution(manager);
+
+	auto state = std::make_shared<ParallelTestState>(loop, object_count);
+	auto gstate = std::static_pointer_cast<State>(state);
+	for (const auto &object : state->objects) {
+		loop->create_event("parallel.count", object, gstate, 0);
+	}
+	// the order of events at the same time is unspecified, so sum in between
+	loop->create_event("parallel.sum", state->objects.at(0), gstate, time::time_t::from_double(0.25));
+
+	for (int t = 1; t <= 12; t++) {
+		loop->reach_time(t, gstate);
+	}
+
+	return state;
+}
+
+
+void parallel_events() {
+	log::log(DBG << "------------- [ Starting Test: Parallel events ] ------------");
+
+	auto manager = std::make_shared<job::JobManager>(4);
+	manager->start();
+
+	auto sequential = run_parallel_events(nullptr);
+	auto parallel = run_parallel_events(manager);
+
+	manager->stop();
+
+	// every object counted to 10 and got 3 bonuses
+	for (const auto &object : sequential->objects) {
+		TESTEQUALS(object->number, 10 + 3 * 100);
+	}
+
+	// the parallel run has the same result, also in between
+	for (size_t i = 0; i < sequential->objects.size(); i++) {
+		TESTEQUALS(parallel->objects[i]->number, sequential->objects[i]->number);
+	}
+	TESTEQUALS(parallel->sums.size(), sequential->sums.size());
+	for (size_t i = 0; i < sequential->sums.size(); i++) {
+		TESTEQUALS(parallel->sums[i], sequential->sums[i]);
+	}
 }
 
 } // namespace openage::event::tests
@@ -1,7 +1,9 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2026 the openage authors. See copying.md for legal info.
 
 #include "activity.h"
 
+#include "gamestate/activity/program.h"
+
 
 namespace openage::gamestate::activity {
 
@@ -25,4 +27,11 @@ const std::shared_ptr<Node> &Activity::get_start() const {
 	return this->start;
 }
 
+const std::shared_ptr<const Program> &Activity::get_program() const {
+	std::call_once(this->compiled, [this]() {
+		this->program = Program::compile(*this);
+	});
+	return this->program;
+}
+
 } // namespace openage::gamestate::activity
@@ -1,14 +1,16 @@
-// Copyright 2023-2024 the openage authors. See copying.md for legal info.
+// Copyright 2023-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
 #include <cstddef>
 #include <memory>
+#include <mutex>
 #include <string>
 
 
 namespace openage::gamestate::activity {
 class Node;
+class Program;
 
 using activity_id = size_t;
 using activity_label = std::string;
@@ -50,6 +52,16 @@ public:
 	 */
 	const std::shared_ptr<Node> &get_start() const;
 
+	/**
+	 * Get the compiled node graph of this activity.
+	 *
+	 * The graph is compiled on the first call, so it must not be
+	 * changed afterwards.
+	 *
+	 * @return Compiled program.
+	 */
+	const std::shared_ptr<const Program> &get_program() const;
+
 private:
 	/**
 	 * Unique ID.
@@ -65,6 +77,16 @@ private:
 	 * Start node.
 	 */
 	std::shared_ptr<Node> start;
+
+	/**
+	 * Compiled node graph.
+	 */
+	mutable std::shared_ptr<const Program> program;
+
+	/**
+	 * Ensures that the graph is compiled once.
+	 */
+	mutable std::once_flag compiled;
 };
 
 } // namespace openage::gamestate::activity
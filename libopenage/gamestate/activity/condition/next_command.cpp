@@ -1,4 +1,4 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2026 the openage authors. See copying.md for legal info.
 
 #include "next_command.h"
 
@@ -10,8 +10,7 @@ namespace openage::gamestate::activity {
 
 bool next_command_idle(const time::time_t &time,
                        const std::shared_ptr<gamestate::GameEntity> &entity) {
-	auto command_queue = std::dynamic_pointer_cast<component::CommandQueue>(
-		entity->get_component(component::component_t::COMMANDQUEUE));
+	auto command_queue = entity->get_component<component::CommandQueue>();
 
 	if (command_queue->get_queue().empty(time)) {
 		return false;
@@ -23,8 +22,7 @@ bool next_command_idle(const time::time_t &time,
 
 bool next_command_move(const time::time_t &time,
                        const std::shared_ptr<gamestate::GameEntity> &entity) {
-	auto command_queue = std::dynamic_pointer_cast<component::CommandQueue>(
-		entity->get_component(component::component_t::COMMANDQUEUE));
+	auto command_queue = entity->get_component<component::CommandQueue>();
 
 	if (command_queue->get_queue().empty(time)) {
 		return false;
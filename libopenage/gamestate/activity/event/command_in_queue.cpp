@@ -1,4 +1,4 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2026 the openage authors. See copying.md for legal info.
 
 #include "command_in_queue.h"
 
@@ -17,15 +17,15 @@ std::shared_ptr<openage::event::Event> primer_command_in_queue(const time::time_
                                                                const std::shared_ptr<openage::event::EventLoop> &loop,
                                                                const std::shared_ptr<gamestate::GameState> &state,
                                                                size_t next_id) {
-	openage::event::EventHandler::param_map::map_t params{{"next", next_id}}; // move->get_id();
+	static const openage::event::ParamKey next_key{"next"};
+	openage::event::EventHandler::param_map params{{next_key, next_id}}; // move->get_id();
 	auto ev = loop->create_event("game.process_command",
 	                             entity->get_manager(),
 	                             state,
 	                             // event is not executed until a command is available
 	                             time::TIME_MAX,
 	                             params);
-	auto entity_queue = std::dynamic_pointer_cast<component::CommandQueue>(
-		entity->get_component(component::component_t::COMMANDQUEUE));
+	auto entity_queue = entity->get_component<component::CommandQueue>();
 	auto &queue = entity_queue->get_queue();
 	queue.add_dependent(ev);
 
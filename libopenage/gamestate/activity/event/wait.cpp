@@ -1,4 +1,4 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2026 the openage authors. See copying.md for legal info.
 
 #include "wait.h"
 
@@ -16,7 +16,8 @@ std::shared_ptr<openage::event::Event> primer_wait(const time::time_t &time,
                                                    const std::shared_ptr<openage::event::EventLoop> &loop,
                                                    const std::shared_ptr<gamestate::GameState> &state,
                                                    size_t next_id) {
-	openage::event::EventHandler::param_map::map_t params{{"next", next_id}};
+	static const openage::event::ParamKey next_key{"next"};
+	openage::event::EventHandler::param_map params{{next_key, next_id}};
 	auto ev = loop->create_event("game.wait",
 	                             entity->get_manager(),
 	                             state,
@@ -0,0 +1,135 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#include "program.h"
+
+#include <deque>
+#include <unordered_map>
+
+#include "error/error.h"
+#include "log/message.h"
+
+#include "gamestate/activity/activity.h"
+#include "gamestate/activity/start_node.h"
+#include "gamestate/activity/task_system_node.h"
+
+
+namespace openage::gamestate::activity {
+
+std::shared_ptr<const Program> Program::compile(const Activity &activity) {
+	auto program = std::shared_ptr<Program>(new Program{});
+
+	if (activity.get_start() == nullptr) [[unlikely]] {
+		throw Error{MSG(err) << "Activity " << activity.get_id() << " has no start node"};
+	}
+
+	// assign instructions to nodes in the order they are reached
+	std::unordered_map<const Node *, program_counter_t> pcs;
+	std::deque<std::shared_ptr<Node>> to_compile;
+	auto get_pc = [&](const std::shared_ptr<Node> &node) {
+		if (node == nullptr) [[unlikely]] {
+			throw Error{MSG(err) << "Activity " << activity.get_id() << " references an undefined node"};
+		}
+
+		auto [it, inserted] = pcs.try_emplace(node.get(), static_cast<program_counter_t>(pcs.size()));
+		if (inserted) {
+			to_compile.push_back(node);
+		}
+		return it->second;
+	};
+
+	get_pc(activity.get_start());
+	while (not to_compile.empty()) {
+		auto node = to_compile.front();
+		to_compile.pop_front();
+
+		instruction_t instruction{
+			node->get_type(),
+			0,
+			static_cast<uint32_t>(program->branches.size()),
+			0,
+			system::system_id_t::NONE,
+			0,
+		};
+
+		switch (node->get_type()) {
+		case node_t::START: {
+			auto start = std::static_pointer_cast<StartNode>(node);
+			instruction.next = get_pc(start->next(start->get_next()));
+		} break;
+		case node_t::END:
+			break;
+		case node_t::TASK_CUSTOM: {
+			auto task = std::static_pointer_cast<TaskCustom>(node);
+			instruction.task = static_cast<uint32_t>(program->tasks.size());
+			program->tasks.push_back(task->get_task_func());
+			instruction.next = get_pc(task->next(task->get_next()));
+		} break;
+		case node_t::TASK_SYSTEM: {
+			auto task = std::static_pointer_cast<TaskSystemNode>(node);
+			instruction.system_id = task->get_system_id();
+			instruction.next = get_pc(task->next(task->get_next()));
+		} break;
+		case node_t::XOR_GATE: {
+			auto gate = std::static_pointer_cast<XorGate>(node);
+			if (gate->get_default() == nullptr) [[unlikely]] {
+				throw Error{MSG(err) << "XorGate " << gate->str() << " has no default output"};
+			}
+			instruction.next = get_pc(gate->get_default());
+
+			// conditions are checked in the order of the map
+			for (const auto &[target_id, condition] : gate->get_conditions()) {
+				auto *condition_ptr = condition.target<condition_ptr_t>();
+				program->branches.push_back(branch_t{
+					get_pc(gate->next(target_id)),
+					target_id,
+					condition_ptr != nullptr ? *condition_ptr : nullptr,
+					static_cast<uint32_t>(program->conditions.size()),
+				});
+				program->conditions.push_back(condition);
+			}
+		} break;
+		case node_t::XOR_EVENT_GATE: {
+			auto gate = std::static_pointer_cast<XorEventGate>(node);
+			for (const auto &[target_id, primer] : gate->get_primers()) {
+				program->branches.push_back(branch_t{
+					get_pc(gate->next(target_id)),
+					target_id,
+					nullptr,
+					static_cast<uint32_t>(program->primers.size()),
+				});
+				program->primers.push_back(primer);
+			}
+		} break;
+		default:
+			throw Error{MSG(err) << "Unhandled node type for node " << node->str()};
+		}
+
+		instruction.branch_count = static_cast<uint32_t>(program->branches.size()) - instruction.first_branch;
+		program->instructions.push_back(instruction);
+		program->nodes.push_back(node);
+	}
+
+	return program;
+}
+
+const std::shared_ptr<Node> &Program::get_node(program_counter_t pc) const {
+	return this->nodes.at(pc);
+}
+
+program_counter_t Program::find_branch(program_counter_t pc, node_id_t target_id) const {
+	const auto &instruction = this->get(pc);
+	const branch_t *branches = this->get_branches(instruction);
+	for (uint32_t i = 0; i < instruction.branch_count; ++i) {
+		if (branches[i].target_id == target_id) {
+			return branches[i].target;
+		}
+	}
+
+	throw Error{MSG(err) << "Node " << this->get_node(pc)->str() << " has no output with id " << target_id};
+}
+
+size_t Program::size() const {
+	return this->instructions.size();
+}
+
+} // namespace openage::gamestate::activity
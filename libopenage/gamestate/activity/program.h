@@ -0,0 +1,240 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "gamestate/activity/node.h"
+#include "gamestate/activity/task_node.h"
+#include "gamestate/activity/types.h"
+#include "gamestate/activity/xor_event_gate.h"
+#include "gamestate/activity/xor_gate.h"
+#include "gamestate/system/types.h"
+#include "time/time.h"
+
+
+namespace openage {
+namespace event {
+class Event;
+class EventLoop;
+} // namespace event
+
+namespace gamestate {
+class GameEntity;
+class GameState;
+
+namespace activity {
+class Activity;
+
+/**
+ * Activity node graph compiled into a flat array of instructions.
+ *
+ * Every node of the graph becomes one instruction, and references to
+ * other nodes are resolved to instruction indices. A program is immutable
+ * after compilation, so all entities that execute the same activity share
+ * it and only have to store their current program counter.
+ */
+class Program {
+public:
+	/**
+	 * Condition function without state. Conditions that are plain functions
+	 * are called through a function pointer instead of a \p std::function.
+	 */
+	using condition_ptr_t = bool (*)(const time::time_t &,
+	                                 const std::shared_ptr<gamestate::GameEntity> &);
+
+	/**
+	 * Output of a gate.
+	 */
+	struct branch_t {
+		/**
+		 * Instruction of the output node.
+		 */
+		program_counter_t target;
+
+		/**
+		 * ID of the output node.
+		 */
+		node_id_t target_id;
+
+		/**
+		 * Condition as function pointer, \p nullptr if the condition has state.
+		 */
+		condition_ptr_t condition;
+
+		/**
+		 * Index of the condition function (XOR_GATE) or event
+		 * primer (XOR_EVENT_GATE) of the branch.
+		 */
+		uint32_t func;
+	};
+
+	/**
+	 * Instruction for one node of the graph.
+	 */
+	struct instruction_t {
+		/**
+		 * Type of the node.
+		 */
+		node_t type;
+
+		/**
+		 * Next instruction of START and task nodes, default output of XOR_GATE.
+		 */
+		program_counter_t next;
+
+		/**
+		 * Outputs of gates in \p branches: [first_branch, first_branch + branch_count).
+		 */
+		uint32_t first_branch;
+		uint32_t branch_count;
+
+		/**
+		 * System of TASK_SYSTEM nodes.
+		 */
+		system::system_id_t system_id;
+
+		/**
+		 * Index of the task function of TASK_CUSTOM nodes.
+		 */
+		uint32_t task;
+	};
+
+	/**
+	 * Compile the node graph of an activity.
+	 *
+	 * Only nodes that are reachable from the start node are compiled.
+	 *
+	 * @param activity Activity.
+	 *
+	 * @return Compiled program.
+	 */
+	static std::shared_ptr<const Program> compile(const Activity &activity);
+
+	/**
+	 * Get the instruction of the start node.
+	 *
+	 * @return Start instruction.
+	 */
+	program_counter_t get_start() const {
+		return 0;
+	}
+
+	/**
+	 * Get an instruction.
+	 *
+	 * @param pc Index of the instruction.
+	 *
+	 * @return Instruction.
+	 */
+	const instruction_t &get(program_counter_t pc) const {
+		return this->instructions[pc];
+	}
+
+	/**
+	 * Get the node that an instruction was compiled from.
+	 *
+	 * @param pc Index of the instruction.
+	 *
+	 * @return Node in the activity graph.
+	 */
+	const std::shared_ptr<Node> &get_node(program_counter_t pc) const;
+
+	/**
+	 * Get the outputs of a gate.
+	 *
+	 * @param instruction Instruction of the gate.
+	 *
+	 * @return Pointer to the first of \p instruction.branch_count outputs.
+	 */
+	const branch_t *get_branches(const instruction_t &instruction) const {
+		return this->branches.data() + instruction.first_branch;
+	}
+
+	/**
+	 * Get the output of a gate that leads to a node.
+	 *
+	 * @param pc Index of the gate instruction.
+	 * @param target_id ID of the output node.
+	 *
+	 * @return Instruction of the output node.
+	 */
+	program_counter_t find_branch(program_counter_t pc, node_id_t target_id) const;
+
+	/**
+	 * Check the condition of an XOR_GATE output.
+	 */
+	bool check_condition(const branch_t &branch,
+	                     const time::time_t &time,
+	                     const std::shared_ptr<gamestate::GameEntity> &entity) const {
+		if (branch.condition != nullptr) {
+			return branch.condition(time, entity);
+		}
+		return this->conditions[branch.func](time, entity);
+	}
+
+	/**
+	 * Run the task of a TASK_CUSTOM instruction.
+	 */
+	void run_task(const instruction_t &instruction,
+	              const time::time_t &time,
+	              const std::shared_ptr<gamestate::GameEntity> &entity) const {
+		this->tasks[instruction.task](time, entity);
+	}
+
+	/**
+	 * Create the event of an XOR_EVENT_GATE output.
+	 */
+	std::shared_ptr<openage::event::Event> prime_event(const branch_t &branch,
+	                                                   const time::time_t &time,
+	                                                   const std::shared_ptr<gamestate::GameEntity> &entity,
+	                                                   const std::shared_ptr<event::EventLoop> &loop,
+	                                                   const std::shared_ptr<gamestate::GameState> &state) const {
+		return this->primers[branch.func](time, entity, loop, state, branch.target_id);
+	}
+
+	/**
+	 * Get the number of instructions.
+	 */
+	size_t size() const;
+
+private:
+	Program() = default;
+
+	/**
+	 * Instructions, indexed by program counter.
+	 */
+	std::vector<instruction_t> instructions;
+
+	/**
+	 * Outputs of all gates.
+	 */
+	std::vector<branch_t> branches;
+
+	/**
+	 * Nodes that the instructions were compiled from.
+	 */
+	std::vector<std::shared_ptr<Node>> nodes;
+
+	/**
+	 * Condition functions of XOR_GATE outputs.
+	 */
+	std::vector<condition_t> conditions;
+
+	/**
+	 * Event primers of XOR_EVENT_GATE outputs.
+	 */
+	std::vector<event_primer_t> primers;
+
+	/**
+	 * Task functions of TASK_CUSTOM nodes.
+	 */
+	std::vector<task_func_t> tasks;
+};
+
+} // namespace activity
+} // namespace gamestate
+} // namespace openage
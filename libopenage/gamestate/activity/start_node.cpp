@@ -1,10 +1,13 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2026 the openage authors. See copying.md for legal info.
 
 #include "start_node.h"
 
 #include <unordered_map>
 #include <utility>
 
+#include "error/error.h"
+#include "log/message.h"
+
 
 namespace openage::gamestate::activity {
 
@@ -23,6 +26,10 @@ void StartNode::add_output(const std::shared_ptr<Node> &output) {
 }
 
 node_id_t StartNode::get_next() const {
+	if (this->outputs.empty()) [[unlikely]] {
+		throw Error{MSG(err) << "Node " << this->str() << " has no output"};
+	}
+
 	return (*this->outputs.begin()).first;
 }
 
@@ -1,9 +1,10 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2026 the openage authors. See copying.md for legal info.
 
 #include <cstddef>
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "event/event_loop.h"
 #include "event/evententity.h"
@@ -13,9 +14,12 @@
 #include "error/error.h"
 #include "log/log.h"
 #include "log/message.h"
+#include "testing/testing.h"
 
+#include "gamestate/activity/activity.h"
 #include "gamestate/activity/end_node.h"
 #include "gamestate/activity/node.h"
+#include "gamestate/activity/program.h"
 #include "gamestate/activity/start_node.h"
 #include "gamestate/activity/task_node.h"
 #include "gamestate/activity/types.h"
@@ -260,7 +264,7 @@ void activity_demo() {
 	                                      const std::shared_ptr<gamestate::GameState> & /* state */,
 	                                      size_t next_id) {
 		log::log(INFO << "Setting up event");
-		event::EventHandler::param_map::map_t params{{"next", next_id}};
+		event::EventHandler::param_map params{{"next", next_id}};
 		auto ev = loop->create_event("test.activity",
 		                             mgr,
 		                             state,
@@ -286,4 +290,149 @@ void activity_demo() {
 	loop->reach_time(0, state);
 }
 
+
+/**
+ * Condition without state, compiled to a function pointer.
+ */
+bool condition_true(const time::time_t & /* time */,
+                    const std::shared_ptr<gamestate::GameEntity> & /* entity */) {
+	return true;
+}
+
+
+/**
+ * Compiles an activity graph and checks the resolved instructions.
+ *
+ * Graph:
+ * Start -> Task 1 -> XOR -> Event -> Task 2 -> End
+ *
+ * XOR also has a conditional output to End and Task 2 as default output.
+ * Event also has an output to End.
+ */
+void activity_program() {
+	auto start = std::make_shared<activity::StartNode>(0);
+	auto task1 = std::make_shared<activity::TaskCustom>(1);
+	auto xor_node = std::make_shared<activity::XorGate>(2);
+	auto event_node = std::make_shared<activity::XorEventGate>(3);
+	auto task2 = std::make_shared<activity::TaskCustom>(4);
+	auto end = std::make_shared<activity::EndNode>(5);
+	auto unreachable = std::make_shared<activity::TaskCustom>(6);
+
+	start->add_output(task1);
+
+	size_t task_runs = 0;
+	task1->add_output(xor_node);
+	task1->set_task_func([&](const time::time_t & /* time */,
+	                         const std::shared_ptr<gamestate::GameEntity> & /* entity */) {
+		task_runs += 1;
+	});
+
+	bool end_condition = false;
+	xor_node->add_output(event_node, condition_true);
+	xor_node->add_output(end, [&](const time::time_t & /* time */, const std::shared_ptr<gamestate::GameEntity> & /* entity */) {
+		return end_condition;
+	});
+	xor_node->set_default(task2);
+
+	std::vector<size_t> primed;
+	activity::event_primer_t primer = [&](const time::time_t & /* time */,
+	                                      const std::shared_ptr<gamestate::GameEntity> & /* entity */,
+	                                      const std::shared_ptr<event::EventLoop> & /* loop */,
+	                                      const std::shared_ptr<gamestate::GameState> & /* state */,
+	                                      size_t next_id) {
+		primed.push_back(next_id);
+		return nullptr;
+	};
+	event_node->add_output(task2, primer);
+	event_node->add_output(end, primer);
+
+	task2->add_output(end);
+	task2->set_task_func([](const time::time_t & /* time */,
+	                        const std::shared_ptr<gamestate::GameEntity> & /* entity */) {});
+
+	unreachable->add_output(end);
+
+	activity::Activity activity{0, start};
+	auto program = activity.get_program();
+	TESTEQUALS(activity.get_program(), program);
+
+	// instructions are assigned in the order the nodes are reached
+	std::vector<std::shared_ptr<activity::Node>> nodes{start, task1, xor_node, task2, event_node, end};
+	TESTEQUALS(program->size(), nodes.size());
+	TESTEQUALS(program->get_start(), 0);
+	for (activity::program_counter_t pc = 0; pc < nodes.size(); ++pc) {
+		TESTEQUALS(program->get_node(pc), nodes[pc]);
+		TESTEQUALS(program->get(pc).type == nodes[pc]->get_type(), true);
+	}
+
+	// START and tasks continue with their output
+	TESTEQUALS(program->get(0).next, 1);
+	TESTEQUALS(program->get(1).next, 2);
+	TESTEQUALS(program->get(3).next, 5);
+	TESTEQUALS(program->get(0).branch_count, 0);
+	TESTEQUALS(program->get(5).branch_count, 0);
+
+	program->run_task(program->get(1), 0, nullptr);
+	TESTEQUALS(task_runs, 1);
+
+	// XOR_GATE: default output and conditions ordered by node ID
+	const auto &gate = program->get(2);
+	TESTEQUALS(gate.next, 3);
+	TESTEQUALS(gate.branch_count, 2);
+	const auto *gate_branches = program->get_branches(gate);
+	TESTEQUALS(gate_branches[0].target, 4);
+	TESTEQUALS(gate_branches[0].target_id, 3);
+	TESTEQUALS(gate_branches[1].target, 5);
+	TESTEQUALS(gate_branches[1].target_id, 5);
+
+	// stateless conditions are called through a function pointer
+	TESTEQUALS(gate_branches[0].condition == condition_true, true);
+	TESTEQUALS(gate_branches[1].condition == nullptr, true);
+	TESTEQUALS(program->check_condition(gate_branches[0], 0, nullptr), true);
+	TESTEQUALS(program->check_condition(gate_branches[1], 0, nullptr), false);
+	end_condition = true;
+	TESTEQUALS(program->check_condition(gate_branches[1], 0, nullptr), true);
+
+	// XOR_EVENT_GATE: one branch per event primer
+	const auto &event_gate = program->get(4);
+	TESTEQUALS(event_gate.branch_count, 2);
+	const auto *event_branches = program->get_branches(event_gate);
+	TESTEQUALS(event_branches[0].target, 3);
+	TESTEQUALS(event_branches[0].target_id, 4);
+	TESTEQUALS(event_branches[1].target, 5);
+	TESTEQUALS(event_branches[1].target_id, 5);
+
+	program->prime_event(event_branches[0], 0, nullptr, nullptr, nullptr);
+	program->prime_event(event_branches[1], 0, nullptr, nullptr, nullptr);
+	TESTEQUALS(primed == (std::vector<size_t>{4, 5}), true);
+
+	// find_branch resolves output node IDs of gates to instructions
+	TESTEQUALS(program->find_branch(4, 4), 3);
+	TESTEQUALS(program->find_branch(4, 5), 5);
+	TESTEQUALS(program->find_branch(2, 3), 4);
+	TESTTHROWS(program->find_branch(4, 1));
+	TESTTHROWS(program->find_branch(5, 5));
+
+	// nodes that are not reachable from the start node are not compiled
+	for (activity::program_counter_t pc = 0; pc < program->size(); ++pc) {
+		TESTEQUALS(program->get_node(pc) == unreachable, false);
+	}
+
+	// undefined next nodes
+	TESTTHROWS(activity::Program::compile(activity::Activity{1, nullptr}));
+
+	auto lone_start = std::make_shared<activity::StartNode>(0);
+	TESTTHROWS(activity::Program::compile(activity::Activity{2, lone_start}));
+
+	auto open_start = std::make_shared<activity::StartNode>(0);
+	open_start->add_output(std::make_shared<activity::TaskCustom>(1));
+	TESTTHROWS(activity::Program::compile(activity::Activity{3, open_start}));
+
+	auto no_default_start = std::make_shared<activity::StartNode>(0);
+	auto no_default_gate = std::make_shared<activity::XorGate>(1);
+	no_default_gate->add_output(end, condition_true);
+	no_default_start->add_output(no_default_gate);
+	TESTTHROWS(activity::Program::compile(activity::Activity{4, no_default_start}));
+}
+
 } // namespace openage::gamestate::tests
@@ -1,7 +1,9 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
+#include <cstdint>
+
 
 namespace openage::gamestate::activity {
 
@@ -17,4 +19,9 @@ enum class node_t {
 	TASK_SYSTEM,
 };
 
+/**
+ * Index of an instruction in a compiled activity program.
+ */
+using program_counter_t = uint32_t;
+
 } // namespace openage::gamestate::activity
@@ -0,0 +1,279 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#include "ability_cache.h"
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "gamestate/api/ability.h"
+#include "gamestate/api/animation.h"
+#include "gamestate/api/property.h"
+#include "gamestate/api/types.h"
+
+
+namespace openage::gamestate::api {
+
+namespace {
+
+/**
+ * Hash for looking up object names with string views.
+ */
+struct name_hash {
+	using is_transparent = void;
+
+	size_t operator()(std::string_view name) const {
+		return std::hash<std::string_view>{}(name);
+	}
+};
+
+/**
+ * Cached values of one type of ability.
+ *
+ * The cache subscribes to changes of the ability objects and of the
+ * objects that the values were read from. When a patch changes one of
+ * them, the values are read again on the next lookup.
+ *
+ * @tparam P Type of the values.
+ */
+template <typename P>
+class ParamsCache {
+public:
+	/**
+	 * Reads the values of an ability from the nyan database.
+	 *
+	 * Other objects than the ability that values were read from
+	 * are added to \p sources.
+	 */
+	using resolver_t = void (*)(const nyan::Object &ability,
+	                            P &params,
+	                            std::vector<nyan::Object> &sources);
+
+	std::shared_ptr<const P> get(const nyan::Object &ability, resolver_t resolve) {
+		const nyan::View *view = ability.get_view().get();
+		const auto &name = ability.get_name();
+
+		{
+			std::shared_lock lock{this->mutex};
+			auto entry = this->find(view, name);
+			if (entry != nullptr and entry->params != nullptr) {
+				return entry->params;
+			}
+		}
+
+		while (true) {
+			uint64_t version;
+			{
+				std::unique_lock lock{this->mutex};
+				auto &entry = this->views[view].try_emplace(name).first->second;
+				if (entry.params != nullptr) {
+					// another thread resolved the object meanwhile
+					return entry.params;
+				}
+				if (entry.notifiers.empty()) {
+					nyan::Object object = ability;
+					entry.notifiers.push_back(object.subscribe(this->on_change(view, name)));
+				}
+				version = entry.version;
+			}
+
+			auto params = std::make_shared<P>();
+			std::vector<nyan::Object> sources;
+			resolve(ability, *params, sources);
+
+			// notifiers must not be destroyed while the lock is held,
+			// because they deregister from the view
+			std::vector<std::shared_ptr<nyan::ObjectNotifier>> notifiers;
+			notifiers.reserve(sources.size() + 1);
+			for (auto &source : sources) {
+				notifiers.push_back(source.subscribe(this->on_change(view, name)));
+			}
+
+			std::unique_lock lock{this->mutex};
+			auto entry = this->find(view, name);
+			if (entry == nullptr) {
+				// the view was invalidated meanwhile
+				return params;
+			}
+			if (entry->version != version) {
+				// a patch was applied while the values were read
+				continue;
+			}
+
+			// keep the notifier of the ability, replace those of the sources
+			notifiers.insert(notifiers.begin(), entry->notifiers.front());
+			std::swap(entry->notifiers, notifiers);
+			entry->params = params;
+
+			return params;
+		}
+	}
+
+	void invalidate(const nyan::View *view) {
+		objects_t removed;
+		{
+			std::unique_lock lock{this->mutex};
+			auto entry = this->views.find(view);
+			if (entry == this->views.end()) {
+				return;
+			}
+			removed = std::move(entry->second);
+			this->views.erase(entry);
+		}
+	}
+
+	void clear() {
+		std::unordered_map<const nyan::View *, objects_t> removed;
+		{
+			std::unique_lock lock{this->mutex};
+			std::swap(removed, this->views);
+		}
+	}
+
+private:
+	struct object_entry {
+		/**
+		 * Values of the object. \p nullptr if they have to be read again.
+		 */
+		std::shared_ptr<const P> params;
+
+		/**
+		 * Incremented on every change of the object or its sources.
+		 */
+		uint64_t version = 0;
+
+		/**
+		 * Subscriptions to changes of the object, followed by those of its sources.
+		 */
+		std::vector<std::shared_ptr<nyan::ObjectNotifier>> notifiers;
+	};
+
+	/**
+	 * Cached objects by object name.
+	 */
+	using objects_t = std::unordered_map<nyan::fqon_t, object_entry, name_hash, std::equal_to<>>;
+
+	object_entry *find(const nyan::View *view, std::string_view name) {
+		auto objects = this->views.find(view);
+		if (objects == this->views.end()) {
+			return nullptr;
+		}
+
+		auto entry = objects->second.find(name);
+		if (entry == objects->second.end()) {
+			return nullptr;
+		}
+		return &entry->second;
+	}
+
+	/**
+	 * Create the change callback for an object.
+	 *
+	 * The entry is only marked as stale, because destroying its notifiers
+	 * from inside their own callback is not allowed.
+	 */
+	nyan::update_cb_t on_change(const nyan::View *view, const nyan::fqon_t &name) {
+		return [this, view, name](const nyan::order_t, const nyan::fqon_t &, const nyan::ObjectState &) {
+			std::unique_lock lock{this->mutex};
+			auto entry = this->find(view, name);
+			if (entry != nullptr) {
+				entry->params = nullptr;
+				entry->version += 1;
+			}
+		};
+	}
+
+	/**
+	 * Cached objects of each view.
+	 *
+	 * The notifiers keep the views alive until they are invalidated.
+	 */
+	std::unordered_map<const nyan::View *, objects_t> views;
+
+	std::shared_mutex mutex;
+};
+
+
+double get_speed(const std::shared_ptr<nyan::Float> &value) {
+	if (value->is_infinite_positive()) {
+		return std::numeric_limits<double>::infinity();
+	}
+	return static_cast<double>(value->get());
+}
+
+void resolve_ability(const nyan::Object &ability,
+                     AbilityParams &params,
+                     std::vector<nyan::Object> &sources) {
+	if (APIAbility::check_property(ability, ability_property_t::ANIMATED)) {
+		auto property = APIAbility::get_property(ability, ability_property_t::ANIMATED);
+		auto animations = APIAbilityProperty::get_animations(property);
+		params.animation_paths = APIAnimation::get_animation_paths(animations);
+
+		sources.push_back(property);
+		sources.insert(sources.end(), animations.begin(), animations.end());
+	}
+}
+
+void resolve_move(const nyan::Object &ability,
+                  MoveParams &params,
+                  std::vector<nyan::Object> &sources) {
+	resolve_ability(ability, params, sources);
+	params.speed = get_speed(ability.get<nyan::Float>("Move.speed"));
+}
+
+void resolve_turn(const nyan::Object &ability,
+                  TurnParams &params,
+                  std::vector<nyan::Object> &sources) {
+	resolve_ability(ability, params, sources);
+	params.turn_speed = get_speed(ability.get<nyan::Float>("Turn.turn_speed"));
+}
+
+ParamsCache<AbilityParams> &ability_cache() {
+	static ParamsCache<AbilityParams> cache;
+	return cache;
+}
+
+ParamsCache<MoveParams> &move_cache() {
+	static ParamsCache<MoveParams> cache;
+	return cache;
+}
+
+ParamsCache<TurnParams> &turn_cache() {
+	static ParamsCache<TurnParams> cache;
+	return cache;
+}
+
+} // namespace
+
+
+std::shared_ptr<const AbilityParams> AbilityCache::get_params(const nyan::Object &ability) {
+	return ability_cache().get(ability, resolve_ability);
+}
+
+std::shared_ptr<const MoveParams> AbilityCache::get_move_params(const nyan::Object &ability) {
+	return move_cache().get(ability, resolve_move);
+}
+
+std::shared_ptr<const TurnParams> AbilityCache::get_turn_params(const nyan::Object &ability) {
+	return turn_cache().get(ability, resolve_turn);
+}
+
+void AbilityCache::invalidate(const std::shared_ptr<nyan::View> &view) {
+	ability_cache().invalidate(view.get());
+	move_cache().invalidate(view.get());
+	turn_cache().invalidate(view.get());
+}
+
+void AbilityCache::clear() {
+	ability_cache().clear();
+	move_cache().clear();
+	turn_cache().clear();
+}
+
+} // namespace openage::gamestate::api
@@ -0,0 +1,104 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <nyan/nyan.h>
+
+
+namespace openage::gamestate::api {
+
+/**
+ * Values of an ability that are used by the game systems.
+ */
+struct AbilityParams {
+	/**
+	 * Paths of the animations of the \p Animated property.
+	 * Empty if the ability is not animated.
+	 */
+	std::vector<std::string> animation_paths;
+};
+
+/**
+ * Values of a \p Move ability (type == \p engine.ability.type.Move).
+ */
+struct MoveParams : public AbilityParams {
+	/**
+	 * Movement speed in tiles per second. Infinite for instant movement.
+	 */
+	double speed = 0;
+};
+
+/**
+ * Values of a \p Turn ability (type == \p engine.ability.type.Turn).
+ */
+struct TurnParams : public AbilityParams {
+	/**
+	 * Turn speed in degrees per second. Infinite for instant turning.
+	 */
+	double turn_speed = 0;
+};
+
+
+/**
+ * Cache for values of ability objects in the nyan API.
+ *
+ * Values are read from the nyan database once per ability object and view,
+ * so the game systems don't have to look up members by name every time
+ * they use an ability. The values are those of the latest state of the view.
+ *
+ * The cache subscribes to changes of the cached objects in the view. When
+ * patches are applied to them, e.g. by a tech upgrade, the values are read
+ * again on the next lookup.
+ *
+ * All methods are thread-safe.
+ */
+class AbilityCache {
+public:
+	/**
+	 * Get the values of an ability.
+	 *
+	 * @param ability \p Ability nyan object (type == \p engine.ability.Ability).
+	 *
+	 * @return Values of the ability.
+	 */
+	static std::shared_ptr<const AbilityParams> get_params(const nyan::Object &ability);
+
+	/**
+	 * Get the values of a \p Move ability.
+	 *
+	 * @param ability \p Move nyan object (type == \p engine.ability.type.Move).
+	 *
+	 * @return Values of the ability.
+	 */
+	static std::shared_ptr<const MoveParams> get_move_params(const nyan::Object &ability);
+
+	/**
+	 * Get the values of a \p Turn ability.
+	 *
+	 * @param ability \p Turn nyan object (type == \p engine.ability.type.Turn).
+	 *
+	 * @return Values of the ability.
+	 */
+	static std::shared_ptr<const TurnParams> get_turn_params(const nyan::Object &ability);
+
+	/**
+	 * Drop the cached values of all objects in a view.
+	 *
+	 * Must be called when the view is no longer used, because the
+	 * subscriptions to changes of the cached objects keep it alive.
+	 *
+	 * @param view nyan database view.
+	 */
+	static void invalidate(const std::shared_ptr<nyan::View> &view);
+
+	/**
+	 * Drop all cached values.
+	 */
+	static void clear();
+};
+
+} // namespace openage::gamestate::api
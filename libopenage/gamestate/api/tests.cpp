@@ -0,0 +1,106 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#include <memory>
+#include <string>
+
+#include <nyan/nyan.h>
+
+#include "testing/testing.h"
+
+#include "gamestate/api/ability_cache.h"
+
+
+namespace openage::gamestate::api::tests {
+
+namespace {
+
+/**
+ * Abilities with the members that are read by the cache.
+ */
+const std::string ability_cache_nyan = R"(!version 1
+
+Property():
+    pass
+
+Ability():
+    properties : dict(abstract(children(Property)), children(Property)) = {}
+
+Move(Ability):
+    speed : float
+
+Walk(Move):
+    speed = 1.0
+
+Run(Walk):
+    pass
+
+SpeedUp<Walk>():
+    speed = 3.0
+)";
+
+} // namespace
+
+
+void ability_cache() {
+	auto db = nyan::Database::create();
+	db->load("test.nyan", [](const std::string &filename) {
+		return std::make_shared<nyan::File>(filename, std::string{ability_cache_nyan});
+	});
+
+	auto view = db->new_view();
+	auto walk = view->get_object("test.Walk");
+	auto run = view->get_object("test.Run");
+
+	// values are only read on the first lookup
+	auto walk_params = AbilityCache::get_move_params(walk);
+	TESTEQUALS_FLOAT(walk_params->speed, 1.0, 1e-6);
+	TESTEQUALS(walk_params->animation_paths.empty(), true);
+	TESTEQUALS(AbilityCache::get_move_params(walk), walk_params);
+	TESTEQUALS(AbilityCache::get_move_params(view->get_object("test.Walk")), walk_params);
+
+	auto run_params = AbilityCache::get_move_params(run);
+	TESTEQUALS_FLOAT(run_params->speed, 1.0, 1e-6);
+	TESTEQUALS(AbilityCache::get_move_params(run), run_params);
+
+	// other views have their own values
+	auto child = view->new_child();
+	auto child_walk = child->get_object("test.Walk");
+	auto child_params = AbilityCache::get_move_params(child_walk);
+	TESTEQUALS(child_params == walk_params, false);
+	TESTEQUALS_FLOAT(child_params->speed, 1.0, 1e-6);
+
+	// patches in a view only change the values of that view
+	auto child_transaction = child->new_transaction(1);
+	child_transaction.add(child->get_object("test.SpeedUp"));
+	TESTEQUALS(child_transaction.commit(), true);
+
+	TESTEQUALS_FLOAT(AbilityCache::get_move_params(child_walk)->speed, 3.0, 1e-6);
+	TESTEQUALS(AbilityCache::get_move_params(walk), walk_params);
+
+	// patches change the values of the patched object and its children
+	auto transaction = view->new_transaction(2);
+	transaction.add(view->get_object("test.SpeedUp"));
+	TESTEQUALS(transaction.commit(), true);
+
+	auto patched_params = AbilityCache::get_move_params(walk);
+	TESTEQUALS(patched_params == walk_params, false);
+	TESTEQUALS_FLOAT(patched_params->speed, 3.0, 1e-6);
+	TESTEQUALS_FLOAT(AbilityCache::get_move_params(run)->speed, 3.0, 1e-6);
+	TESTEQUALS(AbilityCache::get_move_params(walk), patched_params);
+
+	// values that were returned before are not modified
+	TESTEQUALS_FLOAT(walk_params->speed, 1.0, 1e-6);
+
+	// invalidate() drops the values of one view
+	auto child_patched_params = AbilityCache::get_move_params(child_walk);
+	AbilityCache::invalidate(view);
+	auto reread_params = AbilityCache::get_move_params(walk);
+	TESTEQUALS(reread_params == patched_params, false);
+	TESTEQUALS_FLOAT(reread_params->speed, 3.0, 1e-6);
+	TESTEQUALS(AbilityCache::get_move_params(child_walk), child_patched_params);
+
+	AbilityCache::invalidate(view);
+	AbilityCache::invalidate(child);
+}
+
+} // namespace openage::gamestate::api::tests
@@ -1,4 +1,4 @@
-// Copyright 2021-2023 the openage authors. See copying.md for legal info.
+// Copyright 2021-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -11,6 +11,8 @@ class Idle : public APIComponent {
 public:
 	using APIComponent::APIComponent;
 
+	static constexpr component_t component_type = component_t::IDLE;
+
 	component_t get_type() const override;
 };
 
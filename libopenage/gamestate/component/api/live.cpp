@@ -1,4 +1,4 @@
-// Copyright 2021-2023 the openage authors. See copying.md for legal info.
+// Copyright 2021-2026 the openage authors. See copying.md for legal info.
 
 #include "live.h"
 
@@ -34,4 +34,12 @@ void Live::set_attribute(const time::time_t &time,
 		// TODO: fail here
 	}
 }
+
+void Live::compact(const time::time_t &time) {
+	APIComponent::compact(time);
+
+	this->attribute_values.compact(time, [&time](auto &attribute_value) {
+		attribute_value->compact(time);
+	});
+}
 } // namespace openage::gamestate::component
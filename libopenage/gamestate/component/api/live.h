@@ -1,4 +1,4 @@
-// Copyright 2021-2024 the openage authors. See copying.md for legal info.
+// Copyright 2021-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -18,6 +18,8 @@ class Live : public APIComponent {
 public:
 	using APIComponent::APIComponent;
 
+	static constexpr component_t component_type = component_t::LIVE;
+
 	component_t get_type() const override;
 
 	/**
@@ -42,6 +44,8 @@ public:
 	                   const nyan::fqon_t &attribute,
 	                   int64_t value);
 
+	void compact(const time::time_t &time) override;
+
 private:
 	using attribute_storage_t = curve::UnorderedMap<nyan::fqon_t,
 	                                                std::shared_ptr<curve::Discrete<int64_t>>>;
@@ -1,4 +1,4 @@
-// Copyright 2021-2023 the openage authors. See copying.md for legal info.
+// Copyright 2021-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -12,6 +12,8 @@ class Move : public APIComponent {
 public:
 	using APIComponent::APIComponent;
 
+	static constexpr component_t component_type = component_t::MOVE;
+
 	component_t get_type() const override;
 };
 
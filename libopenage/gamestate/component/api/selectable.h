@@ -1,4 +1,4 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -14,6 +14,8 @@ class Selectable : public APIComponent {
 public:
 	using APIComponent::APIComponent;
 
+	static constexpr component_t component_type = component_t::SELECTABLE;
+
 	component_t get_type() const override;
 };
 
@@ -1,4 +1,4 @@
-// Copyright 2021-2023 the openage authors. See copying.md for legal info.
+// Copyright 2021-2026 the openage authors. See copying.md for legal info.
 
 #include "api_component.h"
 
@@ -6,7 +6,7 @@
 namespace openage::gamestate::component {
 
 APIComponent::APIComponent(const std::shared_ptr<event::EventLoop> &loop,
-                           nyan::Object &ability,
+                           const nyan::Object &ability,
                            const time::time_t &creation_time,
                            const bool enabled) :
 	ability{ability},
@@ -15,7 +15,7 @@ APIComponent::APIComponent(const std::shared_ptr<event::EventLoop> &loop,
 }
 
 APIComponent::APIComponent(const std::shared_ptr<event::EventLoop> &loop,
-                           nyan::Object &ability,
+                           const nyan::Object &ability,
                            bool enabled) :
 	ability{ability},
 	enabled(loop, 0, "", nullptr, enabled) {
@@ -25,4 +25,8 @@ const nyan::Object &APIComponent::get_ability() const {
 	return this->ability;
 }
 
+void APIComponent::compact(const time::time_t &time) {
+	this->enabled.compact(time);
+}
+
 } // namespace openage::gamestate::component
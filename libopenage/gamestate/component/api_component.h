@@ -1,4 +1,4 @@
-// Copyright 2021-2024 the openage authors. See copying.md for legal info.
+// Copyright 2021-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -34,7 +34,7 @@ public:
 	 * @param enabled If true, enable the component at creation time.
 	 */
 	APIComponent(const std::shared_ptr<openage::event::EventLoop> &loop,
-	             nyan::Object &ability,
+	             const nyan::Object &ability,
 	             const time::time_t &creation_time,
 	             bool enabled = true);
 
@@ -46,7 +46,7 @@ public:
 	 * @param enabled If true, enable the component at creation time.
 	 */
 	APIComponent(const std::shared_ptr<openage::event::EventLoop> &loop,
-	             nyan::Object &ability,
+	             const nyan::Object &ability,
 	             bool enabled = true);
 
 	/**
@@ -56,6 +56,8 @@ public:
 	 */
 	const nyan::Object &get_ability() const;
 
+	void compact(const time::time_t &time) override;
+
 private:
 	/**
 	 * nyan object holding the data for the component.
@@ -1,8 +1,12 @@
-// Copyright 2021-2023 the openage authors. See copying.md for legal info.
+// Copyright 2021-2026 the openage authors. See copying.md for legal info.
 
 #include "base_component.h"
 
 namespace openage::gamestate::component {
 
+void Component::compact(const time::time_t & /* time */) {
+	// components without curves have no history
+}
+
 
 } // namespace openage::gamestate::component
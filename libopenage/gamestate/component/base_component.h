@@ -1,8 +1,9 @@
-// Copyright 2021-2024 the openage authors. See copying.md for legal info.
+// Copyright 2021-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
 #include "gamestate/component/types.h"
+#include "time/time.h"
 
 namespace openage::gamestate::component {
 
@@ -19,6 +20,14 @@ public:
 	 * @return Component type of the component.
 	 */
 	virtual component_t get_type() const = 0;
+
+	/**
+	 * Erase the history of the component's curves that is not required
+	 * to access their values at t >= \p time.
+	 *
+	 * @param time Retention horizon.
+	 */
+	virtual void compact(const time::time_t &time);
 };
 
 } // namespace openage::gamestate::component
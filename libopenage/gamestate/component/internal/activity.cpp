@@ -1,9 +1,10 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2026 the openage authors. See copying.md for legal info.
 
 #include "activity.h"
 
 #include "event/event.h"
 #include "gamestate/activity/activity.h"
+#include "gamestate/activity/program.h"
 #include "gamestate/component/internal/activity.h"
 
 
@@ -12,7 +13,8 @@ namespace openage::gamestate::component {
 Activity::Activity(const std::shared_ptr<openage::event::EventLoop> &loop,
                    const std::shared_ptr<activity::Activity> &start_activity) :
 	start_activity{start_activity},
-	node{loop, 0} {
+	program{start_activity->get_program()},
+	pc{loop, 0} {
 }
 
 component_t Activity::get_type() const {
@@ -23,17 +25,21 @@ const std::shared_ptr<activity::Activity> &Activity::get_start_activity() const
 	return this->start_activity;
 }
 
-const std::shared_ptr<activity::Node> Activity::get_node(const time::time_t &time) const {
-	return this->node.get(time);
+const std::shared_ptr<const activity::Program> &Activity::get_program() const {
+	return this->program;
 }
 
-void Activity::set_node(const time::time_t &time,
-                        const std::shared_ptr<activity::Node> &node) {
-	this->node.set_last(time, node);
+activity::program_counter_t Activity::get_program_counter(const time::time_t &time) const {
+	return this->pc.get(time);
+}
+
+void Activity::set_program_counter(const time::time_t &time,
+                                   activity::program_counter_t pc) {
+	this->pc.set_last(time, pc);
 }
 
 void Activity::init(const time::time_t &time) {
-	this->set_node(time, this->start_activity->get_start());
+	this->set_program_counter(time, this->program->get_start());
 }
 
 void Activity::add_event(const std::shared_ptr<event::Event> &event) {
@@ -47,4 +53,8 @@ void Activity::cancel_events(const time::time_t &time) {
 	this->scheduled_events.clear();
 }
 
+void Activity::compact(const time::time_t &time) {
+	this->pc.compact(time);
+}
+
 } // namespace openage::gamestate::component
@@ -1,4 +1,4 @@
-// Copyright 2021-2024 the openage authors. See copying.md for legal info.
+// Copyright 2021-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "curve/discrete.h"
+#include "gamestate/activity/types.h"
 #include "gamestate/component/internal_component.h"
 #include "gamestate/component/types.h"
 #include "time/time.h"
@@ -22,7 +23,7 @@ namespace gamestate {
 
 namespace activity {
 class Activity;
-class Node;
+class Program;
 } // namespace activity
 
 namespace component {
@@ -38,6 +39,8 @@ public:
 	Activity(const std::shared_ptr<openage::event::EventLoop> &loop,
 	         const std::shared_ptr<activity::Activity> &start_activity);
 
+	static constexpr component_t component_type = component_t::ACTIVITY;
+
 	component_t get_type() const override;
 
 	/**
@@ -48,21 +51,29 @@ public:
 	const std::shared_ptr<activity::Activity> &get_start_activity() const;
 
 	/**
-	 * Get the node in the activity flow graph at a given time.
+	 * Get the compiled flow graph of the start activity.
+	 *
+	 * @return Compiled program.
+	 */
+	const std::shared_ptr<const activity::Program> &get_program() const;
+
+	/**
+	 * Get the instruction of the current node in the compiled flow graph
+	 * at a given time.
 	 *
 	 * @param time Time at which the node is requested.
-	 * @return Current node in the flow graph.
+	 * @return Program counter of the current node.
 	 */
-	const std::shared_ptr<activity::Node> get_node(const time::time_t &time) const;
+	activity::program_counter_t get_program_counter(const time::time_t &time) const;
 
 	/**
-	 * Sets the current node in the activity flow graph at a given time.
+	 * Sets the current node in the compiled flow graph at a given time.
 	 *
 	 * @param time Time at which the node is set.
-	 * @param node Current node in the flow graph.
+	 * @param pc Program counter of the current node.
 	 */
-	void set_node(const time::time_t &time,
-	              const std::shared_ptr<activity::Node> &node);
+	void set_program_counter(const time::time_t &time,
+	                         activity::program_counter_t pc);
 
 	/**
 	 * Set the current node to the start node of the start activity.
@@ -85,6 +96,8 @@ public:
 	 */
 	void cancel_events(const time::time_t &time);
 
+	void compact(const time::time_t &time) override;
+
 private:
 	/**
 	 * Initial activity that encapsulates the entity's control flow graph.
@@ -97,9 +110,14 @@ private:
 	std::shared_ptr<activity::Activity> start_activity;
 
 	/**
-	 * Current node in the activity flow graph.
+	 * Compiled flow graph of the start activity.
+	 */
+	std::shared_ptr<const activity::Program> program;
+
+	/**
+	 * Program counter of the current node in the compiled flow graph.
 	 */
-	curve::Discrete<std::shared_ptr<activity::Node>> node;
+	curve::Discrete<activity::program_counter_t> pc;
 
 	/**
 	 * Scheduled events that are waited for to progress in the node graph.
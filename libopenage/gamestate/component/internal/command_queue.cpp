@@ -1,4 +1,4 @@
-// Copyright 2021-2023 the openage authors. See copying.md for legal info.
+// Copyright 2021-2026 the openage authors. See copying.md for legal info.
 
 #include "command_queue.h"
 
@@ -30,5 +30,9 @@ const std::shared_ptr<command::Command> CommandQueue::pop_command(const time::ti
 	return this->command_queue.pop_front(time);
 }
 
+void CommandQueue::compact(const time::time_t &time) {
+	this->command_queue.compact(time);
+}
+
 
 } // namespace openage::gamestate::component
@@ -1,4 +1,4 @@
-// Copyright 2021-2023 the openage authors. See copying.md for legal info.
+// Copyright 2021-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -28,6 +28,8 @@ public:
 	 */
 	CommandQueue(const std::shared_ptr<openage::event::EventLoop> &loop);
 
+	static constexpr component_t component_type = component_t::COMMANDQUEUE;
+
 	component_t get_type() const override;
 
 	/**
@@ -55,6 +57,8 @@ public:
 	 */
 	const std::shared_ptr<command::Command> pop_command(const time::time_t &time);
 
+	void compact(const time::time_t &time) override;
+
 private:
 	/**
 	 * Command queue.
@@ -1,15 +1,21 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2026 the openage authors. See copying.md for legal info.
 
 #include "move.h"
 
 
 namespace openage::gamestate::component::command {
 
-MoveCommand::MoveCommand(const coord::phys3 &target) :
-	target{target} {}
+MoveCommand::MoveCommand(const coord::phys3 &target,
+                         const std::shared_ptr<path::FlowField> &flow_field) :
+	target{target},
+	flow_field{flow_field} {}
 
 const coord::phys3 &MoveCommand::get_target() const {
 	return this->target;
 }
 
+const std::shared_ptr<path::FlowField> &MoveCommand::get_flow_field() const {
+	return this->flow_field;
+}
+
 } // namespace openage::gamestate::component::command
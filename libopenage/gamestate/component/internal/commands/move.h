@@ -1,13 +1,20 @@
-// Copyright 2023-2024 the openage authors. See copying.md for legal info.
+// Copyright 2023-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
+#include <memory>
+
 #include "coord/phys.h"
 #include "gamestate/component/internal/commands/base_command.h"
 #include "gamestate/component/internal/commands/types.h"
 
 
-namespace openage::gamestate::component::command {
+namespace openage {
+namespace path {
+class FlowField;
+} // namespace path
+
+namespace gamestate::component::command {
 
 /**
  * Command for moving to a target position.
@@ -18,8 +25,11 @@ public:
 	 * Creates a new move command.
 	 *
 	 * @param target Target position coordinates.
+	 * @param flow_field Flow field to the target that is shared by a group
+	 *                   of entities. Can be \p nullptr.
 	 */
-	MoveCommand(const coord::phys3 &target);
+	MoveCommand(const coord::phys3 &target,
+	            const std::shared_ptr<path::FlowField> &flow_field = nullptr);
 	virtual ~MoveCommand() = default;
 
 	inline command_t get_type() const override {
@@ -33,11 +43,24 @@ public:
 	 */
 	const coord::phys3 &get_target() const;
 
+	/**
+	 * Get the flow field to the target.
+	 *
+	 * @return Flow field. \p nullptr if the entity has to search its own path.
+	 */
+	const std::shared_ptr<path::FlowField> &get_flow_field() const;
+
 private:
 	/**
 	 * Target position.
 	 */
 	const coord::phys3 target;
+
+	/**
+	 * Flow field to the target.
+	 */
+	const std::shared_ptr<path::FlowField> flow_field;
 };
 
-} // namespace openage::gamestate::component::command
+} // namespace gamestate::component::command
+} // namespace openage
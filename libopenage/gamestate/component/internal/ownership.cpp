@@ -1,4 +1,4 @@
-// Copyright 2021-2023 the openage authors. See copying.md for legal info.
+// Copyright 2021-2026 the openage authors. See copying.md for legal info.
 
 #include "ownership.h"
 
@@ -30,4 +30,8 @@ const curve::Discrete<player_id_t> &Ownership::get_owners() const {
 	return this->owner;
 }
 
+void Ownership::compact(const time::time_t &time) {
+	this->owner.compact(time);
+}
+
 } // namespace openage::gamestate::component
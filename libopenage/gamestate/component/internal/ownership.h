@@ -1,4 +1,4 @@
-// Copyright 2021-2024 the openage authors. See copying.md for legal info.
+// Copyright 2021-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -39,6 +39,8 @@ public:
 	 */
 	Ownership(const std::shared_ptr<openage::event::EventLoop> &loop);
 
+	static constexpr component_t component_type = component_t::OWNERSHIP;
+
 	component_t get_type() const override;
 
 	/**
@@ -56,6 +58,8 @@ public:
 	 */
 	const curve::Discrete<player_id_t> &get_owners() const;
 
+	void compact(const time::time_t &time) override;
+
 private:
 	/**
 	 * Owner ID storage over time.
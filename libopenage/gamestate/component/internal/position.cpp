@@ -1,9 +1,10 @@
-// Copyright 2021-2023 the openage authors. See copying.md for legal info.
+// Copyright 2021-2026 the openage authors. See copying.md for legal info.
 
 #include "position.h"
 
 #include "gamestate/component/types.h"
 #include "gamestate/definitions.h"
+#include "gamestate/spatial_index.h"
 #include "util/fixed_point.h"
 
 
@@ -12,7 +13,9 @@ Position::Position(const std::shared_ptr<openage::event::EventLoop> &loop,
                    const coord::phys3 &initial_pos,
                    const time::time_t &creation_time) :
 	position(loop, 0, "", nullptr, WORLD_ORIGIN),
-	angle(loop, 0) {
+	angle(loop, 0),
+	spatial_index{nullptr},
+	entity{0} {
 	this->position.set_insert(creation_time, initial_pos);
 
 	// TODO: testing values
@@ -39,7 +42,15 @@ Position::Position(const std::shared_ptr<openage::event::EventLoop> &loop,
 
 Position::Position(const std::shared_ptr<openage::event::EventLoop> &loop) :
 	position(loop, 0, "", nullptr, WORLD_ORIGIN),
-	angle(loop, 0) {
+	angle(loop, 0),
+	spatial_index{nullptr},
+	entity{0} {
+}
+
+Position::~Position() {
+	if (this->spatial_index != nullptr) {
+		this->spatial_index->remove(this->entity);
+	}
 }
 
 inline component_t Position::get_type() const {
@@ -52,6 +63,24 @@ const curve::Continuous<coord::phys3> &Position::get_positions() const {
 
 void Position::set_position(const time::time_t &time, const coord::phys3 &pos) {
 	this->position.set_last(time, pos);
+
+	if (this->spatial_index != nullptr) {
+		this->spatial_index->update(this->entity, this->position, time);
+	}
+}
+
+void Position::set_spatial_index(entity_id_t entity,
+                                 const std::shared_ptr<SpatialIndex> &index) {
+	if (this->spatial_index != nullptr) {
+		this->spatial_index->remove(this->entity);
+	}
+
+	this->entity = entity;
+	this->spatial_index = index;
+
+	if (this->spatial_index != nullptr) {
+		this->spatial_index->update(this->entity, this->position);
+	}
 }
 
 const curve::Segmented<coord::phys_angle_t> &Position::get_angles() const {
@@ -63,4 +92,9 @@ void Position::set_angle(const time::time_t &time, const coord::phys_angle_t &an
 	this->angle.set_insert_jump(time, old_angle, angle);
 }
 
+void Position::compact(const time::time_t &time) {
+	this->position.compact(time);
+	this->angle.compact(time);
+}
+
 } // namespace openage::gamestate::component
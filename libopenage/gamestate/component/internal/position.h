@@ -1,4 +1,4 @@
-// Copyright 2021-2024 the openage authors. See copying.md for legal info.
+// Copyright 2021-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -10,6 +10,7 @@
 #include "curve/segmented.h"
 #include "gamestate/component/internal_component.h"
 #include "gamestate/component/types.h"
+#include "gamestate/types.h"
 #include "time/time.h"
 
 
@@ -18,7 +19,10 @@ namespace event {
 class EventLoop;
 }
 
-namespace gamestate::component {
+namespace gamestate {
+class SpatialIndex;
+
+namespace component {
 
 class Position : public InternalComponent {
 public:
@@ -40,6 +44,13 @@ public:
 	 */
 	Position(const std::shared_ptr<openage::event::EventLoop> &loop);
 
+	/**
+	 * Removes the entity from the spatial index.
+	 */
+	~Position();
+
+	static constexpr component_t component_type = component_t::POSITION;
+
 	component_t get_type() const override;
 
 	/**
@@ -59,6 +70,17 @@ public:
 	 */
 	void set_position(const time::time_t &time, const coord::phys3 &pos);
 
+	/**
+	 * Track the positions in a spatial index.
+	 *
+	 * The index is updated whenever a new position is set.
+	 *
+	 * @param entity ID of the entity that the component belongs to.
+	 * @param index Spatial index. Can be \p nullptr to stop tracking.
+	 */
+	void set_spatial_index(entity_id_t entity,
+	                       const std::shared_ptr<SpatialIndex> &index);
+
 	/**
 	 * Get the directions in degrees over time.
 	 *
@@ -76,6 +98,8 @@ public:
 	 */
 	void set_angle(const time::time_t &time, const coord::phys_angle_t &angle);
 
+	void compact(const time::time_t &time) override;
+
 private:
 	/**
 	 * Position storage over time.
@@ -91,7 +115,18 @@ private:
 	 * Rotation is clockwise, so at 90 degrees the entity is facing left.
 	 */
 	curve::Segmented<coord::phys_angle_t> angle;
+
+	/**
+	 * Spatial index that tracks the positions. Can be \p nullptr.
+	 */
+	std::shared_ptr<SpatialIndex> spatial_index;
+
+	/**
+	 * ID of the entity in the spatial index.
+	 */
+	entity_id_t entity;
 };
 
-} // namespace gamestate::component
+} // namespace component
+} // namespace gamestate
 } // namespace openage
@@ -1,7 +1,9 @@
-// Copyright 2021-2023 the openage authors. See copying.md for legal info.
+// Copyright 2021-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
+#include <cstddef>
+
 
 namespace openage::gamestate::component {
 
@@ -23,4 +25,9 @@ enum class component_t {
 	LIVE
 };
 
+/**
+ * Number of component types.
+ */
+constexpr size_t component_count = static_cast<size_t>(component_t::LIVE) + 1;
+
 } // namespace openage::gamestate::component
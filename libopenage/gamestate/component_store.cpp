@@ -0,0 +1,106 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#include "component_store.h"
+
+#include <algorithm>
+
+#include "error/error.h"
+#include "log/log.h"
+
+#include "gamestate/component/base_component.h"
+
+
+namespace openage::gamestate {
+
+void ComponentStore::add(entity_id_t entity,
+                         const std::shared_ptr<component::Component> &component) {
+	Table &table = this->table(component->get_type());
+
+	size_t idx = table.find(entity);
+	if (idx != Table::npos) {
+		table.components[idx] = component;
+		return;
+	}
+
+	table.set_index(entity, table.entities.size());
+	table.entities.push_back(entity);
+	table.components.push_back(component);
+}
+
+void ComponentStore::reserve(component::component_t type, size_t count) {
+	Table &table = this->table(type);
+
+	// keep the geometric growth so that many small batches stay cheap
+	size_t required = table.entities.size() + count;
+	if (required > table.entities.capacity()) {
+		required = std::max(required, 2 * table.entities.capacity());
+		table.entities.reserve(required);
+		table.components.reserve(required);
+	}
+}
+
+const std::shared_ptr<component::Component> &ComponentStore::get(entity_id_t entity,
+                                                                 component::component_t type) const {
+	const Table &table = this->table(type);
+
+	size_t idx = table.find(entity);
+	if (idx == Table::npos) [[unlikely]] {
+		throw Error(MSG(err) << "Game entity with ID " << entity
+		                     << " has no component of type " << static_cast<int>(type));
+	}
+	return table.components[idx];
+}
+
+bool ComponentStore::has(entity_id_t entity, component::component_t type) const {
+	return this->table(type).find(entity) != Table::npos;
+}
+
+void ComponentStore::remove(entity_id_t entity) {
+	for (Table &table : this->tables) {
+		size_t idx = table.find(entity);
+		if (idx == Table::npos) {
+			continue;
+		}
+
+		// move the last component into the gap
+		size_t last = table.entities.size() - 1;
+		if (idx != last) {
+			table.entities[idx] = table.entities[last];
+			table.components[idx] = std::move(table.components[last]);
+			table.set_index(table.entities[idx], idx);
+		}
+		table.entities.pop_back();
+		table.components.pop_back();
+		table.set_index(entity, Table::npos);
+	}
+}
+
+size_t ComponentStore::size(component::component_t type) const {
+	return this->table(type).entities.size();
+}
+
+const std::vector<entity_id_t> &ComponentStore::get_entities(component::component_t type) const {
+	return this->table(type).entities;
+}
+
+void ComponentStore::Table::set_index(entity_id_t entity, size_t index) {
+	size_t page = entity / page_size;
+	if (page >= this->sparse.size()) {
+		if (index == npos) {
+			return;
+		}
+		this->sparse.resize(page + 1);
+	}
+	if (this->sparse[page] == nullptr) {
+		if (index == npos) {
+			return;
+		}
+		this->sparse[page] = std::make_unique<page_t>();
+		this->sparse[page]->fill(0);
+	}
+
+	// npos + 1 wraps around to 0, i.e. no component
+	(*this->sparse[page])[entity % page_size] = static_cast<uint32_t>(index + 1);
+}
+
+} // namespace openage::gamestate
@@ -0,0 +1,223 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "gamestate/component/types.h"
+#include "gamestate/types.h"
+
+
+namespace openage::gamestate {
+
+namespace component {
+class Component;
+}
+
+/**
+ * Storage for the components of game entities.
+ *
+ * Components of each type are kept in their own table, which is a sparse
+ * set: a dense array of the components and the IDs of their entities, and
+ * a sparse array that maps entity IDs to positions in the dense array.
+ * Lookups by entity ID and type are O(1), and iterating over all entities
+ * with a set of components only touches the dense arrays of these types.
+ *
+ * Each entity can have at most one component of each type.
+ */
+class ComponentStore {
+public:
+	ComponentStore() = default;
+	~ComponentStore() = default;
+
+	/**
+	 * Add a component to an entity. Replaces the entity's component
+	 * of the same type if there is one.
+	 *
+	 * @param entity ID of the entity.
+	 * @param component Component to add.
+	 */
+	void add(entity_id_t entity,
+	         const std::shared_ptr<component::Component> &component);
+
+	/**
+	 * Preallocate storage for components of a type.
+	 *
+	 * @param type Component type.
+	 * @param count Number of components that are going to be added.
+	 */
+	void reserve(component::component_t type, size_t count);
+
+	/**
+	 * Get a component of an entity.
+	 *
+	 * Throws if the entity has no component of the given type.
+	 *
+	 * @param entity ID of the entity.
+	 * @param type Component type.
+	 *
+	 * @return Component of the entity.
+	 */
+	const std::shared_ptr<component::Component> &get(entity_id_t entity,
+	                                                 component::component_t type) const;
+
+	/**
+	 * Get a component of an entity by its class.
+	 *
+	 * @tparam T Component class. Must define \p component_type.
+	 *
+	 * @param entity ID of the entity.
+	 *
+	 * @return Component of the entity, or \p nullptr if the entity has
+	 *         no component of this type.
+	 */
+	template <typename T>
+	T *get(entity_id_t entity) const {
+		const Table &table = this->table(T::component_type);
+		size_t idx = table.find(entity);
+		if (idx == Table::npos) {
+			return nullptr;
+		}
+		return static_cast<T *>(table.components[idx].get());
+	}
+
+	/**
+	 * Check if an entity has a component of the given type.
+	 *
+	 * @param entity ID of the entity.
+	 * @param type Component type.
+	 */
+	bool has(entity_id_t entity, component::component_t type) const;
+
+	/**
+	 * Remove all components of an entity.
+	 *
+	 * @param entity ID of the entity.
+	 */
+	void remove(entity_id_t entity);
+
+	/**
+	 * Get the number of components of a type.
+	 *
+	 * @param type Component type.
+	 */
+	size_t size(component::component_t type) const;
+
+	/**
+	 * Get the IDs of all entities that have a component of a type.
+	 *
+	 * @param type Component type.
+	 *
+	 * @return Entity IDs, in the order of the component table.
+	 */
+	const std::vector<entity_id_t> &get_entities(component::component_t type) const;
+
+	/**
+	 * Call a function for every entity that has components of all
+	 * the given classes.
+	 *
+	 * Iterates over the smallest of the tables. The function must not
+	 * add or remove components.
+	 *
+	 * @tparam Ts Component classes. Each must define \p component_type.
+	 *
+	 * @param fn Function called with the entity ID and references to
+	 *           the entity's components, as fn(id, Ts &...).
+	 */
+	template <typename... Ts, typename F>
+	void each(F &&fn) const {
+		static_assert(sizeof...(Ts) > 0, "at least one component class is required");
+
+		const Table *smallest = nullptr;
+		for (component::component_t type : {Ts::component_type...}) {
+			const Table &table = this->table(type);
+			if (smallest == nullptr or table.entities.size() < smallest->entities.size()) {
+				smallest = &table;
+			}
+		}
+
+		for (entity_id_t entity : smallest->entities) {
+			if ((this->has(entity, Ts::component_type) and ...)) {
+				fn(entity, *this->get<Ts>(entity)...);
+			}
+		}
+	}
+
+private:
+	/**
+	 * Sparse set of the components of one type.
+	 */
+	struct Table {
+		/**
+		 * Marker for entities without a component in the table.
+		 */
+		static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+		/**
+		 * Number of entity IDs per page of the sparse array.
+		 */
+		static constexpr size_t page_size = 4096;
+
+		/**
+		 * Page of the sparse array. Stores the dense index + 1,
+		 * 0 for entities without a component.
+		 */
+		using page_t = std::array<uint32_t, page_size>;
+
+		/**
+		 * Get the dense index of an entity's component.
+		 *
+		 * @return Index, or \p npos if the entity has no component in this table.
+		 */
+		size_t find(entity_id_t entity) const {
+			size_t page = entity / page_size;
+			if (page >= this->sparse.size() or this->sparse[page] == nullptr) {
+				return npos;
+			}
+			return static_cast<size_t>((*this->sparse[page])[entity % page_size]) - 1;
+		}
+
+		/**
+		 * Set the dense index of an entity's component.
+		 *
+		 * @param index Index, or \p npos to remove the entity.
+		 */
+		void set_index(entity_id_t entity, size_t index);
+
+		/**
+		 * Sparse array: entity ID -> dense index. Pages are allocated
+		 * when an entity in their ID range gets a component.
+		 */
+		std::vector<std::unique_ptr<page_t>> sparse;
+
+		/**
+		 * Dense array of the entities that have a component in this table.
+		 */
+		std::vector<entity_id_t> entities;
+
+		/**
+		 * Dense array of the components, in the same order as \p entities.
+		 */
+		std::vector<std::shared_ptr<component::Component>> components;
+	};
+
+	const Table &table(component::component_t type) const {
+		return this->tables[static_cast<size_t>(type)];
+	}
+
+	Table &table(component::component_t type) {
+		return this->tables[static_cast<size_t>(type)];
+	}
+
+	/**
+	 * One table per component type.
+	 */
+	std::array<Table, component::component_count> tables;
+};
+
+} // namespace openage::gamestate
@@ -1,12 +1,16 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2026 the openage authors. See copying.md for legal info.
 
 #include "entity_factory.h"
 
 #include <cstdint>
 #include <deque>
 #include <mutex>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "error/error.h"
 
@@ -33,6 +37,7 @@
 #include "gamestate/component/internal/ownership.h"
 #include "gamestate/component/internal/position.h"
 #include "gamestate/component/types.h"
+#include "gamestate/component_store.h"
 #include "gamestate/game_entity.h"
 #include "gamestate/game_state.h"
 #include "gamestate/manager.h"
@@ -115,19 +120,101 @@ std::shared_ptr<GameEntity> EntityFactory::add_game_entity(const std::shared_ptr
                                                            const std::shared_ptr<GameState> &state,
                                                            player_id_t owner_id,
                                                            const nyan::fqon_t &nyan_entity) {
-	auto entity = std::make_shared<GameEntity>(this->get_next_entity_id());
-	entity->set_manager(std::make_shared<GameEntityManager>(loop, state, entity));
+	return this->add_game_entities(loop, state, owner_id, nyan_entity, 1).front();
+}
 
+std::vector<std::shared_ptr<GameEntity>> EntityFactory::add_game_entities(const std::shared_ptr<openage::event::EventLoop> &loop,
+                                                                          const std::shared_ptr<GameState> &state,
+                                                                          player_id_t owner_id,
+                                                                          const nyan::fqon_t &nyan_entity,
+                                                                          size_t count) {
 	// use the owner's data to initialize the entity
 	// this ensures that only the owner's tech upgrades apply
 	auto db_view = state->get_player(owner_id)->get_db_view();
-	init_components(loop, db_view, entity, nyan_entity);
+	auto prototype = this->get_template(db_view, nyan_entity);
+
+	const auto &component_store = state->get_component_store();
+	for (auto type : {component::component_t::POSITION,
+	                  component::component_t::OWNERSHIP,
+	                  component::component_t::COMMANDQUEUE,
+	                  component::component_t::ACTIVITY}) {
+		component_store->reserve(type, count);
+	}
+	for (const auto &ability : prototype->abilities) {
+		component_store->reserve(ability.first, count);
+	}
+
+	std::shared_ptr<renderer::RenderFactory> render_factory;
+	{
+		std::shared_lock lock{this->mutex};
+		render_factory = this->render_factory;
+	}
+
+	auto first_id = this->get_next_entity_ids(count);
+
+	std::vector<std::shared_ptr<GameEntity>> entities;
+	entities.reserve(count);
+	for (size_t i = 0; i < count; ++i) {
+		auto entity = std::make_shared<GameEntity>(first_id + i, component_store);
+		entity->set_manager(std::make_shared<GameEntityManager>(loop, state, entity));
 
-	if (this->render_factory) {
-		entity->set_render_entity(this->render_factory->add_world_render_entity());
+		init_components(loop, entity, *prototype);
+
+		if (render_factory) {
+			entity->set_render_entity(render_factory->add_world_render_entity());
+		}
+
+		entities.push_back(std::move(entity));
 	}
 
-	return entity;
+	return entities;
+}
+
+std::vector<std::shared_ptr<GameEntity>> EntityFactory::spawn_game_entities(const std::shared_ptr<openage::event::EventLoop> &loop,
+                                                                            const std::shared_ptr<GameState> &state,
+                                                                            const time::time_t &time,
+                                                                            const nyan::fqon_t &nyan_entity,
+                                                                            const std::vector<spawn_t> &spawns) {
+	// entities of the same owner are created together, owners in the order
+	// of their first spawn, so that the entity IDs are deterministic
+	std::vector<std::pair<player_id_t, std::vector<size_t>>> owner_spawns;
+	std::unordered_map<player_id_t, size_t> owner_index;
+	for (size_t i = 0; i < spawns.size(); ++i) {
+		auto [it, inserted] = owner_index.try_emplace(spawns[i].owner, owner_spawns.size());
+		if (inserted) {
+			owner_spawns.emplace_back(spawns[i].owner, std::vector<size_t>{});
+		}
+		owner_spawns[it->second].second.push_back(i);
+	}
+
+	std::vector<std::shared_ptr<GameEntity>> entities(spawns.size());
+	for (const auto &[owner_id, indices] : owner_spawns) {
+		auto owned = this->add_game_entities(loop, state, owner_id, nyan_entity, indices.size());
+		for (size_t i = 0; i < indices.size(); ++i) {
+			entities[indices[i]] = std::move(owned[i]);
+		}
+	}
+
+	loop->batch([&]() {
+		for (size_t i = 0; i < spawns.size(); ++i) {
+			const auto &entity = entities[i];
+
+			auto entity_pos = entity->get_component<component::Position>();
+			entity_pos->set_position(time, spawns[i].position);
+			entity_pos->set_angle(time, coord::phys_angle_t::from_int(315));
+
+			auto entity_owner = entity->get_component<component::Ownership>();
+			entity_owner->set_owner(time, spawns[i].owner);
+
+			auto activity = entity->get_component<component::Activity>();
+			activity->init(time);
+			entity->get_manager()->run_activity_system(time);
+
+			state->add_game_entity(entity);
+		}
+	});
+
+	return entities;
 }
 
 std::shared_ptr<Player> EntityFactory::add_player(const std::shared_ptr<openage::event::EventLoop> & /* loop */,
@@ -147,91 +234,176 @@ void EntityFactory::attach_renderer(const std::shared_ptr<renderer::RenderFactor
 	this->render_factory = render_factory;
 }
 
-void EntityFactory::init_components(const std::shared_ptr<openage::event::EventLoop> &loop,
-                                    const std::shared_ptr<nyan::View> &owner_db_view,
-                                    const std::shared_ptr<GameEntity> &entity,
-                                    const nyan::fqon_t &nyan_entity) {
-	auto position = std::make_shared<component::Position>(loop);
-	entity->add_component(position);
+void EntityFactory::invalidate(const std::shared_ptr<nyan::View> &db_view) {
+	// the notifiers deregister from the view, which is done after unlocking
+	std::unordered_map<nyan::fqon_t, template_entry> removed;
 
-	auto ownership = std::make_shared<component::Ownership>(loop);
-	entity->add_component(ownership);
+	std::unique_lock lock{this->mutex};
+	auto view_templates = this->templates.find(db_view.get());
+	if (view_templates == this->templates.end()) {
+		return;
+	}
+	removed = std::move(view_templates->second);
+	this->templates.erase(view_templates);
+}
 
-	auto command_queue = std::make_shared<component::CommandQueue>(loop);
-	entity->add_component(command_queue);
+std::shared_ptr<const EntityFactory::entity_template> EntityFactory::get_template(const std::shared_ptr<nyan::View> &owner_db_view,
+                                                                                  const nyan::fqon_t &nyan_entity) {
+	{
+		std::shared_lock lock{this->mutex};
+		auto view_templates = this->templates.find(owner_db_view.get());
+		if (view_templates != this->templates.end()) {
+			auto entry = view_templates->second.find(nyan_entity);
+			if (entry != view_templates->second.end() and entry->second.prototype != nullptr) {
+				return entry->second.prototype;
+			}
+		}
+	}
+
+	// replaced notifiers deregister from the view, which is done after unlocking
+	std::vector<std::shared_ptr<nyan::ObjectNotifier>> notifiers;
+
+	std::unique_lock lock{this->mutex};
+
+	auto &entry = this->templates[owner_db_view.get()][nyan_entity];
+	if (entry.prototype != nullptr) {
+		// another thread read the template meanwhile
+		return entry.prototype;
+	}
+
+	// read the template again when the entity, its abilities or
+	// their attribute settings are patched
+	auto on_change = [this, view = owner_db_view.get(), nyan_entity](const nyan::order_t,
+	                                                                   const nyan::fqon_t &,
+	                                                                   const nyan::ObjectState &) {
+		std::unique_lock lock{this->mutex};
+		auto view_templates = this->templates.find(view);
+		if (view_templates != this->templates.end()) {
+			auto entry = view_templates->second.find(nyan_entity);
+			if (entry != view_templates->second.end()) {
+				// notifiers must not be destroyed in their own callback
+				entry->second.prototype = nullptr;
+			}
+		}
+	};
+
+	auto prototype = std::make_shared<entity_template>();
 
 	auto nyan_obj = owner_db_view->get_object(nyan_entity);
+	notifiers.push_back(nyan_obj.subscribe(on_change));
 	nyan::set_t abilities = nyan_obj.get_set("GameEntity.abilities");
 
 	std::optional<nyan::Object> activity_ability;
 	for (const auto &ability_val : abilities) {
 		auto ability_fqon = std::dynamic_pointer_cast<nyan::ObjectValue>(ability_val.get_ptr())->get_name();
 		auto ability_obj = owner_db_view->get_object(ability_fqon);
+		notifiers.push_back(ability_obj.subscribe(on_change));
 
 		auto ability_parent = ability_obj.get_parents()[0];
 		if (ability_parent == "engine.ability.type.Move") {
-			auto move = std::make_shared<component::Move>(loop, ability_obj);
-			entity->add_component(move);
+			prototype->abilities.emplace_back(component::component_t::MOVE, ability_obj);
 		}
 		else if (ability_parent == "engine.ability.type.Turn") {
-			auto turn = std::make_shared<component::Turn>(loop, ability_obj);
-			entity->add_component(turn);
+			prototype->abilities.emplace_back(component::component_t::TURN, ability_obj);
 		}
 		else if (ability_parent == "engine.ability.type.Idle") {
-			auto idle = std::make_shared<component::Idle>(loop, ability_obj);
-			entity->add_component(idle);
+			prototype->abilities.emplace_back(component::component_t::IDLE, ability_obj);
 		}
 		else if (ability_parent == "engine.ability.type.Live") {
-			auto live = std::make_shared<component::Live>(loop, ability_obj);
-			entity->add_component(live);
+			prototype->abilities.emplace_back(component::component_t::LIVE, ability_obj);
 
 			auto attr_settings = ability_obj.get_set("Live.attributes");
 			for (auto &setting : attr_settings) {
 				auto setting_obj_val = std::dynamic_pointer_cast<nyan::ObjectValue>(setting.get_ptr());
 				auto setting_obj = owner_db_view->get_object(setting_obj_val->get_name());
+				notifiers.push_back(setting_obj.subscribe(on_change));
 				auto attribute = setting_obj.get_object("AttributeSetting.attribute");
 				auto start_value = setting_obj.get_int("AttributeSetting.starting_value");
 
-				live->add_attribute(time::TIME_MIN,
-				                    attribute.get_name(),
-				                    std::make_shared<curve::Discrete<int64_t>>(loop,
-				                                                               0,
-				                                                               "",
-				                                                               nullptr,
-				                                                               start_value));
+				prototype->attributes.emplace_back(attribute.get_name(), start_value);
 			}
 		}
 		else if (ability_parent == "engine.ability.type.Activity") {
 			activity_ability = ability_obj;
 		}
 		else if (ability_parent == "engine.ability.type.Selectable") {
-			auto selectable = std::make_shared<component::Selectable>(loop, ability_obj);
-			entity->add_component(selectable);
+			prototype->abilities.emplace_back(component::component_t::SELECTABLE, ability_obj);
 		}
 	}
 
 	if (activity_ability) {
-		init_activity(loop, owner_db_view, entity, activity_ability.value());
+		prototype->activity = this->get_activity(owner_db_view, activity_ability.value());
 	}
 	else {
-		auto activity = std::make_shared<component::Activity>(loop, create_test_activity());
-		entity->add_component(activity);
+		prototype->activity = create_test_activity();
 	}
+
+	entry.prototype = prototype;
+	std::swap(entry.notifiers, notifiers);
+
+	return prototype;
 }
 
-void EntityFactory::init_activity(const std::shared_ptr<openage::event::EventLoop> &loop,
-                                  const std::shared_ptr<nyan::View> &owner_db_view,
-                                  const std::shared_ptr<GameEntity> &entity,
-                                  const nyan::Object &ability) {
+void EntityFactory::init_components(const std::shared_ptr<openage::event::EventLoop> &loop,
+                                    const std::shared_ptr<GameEntity> &entity,
+                                    const entity_template &prototype) {
+	auto position = std::make_shared<component::Position>(loop);
+	entity->add_component(position);
+
+	auto ownership = std::make_shared<component::Ownership>(loop);
+	entity->add_component(ownership);
+
+	auto command_queue = std::make_shared<component::CommandQueue>(loop);
+	entity->add_component(command_queue);
+
+	for (const auto &[type, ability_obj] : prototype.abilities) {
+		switch (type) {
+		case component::component_t::MOVE: {
+			auto move = std::make_shared<component::Move>(loop, ability_obj);
+			entity->add_component(move);
+		} break;
+		case component::component_t::TURN: {
+			auto turn = std::make_shared<component::Turn>(loop, ability_obj);
+			entity->add_component(turn);
+		} break;
+		case component::component_t::IDLE: {
+			auto idle = std::make_shared<component::Idle>(loop, ability_obj);
+			entity->add_component(idle);
+		} break;
+		case component::component_t::LIVE: {
+			auto live = std::make_shared<component::Live>(loop, ability_obj);
+			entity->add_component(live);
+
+			for (const auto &[attribute, start_value] : prototype.attributes) {
+				live->add_attribute(time::TIME_MIN,
+				                    attribute,
+				                    std::make_shared<curve::Discrete<int64_t>>(loop,
+				                                                               0,
+				                                                               "",
+				                                                               nullptr,
+				                                                               start_value));
+			}
+		} break;
+		case component::component_t::SELECTABLE: {
+			auto selectable = std::make_shared<component::Selectable>(loop, ability_obj);
+			entity->add_component(selectable);
+		} break;
+		default:
+			throw Error{ERR << "Unhandled ability component type: " << static_cast<int>(type)};
+		}
+	}
+
+	auto activity = std::make_shared<component::Activity>(loop, prototype.activity);
+	entity->add_component(activity);
+}
+
+std::shared_ptr<activity::Activity> EntityFactory::get_activity(const std::shared_ptr<nyan::View> &owner_db_view,
+                                                                const nyan::Object &ability) {
 	nyan::Object graph = ability.get_object("Activity.graph");
 
 	// Check if the activity is already exists in the cache
 	if (this->activity_cache.contains(graph.get_name())) {
-		auto activity = this->activity_cache.at(graph.get_name());
-		auto component = std::make_shared<component::Activity>(loop, activity);
-		entity->add_component(component);
-
-		return;
+		return this->activity_cache.at(graph.get_name());
 	}
 
 	auto start_obj = api::APIActivity::get_start(graph);
@@ -354,13 +526,14 @@ void EntityFactory::init_activity(const std::shared_ptr<openage::event::EventLoo
 	auto activity = std::make_shared<activity::Activity>(0, start_node, graph.get_name());
 	this->activity_cache.insert({graph.get_name(), activity});
 
-	auto component = std::make_shared<component::Activity>(loop, activity);
-	entity->add_component(component);
+	return activity;
 }
 
-entity_id_t EntityFactory::get_next_entity_id() {
+entity_id_t EntityFactory::get_next_entity_ids(size_t count) {
+	std::unique_lock lock{this->mutex};
+
 	auto new_id = this->next_entity_id;
-	this->next_entity_id++;
+	this->next_entity_id += count;
 
 	return new_id;
 }
@@ -1,13 +1,21 @@
-// Copyright 2023-2024 the openage authors. See copying.md for legal info.
+// Copyright 2023-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <nyan/nyan.h>
 
+#include "coord/phys.h"
+#include "gamestate/component/types.h"
 #include "gamestate/types.h"
+#include "time/time.h"
 
 
 namespace openage {
@@ -59,6 +67,70 @@ public:
 	                                            player_id_t owner_id,
 	                                            const nyan::fqon_t &nyan_entity);
 
+	/**
+	 * Create multiple game entities of the same type at once.
+	 *
+	 * The nyan data of the entity is only read once per owner and entity type
+	 * and is then reused for all entities created from it, until patches change
+	 * it. Storage for the components is allocated for all entities in advance.
+	 * The entities get consecutive IDs.
+	 *
+	 * This just creates the entities. The caller is responsible for initializing
+	 * their components and placing them into the game.
+	 *
+	 * @param loop Event loop for the gamestate.
+	 * @param state State of the game.
+	 * @param owner_id ID of the player owning the entities.
+	 * @param nyan_entity fqon of the GameEntity data in the nyan database.
+	 * @param count Number of entities.
+	 *
+	 * @return New game entities.
+	 */
+	std::vector<std::shared_ptr<GameEntity>> add_game_entities(const std::shared_ptr<openage::event::EventLoop> &loop,
+	                                                           const std::shared_ptr<GameState> &state,
+	                                                           player_id_t owner_id,
+	                                                           const nyan::fqon_t &nyan_entity,
+	                                                           size_t count);
+
+	/**
+	 * Initial values of a game entity created by \p spawn_game_entities().
+	 */
+	struct spawn_t {
+		/**
+		 * ID of the player owning the entity.
+		 */
+		player_id_t owner;
+
+		/**
+		 * Position of the entity.
+		 */
+		coord::phys3 position;
+	};
+
+	/**
+	 * Create game entities of the same type and place them into the game.
+	 *
+	 * Initializes the components of the entities, starts their activities
+	 * and adds them to the game state. Events created by the activities are
+	 * inserted into the event queue together (see \p EventLoop::batch()).
+	 *
+	 * Entities of the same owner are created together and get consecutive IDs.
+	 * Owners are processed in the order of their first entry in \p spawns.
+	 *
+	 * @param loop Event loop for the gamestate.
+	 * @param state State of the game.
+	 * @param time Time at which the entities are spawned.
+	 * @param nyan_entity fqon of the GameEntity data in the nyan database.
+	 * @param spawns Owner and position of each entity.
+	 *
+	 * @return New game entities, in the order of \p spawns.
+	 */
+	std::vector<std::shared_ptr<GameEntity>> spawn_game_entities(const std::shared_ptr<openage::event::EventLoop> &loop,
+	                                                             const std::shared_ptr<GameState> &state,
+	                                                             const time::time_t &time,
+	                                                             const nyan::fqon_t &nyan_entity,
+	                                                             const std::vector<spawn_t> &spawns);
+
 	/**
 	 * Create a new player.
 	 *
@@ -75,6 +147,16 @@ public:
 	                                   const std::shared_ptr<GameState> &state,
 	                                   const nyan::fqon_t &player_setup);
 
+	/**
+	 * Drop the cached templates of a nyan view.
+	 *
+	 * Must be called before the view is discarded, e.g. when the game state
+	 * that owns the view is destroyed.
+	 *
+	 * @param db_view View of the nyan database.
+	 */
+	void invalidate(const std::shared_ptr<nyan::View> &db_view);
+
 	/**
 	 * Attach a renderer which enables graphical display options for all ingame entities.
 	 *
@@ -84,30 +166,86 @@ public:
 	void attach_renderer(const std::shared_ptr<renderer::RenderFactory> &render_factory);
 
 private:
+	/**
+	 * nyan data of a game entity type, as seen by one player.
+	 */
+	struct entity_template {
+		/**
+		 * Abilities that are added as components, in the order of
+		 * \p GameEntity.abilities.
+		 */
+		std::vector<std::pair<component::component_t, nyan::Object>> abilities;
+
+		/**
+		 * Attributes of the \p Live ability with their starting values.
+		 */
+		std::vector<std::pair<nyan::fqon_t, int64_t>> attributes;
+
+		/**
+		 * Activity of the entity.
+		 */
+		std::shared_ptr<activity::Activity> activity;
+	};
+
+	/**
+	 * Cached template of a game entity type.
+	 */
+	struct template_entry {
+		/**
+		 * Template of the game entity. \p nullptr if it has to be read again.
+		 */
+		std::shared_ptr<const entity_template> prototype;
+
+		/**
+		 * Subscriptions to changes of the nyan objects that the template was read from.
+		 */
+		std::vector<std::shared_ptr<nyan::ObjectNotifier>> notifiers;
+	};
+
+	/**
+	 * Get the template of a game entity type. The template is read from
+	 * the nyan database on the first call, and again after patches changed
+	 * the nyan objects it was read from.
+	 *
+	 * @param owner_db_view View of the nyan database of the player owning the entity.
+	 * @param nyan_entity fqon of the GameEntity data in the nyan database.
+	 *
+	 * @return Template of the game entity.
+	 */
+	std::shared_ptr<const entity_template> get_template(const std::shared_ptr<nyan::View> &owner_db_view,
+	                                                    const nyan::fqon_t &nyan_entity);
+
 	/**
 	 * Initialize components of a game entity.
 	 *
 	 * @param loop Event loop for the gamestate.
-	 * @param owner_db_view View of the nyan database of the player owning the entity.
 	 * @param entity Game entity.
-	 * @param nyan_entity fqon of the GameEntity data in the nyan database.
+	 * @param prototype Template of the game entity.
 	 */
 	void init_components(const std::shared_ptr<openage::event::EventLoop> &loop,
-	                     const std::shared_ptr<nyan::View> &owner_db_view,
 	                     const std::shared_ptr<GameEntity> &entity,
-	                     const nyan::fqon_t &nyan_entity);
+	                     const entity_template &prototype);
 
-	void init_activity(const std::shared_ptr<openage::event::EventLoop> &loop,
-	                   const std::shared_ptr<nyan::View> &owner_db_view,
-	                   const std::shared_ptr<GameEntity> &entity,
-	                   const nyan::Object &ability);
+	/**
+	 * Get the activity of an \p Activity ability. The activity graph is
+	 * created on the first call.
+	 *
+	 * @param owner_db_view View of the nyan database of the player owning the entity.
+	 * @param ability \p Activity nyan object.
+	 *
+	 * @return Activity.
+	 */
+	std::shared_ptr<activity::Activity> get_activity(const std::shared_ptr<nyan::View> &owner_db_view,
+	                                                 const nyan::Object &ability);
 
 	/**
-	 * Get a unique ID for creating a game entity.
+	 * Get unique IDs for creating game entities.
+	 *
+	 * @param count Number of IDs.
 	 *
-	 * @return Unique ID for a game entity.
+	 * @return First of \p count consecutive IDs.
 	 */
-	entity_id_t get_next_entity_id();
+	entity_id_t get_next_entity_ids(size_t count);
 
 	/**
 	 * Get a unique ID for creating a player.
@@ -131,7 +269,13 @@ private:
 	 */
 	std::shared_ptr<renderer::RenderFactory> render_factory;
 
-	// TODO: Cache created game entities.
+	/**
+	 * Cache for game entity templates by nyan view and fqon.
+	 *
+	 * The subscriptions of the templates keep the views alive until
+	 * they are invalidated.
+	 */
+	std::unordered_map<const nyan::View *, std::unordered_map<nyan::fqon_t, template_entry>> templates;
 
 	/**
 	 * Cache for activities.
@@ -1,4 +1,4 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2026 the openage authors. See copying.md for legal info.
 
 #include "send_command.h"
 
@@ -12,6 +12,8 @@
 #include "gamestate/game_entity.h"
 #include "gamestate/game_state.h"
 #include "gamestate/types.h"
+#include "pathfinding/flow_field.h"
+#include "pathfinding/hierarchical_pathfinder.h"
 
 
 namespace openage::gamestate {
@@ -26,6 +28,17 @@ class MoveCommand;
 
 namespace event {
 
+namespace {
+
+/**
+ * Minimum number of entities in a move command that share a flow field
+ * instead of searching their own paths.
+ */
+constexpr size_t flow_field_group_size = 8;
+
+} // namespace
+
+
 Commander::Commander(const std::shared_ptr<openage::event::EventLoop> &loop) :
 	openage::event::EventEntity{loop} {
 }
@@ -53,11 +66,25 @@ void SendCommandHandler::invoke(openage::event::EventLoop & /* loop */,
                                 const std::shared_ptr<openage::event::State> &state,
                                 const time::time_t &time,
                                 const param_map &params) {
+	static const openage::event::ParamKey type_key{"type"};
+	static const openage::event::ParamKey entity_ids_key{"entity_ids"};
+	static const openage::event::ParamKey target_key{"target"};
+
 	auto gstate = std::dynamic_pointer_cast<openage::gamestate::GameState>(state);
 
-	auto command_type = params.get("type", component::command::command_t::NONE);
-	std::vector<gamestate::entity_id_t> ids = params.get("entity_ids",
+	auto command_type = params.get(type_key, component::command::command_t::NONE);
+	std::vector<gamestate::entity_id_t> ids = params.get(entity_ids_key,
 	                                                     std::vector<gamestate::entity_id_t>{});
+
+	// large groups follow one flow field to the target
+	std::shared_ptr<path::FlowField> flow_field = nullptr;
+	if (command_type == component::command::command_t::MOVE
+	    and ids.size() >= flow_field_group_size
+	    and gstate->get_pathfinder() != nullptr) {
+		auto target = params.get(target_key, coord::phys3{0, 0, 0});
+		flow_field = gstate->get_pathfinder()->get_flow_field(target.to_tile());
+	}
+
 	for (auto id : ids) {
 		auto entity = gstate->get_game_entity(id);
 		auto command_queue = std::dynamic_pointer_cast<component::CommandQueue>(
@@ -71,8 +98,9 @@ void SendCommandHandler::invoke(openage::event::EventLoop & /* loop */,
 			command_queue->add_command(
 				time,
 				std::make_shared<component::command::MoveCommand>(
-					params.get("target",
-			                   coord::phys3{0, 0, 0})));
+					params.get(target_key,
+			                   coord::phys3{0, 0, 0}),
+					flow_field));
 			break;
 		default:
 			break;
@@ -1,4 +1,4 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2026 the openage authors. See copying.md for legal info.
 
 #include "spawn_entity.h"
 
@@ -9,16 +9,9 @@
 #include <nyan/nyan.h>
 
 #include "coord/phys.h"
-#include "gamestate/component/internal/activity.h"
-#include "gamestate/component/internal/command_queue.h"
-#include "gamestate/component/internal/ownership.h"
-#include "gamestate/component/internal/position.h"
-#include "gamestate/component/types.h"
 #include "gamestate/definitions.h"
 #include "gamestate/entity_factory.h"
-#include "gamestate/game_entity.h"
 #include "gamestate/game_state.h"
-#include "gamestate/manager.h"
 #include "gamestate/types.h"
 
 // TODO: Testing
@@ -175,28 +168,12 @@ void SpawnEntityHandler::invoke(openage::event::EventLoop & /* loop */,
 		index = 0;
 	}
 
-	// Create entity
-	player_id_t owner_id = params.get("owner", 0);
-	auto entity = this->factory->add_game_entity(this->loop, gstate, owner_id, nyan_entity);
+	static const openage::event::ParamKey owner_key{"owner"};
+	static const openage::event::ParamKey position_key{"position"};
 
-	// Setup components
-	auto entity_pos = std::dynamic_pointer_cast<component::Position>(
-		entity->get_component(component::component_t::POSITION));
-
-	auto pos = params.get("position", gamestate::WORLD_ORIGIN);
-	entity_pos->set_position(time, pos);
-	entity_pos->set_angle(time, coord::phys_angle_t::from_int(315));
-
-	auto entity_owner = std::dynamic_pointer_cast<component::Ownership>(
-		entity->get_component(component::component_t::OWNERSHIP));
-	entity_owner->set_owner(time, owner_id);
-
-	auto activity = std::dynamic_pointer_cast<component::Activity>(
-		entity->get_component(component::component_t::ACTIVITY));
-	activity->init(time);
-	entity->get_manager()->run_activity_system(time);
-
-	gstate->add_game_entity(entity);
+	player_id_t owner_id = params.get(owner_key, 0);
+	auto pos = params.get(position_key, gamestate::WORLD_ORIGIN);
+	this->factory->spawn_game_entities(this->loop, gstate, time, nyan_entity, {{owner_id, pos}});
 }
 
 time::time_t SpawnEntityHandler::predict_invoke_time(const std::shared_ptr<openage::event::EventEntity> & /* target */,
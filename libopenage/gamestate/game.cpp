@@ -1,4 +1,4 @@
-// Copyright 2018-2023 the openage authors. See copying.md for legal info.
+// Copyright 2018-2026 the openage authors. See copying.md for legal info.
 
 #include "game.h"
 
@@ -37,6 +37,7 @@ Game::Game(const std::shared_ptr<openage::event::EventLoop> &event_loop,
 	auto player2 = entity_factory->add_player(event_loop, state, "");
 	state->add_player(player1);
 	state->add_player(player2);
+	state->set_entity_factory(entity_factory);
 
 	// TODO: This lets the spawner event check which modpacks are loaded,
 	//       so that it can decide which entities it can spawn.
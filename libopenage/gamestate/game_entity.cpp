@@ -1,4 +1,4 @@
-// Copyright 2022-2023 the openage authors. See copying.md for legal info.
+// Copyright 2022-2026 the openage authors. See copying.md for legal info.
 
 #include "game_entity.h"
 
@@ -14,14 +14,47 @@
 namespace openage::gamestate {
 
 GameEntity::GameEntity(entity_id_t id) :
+	GameEntity{id, std::make_shared<ComponentStore>()} {
+}
+
+GameEntity::GameEntity(entity_id_t id,
+                       const std::shared_ptr<ComponentStore> &store) :
 	id{id},
-	components{},
+	components{store},
 	render_entity{nullptr} {
 }
 
+GameEntity::~GameEntity() {
+	// moved-from entities have no store
+	if (this->components != nullptr) {
+		this->components->remove(this->id);
+	}
+}
+
+GameEntity &GameEntity::operator=(GameEntity &&other) {
+	if (this != &other) {
+		if (this->components != nullptr) {
+			this->components->remove(this->id);
+		}
+		this->id = other.id;
+		this->components = std::move(other.components);
+		this->render_entity = std::move(other.render_entity);
+		this->manager = std::move(other.manager);
+	}
+	return *this;
+}
+
 std::shared_ptr<GameEntity> GameEntity::copy(entity_id_t id) {
-	auto copy = std::shared_ptr<GameEntity>(new GameEntity(*this));
-	copy->set_id(id);
+	auto copy = std::make_shared<GameEntity>(id, this->components);
+	copy->render_entity = this->render_entity;
+	copy->manager = this->manager;
+
+	for (size_t i = 0; i < component::component_count; ++i) {
+		auto type = static_cast<component::component_t>(i);
+		if (this->components->has(this->id, type)) {
+			copy->add_component(this->components->get(this->id, type));
+		}
+	}
 
 	return copy;
 }
@@ -45,32 +78,36 @@ const std::shared_ptr<GameEntityManager> &GameEntity::get_manager() const {
 }
 
 const std::shared_ptr<component::Component> &GameEntity::get_component(component::component_t type) {
-	return this->components.at(type);
+	return this->components->get(this->id, type);
 }
 
 void GameEntity::add_component(const std::shared_ptr<component::Component> &component) {
-	this->components.insert({component->get_type(), component});
+	this->components->add(this->id, component);
 }
 
 bool GameEntity::has_component(component::component_t type) {
-	return this->components.contains(type);
+	return this->components->has(this->id, type);
 }
 
 void GameEntity::render_update(const time::time_t &time,
                                const std::string &animation_path) {
 	if (this->render_entity != nullptr) {
-		const auto &pos = dynamic_pointer_cast<component::Position>(
-							  this->components.at(component::component_t::POSITION))
-		                      ->get_positions();
-		const auto &angle = dynamic_pointer_cast<component::Position>(
-								this->components.at(component::component_t::POSITION))
-		                        ->get_angles();
-		this->render_entity->update(this->id, pos, angle, animation_path, time);
+		auto position = this->get_component<component::Position>();
+		this->render_entity->update(this->id,
+		                            position->get_positions(),
+		                            position->get_angles(),
+		                            animation_path,
+		                            time);
 	}
 }
 
-void GameEntity::set_id(entity_id_t id) {
-	this->id = id;
+void GameEntity::compact(const time::time_t &time) {
+	for (size_t i = 0; i < component::component_count; ++i) {
+		auto type = static_cast<component::component_t>(i);
+		if (this->components->has(this->id, type)) {
+			this->components->get(this->id, type)->compact(time);
+		}
+	}
 }
 
 } // namespace openage::gamestate
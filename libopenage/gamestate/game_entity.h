@@ -1,12 +1,12 @@
-// Copyright 2022-2024 the openage authors. See copying.md for legal info.
+// Copyright 2022-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
 #include <memory>
 #include <string>
-#include <unordered_map>
 
 #include "gamestate/component/types.h"
+#include "gamestate/component_store.h"
 #include "gamestate/types.h"
 #include "time/time.h"
 
@@ -26,20 +26,35 @@ class Component;
 
 /**
  * Entity for a "physical" thing (unit, building, etc.) in the game world.
+ *
+ * The components of the entity are kept in a component store that
+ * is usually shared by all entities of a game state.
  */
 class GameEntity {
 public:
 	/**
-	 * Create a new game entity.
+	 * Create a new game entity with its own component store.
 	 *
 	 * @param id Unique identifier.
 	 */
 	GameEntity(entity_id_t id);
 
-	~GameEntity() = default;
+	/**
+	 * Create a new game entity.
+	 *
+	 * @param id Unique identifier.
+	 * @param store Store for the components of the entity.
+	 */
+	GameEntity(entity_id_t id,
+	           const std::shared_ptr<ComponentStore> &store);
+
+	/**
+	 * Removes the components of the entity from the component store.
+	 */
+	~GameEntity();
 
 	GameEntity(GameEntity &&) = default;
-	GameEntity &operator=(GameEntity &&) = default;
+	GameEntity &operator=(GameEntity &&other);
 
 	/**
 	 * Copy this game entity.
@@ -85,6 +100,18 @@ public:
 	 */
 	const std::shared_ptr<component::Component> &get_component(component::component_t type);
 
+	/**
+	 * Get a component of this entity by its class.
+	 *
+	 * @tparam T Component class.
+	 *
+	 * @return Component, or \p nullptr if the entity has no component of this class.
+	 */
+	template <typename T>
+	T *get_component() const {
+		return this->components->get<T>(this->id);
+	}
+
 	/**
 	 * Add a component to this entity.
 	 *
@@ -108,36 +135,35 @@ public:
 	void render_update(const time::time_t &time,
 	                   const std::string &animation_path);
 
-protected:
 	/**
-	 * A game entity cannot be default copied because of their unique ID.
+	 * Erase the history of all components that is not required to access
+	 * their values at t >= \p time.
 	 *
-	 * \p copy() must be used instead.
+	 * @param time Retention horizon.
 	 */
-	GameEntity(const GameEntity &) = default;
-	GameEntity &operator=(const GameEntity &) = default;
+	void compact(const time::time_t &time);
 
-private:
+protected:
 	/**
-	 * Set the unique identifier of this game entity.
-	 *
-	 * Only called by \p copy().
+	 * A game entity cannot be default copied because of their unique ID.
 	 *
-	 * @param id New ID.
+	 * \p copy() must be used instead.
 	 */
-	void set_id(entity_id_t id);
+	GameEntity(const GameEntity &) = delete;
+	GameEntity &operator=(const GameEntity &) = delete;
 
+private:
 	/**
 	 * Unique identifier.
 	 */
 	entity_id_t id;
 
 	/**
-	 * Data components.
+	 * Store of the data components.
 	 *
 	 * TODO: Multiple components of the same type.
 	 */
-	std::unordered_map<component::component_t, std::shared_ptr<component::Component>> components;
+	std::shared_ptr<ComponentStore> components;
 
 	/**
 	 * Render entity for pushing updates to the renderer. Can be \p nullptr.
@@ -1,4 +1,4 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2026 the openage authors. See copying.md for legal info.
 
 #include "game_state.h"
 
@@ -7,8 +7,15 @@
 #include "error/error.h"
 #include "log/log.h"
 
+#include "gamestate/api/ability_cache.h"
+#include "gamestate/component/internal/position.h"
+#include "gamestate/component_store.h"
+#include "gamestate/entity_factory.h"
 #include "gamestate/game_entity.h"
 #include "gamestate/player.h"
+#include "gamestate/spatial_index.h"
+#include "gamestate/terrain.h"
+#include "pathfinding/hierarchical_pathfinder.h"
 
 
 namespace openage::gamestate {
@@ -16,7 +23,23 @@ namespace openage::gamestate {
 GameState::GameState(const std::shared_ptr<nyan::Database> &db,
                      const std::shared_ptr<openage::event::EventLoop> &event_loop) :
 	event::State{event_loop},
-	db_view{db->new_view()} {
+	db_view{db->new_view()},
+	component_store{std::make_shared<ComponentStore>()},
+	spatial_index{std::make_shared<SpatialIndex>()} {
+}
+
+GameState::~GameState() {
+	api::AbilityCache::invalidate(this->db_view);
+	for (const auto &[id, player] : this->players) {
+		api::AbilityCache::invalidate(player->get_db_view());
+	}
+
+	if (this->entity_factory) {
+		this->entity_factory->invalidate(this->db_view);
+		for (const auto &[id, player] : this->players) {
+			this->entity_factory->invalidate(player->get_db_view());
+		}
+	}
 }
 
 const std::shared_ptr<nyan::View> &GameState::get_db_view() {
@@ -28,6 +51,10 @@ void GameState::add_game_entity(const std::shared_ptr<GameEntity> &entity) {
 		throw Error(MSG(err) << "Game entity with ID " << entity->get_id() << " already exists");
 	}
 	this->game_entities[entity->get_id()] = entity;
+
+	if (auto position = entity->get_component<component::Position>()) {
+		position->set_spatial_index(entity->get_id(), this->spatial_index);
+	}
 }
 
 void GameState::add_player(const std::shared_ptr<Player> &player) {
@@ -39,6 +66,7 @@ void GameState::add_player(const std::shared_ptr<Player> &player) {
 
 void GameState::set_terrain(const std::shared_ptr<Terrain> &terrain) {
 	this->terrain = terrain;
+	this->pathfinder = std::make_shared<path::HierarchicalPathfinder>(terrain->get_grid());
 }
 
 const std::shared_ptr<GameEntity> &GameState::get_game_entity(entity_id_t id) const {
@@ -52,6 +80,14 @@ const std::unordered_map<entity_id_t, std::shared_ptr<GameEntity>> &GameState::g
 	return this->game_entities;
 }
 
+const std::shared_ptr<ComponentStore> &GameState::get_component_store() const {
+	return this->component_store;
+}
+
+const std::shared_ptr<SpatialIndex> &GameState::get_spatial_index() const {
+	return this->spatial_index;
+}
+
 const std::shared_ptr<Player> &GameState::get_player(player_id_t id) const {
 	if (!this->players.contains(id)) [[unlikely]] {
 		throw Error(MSG(err) << "Player with ID " << id << " does not exist");
@@ -63,6 +99,21 @@ const std::shared_ptr<Terrain> &GameState::get_terrain() const {
 	return this->terrain;
 }
 
+const std::shared_ptr<path::HierarchicalPathfinder> &GameState::get_pathfinder() const {
+	return this->pathfinder;
+}
+
+void GameState::compact(const time::time_t &time) {
+	for (auto &entity : this->game_entities) {
+		entity.second->compact(time);
+	}
+	this->spatial_index->compact(time);
+}
+
+void GameState::set_entity_factory(const std::shared_ptr<EntityFactory> &entity_factory) {
+	this->entity_factory = entity_factory;
+}
+
 const std::shared_ptr<assets::ModManager> &GameState::get_mod_manager() const {
 	return this->mod_manager;
 }
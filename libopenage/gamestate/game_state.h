@@ -1,4 +1,4 @@
-// Copyright 2023-2024 the openage authors. See copying.md for legal info.
+// Copyright 2023-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -7,6 +7,7 @@
 
 #include "event/state.h"
 #include "gamestate/types.h"
+#include "time/time.h"
 
 
 namespace nyan {
@@ -24,9 +25,16 @@ namespace event {
 class EventLoop;
 }
 
+namespace path {
+class HierarchicalPathfinder;
+}
+
 namespace gamestate {
+class ComponentStore;
+class EntityFactory;
 class GameEntity;
 class Player;
+class SpatialIndex;
 class Terrain;
 
 /**
@@ -46,6 +54,12 @@ public:
 	explicit GameState(const std::shared_ptr<nyan::Database> &db,
 	                   const std::shared_ptr<openage::event::EventLoop> &event_loop);
 
+	/**
+	 * Drops the cached ability values and entity templates of the
+	 * database views of the game.
+	 */
+	~GameState();
+
 	/**
 	 * Get the nyan database view for the whole game.
 	 *
@@ -58,6 +72,8 @@ public:
 	/**
 	 * Add a new game entity to the index.
 	 *
+	 * If the entity has a position, it is also added to the spatial index.
+	 *
 	 * @param entity New game entity.
 	 */
 	void add_game_entity(const std::shared_ptr<GameEntity> &entity);
@@ -72,6 +88,9 @@ public:
 	/**
 	 * Set the terrain of the current game.
 	 *
+	 * Also creates the pathfinder for the terrain grid, so all chunks
+	 * should be added to the terrain before it is set.
+	 *
 	 * @param terrain Terrain object.
 	 */
 	void set_terrain(const std::shared_ptr<Terrain> &terrain);
@@ -92,6 +111,20 @@ public:
 	 */
 	const std::unordered_map<entity_id_t, std::shared_ptr<GameEntity>> &get_game_entities() const;
 
+	/**
+	 * Get the store for the components of the game entities.
+	 *
+	 * @return Component store.
+	 */
+	const std::shared_ptr<ComponentStore> &get_component_store() const;
+
+	/**
+	 * Get the spatial index of the positions of all game entities.
+	 *
+	 * @return Spatial index.
+	 */
+	const std::shared_ptr<SpatialIndex> &get_spatial_index() const;
+
 	/**
 	 * Get a player by its ID.
 	 *
@@ -108,6 +141,30 @@ public:
 	 */
 	const std::shared_ptr<Terrain> &get_terrain() const;
 
+	/**
+	 * Get the pathfinder for the terrain of the current game.
+	 *
+	 * @return Pathfinder object. \p nullptr if no terrain is set.
+	 */
+	const std::shared_ptr<path::HierarchicalPathfinder> &get_pathfinder() const;
+
+	/**
+	 * Erase the history of all game entities that is not required to access
+	 * the game state at t >= \p time.
+	 *
+	 * @param time Retention horizon.
+	 */
+	void compact(const time::time_t &time);
+
+	/**
+	 * Set the factory that creates the game entities of this game.
+	 *
+	 * Its cached entity templates are dropped when the game state is destroyed.
+	 *
+	 * @param entity_factory Entity factory.
+	 */
+	void set_entity_factory(const std::shared_ptr<EntityFactory> &entity_factory);
+
 	/**
 	 * TODO: Only for testing.
 	 */
@@ -125,6 +182,16 @@ private:
 	 */
 	std::unordered_map<entity_id_t, std::shared_ptr<GameEntity>> game_entities;
 
+	/**
+	 * Components of all game entities in the current game.
+	 */
+	std::shared_ptr<ComponentStore> component_store;
+
+	/**
+	 * Spatial index of the positions of all game entities.
+	 */
+	std::shared_ptr<SpatialIndex> spatial_index;
+
 	/**
 	 * Map of all players in the current game by their ID.
 	 */
@@ -135,6 +202,16 @@ private:
 	 */
 	std::shared_ptr<Terrain> terrain;
 
+	/**
+	 * Pathfinder for the terrain.
+	 */
+	std::shared_ptr<path::HierarchicalPathfinder> pathfinder;
+
+	/**
+	 * Factory that creates the game entities of this game.
+	 */
+	std::shared_ptr<EntityFactory> entity_factory;
+
 	/**
 	 * TODO: Only for testing
 	 */
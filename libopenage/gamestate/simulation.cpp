@@ -1,8 +1,14 @@
-// Copyright 2013-2024 the openage authors. See copying.md for legal info.
+// Copyright 2013-2026 the openage authors. See copying.md for legal info.
 
 #include "simulation.h"
 
+#include <array>
+#include <stdexcept>
+#include <string>
+
 #include "assets/mod_manager.h"
+#include "cvar/cvar.h"
+#include "error/error.h"
 #include "event/event_loop.h"
 #include "gamestate/entity_factory.h"
 #include "gamestate/event/drag_select.h"
@@ -20,6 +26,56 @@
 
 namespace openage::gamestate {
 
+namespace {
+
+/**
+ * Maximum real time the simulation loop sleeps without a wakeup.
+ */
+constexpr time::dt_ms_t max_sleep{1000};
+
+/**
+ * Default maximum number of ticks per simulation loop iteration.
+ */
+constexpr size_t default_max_catchup_ticks = 8;
+
+/**
+ * Names of the cvars registered by the simulation.
+ */
+constexpr std::array<const char *, 3> cvar_names{
+	"SIMULATION_HISTORY_RETENTION",
+	"SIMULATION_TICK_LENGTH",
+	"SIMULATION_REALTIME",
+};
+
+/**
+ * Parse the value of a cvar that is given in seconds.
+ *
+ * @param name Name of the cvar.
+ * @param value Value of the cvar.
+ *
+ * @return Parsed time.
+ */
+time::time_t parse_seconds(const std::string &name, const std::string &value) {
+	size_t parsed = 0;
+	double seconds = 0.0;
+	try {
+		seconds = std::stod(value, &parsed);
+	}
+	catch (const std::logic_error &) {
+		// std::invalid_argument and std::out_of_range
+		parsed = 0;
+	}
+
+	if (parsed == 0 or parsed != value.size()) {
+		throw Error{ERR << name << " must be a number of seconds, not: " << value};
+	}
+
+	return time::time_t::from_double(seconds);
+}
+
+} // namespace
+
+
 GameSimulation::GameSimulation(const util::Path &root_dir,
                                const std::shared_ptr<cvar::CVarManager> &cvar_manager,
                                const std::shared_ptr<openage::time::TimeLoop> time_loop) :
@@ -32,21 +88,76 @@ GameSimulation::GameSimulation(const util::Path &root_dir,
 	terrain_factory{std::make_shared<gamestate::TerrainFactory>()},
 	mod_manager{std::make_shared<assets::ModManager>(this->root_dir / "assets" / "converted")},
 	spawner{std::make_shared<gamestate::event::Spawner>(this->event_loop)},
-	commander{std::make_shared<gamestate::event::Commander>(this->event_loop)} {
+	commander{std::make_shared<gamestate::event::Commander>(this->event_loop)},
+	history_retention{time::TIME_ZERO},
+	last_compaction{time::TIME_MIN},
+	loop_mode{time::LoopMode::SLEEP},
+	tick_length{time::TIME_ZERO},
+	max_catchup_ticks{default_max_catchup_ticks},
+	realtime{true},
+	ticks{} {
 	auto mods = mod_manager->enumerate_modpacks(root_dir / "assets" / "converted");
 	for (const auto &mod : mods) {
 		this->mod_manager->register_modpack(mod);
 	}
 
+	this->init_cvars();
+
 	log::log(MSG(info) << "Created game simulation");
 }
 
 
+GameSimulation::~GameSimulation() {
+	// the accessors of the cvars reference this simulation
+	if (this->cvar_manager) {
+		for (auto name : cvar_names) {
+			this->cvar_manager->remove(name);
+		}
+	}
+}
+
+
 void GameSimulation::run() {
 	this->start();
+	auto clock = this->time_loop->get_clock();
 	while (this->running) {
-		time::time_t current_time = this->time_loop->get_clock()->get_time();
-		this->event_loop->reach_time(current_time, this->game->get_state());
+		time::LoopMode mode;
+		time::time_t tick_length;
+		size_t max_ticks;
+		bool realtime;
+		{
+			std::shared_lock lock{this->mutex};
+			mode = this->loop_mode;
+			tick_length = this->tick_length;
+			max_ticks = this->max_catchup_ticks;
+			realtime = this->realtime;
+		}
+
+		time::time_t current_time;
+		if (tick_length == time::TIME_ZERO) {
+			current_time = this->step_variable(clock, mode);
+		}
+		else if (not realtime) {
+			current_time = this->step_ticks(time::TIME_MAX, tick_length, max_ticks);
+		}
+		else {
+			auto now = clock->get_time();
+			current_time = this->step_ticks(now, tick_length, max_ticks);
+			if (current_time + tick_length <= now) {
+				// the simulation can't keep up with the clock, so skip the
+				// surplus ticks instead of executing an ever growing backlog
+				auto dropped = this->ticks.drop_backlog(now, tick_length);
+				current_time = this->ticks.get_time();
+				log::log(DBG << "Simulation is behind the clock, dropped " << dropped << " ticks");
+			}
+
+			if (mode == time::LoopMode::SLEEP) {
+				// ticks that are behind the clock are due immediately
+				clock->wait_until(current_time + tick_length, max_sleep);
+			}
+		}
+
+		this->compact_history(current_time);
 	}
 	log::log(MSG(info) << "Game simulation loop exited");
 }
@@ -63,6 +174,11 @@ void GameSimulation::start() {
 	                                               this->entity_factory,
 	                                               this->terrain_factory);
 
+	// wake up the sleeping simulation loop when other threads add events
+	this->event_loop->set_wakeup([clock = this->time_loop->get_clock()]() {
+		clock->wake();
+	});
+
 	this->running = true;
 
 	log::log(MSG(info) << "Game simulation started");
@@ -73,6 +189,7 @@ void GameSimulation::stop() {
 	std::unique_lock lock{this->mutex};
 
 	this->running = false;
+	this->time_loop->get_clock()->wake();
 
 	log::log(MSG(info) << "Game simulation stopped");
 }
@@ -133,6 +250,41 @@ void GameSimulation::set_modpacks(const std::vector<std::string> &modpacks) {
 	// TODO: Prevent setting modpacks if a game is already running
 }
 
+void GameSimulation::set_history_retention(const time::time_t &retention) {
+	ENSURE(retention >= time::TIME_ZERO, "history retention must not be negative");
+
+	std::unique_lock lock{this->mutex};
+	this->history_retention = retention;
+}
+
+void GameSimulation::set_loop_mode(time::LoopMode mode) {
+	std::unique_lock lock{this->mutex};
+	this->loop_mode = mode;
+}
+
+void GameSimulation::set_tick_length(const time::time_t &tick_length) {
+	ENSURE(tick_length >= time::TIME_ZERO, "tick length must not be negative");
+
+	std::unique_lock lock{this->mutex};
+	ENSURE(tick_length > time::TIME_ZERO or this->realtime,
+	       "simulation can only run faster than real time with fixed-length ticks");
+	this->tick_length = tick_length;
+}
+
+void GameSimulation::set_max_catchup_ticks(size_t max_ticks) {
+	ENSURE(max_ticks > 0, "at least one tick must be executed per loop iteration");
+
+	std::unique_lock lock{this->mutex};
+	this->max_catchup_ticks = max_ticks;
+}
+
+void GameSimulation::set_realtime(bool realtime) {
+	std::unique_lock lock{this->mutex};
+	ENSURE(realtime or this->tick_length > time::TIME_ZERO,
+	       "simulation can only run faster than real time with fixed-length ticks");
+	this->realtime = realtime;
+}
+
 void GameSimulation::init_event_handlers() {
 	auto drag_select_handler = std::make_shared<gamestate::event::DragSelectHandler>();
 	auto spawn_handler = std::make_shared<gamestate::event::SpawnEntityHandler>(this->event_loop,
@@ -147,4 +299,94 @@ void GameSimulation::init_event_handlers() {
 	this->event_loop->add_event_handler(wait_handler);
 }
 
+void GameSimulation::init_cvars() {
+	if (not this->cvar_manager) {
+		return;
+	}
+
+	this->cvar_manager->create(
+		cvar_names[0],
+		std::make_pair(
+			[this]() {
+				std::shared_lock lock{this->mutex};
+				return std::to_string(this->history_retention.to_double());
+			},
+			[this](const std::string &value) {
+				this->set_history_retention(parse_seconds(cvar_names[0], value));
+			}));
+	this->cvar_manager->create(
+		cvar_names[1],
+		std::make_pair(
+			[this]() {
+				std::shared_lock lock{this->mutex};
+				return std::to_string(this->tick_length.to_double());
+			},
+			[this](const std::string &value) {
+				this->set_tick_length(parse_seconds(cvar_names[1], value));
+			}));
+	this->cvar_manager->create(
+		cvar_names[2],
+		std::make_pair(
+			[this]() {
+				std::shared_lock lock{this->mutex};
+				return std::string{this->realtime ? "1" : "0"};
+			},
+			[this](const std::string &value) {
+				if (value != "0" and value != "1") {
+					throw Error{ERR << cvar_names[2] << " must be 0 or 1, not: " << value};
+				}
+				this->set_realtime(value == "1");
+			}));
+}
+
+void GameSimulation::compact_history(const time::time_t &current_time) {
+	time::time_t retention;
+	{
+		std::shared_lock lock{this->mutex};
+		retention = this->history_retention;
+	}
+
+	if (retention == time::TIME_ZERO) {
+		return;
+	}
+
+	// only compact when the horizon has moved by a significant amount
+	// so that the cost of visiting every curve is amortized
+	auto horizon = current_time - retention;
+	if (horizon < this->last_compaction + retention / 2) {
+		return;
+	}
+
+	this->game->get_state()->compact(horizon);
+	this->last_compaction = horizon;
+
+	log::log(DBG << "Compacted game state history before t=" << horizon);
+}
+
+time::time_t GameSimulation::step_variable(const std::shared_ptr<time::Clock> &clock,
+                                          time::LoopMode mode) {
+	time::time_t current_time = clock->get_time();
+	this->event_loop->reach_time(current_time, this->game->get_state());
+	this->ticks.set_time(current_time);
+
+	if (mode == time::LoopMode::SLEEP) {
+		// events added meanwhile by other threads wake up the clock,
+		// so they are not missed
+		clock->wait_until(this->event_loop->next_event_time(), max_sleep);
+	}
+
+	return current_time;
+}
+
+time::time_t GameSimulation::step_ticks(const time::time_t &target,
+                                       const time::time_t &tick_length,
+                                       size_t max_ticks) {
+	auto state = this->game->get_state();
+	this->ticks.step(target, tick_length, max_ticks, [&](const time::time_t &tick_time) {
+		this->event_loop->reach_time(tick_time, state);
+	});
+
+	return this->ticks.get_time();
+}
+
 } // namespace openage::gamestate
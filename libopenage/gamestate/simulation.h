@@ -1,9 +1,13 @@
-// Copyright 2013-2024 the openage authors. See copying.md for legal info.
+// Copyright 2013-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
+#include <cstddef>
+#include <memory>
 #include <shared_mutex>
 
+#include "time/tick_scheduler.h"
+#include "time/time.h"
 #include "util/path.h"
 
 namespace openage {
@@ -25,7 +29,9 @@ class RenderFactory;
 }
 
 namespace time {
+class Clock;
 class TimeLoop;
+enum class LoopMode;
 } // namespace time
 
 namespace gamestate {
@@ -61,7 +67,7 @@ public:
 	GameSimulation &operator=(const GameSimulation &copy) = delete;
 	GameSimulation(GameSimulation &&other) = delete;
 	GameSimulation &operator=(GameSimulation &&other) = delete;
-	~GameSimulation() = default;
+	~GameSimulation();
 
 	/**
 	 * Run the simulation loop.
@@ -136,6 +142,77 @@ public:
 	 */
 	void set_modpacks(const std::vector<std::string> &modpacks);
 
+	/**
+	 * Set how long the history of the game state is kept.
+	 *
+	 * Keyframes of game entity curves that are older than \p retention
+	 * (relative to the current simulation time) are periodically erased
+	 * from the simulation loop. This bounds the memory usage of long games.
+	 *
+	 * Can also be set with the cvar \p SIMULATION_HISTORY_RETENTION (in seconds).
+	 *
+	 * @param retention Time span of kept history. 0 keeps the whole history.
+	 */
+	void set_history_retention(const time::time_t &retention);
+
+	/**
+	 * Set how the simulation loop waits for events.
+	 *
+	 * In SLEEP mode (the default), the loop sleeps until the next queued
+	 * event is due, or until an event is added by another thread or the
+	 * clock is paused, resumed or changes speed. In SPIN mode, it executes
+	 * events continuously.
+	 *
+	 * @param mode Loop mode.
+	 */
+	void set_loop_mode(time::LoopMode mode);
+
+	/**
+	 * Set the length of the simulation ticks.
+	 *
+	 * With a tick length of 0 (the default), the simulation loop advances the
+	 * game state to the current clock time in each iteration, so the events
+	 * that are processed together depend on how fast the loop runs.
+	 *
+	 * With a positive tick length, the game state is advanced in discrete,
+	 * fixed-length ticks instead. The events processed per tick are the same
+	 * in every run, which makes runs reproducible and per-tick profiles
+	 * comparable.
+	 *
+	 * Can also be set with the cvar \p SIMULATION_TICK_LENGTH (in seconds).
+	 *
+	 * @param tick_length Simulated time per tick.
+	 */
+	void set_tick_length(const time::time_t &tick_length);
+
+	/**
+	 * Set how many ticks the simulation loop may execute per iteration to
+	 * catch up with the clock. If more ticks are due, the simulation can't
+	 * keep up with the clock and the surplus ticks are dropped, i.e. the
+	 * tick time jumps to the last tick before the clock time. The events of
+	 * the dropped ticks are then processed by the next tick.
+	 *
+	 * Only used with fixed-length ticks.
+	 *
+	 * @param max_ticks Maximum number of ticks per loop iteration.
+	 */
+	void set_max_catchup_ticks(size_t max_ticks);
+
+	/**
+	 * Set whether the simulation follows the clock.
+	 *
+	 * If \p realtime is false, the simulation executes its ticks as fast as
+	 * possible, independent of the clock, e.g. for headless AI matches or
+	 * benchmarks. The clock then no longer reflects the simulation time.
+	 * Requires fixed-length ticks.
+	 *
+	 * Can also be set with the cvar \p SIMULATION_REALTIME (0 or 1).
+	 *
+	 * @param realtime true to follow the clock (the default), false to run
+	 *                 faster than real time.
+	 */
+	void set_realtime(bool realtime);
+
 	/**
 	 * current simulation state variable.
 	 * to be set to false to stop the simulation loop.
@@ -148,6 +225,46 @@ private:
 	 */
 	void init_event_handlers();
 
+	/**
+	 * Register the cvars of the simulation in the cvar manager.
+	 *
+	 * The cvars are removed again when the simulation is destroyed.
+	 */
+	void init_cvars();
+
+	/**
+	 * Compact the game state history if the retention horizon has advanced
+	 * far enough since the last compaction.
+	 *
+	 * @param current_time Current simulation time.
+	 */
+	void compact_history(const time::time_t &current_time);
+
+	/**
+	 * Advance the game state to the current clock time in one step.
+	 *
+	 * @param clock Clock of the time loop.
+	 * @param mode How to wait for events.
+	 *
+	 * @return Time the game state was advanced to.
+	 */
+	time::time_t step_variable(const std::shared_ptr<time::Clock> &clock,
+	                           time::LoopMode mode);
+
+	/**
+	 * Advance the game state in fixed-length ticks until \p target is
+	 * reached or \p max_ticks ticks have been executed.
+	 *
+	 * @param target Time up to which ticks are executed.
+	 * @param tick_length Simulated time per tick.
+	 * @param max_ticks Maximum number of executed ticks.
+	 *
+	 * @return Time the game state was advanced to.
+	 */
+	time::time_t step_ticks(const time::time_t &target,
+	                        const time::time_t &tick_length,
+	                        size_t max_ticks);
+
 	/**
 	 * The simulation root directory.
 	 * Uses the openage fslike path abstraction that can mount paths into one.
@@ -196,6 +313,43 @@ private:
 	// TODO: The game run by the engine
 	std::shared_ptr<gamestate::Game> game;
 
+	/**
+	 * Time span for which the history of the game state is kept.
+	 * 0 keeps the whole history.
+	 */
+	time::time_t history_retention;
+
+	/**
+	 * Retention horizon of the last history compaction.
+	 */
+	time::time_t last_compaction;
+
+	/**
+	 * How the simulation loop waits for events.
+	 */
+	time::LoopMode loop_mode;
+
+	/**
+	 * Simulated time per tick. 0 advances the game state to the clock time
+	 * without fixed ticks.
+	 */
+	time::time_t tick_length;
+
+	/**
+	 * Maximum number of ticks per loop iteration.
+	 */
+	size_t max_catchup_ticks;
+
+	/**
+	 * Whether the simulation follows the clock or runs as fast as possible.
+	 */
+	bool realtime;
+
+	/**
+	 * Executes the fixed-length ticks. Only used by the simulation loop.
+	 */
+	time::TickScheduler ticks;
+
 	/**
 	 * Mutex for thread-safe access to the simulation.
 	 */
@@ -0,0 +1,413 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#include "spatial_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <tuple>
+#include <utility>
+
+#include "error/error.h"
+
+
+namespace openage::gamestate {
+
+namespace {
+
+/**
+ * Integer division that rounds towards negative infinity.
+ */
+int64_t floor_div(int64_t a, int64_t b) {
+	int64_t q = a / b;
+	if ((a % b != 0) and ((a < 0) != (b < 0))) {
+		q -= 1;
+	}
+	return q;
+}
+
+} // namespace
+
+
+SpatialIndex::SpatialIndex(size_t cell_size) :
+	cell_size_raw{coord::phys_t::from_int(cell_size).get_raw_value()} {
+	ENSURE(cell_size > 0, "cell size of the spatial index must be positive");
+}
+
+void SpatialIndex::update(entity_id_t entity,
+                          const curve::Continuous<coord::phys3> &positions,
+                          const time::time_t &changed) {
+	const auto &container = positions.get_container();
+
+	// keyframes up to the last one before the change are still the same
+	size_t first = 0;
+	if (changed != time::TIME_MIN) {
+		first = container.last_before(changed);
+		if (container.get(first).time() >= changed) {
+			first = 0;
+		}
+	}
+	auto from = container.get(first).time();
+
+	std::unique_lock lock{this->mutex};
+
+	auto &sections = this->entities[entity];
+	while (not sections.empty() and sections.back().end > from) {
+		this->erase(entity, sections.back());
+		sections.pop_back();
+	}
+
+	for (size_t i = first; i < container.size(); ++i) {
+		auto keyframe = container.get(i);
+
+		// the default value of the curve before the first keyframe is not indexed
+		if (keyframe.time() == time::TIME_MIN) {
+			continue;
+		}
+
+		section_t section{
+			keyframe.time(),
+			time::TIME_MAX,
+			keyframe.val(),
+			keyframe.val(),
+			{},
+			{},
+		};
+		if (i + 1 < container.size()) {
+			auto next = container.get(i + 1);
+			if (next.time() == keyframe.time()) {
+				// the position jumps, only the last value at this time is used
+				continue;
+			}
+			section.end = next.time();
+			section.end_pos = next.val();
+		}
+
+		auto start_cell = this->get_cell(section.start_pos);
+		auto end_cell = this->get_cell(section.end_pos);
+		section.min_cell = {std::min(start_cell.ne, end_cell.ne),
+		                    std::min(start_cell.se, end_cell.se)};
+		section.max_cell = {std::max(start_cell.ne, end_cell.ne),
+		                    std::max(start_cell.se, end_cell.se)};
+
+		this->insert(entity, section);
+		sections.push_back(section);
+	}
+}
+
+void SpatialIndex::remove(entity_id_t entity) {
+	std::unique_lock lock{this->mutex};
+
+	auto it = this->entities.find(entity);
+	if (it == this->entities.end()) {
+		return;
+	}
+
+	for (const auto &section : it->second) {
+		this->erase(entity, section);
+	}
+	this->entities.erase(it);
+}
+
+std::vector<entity_id_t> SpatialIndex::find_in_rect(const time::time_t &time,
+                                                    const coord::phys2 &corner0,
+                                                    const coord::phys2 &corner1) const {
+	coord::phys2 min{std::min(corner0.ne, corner1.ne), std::min(corner0.se, corner1.se)};
+	coord::phys2 max{std::max(corner0.ne, corner1.ne), std::max(corner0.se, corner1.se)};
+
+	std::vector<entity_id_t> result;
+
+	std::unique_lock lock{this->mutex};
+	this->visit(time,
+	            this->get_cell(min.to_phys3()),
+	            this->get_cell(max.to_phys3()),
+	            [&](entity_id_t entity, const coord::phys3 &pos) {
+					if (pos.ne >= min.ne and pos.ne <= max.ne
+				        and pos.se >= min.se and pos.se <= max.se) {
+						result.push_back(entity);
+					}
+				});
+
+	return result;
+}
+
+std::vector<entity_id_t> SpatialIndex::find_in_radius(const time::time_t &time,
+                                                      const coord::phys3 &center,
+                                                      double radius) const {
+	auto extent = coord::phys3_delta{coord::phys_t::from_double(radius),
+	                                 coord::phys_t::from_double(radius),
+	                                 0};
+	double radius_sq = radius * radius;
+
+	std::vector<entity_id_t> result;
+
+	std::unique_lock lock{this->mutex};
+	this->visit(time,
+	            this->get_cell(center - extent),
+	            this->get_cell(center + extent),
+	            [&](entity_id_t entity, const coord::phys3 &pos) {
+					auto delta = (pos - center).to_phys2();
+					double ne = delta.ne.to_double();
+					double se = delta.se.to_double();
+					if (ne * ne + se * se <= radius_sq) {
+						result.push_back(entity);
+					}
+				});
+
+	return result;
+}
+
+std::vector<entity_id_t> SpatialIndex::find_nearest(const time::time_t &time,
+                                                    const coord::phys3 &center,
+                                                    size_t count) const {
+	if (count == 0) {
+		return {};
+	}
+
+	// (squared distance, entity)
+	std::vector<std::pair<double, entity_id_t>> found;
+	auto collect = [&](entity_id_t entity, const coord::phys3 &pos) {
+		auto delta = (pos - center).to_phys2();
+		double ne = delta.ne.to_double();
+		double se = delta.se.to_double();
+		found.emplace_back(ne * ne + se * se, entity);
+	};
+
+	std::unique_lock lock{this->mutex};
+	if (this->cells.empty()) {
+		return {};
+	}
+
+	auto center_cell = this->get_cell(center);
+	int64_t max_ring = std::max({
+		int64_t{0},
+		center_cell.ne - this->min_bounds.ne,
+		this->max_bounds.ne - center_cell.ne,
+		center_cell.se - this->min_bounds.se,
+		this->max_bounds.se - center_cell.se,
+	});
+	double cell_width = coord::phys_t::from_raw_value(this->cell_size_raw).to_double();
+
+	// search rings of cells around the center cell until the
+	// remaining cells cannot contain closer entities
+	for (int64_t ring = 0; ring <= max_ring; ++ring) {
+		int64_t ne0 = center_cell.ne - ring;
+		int64_t ne1 = center_cell.ne + ring;
+		int64_t se0 = center_cell.se - ring;
+		int64_t se1 = center_cell.se + ring;
+
+		if (ring == 0) {
+			this->visit(time, center_cell, center_cell, collect);
+		}
+		else {
+			this->visit(time, {ne0, se0}, {ne1, se0}, collect);
+			this->visit(time, {ne0, se1}, {ne1, se1}, collect);
+			this->visit(time, {ne0, se0 + 1}, {ne0, se1 - 1}, collect);
+			this->visit(time, {ne1, se0 + 1}, {ne1, se1 - 1}, collect);
+		}
+
+		if (found.size() >= count) {
+			std::nth_element(found.begin(), found.begin() + (count - 1), found.end());
+			double reach = static_cast<double>(ring) * cell_width;
+			if (found[count - 1].first <= reach * reach) {
+				break;
+			}
+		}
+	}
+
+	std::sort(found.begin(), found.end());
+	if (found.size() > count) {
+		found.resize(count);
+	}
+
+	std::vector<entity_id_t> result;
+	result.reserve(found.size());
+	for (const auto &item : found) {
+		result.push_back(item.second);
+	}
+
+	return result;
+}
+
+void SpatialIndex::compact(const time::time_t &time) {
+	std::unique_lock lock{this->mutex};
+
+	for (auto &[entity, sections] : this->entities) {
+		while (not sections.empty() and sections.front().end <= time) {
+			this->erase(entity, sections.front());
+			sections.pop_front();
+		}
+	}
+}
+
+bool SpatialIndex::section_t::contains(const time::time_t &time) const {
+	return this->start <= time and (time < this->end or this->end == time::TIME_MAX);
+}
+
+coord::phys3 SpatialIndex::section_t::get(const time::time_t &time) const {
+	if (this->end == time::TIME_MAX or time == this->start) {
+		return this->start_pos;
+	}
+
+	// same interpolation as in curve::Interpolated
+	double elapsed_frac = (time - this->start).to_double() / (this->end - this->start).to_double();
+	return this->start_pos + (this->end_pos - this->start_pos) * elapsed_frac;
+}
+
+SpatialIndex::cell_t SpatialIndex::get_cell(const coord::phys3 &pos) const {
+	return {floor_div(pos.ne.get_raw_value(), this->cell_size_raw),
+	        floor_div(pos.se.get_raw_value(), this->cell_size_raw)};
+}
+
+std::vector<SpatialIndex::cell_t> SpatialIndex::get_cells(const section_t &section) const {
+	auto cell = this->get_cell(section.start_pos);
+	auto end_cell = this->get_cell(section.end_pos);
+
+	std::vector<cell_t> result{cell};
+	if (cell == end_cell) {
+		return result;
+	}
+
+	double start_ne = static_cast<double>(section.start_pos.ne.get_raw_value());
+	double start_se = static_cast<double>(section.start_pos.se.get_raw_value());
+	double delta_ne = static_cast<double>(section.end_pos.ne.get_raw_value()) - start_ne;
+	double delta_se = static_cast<double>(section.end_pos.se.get_raw_value()) - start_se;
+	double size = static_cast<double>(this->cell_size_raw);
+
+	int64_t step_ne = (end_cell.ne > cell.ne) ? 1 : -1;
+	int64_t step_se = (end_cell.se > cell.se) ? 1 : -1;
+	int64_t steps_ne = std::abs(end_cell.ne - cell.ne);
+	int64_t steps_se = std::abs(end_cell.se - cell.se);
+
+	// path parameter in [0, 1] at which the path leaves the current cell
+	// on each axis, and the parameter distance between two cell borders
+	constexpr double never = std::numeric_limits<double>::infinity();
+	double next_ne = never;
+	double next_se = never;
+	double dist_ne = never;
+	double dist_se = never;
+	if (steps_ne > 0) {
+		double border = static_cast<double>(step_ne > 0 ? cell.ne + 1 : cell.ne) * size;
+		next_ne = (border - start_ne) / delta_ne;
+		dist_ne = size / std::abs(delta_ne);
+	}
+	if (steps_se > 0) {
+		double border = static_cast<double>(step_se > 0 ? cell.se + 1 : cell.se) * size;
+		next_se = (border - start_se) / delta_se;
+		dist_se = size / std::abs(delta_se);
+	}
+
+	// interpolated positions are truncated to the raw value, so they
+	// can be up to one raw unit away from the exact path
+	double corner_tolerance = 2.0 / std::min(std::abs(delta_ne), std::abs(delta_se));
+
+	while (steps_ne > 0 or steps_se > 0) {
+		if (steps_ne > 0 and steps_se > 0
+		    and std::abs(next_ne - next_se) <= corner_tolerance) {
+			// the path passes the corner, add both cells next to it
+			result.push_back({cell.ne + step_ne, cell.se});
+			result.push_back({cell.ne, cell.se + step_se});
+			cell.ne += step_ne;
+			cell.se += step_se;
+			next_ne += dist_ne;
+			next_se += dist_se;
+			steps_ne -= 1;
+			steps_se -= 1;
+		}
+		else if (steps_se == 0 or (steps_ne > 0 and next_ne < next_se)) {
+			cell.ne += step_ne;
+			next_ne += dist_ne;
+			steps_ne -= 1;
+		}
+		else {
+			cell.se += step_se;
+			next_se += dist_se;
+			steps_se -= 1;
+		}
+		result.push_back(cell);
+	}
+
+	// cells next to corners can also be on the path
+	std::sort(result.begin(), result.end(), [](const cell_t &a, const cell_t &b) {
+		return std::tie(a.ne, a.se) < std::tie(b.ne, b.se);
+	});
+	result.erase(std::unique(result.begin(), result.end()), result.end());
+
+	return result;
+}
+
+void SpatialIndex::insert(entity_id_t entity, const section_t &section) {
+	this->min_bounds = {std::min(this->min_bounds.ne, section.min_cell.ne),
+	                    std::min(this->min_bounds.se, section.min_cell.se)};
+	this->max_bounds = {std::max(this->max_bounds.ne, section.max_cell.ne),
+	                    std::max(this->max_bounds.se, section.max_cell.se)};
+
+	for (const auto &cell : this->get_cells(section)) {
+		this->cells[cell].push_back(entry_t{entity, section});
+	}
+}
+
+void SpatialIndex::erase(entity_id_t entity, const section_t &section) {
+	for (const auto &cell_pos : this->get_cells(section)) {
+		auto cell = this->cells.find(cell_pos);
+		if (cell == this->cells.end()) [[unlikely]] {
+			continue;
+		}
+
+		auto &entries = cell->second;
+		auto it = std::find_if(entries.begin(), entries.end(), [&](const entry_t &entry) {
+			return entry.entity == entity and entry.section.start == section.start;
+		});
+		if (it != entries.end()) {
+			*it = std::move(entries.back());
+			entries.pop_back();
+		}
+		if (entries.empty()) {
+			this->cells.erase(cell);
+		}
+	}
+}
+
+void SpatialIndex::visit(const time::time_t &time,
+                         const cell_t &min_cell,
+                         const cell_t &max_cell,
+                         const std::function<void(entity_id_t, const coord::phys3 &)> &fn) const {
+	if (this->cells.empty()) {
+		return;
+	}
+
+	// cells outside of the bounds are always empty
+	int64_t ne0 = std::max(min_cell.ne, this->min_bounds.ne);
+	int64_t ne1 = std::min(max_cell.ne, this->max_bounds.ne);
+	int64_t se0 = std::max(min_cell.se, this->min_bounds.se);
+	int64_t se1 = std::min(max_cell.se, this->max_bounds.se);
+
+	for (int64_t ne = ne0; ne <= ne1; ++ne) {
+		for (int64_t se = se0; se <= se1; ++se) {
+			auto cell = this->cells.find(cell_t{ne, se});
+			if (cell == this->cells.end()) {
+				continue;
+			}
+
+			for (const auto &entry : cell->second) {
+				if (not entry.section.contains(time)) {
+					continue;
+				}
+
+				// sections are stored in all cells they cross, but the
+				// entity is only reported in the cell of its position,
+				// which is always one of them
+				auto pos = entry.section.get(time);
+				auto pos_cell = this->get_cell(pos);
+				pos_cell.ne = std::clamp(pos_cell.ne, entry.section.min_cell.ne, entry.section.max_cell.ne);
+				pos_cell.se = std::clamp(pos_cell.se, entry.section.min_cell.se, entry.section.max_cell.se);
+				if (pos_cell.ne == ne and pos_cell.se == se) {
+					fn(entry.entity, pos);
+				}
+			}
+		}
+	}
+}
+
+} // namespace openage::gamestate
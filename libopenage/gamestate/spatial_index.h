@@ -0,0 +1,264 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "coord/phys.h"
+#include "curve/continuous.h"
+#include "gamestate/types.h"
+#include "time/time.h"
+#include "util/hash.h"
+
+
+namespace openage::gamestate {
+
+/**
+ * Index of game entity positions over time.
+ *
+ * The world is divided into a uniform grid of square cells. For every
+ * section of an entity's position curve between two keyframes, the entity
+ * is stored in all cells that the straight path of the section crosses,
+ * together with the time interval of the section. Queries at a given time
+ * only look at the cells that overlap the queried area and interpolate the
+ * positions of the entities found there.
+ *
+ * The index is updated by the Position components of the tracked entities
+ * whenever a new position keyframe is set. This only happens in the game
+ * event handlers, which run sequentially.
+ *
+ * All methods are thread-safe, so that other threads can query the index
+ * while the simulation updates it.
+ */
+class SpatialIndex {
+public:
+	/**
+	 * Create a new spatial index.
+	 *
+	 * @param cell_size Width of the grid cells in tiles.
+	 */
+	SpatialIndex(size_t cell_size = default_cell_size);
+
+	~SpatialIndex() = default;
+
+	/**
+	 * Update the positions of an entity from its position curve.
+	 *
+	 * Adds the entity if it is not in the index yet.
+	 *
+	 * @param entity ID of the entity.
+	 * @param positions Position curve of the entity.
+	 * @param changed Earliest time at which keyframes of the curve changed
+	 *                since the last update. \p time::TIME_MIN updates the
+	 *                whole curve.
+	 */
+	void update(entity_id_t entity,
+	            const curve::Continuous<coord::phys3> &positions,
+	            const time::time_t &changed = time::TIME_MIN);
+
+	/**
+	 * Remove an entity from the index.
+	 *
+	 * @param entity ID of the entity.
+	 */
+	void remove(entity_id_t entity);
+
+	/**
+	 * Find all entities inside a rectangle.
+	 *
+	 * @param time Time of the query.
+	 * @param corner0 Corner of the rectangle.
+	 * @param corner1 Opposite corner of the rectangle.
+	 *
+	 * @return IDs of the entities in the rectangle.
+	 */
+	std::vector<entity_id_t> find_in_rect(const time::time_t &time,
+	                                      const coord::phys2 &corner0,
+	                                      const coord::phys2 &corner1) const;
+
+	/**
+	 * Find all entities within a radius around a position.
+	 *
+	 * Height differences are ignored.
+	 *
+	 * @param time Time of the query.
+	 * @param center Center of the circle.
+	 * @param radius Radius in tiles.
+	 *
+	 * @return IDs of the entities in the circle.
+	 */
+	std::vector<entity_id_t> find_in_radius(const time::time_t &time,
+	                                        const coord::phys3 &center,
+	                                        double radius) const;
+
+	/**
+	 * Find the entities closest to a position.
+	 *
+	 * Height differences are ignored.
+	 *
+	 * @param time Time of the query.
+	 * @param center Position to search from.
+	 * @param count Maximum number of entities.
+	 *
+	 * @return IDs of the \p count entities closest to \p center, ordered by distance.
+	 */
+	std::vector<entity_id_t> find_nearest(const time::time_t &time,
+	                                      const coord::phys3 &center,
+	                                      size_t count) const;
+
+	/**
+	 * Erase the sections of the position curves that are not required
+	 * for queries at t >= \p time.
+	 *
+	 * @param time Retention horizon.
+	 */
+	void compact(const time::time_t &time);
+
+	/**
+	 * Default cell width in tiles, which is the width of a terrain chunk.
+	 */
+	static constexpr size_t default_cell_size = 16;
+
+private:
+	/**
+	 * Coordinates of a grid cell.
+	 */
+	struct cell_t {
+		int64_t ne;
+		int64_t se;
+
+		bool operator==(const cell_t &other) const = default;
+	};
+
+	struct cell_hash {
+		size_t operator()(const cell_t &cell) const {
+			return util::hash_combine(std::hash<int64_t>{}(cell.ne),
+			                          std::hash<int64_t>{}(cell.se));
+		}
+	};
+
+	/**
+	 * Section of a position curve between two keyframes.
+	 */
+	struct section_t {
+		/**
+		 * Time of the first keyframe.
+		 */
+		time::time_t start;
+
+		/**
+		 * Time of the second keyframe. \p time::TIME_MAX for the section
+		 * after the last keyframe.
+		 */
+		time::time_t end;
+
+		/**
+		 * Position at \p start.
+		 */
+		coord::phys3 start_pos;
+
+		/**
+		 * Position at \p end.
+		 */
+		coord::phys3 end_pos;
+
+		/**
+		 * Bounding box of the cells crossed by the section, from
+		 * \p min_cell to \p max_cell.
+		 */
+		cell_t min_cell;
+		cell_t max_cell;
+
+		/**
+		 * Check if the section contains the position at a time.
+		 */
+		bool contains(const time::time_t &time) const;
+
+		/**
+		 * Get the position at a time, interpolated like in the position curve.
+		 */
+		coord::phys3 get(const time::time_t &time) const;
+	};
+
+	/**
+	 * Entry of an entity in a cell.
+	 */
+	struct entry_t {
+		entity_id_t entity;
+		section_t section;
+	};
+
+	/**
+	 * Get the cell of a position.
+	 */
+	cell_t get_cell(const coord::phys3 &pos) const;
+
+	/**
+	 * Get the cells crossed by the straight path of a section.
+	 *
+	 * The cells are found by walking the path cell by cell. Where the path
+	 * passes a cell corner so closely that interpolated positions can be
+	 * rounded into the cells next to the corner, these cells are included too.
+	 *
+	 * @return Cells crossed by the section, without duplicates.
+	 */
+	std::vector<cell_t> get_cells(const section_t &section) const;
+
+	/**
+	 * Add a section of an entity to the cells it crosses.
+	 */
+	void insert(entity_id_t entity, const section_t &section);
+
+	/**
+	 * Remove a section of an entity from the cells it crosses.
+	 */
+	void erase(entity_id_t entity, const section_t &section);
+
+	/**
+	 * Call a function for every entity in the given cells at a time.
+	 *
+	 * Each entity is visited at most once, in the cell of its position.
+	 * The mutex must be locked by the caller.
+	 *
+	 * @param fn Function called as fn(id, position).
+	 */
+	void visit(const time::time_t &time,
+	           const cell_t &min_cell,
+	           const cell_t &max_cell,
+	           const std::function<void(entity_id_t, const coord::phys3 &)> &fn) const;
+
+	/**
+	 * Width of a cell in the raw fixed point values of phys coordinates.
+	 */
+	int64_t cell_size_raw;
+
+	/**
+	 * Entries of the entities in each non-empty cell.
+	 */
+	std::unordered_map<cell_t, std::vector<entry_t>, cell_hash> cells;
+
+	/**
+	 * Indexed sections of each entity, ordered by time.
+	 */
+	std::unordered_map<entity_id_t, std::deque<section_t>> entities;
+
+	/**
+	 * Smallest and largest cell coordinates that contained entities.
+	 */
+	cell_t min_bounds{std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::max()};
+	cell_t max_bounds{std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::min()};
+
+	/**
+	 * Protects the index against queries from other threads during updates.
+	 */
+	mutable std::mutex mutex;
+};
+
+} // namespace openage::gamestate
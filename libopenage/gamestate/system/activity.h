@@ -1,4 +1,4 @@
-// Copyright 2023-2024 the openage authors. See copying.md for legal info.
+// Copyright 2023-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -41,12 +41,14 @@ private:
 	 * Run a built-in engine subsystem.
 	 *
 	 * @param entity Game entity.
+	 * @param state Game state.
 	 * @param start_time Start time of change.
 	 * @param system_id ID of the subsystem to run.
 	 *
 	 * @return Runtime of the change in simulation time.
 	 */
 	static const time::time_t handle_subsystem(const std::shared_ptr<gamestate::GameEntity> &entity,
+	                                           const std::shared_ptr<openage::gamestate::GameState> &state,
 	                                           const time::time_t &start_time,
 	                                           system_id_t system_id);
 };
@@ -1,7 +1,8 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2026 the openage authors. See copying.md for legal info.
 
 #include "move.h"
 
+#include <cmath>
 #include <compare>
 #include <vector>
 
@@ -13,10 +14,7 @@
 #include "coord/phys.h"
 #include "curve/continuous.h"
 #include "curve/segmented.h"
-#include "gamestate/api/ability.h"
-#include "gamestate/api/animation.h"
-#include "gamestate/api/property.h"
-#include "gamestate/api/types.h"
+#include "gamestate/api/ability_cache.h"
 #include "gamestate/component/api/move.h"
 #include "gamestate/component/api/turn.h"
 #include "gamestate/component/internal/command_queue.h"
@@ -24,14 +22,80 @@
 #include "gamestate/component/internal/position.h"
 #include "gamestate/component/types.h"
 #include "gamestate/game_entity.h"
+#include "gamestate/game_state.h"
+#include "pathfinding/flow_field.h"
+#include "pathfinding/hierarchical_pathfinder.h"
 #include "util/fixed_point.h"
 
 
 namespace openage::gamestate::system {
+
+namespace {
+
+/**
+ * Find the waypoints for moving from a position to a destination.
+ *
+ * @param pathfinder Pathfinder for the terrain. Can be \p nullptr.
+ * @param flow_field Flow field to the destination. Can be \p nullptr.
+ * @param start Start position.
+ * @param destination Destination position.
+ *
+ * @return Waypoints of the path, excluding the start position.
+ */
+std::vector<coord::phys3> find_path(const std::shared_ptr<path::HierarchicalPathfinder> &pathfinder,
+                                    const std::shared_ptr<path::FlowField> &flow_field,
+                                    const coord::phys3 &start,
+                                    const coord::phys3 &destination) {
+	if (pathfinder == nullptr) [[unlikely]] {
+		return {destination};
+	}
+
+	auto start_tile = start.to_tile();
+	auto destination_tile = destination.to_tile();
+
+	std::vector<coord::tile> tiles;
+	if (flow_field != nullptr and flow_field->get_target() == destination_tile) {
+		tiles = flow_field->get_path(start_tile);
+	}
+	if (tiles.empty() or tiles.back() != destination_tile) {
+		// the flow field doesn't lead to the destination from this tile,
+		// so the pathfinder finds the closest reachable tile instead
+		tiles = pathfinder->find_path(start_tile, destination_tile);
+	}
+	if (tiles.empty()) [[unlikely]] {
+		// start is not on the terrain
+		return {destination};
+	}
+
+	// waypoints are in the center of their tiles
+	const coord::phys3_delta tile_center{coord::phys_t{0.5f}, coord::phys_t{0.5f}, 0};
+
+	std::vector<coord::phys3> waypoints;
+	waypoints.reserve(tiles.size());
+
+	// skip the start tile, because the entity moves from its current position
+	for (size_t i = 1; i + 1 < tiles.size(); ++i) {
+		waypoints.push_back(tiles[i].to_phys3() + tile_center);
+	}
+
+	if (tiles.back() == destination_tile) {
+		waypoints.push_back(destination);
+	}
+	else if (tiles.size() > 1) {
+		// destination is unreachable, move as close as possible
+		waypoints.push_back(tiles.back().to_phys3() + tile_center);
+	}
+
+	return waypoints;
+}
+
+} // namespace
+
+
 const time::time_t Move::move_command(const std::shared_ptr<gamestate::GameEntity> &entity,
+                                      const std::shared_ptr<gamestate::GameState> &state,
                                       const time::time_t &start_time) {
-	auto command_queue = std::dynamic_pointer_cast<component::CommandQueue>(
-		entity->get_component(component::component_t::COMMANDQUEUE));
+	auto command_queue = entity->get_component<component::CommandQueue>();
 	auto command = std::dynamic_pointer_cast<component::command::MoveCommand>(
 		command_queue->pop_command(start_time));
 
@@ -40,80 +104,87 @@ const time::time_t Move::move_command(const std::shared_ptr<gamestate::GameEntit
 		return time::time_t::from_int(0);
 	}
 
-	return Move::move_default(entity, command->get_target(), start_time);
+	return Move::move_default(entity,
+	                          state,
+	                          command->get_target(),
+	                          start_time,
+	                          command->get_flow_field());
 }
 
 
 const time::time_t Move::move_default(const std::shared_ptr<gamestate::GameEntity> &entity,
+                                      const std::shared_ptr<gamestate::GameState> &state,
                                       const coord::phys3 &destination,
-                                      const time::time_t &start_time) {
+                                      const time::time_t &start_time,
+                                      const std::shared_ptr<path::FlowField> &flow_field) {
 	if (not entity->has_component(component::component_t::MOVE)) [[unlikely]] {
 		log::log(WARN << "Entity " << entity->get_id() << " has no move component.");
 		return time::time_t::from_int(0);
 	}
 
-	auto turn_component = std::dynamic_pointer_cast<component::Turn>(
-		entity->get_component(component::component_t::TURN));
-	auto turn_ability = turn_component->get_ability();
-	auto turn_speed = turn_ability.get<nyan::Float>("Turn.turn_speed");
+	auto turn_component = entity->get_component<component::Turn>();
+	auto turn_params = api::AbilityCache::get_turn_params(turn_component->get_ability());
 
-	auto move_component = std::dynamic_pointer_cast<component::Move>(
-		entity->get_component(component::component_t::MOVE));
-	auto move_ability = move_component->get_ability();
-	auto move_speed = move_ability.get<nyan::Float>("Move.speed");
+	auto move_component = entity->get_component<component::Move>();
+	auto move_params = api::AbilityCache::get_move_params(move_component->get_ability());
 
-	auto pos_component = std::dynamic_pointer_cast<component::Position>(
-		entity->get_component(component::component_t::POSITION));
+	auto pos_component = entity->get_component<component::Position>();
 
 	auto &positions = pos_component->get_positions();
 	auto &angles = pos_component->get_angles();
 	auto current_pos = positions.get(start_time);
 	auto current_angle = angles.get(start_time);
 
-	// TODO: pathfinder
-	auto path = destination.to_phys2() - current_pos.to_phys2();
-	auto new_angle = path.to_angle();
-
-	// rotation
-	double turn_time = 0;
-	if (not turn_speed->is_infinite_positive()) {
-		auto angle_diff = new_angle - current_angle;
-		if (angle_diff < 0) {
-			// get the positive difference
-			angle_diff = angle_diff * -1;
+	auto waypoints = find_path(state->get_pathfinder(), flow_field, current_pos, destination);
+
+	pos_component->set_position(start_time, current_pos);
+
+	time::time_t current_time = start_time;
+	for (const auto &waypoint : waypoints) {
+		auto path = waypoint.to_phys2() - current_pos.to_phys2();
+		if (path.ne == 0 and path.se == 0) [[unlikely]] {
+			continue;
 		}
-		if (angle_diff > 180) {
-			// always use the smaller angle
-			angle_diff = angle_diff - 360;
-			angle_diff = angle_diff * -1;
+		auto new_angle = path.to_angle();
+
+		// rotation
+		double turn_time = 0;
+		if (not std::isinf(turn_params->turn_speed)) {
+			auto angle_diff = new_angle - current_angle;
+			if (angle_diff < 0) {
+				// get the positive difference
+				angle_diff = angle_diff * -1;
+			}
+			if (angle_diff > 180) {
+				// always use the smaller angle
+				angle_diff = angle_diff - 360;
+				angle_diff = angle_diff * -1;
+			}
+
+			turn_time = angle_diff.to_double() / turn_params->turn_speed;
 		}
+		pos_component->set_angle(current_time + turn_time, new_angle);
 
-		turn_time = angle_diff.to_double() / turn_speed->get();
-	}
-	pos_component->set_angle(start_time + turn_time, new_angle);
+		// movement
+		double move_time = 0;
+		if (not std::isinf(move_params->speed)) {
+			auto distance = path.length();
+			move_time = distance / move_params->speed;
+		}
 
-	// movement
-	double move_time = 0;
-	if (not move_speed->is_infinite_positive()) {
-		auto distance = path.length();
-		move_time = distance / move_speed->get();
-	}
+		current_time = current_time + turn_time + move_time;
+		pos_component->set_position(current_time, waypoint);
 
-	pos_component->set_position(start_time, current_pos);
-	pos_component->set_position(start_time + turn_time + move_time, destination);
-
-	auto ability = move_component->get_ability();
-	if (api::APIAbility::check_property(ability, api::ability_property_t::ANIMATED)) {
-		auto property = api::APIAbility::get_property(ability, api::ability_property_t::ANIMATED);
-		auto animations = api::APIAbilityProperty::get_animations(property);
-		auto animation_paths = api::APIAnimation::get_animation_paths(animations);
+		current_pos = waypoint;
+		current_angle = new_angle;
+	}
 
-		if (animation_paths.size() > 0) [[likely]] {
-			entity->render_update(start_time, animation_paths[0]);
-		}
+	const auto &animation_paths = move_params->animation_paths;
+	if (animation_paths.size() > 0) [[likely]] {
+		entity->render_update(start_time, animation_paths[0]);
 	}
 
-	return turn_time + move_time;
+	return current_time - start_time;
 }
 
 } // namespace openage::gamestate::system
@@ -1,4 +1,4 @@
-// Copyright 2023-2024 the openage authors. See copying.md for legal info.
+// Copyright 2023-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -8,8 +8,14 @@
 #include "time/time.h"
 
 
-namespace openage::gamestate {
+namespace openage {
+namespace path {
+class FlowField;
+} // namespace path
+
+namespace gamestate {
 class GameEntity;
+class GameState;
 
 namespace system {
 
@@ -19,26 +25,41 @@ public:
 	 * Move a game entity to a destination from a move command.
 	 *
 	 * @param entity Game entity.
+	 * @param state Game state.
 	 * @param start_time Start time of change.
 	 *
 	 * @return Runtime of the change in simulation time.
 	 */
 	static const time::time_t move_command(const std::shared_ptr<gamestate::GameEntity> &entity,
+	                                       const std::shared_ptr<gamestate::GameState> &state,
 	                                       const time::time_t &start_time);
 
 	/**
 	 * Move a game entity to a destination.
 	 *
+	 * The entity follows the path found by the pathfinder of the game state
+	 * and gets a position keyframe for every waypoint. Without a pathfinder,
+	 * or if the entity is not on the terrain, it moves in a straight line.
+	 *
+	 * If a flow field to the destination is given, the entity follows the
+	 * flow instead of searching its own path. The pathfinder is still used
+	 * if the destination can't be reached over the flow field.
+	 *
 	 * @param entity Game entity.
+	 * @param state Game state.
 	 * @param destination Destination coordinates.
 	 * @param start_time Start time of change.
+	 * @param flow_field Flow field to the destination. Can be \p nullptr.
 	 *
 	 * @return Runtime of the change in simulation time.
 	 */
 	static const time::time_t move_default(const std::shared_ptr<gamestate::GameEntity> &entity,
+	                                       const std::shared_ptr<gamestate::GameState> &state,
 	                                       const coord::phys3 &destination,
-	                                       const time::time_t &start_time);
+	                                       const time::time_t &start_time,
+	                                       const std::shared_ptr<path::FlowField> &flow_field = nullptr);
 };
 
 } // namespace system
-} // namespace openage::gamestate
+} // namespace gamestate
+} // namespace openage
@@ -1,4 +1,4 @@
-// Copyright 2018-2023 the openage authors. See copying.md for legal info.
+// Copyright 2018-2026 the openage authors. See copying.md for legal info.
 
 #include "terrain.h"
 
@@ -6,7 +6,10 @@
 #include <array>
 #include <cstddef>
 
+#include "error/error.h"
 #include "gamestate/terrain_chunk.h"
+#include "pathfinding/cost_field.h"
+#include "pathfinding/grid.h"
 #include "renderer/render_factory.h"
 
 
@@ -14,18 +17,46 @@ namespace openage::gamestate {
 
 Terrain::Terrain() :
 	size{0, 0},
-	chunks{} {
-	// TODO: Get actual size of terrain.
+	chunks{},
+	grid{std::make_shared<path::Grid>(util::Vector2s{0, 0}, util::Vector2s{1, 1})} {
 }
 
 void Terrain::add_chunk(const std::shared_ptr<TerrainChunk> &chunk) {
+	auto &chunk_size = chunk->get_size();
+	auto &offset = chunk->get_offset();
+	if (not this->chunks.empty()) {
+		ENSURE(chunk_size == this->chunks.front()->get_size(),
+		       "terrain chunks must have the same size");
+	}
+	ENSURE(offset.ne >= 0 and offset.se >= 0
+	           and offset.ne % chunk_size[0] == 0 and offset.se % chunk_size[1] == 0,
+	       "terrain chunk offset " << offset << " is not aligned to the chunk size");
+
 	this->chunks.push_back(chunk);
+
+	// the terrain size is the bounding box of all chunks
+	this->size[0] = std::max(this->size[0], offset.ne + chunk_size[0]);
+	this->size[1] = std::max(this->size[1], offset.se + chunk_size[1]);
+
+	// rebuild the grid, so that it covers the new chunk
+	this->grid = std::make_shared<path::Grid>(
+		util::Vector2s{this->size[0] / chunk_size[0], this->size[1] / chunk_size[1]},
+		chunk_size);
+	for (auto &terrain_chunk : this->chunks) {
+		auto &chunk_offset = terrain_chunk->get_offset();
+		this->grid->set_chunk({chunk_offset.ne / chunk_size[0], chunk_offset.se / chunk_size[1]},
+		                      terrain_chunk->get_cost_field());
+	}
 }
 
 const std::vector<std::shared_ptr<TerrainChunk>> &Terrain::get_chunks() const {
 	return this->chunks;
 }
 
+const std::shared_ptr<path::Grid> &Terrain::get_grid() const {
+	return this->grid;
+}
+
 void Terrain::attach_renderer(const std::shared_ptr<renderer::RenderFactory> &render_factory) {
 	for (auto &chunk : this->get_chunks()) {
 		auto render_entity = render_factory->add_terrain_render_entity(chunk->get_size(),
@@ -1,4 +1,4 @@
-// Copyright 2018-2024 the openage authors. See copying.md for legal info.
+// Copyright 2018-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -9,6 +9,10 @@
 #include "util/vector.h"
 
 namespace openage {
+namespace path {
+class Grid;
+} // namespace path
+
 namespace renderer {
 class RenderFactory;
 } // namespace renderer
@@ -30,6 +34,9 @@ public:
 	/**
 	 * Add a chunk to the terrain.
 	 *
+	 * All chunks must have the same size and their offsets must be
+	 * multiples of the chunk size.
+	 *
 	 * @param chunk New chunk.
 	 */
 	void add_chunk(const std::shared_ptr<TerrainChunk> &chunk);
@@ -41,6 +48,15 @@ public:
 	 */
 	const std::vector<std::shared_ptr<TerrainChunk>> &get_chunks() const;
 
+	/**
+	 * Get the pathfinding grid of the terrain.
+	 *
+	 * The grid uses the cost fields of the terrain chunks.
+	 *
+	 * @return Pathfinding grid.
+	 */
+	const std::shared_ptr<path::Grid> &get_grid() const;
+
 	/**
 	 * Attach a renderer which enables graphical display.
 	 *
@@ -66,6 +82,11 @@ private:
 	 * Subdivision of the main terrain entity.
 	 */
 	std::vector<std::shared_ptr<TerrainChunk>> chunks;
+
+	/**
+	 * Pathfinding grid of the terrain.
+	 */
+	std::shared_ptr<path::Grid> grid;
 };
 
 } // namespace gamestate
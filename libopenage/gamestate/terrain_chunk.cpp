@@ -1,7 +1,9 @@
-// Copyright 2018-2024 the openage authors. See copying.md for legal info.
+// Copyright 2018-2026 the openage authors. See copying.md for legal info.
 
 #include "terrain_chunk.h"
 
+#include "pathfinding/cost_field.h"
+
 
 namespace openage::gamestate {
 
@@ -10,7 +12,9 @@ TerrainChunk::TerrainChunk(const util::Vector2s size,
                            const std::vector<TerrainTile> &&tiles) :
 	size{size},
 	offset{offset},
-	tiles{std::move(tiles)} {
+	tiles{std::move(tiles)},
+	// TODO: Get the costs from the terrain definitions of the tiles.
+	cost_field{std::make_shared<path::CostField>(size)} {
 	if (this->size[0] > MAX_CHUNK_WIDTH || this->size[1] > MAX_CHUNK_HEIGHT) {
 		throw Error(MSG(err) << "Terrain chunk size exceeds maximum size: "
 		                     << this->size[0] << "x" << this->size[1] << " > "
@@ -30,6 +34,10 @@ const coord::tile_delta &TerrainChunk::get_offset() const {
 	return this->offset;
 }
 
+const std::shared_ptr<path::CostField> &TerrainChunk::get_cost_field() const {
+	return this->cost_field;
+}
+
 void TerrainChunk::render_update(const time::time_t &time) {
 	if (this->render_entity != nullptr) {
 		// TODO: Update individual tiles instead of the whole chunk
@@ -1,7 +1,8 @@
-// Copyright 2018-2024 the openage authors. See copying.md for legal info.
+// Copyright 2018-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "coord/tile.h"
@@ -11,7 +12,12 @@
 #include "util/vector.h"
 
 
-namespace openage::gamestate {
+namespace openage {
+namespace path {
+class CostField;
+} // namespace path
+
+namespace gamestate {
 
 const size_t MAX_CHUNK_WIDTH = 16;
 const size_t MAX_CHUNK_HEIGHT = 16;
@@ -48,6 +54,13 @@ public:
 	 */
 	const coord::tile_delta &get_offset() const;
 
+	/**
+	 * Get the pathfinding costs of the tiles in this chunk.
+	 *
+	 * @return Cost field of the terrain chunk.
+	 */
+	const std::shared_ptr<path::CostField> &get_cost_field() const;
+
 	/**
 	 * Update the render entity.
 	 *
@@ -75,10 +88,18 @@ private:
 	 */
 	std::vector<TerrainTile> tiles;
 
+	/**
+	 * Pathfinding costs of the tiles.
+	 *
+	 * Layout is the same as for the tiles.
+	 */
+	std::shared_ptr<path::CostField> cost_field;
+
 	/**
 	 * Render entity for pushing updates to the renderer. Can be \p nullptr.
 	 */
 	std::shared_ptr<renderer::terrain::TerrainRenderEntity> render_entity;
 };
 
-} // namespace openage::gamestate
+} // namespace gamestate
+} // namespace openage
@@ -0,0 +1,395 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <nyan/nyan.h>
+
+#include "coord/phys.h"
+#include "curve/continuous.h"
+#include "event/event_loop.h"
+#include "testing/testing.h"
+
+#include "gamestate/component/internal/command_queue.h"
+#include "gamestate/component/internal/ownership.h"
+#include "gamestate/component/internal/position.h"
+#include "gamestate/component/types.h"
+#include "gamestate/component_store.h"
+#include "gamestate/entity_factory.h"
+#include "gamestate/game_entity.h"
+#include "gamestate/game_state.h"
+#include "gamestate/player.h"
+#include "gamestate/spatial_index.h"
+#include "gamestate/types.h"
+
+
+namespace openage::gamestate::tests {
+
+namespace {
+
+/**
+ * Parts of the engine API that are read by the entity factory,
+ * and a game entity type with a patch that adds an ability.
+ */
+const std::string entity_factory_nyan = R"(!version 1
+
+Property():
+    pass
+
+ability():
+    Ability():
+        properties : dict(abstract(children(Property)), children(Property)) = {}
+
+    type():
+        Idle(ability.Ability):
+            pass
+
+        Selectable(ability.Ability):
+            pass
+
+GameEntity():
+    abilities : set(children(ability.Ability))
+
+VillagerIdle(ability.type.Idle):
+    pass
+
+VillagerSelectable(ability.type.Selectable):
+    pass
+
+Villager(GameEntity):
+    abilities = {VillagerIdle}
+
+MakeSelectable<Villager>():
+    abilities += {VillagerSelectable}
+)";
+
+} // namespace
+
+
+void component_store() {
+	auto loop = std::make_shared<openage::event::EventLoop>();
+
+	// add and replace
+	{
+		ComponentStore store;
+		auto first = std::make_shared<component::Ownership>(loop);
+		auto second = std::make_shared<component::Ownership>(loop);
+
+		store.add(5, first);
+		TESTEQUALS(store.has(5, component::component_t::OWNERSHIP), true);
+		TESTEQUALS(store.has(5, component::component_t::COMMANDQUEUE), false);
+		TESTEQUALS(store.get(5, component::component_t::OWNERSHIP), first);
+		TESTEQUALS(store.get<component::Ownership>(5), first.get());
+
+		store.add(5, second);
+		TESTEQUALS(store.size(component::component_t::OWNERSHIP), 1);
+		TESTEQUALS(store.get(5, component::component_t::OWNERSHIP), second);
+
+		TESTEQUALS(store.has(6, component::component_t::OWNERSHIP), false);
+		TESTEQUALS(store.get<component::Ownership>(6), nullptr);
+		TESTTHROWS(store.get(6, component::component_t::OWNERSHIP));
+	}
+
+	// remove moves the last component into the gap
+	{
+		ComponentStore store;
+		std::vector<std::shared_ptr<component::Ownership>> owners;
+		for (entity_id_t id = 1; id <= 4; ++id) {
+			auto owner = std::make_shared<component::Ownership>(loop);
+			store.add(id, owner);
+			owners.push_back(owner);
+		}
+		store.add(2, std::make_shared<component::CommandQueue>(loop));
+
+		store.remove(1);
+		TESTEQUALS(store.has(1, component::component_t::OWNERSHIP), false);
+		TESTEQUALS(store.size(component::component_t::OWNERSHIP), 3);
+		auto entities = store.get_entities(component::component_t::OWNERSHIP);
+		TESTEQUALS(entities.size(), 3);
+		TESTEQUALS(entities[0], 4);
+		TESTEQUALS(entities[1], 2);
+		TESTEQUALS(entities[2], 3);
+
+		// the sparse index of the moved entity points to its new position
+		TESTEQUALS(store.get<component::Ownership>(4), owners[3].get());
+		TESTEQUALS(store.get<component::Ownership>(2), owners[1].get());
+		TESTEQUALS(store.get<component::Ownership>(3), owners[2].get());
+
+		// removing the last component doesn't move anything
+		store.remove(3);
+		TESTEQUALS(store.get_entities(component::component_t::OWNERSHIP).size(), 2);
+		TESTEQUALS(store.get<component::Ownership>(4), owners[3].get());
+		TESTEQUALS(store.get<component::Ownership>(2), owners[1].get());
+
+		// all components of the entity are removed
+		store.remove(2);
+		TESTEQUALS(store.has(2, component::component_t::OWNERSHIP), false);
+		TESTEQUALS(store.has(2, component::component_t::COMMANDQUEUE), false);
+		TESTEQUALS(store.size(component::component_t::COMMANDQUEUE), 0);
+
+		// removing unknown entities does nothing
+		store.remove(2);
+		store.remove(1000000);
+		TESTEQUALS(store.size(component::component_t::OWNERSHIP), 1);
+		TESTEQUALS(store.get<component::Ownership>(4), owners[3].get());
+	}
+
+	// sparse pages are allocated for far apart IDs
+	{
+		ComponentStore store;
+		std::vector<entity_id_t> ids{0, 4095, 4096, 100000, 8191};
+		for (auto id : ids) {
+			store.add(id, std::make_shared<component::Ownership>(loop));
+		}
+		for (auto id : ids) {
+			TESTEQUALS(store.has(id, component::component_t::OWNERSHIP), true);
+		}
+		TESTEQUALS(store.has(1, component::component_t::OWNERSHIP), false);
+		TESTEQUALS(store.has(50000, component::component_t::OWNERSHIP), false);
+		TESTEQUALS(store.has(200000, component::component_t::OWNERSHIP), false);
+
+		store.remove(100000);
+		TESTEQUALS(store.has(100000, component::component_t::OWNERSHIP), false);
+		TESTEQUALS(store.has(8191, component::component_t::OWNERSHIP), true);
+	}
+
+	// each() visits the entities that have all components
+	{
+		ComponentStore store;
+		for (entity_id_t id = 0; id < 10; ++id) {
+			store.add(id, std::make_shared<component::Ownership>(loop, id % 3, 0));
+			if (id % 2 == 0) {
+				store.add(id, std::make_shared<component::CommandQueue>(loop));
+			}
+		}
+
+		std::vector<entity_id_t> visited;
+		store.each<component::Ownership, component::CommandQueue>(
+			[&](entity_id_t id, component::Ownership &owner, component::CommandQueue &queue) {
+				TESTEQUALS(&owner, store.get<component::Ownership>(id));
+				TESTEQUALS(&queue, store.get<component::CommandQueue>(id));
+				TESTEQUALS(owner.get_owners().get(0), id % 3);
+				visited.push_back(id);
+			});
+		std::sort(visited.begin(), visited.end());
+		TESTEQUALS(visited == (std::vector<entity_id_t>{0, 2, 4, 6, 8}), true);
+
+		size_t count = 0;
+		store.each<component::Ownership>([&](entity_id_t, component::Ownership &) {
+			count += 1;
+		});
+		TESTEQUALS(count, 10);
+	}
+
+	// reserve() keeps the stored components
+	{
+		ComponentStore store;
+		store.reserve(component::component_t::OWNERSHIP, 16);
+		TESTEQUALS(store.size(component::component_t::OWNERSHIP), 0);
+
+		for (entity_id_t id = 0; id < 40; ++id) {
+			store.reserve(component::component_t::OWNERSHIP, 1);
+			store.add(id, std::make_shared<component::Ownership>(loop, id, 0));
+		}
+		store.reserve(component::component_t::OWNERSHIP, 1000);
+
+		TESTEQUALS(store.size(component::component_t::OWNERSHIP), 40);
+		for (entity_id_t id = 0; id < 40; ++id) {
+			TESTEQUALS(store.get_entities(component::component_t::OWNERSHIP)[id], id);
+			TESTEQUALS(store.get<component::Ownership>(id)->get_owners().get(0), id);
+		}
+	}
+}
+
+void spatial_index() {
+	auto loop = std::make_shared<openage::event::EventLoop>();
+
+	auto sorted = [](std::vector<entity_id_t> ids) {
+		std::sort(ids.begin(), ids.end());
+		return ids;
+	};
+	auto make_curve = [&](size_t id) {
+		return std::make_unique<curve::Continuous<coord::phys3>>(loop, id, "", nullptr, coord::phys3{0, 0, 0});
+	};
+
+	SpatialIndex index{4};
+
+	// stationary entities
+	auto pos1 = make_curve(1);
+	auto pos2 = make_curve(2);
+	auto pos3 = make_curve(3);
+	pos1->set_insert(0, coord::phys3{1, 1, 0});
+	pos2->set_insert(0, coord::phys3{10, 10, 0});
+	pos3->set_insert(0, coord::phys3{-5, 3, 0});
+	index.update(1, *pos1);
+	index.update(2, *pos2);
+	index.update(3, *pos3);
+
+	// find_in_rect
+	TESTEQUALS(index.find_in_rect(1, {0, 0}, {2, 2}) == (std::vector<entity_id_t>{1}), true);
+	TESTEQUALS(index.find_in_rect(1, {2, 2}, {0, 0}) == (std::vector<entity_id_t>{1}), true);
+	TESTEQUALS(sorted(index.find_in_rect(1, {-10, -10}, {20, 20})) == (std::vector<entity_id_t>{1, 2, 3}), true);
+	TESTEQUALS(index.find_in_rect(1, {2, 2}, {9, 9}).empty(), true);
+
+	// the first keyframe is not indexed before its time
+	TESTEQUALS(index.find_in_rect(-1, {-10, -10}, {20, 20}).empty(), true);
+
+	// find_in_radius
+	TESTEQUALS(index.find_in_radius(1, {0, 0, 0}, 2.0) == (std::vector<entity_id_t>{1}), true);
+	TESTEQUALS(sorted(index.find_in_radius(1, {0, 0, 0}, 15.0)) == (std::vector<entity_id_t>{1, 2, 3}), true);
+	TESTEQUALS(index.find_in_radius(1, {0, 0, 0}, 1.0).empty(), true);
+
+	// find_nearest
+	TESTEQUALS(index.find_nearest(1, {9, 9, 0}, 2) == (std::vector<entity_id_t>{2, 1}), true);
+	TESTEQUALS(index.find_nearest(1, {9, 9, 0}, 10) == (std::vector<entity_id_t>{2, 1, 3}), true);
+	TESTEQUALS(index.find_nearest(1, {-40, 40, 0}, 1) == (std::vector<entity_id_t>{3}), true);
+	TESTEQUALS(index.find_nearest(1, {9, 9, 0}, 0).empty(), true);
+
+	// moving entities are found along their path, exactly once,
+	// including paths that cross the corners of cells
+	auto pos4 = make_curve(4);
+	auto pos5 = make_curve(5);
+	pos4->set_insert(10, coord::phys3{20, 20, 0});
+	pos4->set_insert(50, coord::phys3{60, 60, 0});
+	pos5->set_insert(10, coord::phys3{20, -20, 0});
+	pos5->set_insert(50, coord::phys3{60, -8, 0});
+	index.update(4, *pos4);
+	index.update(5, *pos5);
+
+	for (int t = 10; t <= 60; ++t) {
+		for (auto *curve : {pos4.get(), pos5.get()}) {
+			auto pos = curve->get(t);
+			auto entity = static_cast<entity_id_t>(curve->id());
+			coord::phys2 min{pos.ne - 1, pos.se - 1};
+			coord::phys2 max{pos.ne + 1, pos.se + 1};
+			auto found = index.find_in_rect(t, min, max);
+			TESTEQUALS(std::count(found.begin(), found.end(), entity), 1);
+		}
+		auto all = sorted(index.find_in_rect(t, {-100, -100}, {100, 100}));
+		TESTEQUALS(all == (std::vector<entity_id_t>{1, 2, 3, 4, 5}), true);
+	}
+	TESTEQUALS(index.find_in_rect(30, {55, 55}, {65, 65}).empty(), true);
+	TESTEQUALS(index.find_nearest(30, {40, 40, 0}, 1) == (std::vector<entity_id_t>{4}), true);
+
+	// update only replaces the sections after the change
+	pos1->set_last(20, coord::phys3{-31, -31, 0});
+	index.update(1, *pos1, 20);
+	TESTEQUALS(index.find_in_radius(10, {-15, -15, 0}, 1.0) == (std::vector<entity_id_t>{1}), true);
+	TESTEQUALS(index.find_in_radius(40, {-31, -31, 0}, 1.0) == (std::vector<entity_id_t>{1}), true);
+	TESTEQUALS(index.find_in_radius(40, {1, 1, 0}, 1.0).empty(), true);
+
+	pos1->set_last(15, coord::phys3{29, -29, 0});
+	index.update(1, *pos1, 15);
+	TESTEQUALS(index.find_in_radius(40, {29, -29, 0}, 1.0) == (std::vector<entity_id_t>{1}), true);
+	TESTEQUALS(index.find_in_radius(40, {-31, -31, 0}, 1.0).empty(), true);
+
+	// remove
+	index.remove(3);
+	index.remove(3);
+	TESTEQUALS(index.find_in_radius(1, {-5, 3, 0}, 1.0).empty(), true);
+	TESTEQUALS(index.find_nearest(1, {-40, -40, 0}, 1) == (std::vector<entity_id_t>{1}), true);
+
+	// compact drops the sections that end before the horizon
+	TESTEQUALS(index.find_in_rect(30, {39, 39}, {41, 41}) == (std::vector<entity_id_t>{4}), true);
+	index.compact(60);
+	TESTEQUALS(index.find_in_rect(30, {39, 39}, {41, 41}).empty(), true);
+	TESTEQUALS(index.find_in_rect(60, {59, 59}, {61, 61}) == (std::vector<entity_id_t>{4}), true);
+	TESTEQUALS(sorted(index.find_in_rect(60, {-100, -100}, {100, 100})) == (std::vector<entity_id_t>{1, 2, 4, 5}), true);
+	TESTEQUALS(sorted(index.find_nearest(100, {0, 0, 0}, 10)) == (std::vector<entity_id_t>{1, 2, 4, 5}), true);
+}
+
+void entity_factory() {
+	auto db = nyan::Database::create();
+	db->load("engine.nyan", [](const std::string &filename) {
+		return std::make_shared<nyan::File>(filename, std::string{entity_factory_nyan});
+	});
+
+	auto loop = std::make_shared<openage::event::EventLoop>();
+	size_t wakeups = 0;
+	loop->set_wakeup([&wakeups]() {
+		wakeups += 1;
+	});
+
+	auto state = std::make_shared<GameState>(db, loop);
+	auto factory = std::make_shared<EntityFactory>();
+	auto player0 = factory->add_player(loop, state, "");
+	auto player1 = factory->add_player(loop, state, "");
+	state->add_player(player0);
+	state->add_player(player1);
+	state->set_entity_factory(factory);
+
+	const nyan::fqon_t villager = "engine.Villager";
+
+	// entities created together get a block of consecutive IDs
+	auto created = factory->add_game_entities(loop, state, player0->get_id(), villager, 3);
+	TESTEQUALS(created.size(), 3);
+	auto first_id = created[0]->get_id();
+	for (size_t i = 0; i < created.size(); ++i) {
+		TESTEQUALS(created[i]->get_id(), first_id + i);
+		TESTEQUALS(created[i]->has_component(component::component_t::POSITION), true);
+		TESTEQUALS(created[i]->has_component(component::component_t::OWNERSHIP), true);
+		TESTEQUALS(created[i]->has_component(component::component_t::COMMANDQUEUE), true);
+		TESTEQUALS(created[i]->has_component(component::component_t::ACTIVITY), true);
+		TESTEQUALS(created[i]->has_component(component::component_t::IDLE), true);
+		TESTEQUALS(created[i]->has_component(component::component_t::SELECTABLE), false);
+	}
+
+	auto single = factory->add_game_entity(loop, state, player0->get_id(), villager);
+	TESTEQUALS(single->get_id(), first_id + 3);
+
+	// spawned entities are grouped by owner in the order of the first spawn
+	// of each owner, and are returned in the order of the spawns
+	std::vector<EntityFactory::spawn_t> spawns{
+		{player1->get_id(), coord::phys3{1, 1, 0}},
+		{player0->get_id(), coord::phys3{2, 2, 0}},
+		{player1->get_id(), coord::phys3{3, 3, 0}},
+		{player0->get_id(), coord::phys3{4, 4, 0}},
+		{player1->get_id(), coord::phys3{5, 5, 0}},
+	};
+	std::vector<entity_id_t> expected_ids{0, 3, 1, 4, 2};
+
+	auto wakeups_before = wakeups;
+	auto spawned = factory->spawn_game_entities(loop, state, 1, villager, spawns);
+
+	// all events and changes of the spawn wake up the loop once
+	TESTEQUALS(wakeups, wakeups_before + 1);
+
+	TESTEQUALS(spawned.size(), spawns.size());
+	for (size_t i = 0; i < spawned.size(); ++i) {
+		const auto &entity = spawned[i];
+		TESTEQUALS(entity->get_id(), single->get_id() + 1 + expected_ids[i]);
+		TESTEQUALS(state->get_game_entity(entity->get_id()), entity);
+
+		auto owner = entity->get_component<component::Ownership>();
+		TESTEQUALS(owner->get_owners().get(1), spawns[i].owner);
+
+		auto position = entity->get_component<component::Position>();
+		TESTEQUALS(position->get_positions().get(1) == spawns[i].position, true);
+	}
+
+	// templates are read again after a patch of the owner's view
+	auto owner_view = player0->get_db_view();
+	auto transaction = owner_view->new_transaction(2);
+	transaction.add(owner_view->get_object("engine.MakeSelectable"));
+	TESTEQUALS(transaction.commit(), true);
+
+	auto patched = factory->add_game_entity(loop, state, player0->get_id(), villager);
+	TESTEQUALS(patched->has_component(component::component_t::IDLE), true);
+	TESTEQUALS(patched->has_component(component::component_t::SELECTABLE), true);
+
+	// the templates of other owners are not affected
+	auto unpatched = factory->add_game_entity(loop, state, player1->get_id(), villager);
+	TESTEQUALS(unpatched->has_component(component::component_t::SELECTABLE), false);
+
+	// invalidated templates release their subscriptions to the view
+	auto view_uses = owner_view.use_count();
+	factory->invalidate(owner_view);
+	TESTEQUALS(owner_view.use_count() < view_uses, true);
+
+	auto reread = factory->add_game_entity(loop, state, player0->get_id(), villager);
+	TESTEQUALS(reread->has_component(component::component_t::SELECTABLE), true);
+}
+
+} // namespace openage::gamestate::tests
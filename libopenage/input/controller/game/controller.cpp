@@ -1,4 +1,4 @@
-// Copyright 2021-2023 the openage authors. See copying.md for legal info.
+// Copyright 2021-2026 the openage authors. See copying.md for legal info.
 
 #include "controller.h"
 
@@ -123,7 +123,7 @@ void setup_defaults(const std::shared_ptr<BindingContext> &ctx,
 	binding_func_t create_entity_event{[&](const event_arguments &args,
 	                                       const std::shared_ptr<Controller> controller) {
 		auto mouse_pos = args.mouse.to_phys3(camera);
-		event::EventHandler::param_map::map_t params{
+		event::EventHandler::param_map params{
 			{"position", mouse_pos},
 			{"owner", controller->get_controlled()},
 		};
@@ -149,7 +149,7 @@ void setup_defaults(const std::shared_ptr<BindingContext> &ctx,
 	binding_func_t move_entity{[&](const event_arguments &args,
 	                               const std::shared_ptr<Controller> controller) {
 		auto mouse_pos = args.mouse.to_phys3(camera);
-		event::EventHandler::param_map::map_t params{
+		event::EventHandler::param_map params{
 			{"type", gamestate::component::command::command_t::MOVE},
 			{"target", mouse_pos},
 			{"entity_ids", controller->get_selected()},
@@ -192,7 +192,7 @@ void setup_defaults(const std::shared_ptr<BindingContext> &ctx,
 		[&](const event_arguments &args,
 	        const std::shared_ptr<Controller> controller) {
 			Eigen::Matrix4f cam_matrix = camera->get_projection_matrix() * camera->get_view_matrix();
-			event::EventHandler::param_map::map_t params{
+			event::EventHandler::param_map params{
 				{"controlled", controller->get_controlled()},
 				{"drag_start", controller->get_drag_select_start().to_viewport(camera).to_ndc_space(camera)},
 				{"drag_end", args.mouse.to_viewport(camera).to_ndc_space(camera)},
@@ -1,8 +1,9 @@
-// Copyright 2015-2024 the openage authors. See copying.md for legal info.
+// Copyright 2015-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
 #include <functional>
+#include <utility>
 
 #include "job_aborted_exception.h"
 #include "typed_job_state_base.h"
@@ -26,8 +27,8 @@ public:
 	/** Creates a new abortable job with the given function and callback. */
 	AbortableJobState(abortable_function_t<T> function,
 	                  callback_function_t<T> callback) :
-		TypedJobStateBase<T>{callback},
-		function{function} {
+		TypedJobStateBase<T>{std::move(callback)},
+		function{std::move(function)} {
 	}
 
 	/** Default destructor. */
@@ -0,0 +1,73 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "job.h"
+#include "job_state_base.h"
+
+namespace openage {
+namespace job {
+
+class JobManager;
+
+/**
+ * A set of jobs that another job waits for. The waiting job is enqueued by
+ * JobManager::enqueue_after when all of these jobs have finished, whether
+ * they returned a result or threw an exception.
+ *
+ * A single job converts implicitly, which allows to chain continuations:
+ *
+ *   auto a = manager.enqueue<int>(load);
+ *   auto b = manager.enqueue_after<int>(a, [a]() mutable {
+ *       return a.get_result() + 1;
+ *   });
+ */
+class Dependencies {
+private:
+	/** The shared states of the jobs to wait for. */
+	std::vector<std::shared_ptr<JobStateBase>> jobs;
+
+public:
+	/** Creates an empty set of dependencies. */
+	Dependencies() = default;
+
+	/** Creates a set of dependencies that only contains the given job. */
+	template <class T>
+	Dependencies(const Job<T> &job) {
+		this->add(job);
+	}
+
+	/** Adds a job to wait for. Empty jobs are ignored. */
+	template <class T>
+	void add(const Job<T> &job) {
+		if (job.state) {
+			this->jobs.push_back(job.state);
+		}
+	}
+
+	/** Returns the number of jobs to wait for. */
+	size_t size() const {
+		return this->jobs.size();
+	}
+
+private:
+	/** The job manager must be a friend in order to register the waiting job. */
+	friend class JobManager;
+};
+
+
+/**
+ * Returns the dependencies for a job that waits for all of the given jobs.
+ */
+template <class... Ts>
+Dependencies when_all(const Job<Ts> &...jobs) {
+	Dependencies result;
+	(result.add(jobs), ...);
+	return result;
+}
+
+} // namespace job
+} // namespace openage
@@ -1,4 +1,4 @@
-// Copyright 2014-2024 the openage authors. See copying.md for legal info.
+// Copyright 2014-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -10,9 +10,13 @@
 namespace openage {
 namespace job {
 
+class Dependencies;
 class JobGroup;
 class JobManager;
 
+template <class U>
+class JobAwaiter;
+
 /**
  * A job is a wrapper around a shared job state object and is returned by the
  * job manager. It can be used to retrieve the current state of the job and its
@@ -75,8 +79,12 @@ private:
 
 	/*
 	 * Job manager and job group have to be friends of job in order to access the
-	 * private constructor.
+	 * private constructor. Dependencies and the awaiter of coroutines access
+	 * the shared state.
 	 */
+	friend class Dependencies;
+	template <class U>
+	friend class JobAwaiter;
 	friend class JobGroup;
 	friend class JobManager;
 };
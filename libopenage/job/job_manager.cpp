@@ -1,29 +1,104 @@
-// Copyright 2014-2019 the openage authors. See copying.md for legal info.
+// Copyright 2014-2026 the openage authors. See copying.md for legal info.
 
 #include "job_manager.h"
 
+#include <algorithm>
+#include <exception>
+
 #include "../log/log.h"
 #include "../util/thread_id.h"
+#include "task_state.h"
 #include "worker.h"
 
 
 namespace openage::job {
 
+namespace {
+
+/**
+ * The shared state of a parallel_for call. The calling thread and the
+ * helping jobs take chunks until none are left.
+ */
+struct parallel_for_state {
+	size_t begin;
+	size_t end;
+	size_t grain;
+	size_t chunk_count;
+
+	/**
+	 * The function of the parallel_for. Only used while a chunk is executed,
+	 * as the calling thread waits for that. Helping jobs that start later
+	 * don't take a chunk and don't touch it.
+	 */
+	const std::function<void(size_t, size_t)> *function;
+
+	/** The index of the next chunk to execute. */
+	std::atomic<size_t> next_chunk{0};
+
+	/** The number of chunks that have been executed or skipped. */
+	std::atomic<size_t> done_chunks{0};
+
+	/** Whether a chunk has thrown an exception. */
+	std::atomic<bool> failed{false};
+
+	/** The first exception thrown by a chunk. */
+	std::exception_ptr exception;
+
+	/** Executes chunks until all of them have been taken. */
+	void run() {
+		while (true) {
+			size_t chunk = this->next_chunk.fetch_add(1, std::memory_order_relaxed);
+			if (chunk >= this->chunk_count) {
+				return;
+			}
+
+			// the remaining chunks are skipped after an exception
+			if (not this->failed.load(std::memory_order_relaxed)) {
+				size_t chunk_begin = this->begin + chunk * this->grain;
+				size_t chunk_end = std::min(chunk_begin + this->grain, this->end);
+				try {
+					(*this->function)(chunk_begin, chunk_end);
+				}
+				catch (...) {
+					if (not this->failed.exchange(true)) {
+						this->exception = std::current_exception();
+					}
+				}
+			}
+
+			this->done_chunks.fetch_add(1, std::memory_order_release);
+		}
+	}
+};
+
+} // namespace
+
+
 
 JobManager::JobManager(int number_of_workers)
 	:
 	number_of_workers{number_of_workers},
 	group_index{0},
+	idle_workers{0},
+	wake_index{0},
 	is_running{false} {
 
 	for (int i = 0; i < number_of_workers; i++) {
-		this->workers.emplace_back(new Worker{this});
+		this->workers.emplace_back(new Worker{this, static_cast<size_t>(i)});
 	}
 }
 
 
 JobManager::~JobManager() {
 	this->stop();
+
+	// release the jobs that were never executed
+	JobStateBase *job = this->pending_jobs.take_all();
+	while (job != nullptr) {
+		JobStateBase *next = job->next_queued;
+		job->queued_ref.reset();
+		job = next;
+	}
 }
 
 
@@ -55,6 +130,88 @@ void JobManager::stop() {
 }
 
 
+void JobManager::parallel_for(size_t begin, size_t end, size_t grain,
+                              const std::function<void(size_t, size_t)> &function) {
+	if (begin >= end) {
+		return;
+	}
+
+	grain = std::max<size_t>(grain, 1);
+	auto state = std::make_shared<parallel_for_state>();
+	state->begin = begin;
+	state->end = end;
+	state->grain = grain;
+	state->chunk_count = (end - begin - 1) / grain + 1;
+	state->function = &function;
+
+	// the calling thread executes chunks as well, so one helper less is needed
+	size_t helpers = std::min(this->workers.size(), state->chunk_count - 1);
+	for (size_t i = 0; i < helpers; i++) {
+		this->enqueue_state(std::make_shared<TaskState>([state]() {
+			state->run();
+		}));
+	}
+
+	state->run();
+
+	// wait for the chunks that other threads are still executing
+	while (state->done_chunks.load(std::memory_order_acquire) < state->chunk_count) {
+		std::this_thread::yield();
+	}
+
+	if (state->exception != nullptr) {
+		std::rethrow_exception(state->exception);
+	}
+}
+
+
+bool JobManager::help() {
+	std::shared_ptr<JobStateBase> job;
+
+	Worker *worker = Worker::current();
+	if (worker != nullptr and worker->manager == this) {
+		// jobs of job groups are not taken, as the job that helps might be
+		// one of them
+		job = worker->fetch_shared_job();
+	}
+	else if (JobStateBase *oldest = this->pending_jobs.take_all()) {
+		// give back the others in the order they were enqueued
+		JobStateBase *next = oldest->next_queued;
+		if (next != nullptr) {
+			while (next != nullptr) {
+				JobStateBase *after = next->next_queued;
+				this->pending_jobs.push(next);
+				next = after;
+			}
+			this->wake_one();
+		}
+		job = std::move(oldest->queued_ref);
+	}
+	else {
+		size_t start = this->wake_index.load(std::memory_order_relaxed);
+		for (size_t i = 0; i < this->workers.size(); i++) {
+			Worker *victim = this->workers[(start + i) % this->workers.size()].get();
+			if (JobStateBase *stolen = victim->jobs.steal()) {
+				job = std::move(stolen->queued_ref);
+				break;
+			}
+		}
+	}
+
+	if (job == nullptr) {
+		return false;
+	}
+
+	bool aborted = job->execute([this]() {
+		return not this->is_running.load();
+	});
+	if (not aborted) {
+		this->complete_job(job);
+	}
+	return true;
+}
+
+
 void JobManager::execute_callbacks() {
 	// run callbacks for finished jobs on this thread id.
 	size_t id = util::get_current_thread_id();
@@ -87,29 +244,85 @@ JobGroup JobManager::create_job_group() {
 
 
 void JobManager::enqueue_state(const std::shared_ptr<JobStateBase> &state) {
-	std::lock_guard<std::mutex> lock{this->pending_jobs_mutex};
-	this->pending_jobs.push(state);
-	for (auto &worker : this->workers) {
-		worker->notify();
+	state->queued_ref = state;
+
+	// jobs of worker threads go to their own deque,
+	// which lets fork-join jobs run without any locks
+	Worker *worker = Worker::current();
+	if (worker != nullptr and worker->manager == this) {
+		worker->jobs.push(state.get());
+	}
+	else {
+		this->pending_jobs.push(state.get());
 	}
+
+	this->wake_one();
 }
 
 
-std::shared_ptr<JobStateBase> JobManager::fetch_job() {
-	std::lock_guard<std::mutex> lock{this->pending_jobs_mutex};
-	if (this->pending_jobs.empty()) {
-		return std::shared_ptr<JobStateBase>{};
+void JobManager::enqueue_state_after(const std::shared_ptr<JobStateBase> &state,
+                                     const Dependencies &dependencies) {
+	// the extra dependency keeps the job from being enqueued by a dependency
+	// that finishes before all of them are registered
+	state->unfinished_dependencies.store(static_cast<int>(dependencies.jobs.size()) + 1);
+	for (auto &dependency : dependencies.jobs) {
+		if (not dependency->add_dependent(state)) {
+			state->unfinished_dependencies.fetch_sub(1);
+		}
 	}
 
-	auto job = this->pending_jobs.front();
-	this->pending_jobs.pop();
-	return job;
+	if (state->unfinished_dependencies.fetch_sub(1) == 1) {
+		this->enqueue_state(state);
+	}
 }
 
 
 bool JobManager::has_job() {
-	std::lock_guard<std::mutex> lock(this->pending_jobs_mutex);
-	return not this->pending_jobs.empty();
+	if (not this->pending_jobs.empty()) {
+		return true;
+	}
+
+	for (auto &worker : this->workers) {
+		if (not worker->jobs.empty()) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+void JobManager::wake_one() {
+	// parking workers count themselves as idle before they check for jobs
+	// one last time, so either they see the new job or we see them
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (this->idle_workers.load(std::memory_order_relaxed) == 0) {
+		return;
+	}
+
+	size_t start = this->wake_index.fetch_add(1, std::memory_order_relaxed);
+	for (size_t i = 0; i < this->workers.size(); i++) {
+		if (this->workers[(start + i) % this->workers.size()]->wake()) {
+			return;
+		}
+	}
+}
+
+
+void JobManager::complete_job(const std::shared_ptr<JobStateBase> &job) {
+	JobStateBase::dependent *entry = job->complete();
+	while (entry != nullptr) {
+		if (entry->job->unfinished_dependencies.fetch_sub(1) == 1) {
+			this->enqueue_state(entry->job);
+		}
+		JobStateBase::dependent *next = entry->next;
+		delete entry;
+		entry = next;
+	}
+
+	if (job->has_callback()) {
+		this->finish_job(job);
+	}
 }
 
 
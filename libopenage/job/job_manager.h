@@ -1,18 +1,21 @@
-// Copyright 2014-2024 the openage authors. See copying.md for legal info.
+// Copyright 2014-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
 #include <atomic>
-#include <condition_variable>
+#include <cstddef>
+#include <functional>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "abortable_job_state.h"
+#include "dependencies.h"
 #include "job.h"
 #include "job_group.h"
+#include "job_stack.h"
 #include "job_state.h"
 #include "job_state_base.h"
 #include "types.h"
@@ -20,11 +23,18 @@
 namespace openage {
 namespace job {
 
+class ResumeOnWorker;
+class TaskGraph;
 class Worker;
 
 /**
  * A job manager can be used to execute functions within separate worker
  * threads.
+ *
+ * Jobs are scheduled by work stealing: jobs that a worker thread enqueues go
+ * to its own deque, jobs from other threads are collected in a lock-free
+ * stack, and idle workers steal from the others. No lock is taken to enqueue
+ * or fetch a job.
  */
 class JobManager {
 private:
@@ -40,11 +50,14 @@ private:
 	/** A vector of all worker threads. */
 	std::vector<std::unique_ptr<Worker>> workers;
 
-	/** A mutex to synchronize accesses to the internal job queue. */
-	std::mutex pending_jobs_mutex;
+	/** Jobs that were enqueued by threads that are not workers. */
+	JobStack pending_jobs;
 
-	/** A queue of jobs that are to be executed. */
-	std::queue<std::shared_ptr<JobStateBase>> pending_jobs;
+	/** The number of parked workers. */
+	std::atomic<int> idle_workers;
+
+	/** The index of the worker that is tried first by wake_one. */
+	std::atomic<size_t> wake_index;
 
 	/** A mutex to synchronize the finished job map. */
 	std::mutex finished_jobs_mutex;
@@ -117,6 +130,50 @@ public:
 		return Job<T>{state};
 	}
 
+	/**
+	 * Enqueues the given function, so that it is dispatched by one of the
+	 * worker threads after all given dependencies have finished. This allows
+	 * to chain jobs, see Dependencies and when_all.
+	 *
+	 * @param dependencies the jobs that must finish before the function is
+	 *        executed
+	 * @param function the function that is executed as background job
+	 * @param callback the callback function that is executed, when the background
+	 *        job has finished
+	 */
+	template <class T>
+	Job<T> enqueue_after(const Dependencies &dependencies,
+	                     job_function_t<T> function,
+	                     callback_function_t<T> callback = {}) {
+		auto state = std::make_shared<JobState<T>>(function, callback);
+		this->enqueue_state_after(state, dependencies);
+		return Job<T>{state};
+	}
+
+	/**
+	 * Splits the range [begin, end) into chunks of at most grain indices and
+	 * calls the function for each chunk with its begin and end index. The
+	 * chunks are executed by the worker threads and the calling thread, and
+	 * this method returns when all chunks have been executed.
+	 *
+	 * If the function throws, the remaining chunks are skipped and the first
+	 * exception is rethrown.
+	 *
+	 * @param begin the first index of the range
+	 * @param end the index after the last index of the range
+	 * @param grain the maximum number of indices per chunk
+	 * @param function the function that is called for each chunk
+	 */
+	void parallel_for(size_t begin, size_t end, size_t grain,
+	                  const std::function<void(size_t, size_t)> &function);
+
+	/**
+	 * Executes one pending job on the calling thread. Threads that wait for
+	 * jobs can use this to help instead of blocking. Returns whether a job
+	 * was executed.
+	 */
+	bool help();
+
 	/**
 	 * Creates a job group, in order to be able to execute multiple jobs on the
 	 * same worker thread.
@@ -134,20 +191,39 @@ private:
 	void enqueue_state(const std::shared_ptr<JobStateBase> &state);
 
 	/**
-	 * Returns a job from the internal job queue. If the queue is empty, a
-	 * nullptr is returned.
+	 * Enqueues the given job into the internal job queue, once all given
+	 * dependencies have finished.
 	 */
-	std::shared_ptr<JobStateBase> fetch_job();
+	void enqueue_state_after(const std::shared_ptr<JobStateBase> &state,
+	                         const Dependencies &dependencies);
 
-	/** Returns whether there are jobs to be executed. */
+	/**
+	 * Returns whether there are jobs that can be executed by any worker.
+	 */
 	bool has_job();
 
+	/** Wakes one parked worker, if there is one. */
+	void wake_one();
+
+	/**
+	 * Enqueues the jobs that waited for the given job and hands the job to
+	 * the finished job map if it has a callback.
+	 */
+	void complete_job(const std::shared_ptr<JobStateBase> &job);
+
 	/** Adds a finished job to the internal finished job map. */
 	void finish_job(const std::shared_ptr<JobStateBase> &job);
 
+	/**
+	 * Task graphs and coroutines that continue on a worker have to be friends
+	 * of the job manager in order to enqueue their tasks.
+	 */
+	friend class ResumeOnWorker;
+	friend class TaskGraph;
+
 	/**
 	 * A worker has to be a friend of the job manager in order to call the
-	 * private finish_job method.
+	 * private complete_job method and to fetch pending jobs.
 	 */
 	friend class Worker;
 };
@@ -0,0 +1,69 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <atomic>
+
+#include "job_state_base.h"
+
+namespace openage {
+namespace job {
+
+/**
+ * A lock-free list of jobs that any thread can add jobs to. Jobs are only
+ * taken out all at once, which avoids the ABA problem of lock-free stacks.
+ */
+class JobStack {
+private:
+	/** The most recently pushed job. */
+	std::atomic<JobStateBase *> head{nullptr};
+
+public:
+	/** Adds a job to the stack. */
+	void push(JobStateBase *job) {
+		JobStateBase *next = this->head.load(std::memory_order_relaxed);
+		do {
+			job->next_queued = next;
+		}
+		while (not this->head.compare_exchange_weak(next, job,
+		                                            std::memory_order_release,
+		                                            std::memory_order_relaxed));
+	}
+
+	/**
+	 * Removes all jobs from the stack. Returns the newest job, whose
+	 * next_queued pointers link the jobs from the newest to the oldest.
+	 */
+	JobStateBase *take_all_newest_first() {
+		if (this->empty()) {
+			return nullptr;
+		}
+
+		return this->head.exchange(nullptr, std::memory_order_acquire);
+	}
+
+	/**
+	 * Removes all jobs from the stack. Returns the oldest job, whose
+	 * next_queued pointers link the jobs in the order they were pushed.
+	 */
+	JobStateBase *take_all() {
+		JobStateBase *job = this->take_all_newest_first();
+
+		JobStateBase *oldest = nullptr;
+		while (job != nullptr) {
+			JobStateBase *next = job->next_queued;
+			job->next_queued = oldest;
+			oldest = job;
+			job = next;
+		}
+		return oldest;
+	}
+
+	/** Returns whether the stack is empty. */
+	bool empty() const {
+		return this->head.load(std::memory_order_relaxed) == nullptr;
+	}
+};
+
+} // namespace job
+} // namespace openage
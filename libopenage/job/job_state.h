@@ -1,8 +1,9 @@
-// Copyright 2014-2024 the openage authors. See copying.md for legal info.
+// Copyright 2014-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
 #include <functional>
+#include <utility>
 
 #include "typed_job_state_base.h"
 #include "types.h"
@@ -22,8 +23,8 @@ public:
 
 	/** Creates a new JobState with the given function, that is to be executed. */
 	JobState(job_function_t<T> function, callback_function_t<T> callback) :
-		TypedJobStateBase<T>{callback},
-		function{function} {
+		TypedJobStateBase<T>{std::move(callback)},
+		function{std::move(function)} {
 	}
 
 	/** Default destructor. */
@@ -0,0 +1,56 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#include "job_state_base.h"
+
+
+namespace openage::job {
+
+namespace {
+
+/** Marks the dependents list of a job that has completed. */
+JobStateBase::dependent completed_marker{nullptr, nullptr};
+
+} // namespace
+
+
+JobStateBase::~JobStateBase() {
+	// jobs that were aborted never release their dependents
+	dependent *entry = this->dependents.load(std::memory_order_relaxed);
+	if (entry == &completed_marker) {
+		return;
+	}
+
+	while (entry != nullptr) {
+		dependent *next = entry->next;
+		delete entry;
+		entry = next;
+	}
+}
+
+
+bool JobStateBase::add_dependent(const std::shared_ptr<JobStateBase> &job) {
+	dependent *head = this->dependents.load(std::memory_order_acquire);
+	if (head == &completed_marker) {
+		return false;
+	}
+
+	auto entry = new dependent{job, head};
+	while (not this->dependents.compare_exchange_weak(entry->next, entry,
+	                                                  std::memory_order_acq_rel,
+	                                                  std::memory_order_acquire)) {
+		if (entry->next == &completed_marker) {
+			delete entry;
+			return false;
+		}
+	}
+	return true;
+}
+
+
+JobStateBase::dependent *JobStateBase::complete() {
+	dependent *entry = this->dependents.exchange(&completed_marker, std::memory_order_acq_rel);
+	return entry == &completed_marker ? nullptr : entry;
+}
+
+
+} // namespace openage::job
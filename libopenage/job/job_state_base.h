@@ -1,8 +1,10 @@
-// Copyright 2015-2024 the openage authors. See copying.md for legal info.
+// Copyright 2015-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
+#include <atomic>
 #include <functional>
+#include <memory>
 
 #include "types.h"
 
@@ -18,8 +20,8 @@ namespace job {
  */
 class JobStateBase {
 public:
-	/** Default constructor. */
-	virtual ~JobStateBase() = default;
+	/** Destructor that releases the jobs that still wait for this job. */
+	virtual ~JobStateBase();
 
 	/**
 	 * This function executes the job. It returns whether the job has been
@@ -36,6 +38,53 @@ public:
 
 	/** Returns the id of the thread that has created this job. */
 	virtual size_t get_thread_id() = 0;
+
+	/** Returns whether the job has a callback function. */
+	virtual bool has_callback() = 0;
+
+	/**
+	 * Reference to this job while it waits in a queue of the job manager.
+	 * The lock-free queues only store raw pointers, so this keeps the job
+	 * alive until a worker takes it out of the queue.
+	 */
+	std::shared_ptr<JobStateBase> queued_ref;
+
+	/** The next job in the same JobStack. */
+	JobStateBase *next_queued = nullptr;
+
+	/** A job that waits for this job to complete. */
+	struct dependent {
+		/** The waiting job. */
+		std::shared_ptr<JobStateBase> job;
+
+		/** The next waiting job. */
+		dependent *next;
+	};
+
+	/**
+	 * Registers a job that waits for this job to complete. Returns false if
+	 * this job has already completed, so there is nothing to wait for.
+	 */
+	bool add_dependent(const std::shared_ptr<JobStateBase> &job);
+
+	/**
+	 * Marks this job as completed and returns the jobs that wait for it. The
+	 * caller takes ownership of the returned list.
+	 */
+	dependent *complete();
+
+	/**
+	 * The number of dependencies of this job that have not completed yet.
+	 * The job is enqueued when it drops to zero.
+	 */
+	std::atomic<int> unfinished_dependencies{0};
+
+private:
+	/**
+	 * Lock-free list of the jobs that wait for this job, or a marker when
+	 * this job has completed.
+	 */
+	std::atomic<dependent *> dependents{nullptr};
 };
 
 } // namespace job
@@ -0,0 +1,40 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#include "main_thread_executor.h"
+
+#include <utility>
+
+
+namespace openage::job {
+
+
+size_t MainThreadExecutor::run_pending() {
+	{
+		std::lock_guard<std::mutex> lock{this->pending_mutex};
+		std::swap(this->running, this->pending);
+	}
+
+	// coroutines that are scheduled while they run are resumed by the next call
+	for (auto &coroutine : this->running) {
+		coroutine.resume();
+	}
+
+	size_t count = this->running.size();
+	this->running.clear();
+	return count;
+}
+
+
+bool MainThreadExecutor::has_pending() {
+	std::lock_guard<std::mutex> lock{this->pending_mutex};
+	return not this->pending.empty();
+}
+
+
+void MainThreadExecutor::post(std::coroutine_handle<> coroutine) {
+	std::lock_guard<std::mutex> lock{this->pending_mutex};
+	this->pending.push_back(coroutine);
+}
+
+
+} // namespace openage::job
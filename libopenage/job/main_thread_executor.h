@@ -0,0 +1,88 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace openage {
+namespace job {
+
+/**
+ * Resumes coroutines on the thread that runs it, e.g. the main thread that
+ * owns the renderer and the asset caches. Coroutines move there with
+ * co_await executor.schedule(), and the owning thread resumes them by
+ * calling run_pending() regularly, e.g. once per frame.
+ */
+class MainThreadExecutor {
+public:
+	MainThreadExecutor() = default;
+	~MainThreadExecutor() = default;
+
+	MainThreadExecutor(const MainThreadExecutor &) = delete;
+	MainThreadExecutor &operator=(const MainThreadExecutor &) = delete;
+
+	/** Awaiter that hands the awaiting coroutine to the executor. */
+	class Awaiter {
+	public:
+		explicit Awaiter(MainThreadExecutor &executor) :
+			executor{executor} {
+		}
+
+		bool await_ready() noexcept {
+			return false;
+		}
+
+		void await_suspend(std::coroutine_handle<> awaiting) {
+			this->executor.post(awaiting);
+		}
+
+		void await_resume() noexcept {}
+
+	private:
+		MainThreadExecutor &executor;
+	};
+
+	/**
+	 * Returns an awaitable that continues the awaiting coroutine the next
+	 * time run_pending() is called.
+	 */
+	Awaiter schedule() {
+		return Awaiter{*this};
+	}
+
+	/**
+	 * Resumes the coroutines that were scheduled before this call. Must only
+	 * be called by the owning thread.
+	 *
+	 * @return Number of resumed coroutines.
+	 */
+	size_t run_pending();
+
+	/**
+	 * Check if coroutines wait to be resumed.
+	 *
+	 * @return true if run_pending() would resume a coroutine, else false.
+	 */
+	bool has_pending();
+
+private:
+	/**
+	 * Adds a coroutine that is resumed by run_pending().
+	 */
+	void post(std::coroutine_handle<> coroutine);
+
+	/** A mutex to synchronize the scheduled coroutines. */
+	std::mutex pending_mutex;
+
+	/** The coroutines to resume in run_pending(). */
+	std::vector<std::coroutine_handle<>> pending;
+
+	/** The coroutines that are resumed by the current run_pending() call. */
+	std::vector<std::coroutine_handle<>> running;
+};
+
+} // namespace job
+} // namespace openage
@@ -0,0 +1,352 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <utility>
+
+#include "../error/error.h"
+#include "../log/log.h"
+#include "job.h"
+#include "job_manager.h"
+#include "task_state.h"
+#include "types.h"
+
+namespace openage {
+namespace job {
+
+template <class T>
+class Task;
+
+/**
+ * Parts of the promise of a Task that don't depend on the result type.
+ */
+class TaskPromiseBase {
+public:
+	/** Tasks are lazy, they start when they are awaited or started. */
+	std::suspend_always initial_suspend() noexcept {
+		return {};
+	}
+
+	void unhandled_exception() {
+		this->exception = std::current_exception();
+	}
+
+	/** The coroutine that awaits this task. */
+	std::coroutine_handle<> continuation;
+
+	/** The exception that was thrown by the task. */
+	std::exception_ptr exception;
+};
+
+
+/**
+ * The promise of a Task with a result.
+ */
+template <class T>
+class TaskPromise : public TaskPromiseBase {
+public:
+	Task<T> get_return_object();
+
+	auto final_suspend() noexcept;
+
+	void return_value(T value) {
+		this->result = std::move(value);
+	}
+
+	/** Returns the result or rethrows the exception of the task. */
+	T get_result() {
+		if (this->exception != nullptr) {
+			std::rethrow_exception(this->exception);
+		}
+		return std::move(this->result);
+	}
+
+	/** The result of the task. */
+	T result;
+
+	/** Called when a started task has finished. */
+	callback_function_t<T> callback;
+};
+
+
+/**
+ * The promise of a Task without result.
+ */
+template <>
+class TaskPromise<void> : public TaskPromiseBase {
+public:
+	Task<void> get_return_object();
+
+	auto final_suspend() noexcept;
+
+	void return_void() {}
+
+	/** Rethrows the exception of the task. */
+	void get_result() {
+		if (this->exception != nullptr) {
+			std::rethrow_exception(this->exception);
+		}
+	}
+
+	/** Called when a started task has finished. */
+	callback_function_t<void> callback;
+};
+
+
+/**
+ * Continues when a task has finished: with the coroutine that awaits the
+ * task, or for a started task by calling its callback and destroying it.
+ */
+template <class T>
+class TaskFinalAwaiter {
+public:
+	bool await_ready() noexcept {
+		return false;
+	}
+
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<TaskPromise<T>> handle) noexcept {
+		TaskPromise<T> &promise = handle.promise();
+		if (promise.continuation) {
+			return promise.continuation;
+		}
+
+		// the task was started and nobody awaits it
+		if (promise.callback) {
+			try {
+				promise.callback([&promise]() {
+					return promise.get_result();
+				});
+			}
+			catch (...) {
+				log::log(MSG(err) << "Callback of a started task threw an exception");
+			}
+		}
+		else if (promise.exception != nullptr) {
+			// nobody can receive the exception
+			try {
+				std::rethrow_exception(promise.exception);
+			}
+			catch (const std::exception &exc) {
+				log::log(MSG(err) << "Started task threw an exception: " << exc.what());
+			}
+			catch (...) {
+				log::log(MSG(err) << "Started task threw an exception");
+			}
+		}
+		handle.destroy();
+		return std::noop_coroutine();
+	}
+
+	void await_resume() noexcept {}
+};
+
+
+template <class T>
+auto TaskPromise<T>::final_suspend() noexcept {
+	return TaskFinalAwaiter<T>{};
+}
+
+
+inline auto TaskPromise<void>::final_suspend() noexcept {
+	return TaskFinalAwaiter<void>{};
+}
+
+
+/**
+ * A coroutine that returns a result of type T. A task starts when another
+ * coroutine awaits it with co_await, or when it is started with start().
+ *
+ * Inside a task, co_await can wait for
+ *   - other tasks,
+ *   - jobs of the job manager (see JobAwaiter),
+ *   - resume_on(manager) to continue on a worker thread of the manager and
+ *   - MainThreadExecutor::schedule() to continue on the main thread.
+ *
+ * A task continues on the thread that resumes it, e.g. the worker that
+ * finished an awaited job.
+ *
+ * @param T the task's result type
+ */
+template <class T>
+class Task {
+public:
+	using promise_type = TaskPromise<T>;
+
+	/** Creates an empty task. Should only be used as dummy object. */
+	Task() = default;
+
+	Task(Task &&other) noexcept :
+		handle{std::exchange(other.handle, nullptr)} {
+	}
+
+	Task &operator=(Task &&other) noexcept {
+		if (this != &other) {
+			if (this->handle) {
+				this->handle.destroy();
+			}
+			this->handle = std::exchange(other.handle, nullptr);
+		}
+		return *this;
+	}
+
+	Task(const Task &) = delete;
+	Task &operator=(const Task &) = delete;
+
+	/** Destroys the coroutine, if it was not started. */
+	~Task() {
+		if (this->handle) {
+			this->handle.destroy();
+		}
+	}
+
+	/**
+	 * Starts the task on the calling thread. It runs until it first has to
+	 * wait, and destroys itself when it has finished.
+	 *
+	 * @param callback the callback function that is executed on the thread
+	 *        that finishes the task
+	 */
+	void start(callback_function_t<T> callback = {}) {
+		ENSURE(this->handle, "trying to start an empty task");
+		auto task = std::exchange(this->handle, nullptr);
+		task.promise().callback = std::move(callback);
+		task.resume();
+	}
+
+	/** Awaiter that starts the task and waits for its result. */
+	class Awaiter {
+	public:
+		explicit Awaiter(std::coroutine_handle<promise_type> handle) :
+			handle{handle} {
+		}
+
+		bool await_ready() noexcept {
+			return false;
+		}
+
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+			this->handle.promise().continuation = awaiting;
+			return this->handle;
+		}
+
+		T await_resume() {
+			return this->handle.promise().get_result();
+		}
+
+	private:
+		std::coroutine_handle<promise_type> handle;
+	};
+
+	Awaiter operator co_await() && {
+		ENSURE(this->handle, "trying to await an empty task");
+		return Awaiter{this->handle};
+	}
+
+private:
+	explicit Task(std::coroutine_handle<promise_type> handle) :
+		handle{handle} {
+	}
+
+	/** The coroutine, until it is started. */
+	std::coroutine_handle<promise_type> handle;
+
+	friend promise_type;
+};
+
+
+template <class T>
+Task<T> TaskPromise<T>::get_return_object() {
+	return Task<T>{std::coroutine_handle<TaskPromise<T>>::from_promise(*this)};
+}
+
+
+inline Task<void> TaskPromise<void>::get_return_object() {
+	return Task<void>{std::coroutine_handle<TaskPromise<void>>::from_promise(*this)};
+}
+
+
+/**
+ * Awaiter for a job of the job manager. The awaiting coroutine is resumed
+ * on a worker thread when the job has finished, and receives the job's
+ * result. Coroutines that wait for a job that is aborted are never resumed.
+ *
+ * @param T the job's result type
+ */
+template <class T>
+class JobAwaiter {
+public:
+	explicit JobAwaiter(Job<T> job) :
+		job{std::move(job)} {
+	}
+
+	bool await_ready() {
+		return this->job.is_finished();
+	}
+
+	bool await_suspend(std::coroutine_handle<> awaiting) {
+		auto resume = std::make_shared<TaskState>([awaiting]() {
+			awaiting.resume();
+		});
+		resume->unfinished_dependencies.store(1);
+
+		// when the job has completed meanwhile, continue right away
+		return this->job.state->add_dependent(resume);
+	}
+
+	T await_resume() {
+		return this->job.get_result();
+	}
+
+private:
+	/** The awaited job. */
+	Job<T> job;
+};
+
+
+/** Waits for a job in a coroutine. */
+template <class T>
+JobAwaiter<T> operator co_await(Job<T> job) {
+	return JobAwaiter<T>{std::move(job)};
+}
+
+
+/**
+ * Awaiter that continues the awaiting coroutine on a worker thread.
+ */
+class ResumeOnWorker {
+public:
+	explicit ResumeOnWorker(JobManager &manager) :
+		manager{manager} {
+	}
+
+	bool await_ready() noexcept {
+		return false;
+	}
+
+	void await_suspend(std::coroutine_handle<> awaiting) {
+		this->manager.enqueue_state(std::make_shared<TaskState>([awaiting]() {
+			awaiting.resume();
+		}));
+	}
+
+	void await_resume() noexcept {}
+
+private:
+	/** The job manager whose workers resume the coroutine. */
+	JobManager &manager;
+};
+
+
+/**
+ * Continues the awaiting coroutine on a worker thread of the given job
+ * manager, e.g. to do blocking I/O there.
+ */
+inline ResumeOnWorker resume_on(JobManager &manager) {
+	return ResumeOnWorker{manager};
+}
+
+} // namespace job
+} // namespace openage
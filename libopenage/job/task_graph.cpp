@@ -0,0 +1,150 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#include "task_graph.h"
+
+#include <thread>
+#include <utility>
+
+#include "../error/error.h"
+#include "job_manager.h"
+
+
+namespace openage::job {
+
+namespace {
+
+/** Marks that a task doesn't continue with another task. */
+constexpr TaskGraph::task_id no_task = static_cast<TaskGraph::task_id>(-1);
+
+} // namespace
+
+
+TaskGraph::task_id TaskGraph::add_task(std::function<void()> function) {
+	task_id id = this->tasks.size();
+	auto state = std::make_shared<TaskState>([this, id]() {
+		this->execute(id);
+	});
+	this->tasks.push_back(task{std::move(function), {}, 0, std::move(state)});
+	this->validated = false;
+	return id;
+}
+
+
+void TaskGraph::add_dependency(task_id before, task_id after) {
+	if (before >= this->tasks.size() or after >= this->tasks.size()) {
+		throw Error(MSG(err) << "Task graph dependency " << before << " -> " << after
+		                     << " refers to an unknown task");
+	}
+
+	this->tasks[before].successors.push_back(after);
+	this->tasks[after].predecessor_count += 1;
+	this->validated = false;
+}
+
+
+size_t TaskGraph::size() const {
+	return this->tasks.size();
+}
+
+
+void TaskGraph::validate() {
+	// Kahn's algorithm: a task is visited when all its predecessors were
+	this->roots.clear();
+	std::vector<int> waiting_count(this->tasks.size());
+	for (task_id id = 0; id < this->tasks.size(); id++) {
+		waiting_count[id] = this->tasks[id].predecessor_count;
+		if (waiting_count[id] == 0) {
+			this->roots.push_back(id);
+		}
+	}
+
+	std::vector<task_id> ready = this->roots;
+	size_t visited = 0;
+	while (not ready.empty()) {
+		task_id id = ready.back();
+		ready.pop_back();
+		visited += 1;
+		for (task_id successor : this->tasks[id].successors) {
+			if (--waiting_count[successor] == 0) {
+				ready.push_back(successor);
+			}
+		}
+	}
+
+	if (visited != this->tasks.size()) {
+		throw Error(MSG(err) << "Task graph contains a cycle");
+	}
+
+	this->waiting = std::make_unique<std::atomic<int>[]>(this->tasks.size());
+	this->validated = true;
+}
+
+
+void TaskGraph::run(JobManager &manager) {
+	if (not this->validated) {
+		this->validate();
+	}
+	if (this->tasks.empty()) {
+		return;
+	}
+
+	this->manager = &manager;
+	this->exception = nullptr;
+	for (task_id id = 0; id < this->tasks.size(); id++) {
+		this->waiting[id].store(this->tasks[id].predecessor_count, std::memory_order_relaxed);
+	}
+	this->unfinished.store(this->tasks.size(), std::memory_order_release);
+
+	// hand all roots but the first to the workers, this thread runs the first
+	for (size_t i = 1; i < this->roots.size(); i++) {
+		manager.enqueue_state(this->tasks[this->roots[i]].state);
+	}
+	this->execute(this->roots[0]);
+
+	while (this->unfinished.load(std::memory_order_acquire) > 0) {
+		if (not manager.help()) {
+			std::this_thread::yield();
+		}
+	}
+
+	if (this->exception != nullptr) {
+		std::rethrow_exception(std::exchange(this->exception, nullptr));
+	}
+}
+
+
+void TaskGraph::execute(task_id id) {
+	while (id != no_task) {
+		task &current = this->tasks[id];
+		try {
+			current.function();
+		}
+		catch (...) {
+			std::lock_guard<std::mutex> lock{this->exception_mutex};
+			if (this->exception == nullptr) {
+				this->exception = std::current_exception();
+			}
+		}
+
+		// continue with the first successor that became ready,
+		// the other ones are handed to the workers
+		task_id next = no_task;
+		for (task_id successor : current.successors) {
+			if (this->waiting[successor].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				if (next == no_task) {
+					next = successor;
+				}
+				else {
+					this->manager->enqueue_state(this->tasks[successor].state);
+				}
+			}
+		}
+
+		// the graph must not be touched once the last task has finished
+		this->unfinished.fetch_sub(1, std::memory_order_acq_rel);
+		id = next;
+	}
+}
+
+
+} // namespace openage::job
@@ -0,0 +1,153 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "task_state.h"
+
+namespace openage {
+namespace job {
+
+class JobManager;
+
+/**
+ * A graph of tasks that is built once and can be run many times, e.g. once
+ * per simulation tick. Tasks run on the worker threads of a job manager as
+ * soon as all tasks they depend on have finished.
+ *
+ * Running the graph doesn't allocate: every task keeps its job state, and
+ * the thread that finishes a task continues with one of the tasks that
+ * became ready instead of enqueuing it.
+ */
+class TaskGraph {
+public:
+	/** Identifies a task of the graph. */
+	using task_id = size_t;
+
+	TaskGraph() = default;
+	~TaskGraph() = default;
+
+	TaskGraph(const TaskGraph &) = delete;
+	TaskGraph &operator=(const TaskGraph &) = delete;
+
+	/**
+	 * Adds a task to the graph.
+	 *
+	 * @param function Function that is executed by the task.
+	 *
+	 * @return ID of the new task.
+	 */
+	task_id add_task(std::function<void()> function);
+
+	/**
+	 * Makes a task wait for another task.
+	 *
+	 * @param before Task that must finish first.
+	 * @param after Task that runs after \p before has finished.
+	 */
+	void add_dependency(task_id before, task_id after);
+
+	/**
+	 * Runs all tasks and returns when they have finished. The calling thread
+	 * executes tasks as well and may execute other jobs of the job manager
+	 * while it waits for the last tasks.
+	 *
+	 * If a task throws, all remaining tasks are still run and the first
+	 * exception is rethrown afterwards.
+	 *
+	 * @param manager Job manager whose workers execute the tasks.
+	 *
+	 * @throws Error if the dependencies contain a cycle.
+	 */
+	void run(JobManager &manager);
+
+	/**
+	 * Get the number of tasks.
+	 *
+	 * @return Number of tasks in the graph.
+	 */
+	size_t size() const;
+
+private:
+	/**
+	 * Executes a task and all tasks that it makes ready and that are not
+	 * handed to other workers.
+	 *
+	 * @param id Task to execute.
+	 */
+	void execute(task_id id);
+
+	/**
+	 * Check that the dependencies don't contain a cycle.
+	 *
+	 * @throws Error if there is a cycle.
+	 */
+	void validate();
+
+	/**
+	 * A task of the graph.
+	 */
+	struct task {
+		/** Function of the task. */
+		std::function<void()> function;
+
+		/** Tasks that wait for this task. */
+		std::vector<task_id> successors;
+
+		/** Number of tasks this task waits for. */
+		int predecessor_count;
+
+		/** Job state that is enqueued when the task is handed to a worker. */
+		std::shared_ptr<TaskState> state;
+	};
+
+	/**
+	 * All tasks, indexed by their ID.
+	 */
+	std::vector<task> tasks;
+
+	/**
+	 * Tasks without dependencies.
+	 */
+	std::vector<task_id> roots;
+
+	/**
+	 * Number of unfinished dependencies of each task in the current run.
+	 */
+	std::unique_ptr<std::atomic<int>[]> waiting;
+
+	/**
+	 * Number of tasks that have not finished in the current run.
+	 */
+	std::atomic<size_t> unfinished{0};
+
+	/**
+	 * Job manager of the current run.
+	 */
+	JobManager *manager = nullptr;
+
+	/**
+	 * Whether the tasks were checked for cycles since the last change.
+	 */
+	bool validated = false;
+
+	/**
+	 * Guards the first exception of the current run.
+	 */
+	std::mutex exception_mutex;
+
+	/**
+	 * First exception that was thrown by a task in the current run.
+	 */
+	std::exception_ptr exception;
+};
+
+} // namespace job
+} // namespace openage
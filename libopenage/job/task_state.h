@@ -0,0 +1,49 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <functional>
+#include <utility>
+
+#include "job_state_base.h"
+#include "types.h"
+
+namespace openage {
+namespace job {
+
+/**
+ * The state of an internal job of the job manager, e.g. a part of a
+ * parallel_for or a task of a task graph. It has no result and no callback,
+ * and its function must not throw.
+ */
+class TaskState : public JobStateBase {
+public:
+	/** The function that is executed by the job manager. */
+	std::function<void()> function;
+
+	/** Creates a new task state with the given function. */
+	TaskState(std::function<void()> function) :
+		function{std::move(function)} {
+	}
+
+	/** Default destructor. */
+	virtual ~TaskState() = default;
+
+	bool execute(should_abort_t /*should_abort*/) override {
+		this->function();
+		return false;
+	}
+
+	void execute_callback() override {}
+
+	size_t get_thread_id() override {
+		return 0;
+	}
+
+	bool has_callback() override {
+		return false;
+	}
+};
+
+} // namespace job
+} // namespace openage
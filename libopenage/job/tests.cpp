@@ -1,11 +1,20 @@
-// Copyright 2015-2019 the openage authors. See copying.md for legal info.
+// Copyright 2015-2026 the openage authors. See copying.md for legal info.
 
 #include "../log/log.h"
 #include "../testing/testing.h"
 
+#include "../util/thread_id.h"
+#include "../util/timer.h"
 #include "job_manager.h"
+#include "main_thread_executor.h"
+#include "task.h"
+#include "task_graph.h"
 
 #include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 namespace openage {
 namespace job {
@@ -90,9 +99,457 @@ void test_simple_job_with_exception() {
 }
 
 
+/**
+ * Spawns two child jobs until the given depth is reached.
+ */
+void fork(JobManager &manager, std::atomic<int> &done, int depth) {
+	if (depth > 0) {
+		for (int i = 0; i < 2; i++) {
+			manager.enqueue<int>([&manager, &done, depth]() {
+				fork(manager, done, depth - 1);
+				return 0;
+			});
+		}
+	}
+	done++;
+}
+
+
+void test_fork_join() {
+	JobManager manager{8};
+	manager.start();
+
+	// jobs that enqueue jobs on the worker threads
+	std::atomic<int> done{0};
+	constexpr int depth = 12;
+	fork(manager, done, depth);
+
+	while (done.load() < (1 << (depth + 1)) - 1) {
+		std::this_thread::yield();
+	}
+
+	manager.stop();
+}
+
+
+void test_job_group() {
+	JobManager manager{4};
+	manager.start();
+
+	// jobs of a group run on the same thread in the order they were enqueued
+	JobGroup group = manager.create_job_group();
+	std::vector<int> order;
+	std::atomic<size_t> thread_id{0};
+	std::atomic<bool> same_thread{true};
+	std::atomic<int> finished{0};
+	constexpr int job_count = 1000;
+
+	auto job_callback = [&](const result_function_t<int> & /*get_result*/) {
+		finished++;
+	};
+
+	for (int i = 0; i < job_count; i++) {
+		auto job_function = [&, i]() -> int {
+			size_t expected = 0;
+			size_t id = util::get_current_thread_id();
+			if (not thread_id.compare_exchange_strong(expected, id) and expected != id) {
+				same_thread.store(false);
+			}
+			order.push_back(i);
+			return i;
+		};
+		group.enqueue<int>(job_function, job_callback);
+	}
+
+	while (finished.load() < job_count) {
+		manager.execute_callbacks();
+	}
+
+	manager.stop();
+
+	same_thread.load() or TESTFAIL;
+	for (int i = 0; i < job_count; i++) {
+		order[i] == i or TESTFAIL;
+	}
+}
+
+
+void test_parallel_for() {
+	JobManager manager{4};
+	manager.start();
+
+	// every index is visited exactly once
+	constexpr size_t count = 10007;
+	std::vector<std::atomic<int>> visits(count);
+	manager.parallel_for(0, count, 64, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			visits[i]++;
+		}
+	});
+	for (auto &visit : visits) {
+		visit.load() == 1 or TESTFAIL;
+	}
+
+	// nested loops on the worker threads
+	std::atomic<size_t> sum{0};
+	manager.parallel_for(0, 16, 1, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			manager.parallel_for(0, 100, 7, [&](size_t inner_begin, size_t inner_end) {
+				sum += inner_end - inner_begin;
+			});
+		}
+	});
+	TESTEQUALS(sum.load(), 1600);
+
+	// empty ranges don't call the function
+	manager.parallel_for(5, 5, 1, [](size_t, size_t) {
+		TESTFAIL;
+	});
+
+	// the first exception is rethrown
+	bool thrown = false;
+	try {
+		manager.parallel_for(0, 100, 1, [](size_t begin, size_t) {
+			if (begin == 50) {
+				throw std::runtime_error{"chunk failed"};
+			}
+		});
+	}
+	catch (std::runtime_error &) {
+		thrown = true;
+	}
+	thrown or TESTFAIL;
+
+	manager.stop();
+
+	// without running workers the calling thread executes all chunks
+	sum.store(0);
+	manager.parallel_for(0, 1000, 10, [&](size_t begin, size_t end) {
+		sum += end - begin;
+	});
+	TESTEQUALS(sum.load(), 1000);
+}
+
+
+void test_when_all() {
+	JobManager manager{4};
+	manager.start();
+
+	std::atomic<bool> first_done{false};
+	auto a = manager.enqueue<int>([&]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		first_done.store(true);
+		return 2;
+	});
+	auto c = manager.enqueue<int>([]() {
+		return 3;
+	});
+
+	// b runs after a and c, d after b
+	auto b = manager.enqueue_after<int>(when_all(a, c), [&, a, c]() mutable {
+		if (not first_done.load()) {
+			return -1;
+		}
+		return a.get_result() * c.get_result();
+	});
+	int result = 0;
+	auto d_callback = [&](const result_function_t<int> &get_result) {
+		result = get_result();
+	};
+	auto d = manager.enqueue_after<int>(b, [b]() mutable {
+		return b.get_result() + 1;
+	},
+	                                    d_callback);
+
+	// dependencies that have finished already
+	while (not c.is_finished()) {
+		std::this_thread::yield();
+	}
+	auto e = manager.enqueue_after<int>(c, []() {
+		return 0;
+	});
+
+	// without dependencies
+	auto f = manager.enqueue_after<int>(Dependencies{}, []() {
+		return 0;
+	});
+
+	while (not d.is_finished() or not e.is_finished() or not f.is_finished()) {
+		std::this_thread::yield();
+	}
+	while (result == 0) {
+		manager.execute_callbacks();
+	}
+	TESTEQUALS(result, 7);
+
+	// a dependency that throws still releases the waiting job
+	auto bad = manager.enqueue<int>([]() -> int {
+		throw std::runtime_error{"dependency failed"};
+	});
+	auto after_bad = manager.enqueue_after<int>(bad, [bad]() mutable {
+		try {
+			bad.get_result();
+		}
+		catch (std::runtime_error &) {
+			return 1;
+		}
+		return 0;
+	});
+	while (not after_bad.is_finished()) {
+		std::this_thread::yield();
+	}
+	TESTEQUALS(after_bad.get_result(), 1);
+
+	manager.stop();
+}
+
+
+void test_task_graph() {
+	JobManager manager{4};
+	manager.start();
+
+	// diamond: a -> (b, c) -> d, plus an independent task e
+	TaskGraph graph;
+	std::atomic<int> a_runs{0}, b_runs{0}, c_runs{0}, d_runs{0}, e_runs{0};
+	std::atomic<bool> in_order{true};
+
+	auto a = graph.add_task([&]() {
+		a_runs++;
+	});
+	auto b = graph.add_task([&]() {
+		if (b_runs.load() >= a_runs.load()) {
+			in_order.store(false);
+		}
+		b_runs++;
+	});
+	auto c = graph.add_task([&]() {
+		if (c_runs.load() >= a_runs.load()) {
+			in_order.store(false);
+		}
+		c_runs++;
+	});
+	auto d = graph.add_task([&]() {
+		if (d_runs.load() >= b_runs.load() or d_runs.load() >= c_runs.load()) {
+			in_order.store(false);
+		}
+		d_runs++;
+	});
+	graph.add_task([&]() {
+		e_runs++;
+	});
+	graph.add_dependency(a, b);
+	graph.add_dependency(a, c);
+	graph.add_dependency(b, d);
+	graph.add_dependency(c, d);
+	TESTEQUALS(graph.size(), 5);
+
+	// the graph is built once and run every tick
+	constexpr int ticks = 1000;
+	for (int i = 0; i < ticks; i++) {
+		graph.run(manager);
+		TESTEQUALS(d_runs.load(), i + 1);
+	}
+	in_order.load() or TESTFAIL;
+	TESTEQUALS(a_runs.load(), ticks);
+	TESTEQUALS(e_runs.load(), ticks);
+
+	// a throwing task doesn't stop the others
+	TaskGraph failing;
+	std::atomic<int> runs{0};
+	auto thrower = failing.add_task([]() {
+		throw std::runtime_error{"task failed"};
+	});
+	auto next = failing.add_task([&]() {
+		runs++;
+	});
+	failing.add_dependency(thrower, next);
+	bool thrown = false;
+	try {
+		failing.run(manager);
+	}
+	catch (std::runtime_error &) {
+		thrown = true;
+	}
+	thrown or TESTFAIL;
+	TESTEQUALS(runs.load(), 1);
+
+	// cycles are rejected
+	TaskGraph cyclic;
+	auto x = cyclic.add_task([]() {});
+	auto y = cyclic.add_task([]() {});
+	cyclic.add_dependency(x, y);
+	cyclic.add_dependency(y, x);
+	TESTTHROWS(cyclic.run(manager));
+
+	manager.stop();
+}
+
+
+/**
+ * Continues on a worker and returns whether it runs on another thread.
+ */
+Task<bool> switch_to_worker(JobManager &manager, size_t main_thread) {
+	co_await resume_on(manager);
+	co_return util::get_current_thread_id() != main_thread;
+}
+
+
+Task<void> throw_in_task() {
+	throw std::runtime_error{"task failed"};
+	co_return;
+}
+
+
+/**
+ * Chains a task, a job and a failing task, and finishes on the main thread.
+ */
+Task<int> load_chain(JobManager &manager, MainThreadExecutor &main_thread, size_t main_thread_id) {
+	bool on_worker = co_await switch_to_worker(manager, main_thread_id);
+	int loaded = co_await manager.enqueue<int>([]() {
+		return 40;
+	});
+
+	bool caught = false;
+	try {
+		co_await throw_in_task();
+	}
+	catch (std::runtime_error &) {
+		caught = true;
+	}
+
+	co_await main_thread.schedule();
+	bool on_main = util::get_current_thread_id() == main_thread_id;
+
+	co_return (on_worker and caught and on_main) ? loaded + 2 : -1;
+}
+
+
+void test_coroutines() {
+	JobManager manager{4};
+	manager.start();
+	MainThreadExecutor main_thread;
+	size_t main_thread_id = util::get_current_thread_id();
+
+	constexpr int task_count = 100;
+	int finished = 0;
+	int sum = 0;
+	for (int i = 0; i < task_count; i++) {
+		load_chain(manager, main_thread, main_thread_id).start([&](const result_function_t<int> &get_result) {
+			// runs on the main thread, as the task finishes there
+			sum += get_result();
+			finished++;
+		});
+	}
+
+	while (finished < task_count) {
+		if (main_thread.run_pending() == 0) {
+			std::this_thread::yield();
+		}
+	}
+	TESTEQUALS(sum, 42 * task_count);
+	main_thread.has_pending() and TESTFAIL;
+
+	// the exception of a started task without callback is logged
+	throw_in_task().start();
+
+	manager.stop();
+}
+
+
 void test_job_manager() {
 	test_simple_job();
 	test_simple_job_with_exception();
+	test_fork_join();
+	test_job_group();
+	test_parallel_for();
+	test_when_all();
+	test_task_graph();
+	test_coroutines();
+}
+
+
+/**
+ * Benchmark the job throughput for 10^6 tiny jobs that are enqueued
+ * by the main thread and for fork-join trees of jobs that enqueue jobs,
+ * and the overhead of parallel_for calls and task graph runs.
+ */
+void benchmark_job_manager() {
+	constexpr int tiny_job_count = 1000000;
+	constexpr int tree_depth = 18;
+	constexpr int tree_job_count = (1 << (tree_depth + 1)) - 1;
+
+	unsigned worker_count = std::max(std::thread::hardware_concurrency(), 2u);
+	JobManager manager{static_cast<int>(worker_count)};
+	manager.start();
+
+	util::Timer timer;
+	std::atomic<int> done{0};
+
+	timer.start();
+	for (int i = 0; i < tiny_job_count; i++) {
+		manager.enqueue<int>([&done]() {
+			done++;
+			return 0;
+		});
+	}
+	while (done.load() < tiny_job_count) {
+		std::this_thread::yield();
+	}
+	timer.stop();
+	auto tiny_time = timer.getval();
+
+	done.store(0);
+	timer.reset(false);
+	fork(manager, done, tree_depth);
+	while (done.load() < tree_job_count) {
+		std::this_thread::yield();
+	}
+	timer.stop();
+	auto tree_time = timer.getval();
+
+	// small loops, like per-entity work of a tick
+	constexpr int loop_count = 10000;
+	std::vector<int> values(4096);
+	timer.reset(false);
+	for (int i = 0; i < loop_count; i++) {
+		manager.parallel_for(0, values.size(), 256, [&values](size_t begin, size_t end) {
+			for (size_t j = begin; j < end; j++) {
+				values[j] += 1;
+			}
+		});
+	}
+	timer.stop();
+	auto loop_time = timer.getval();
+
+	// 8 layers of 8 tasks, every task depends on two tasks of the layer above
+	constexpr int graph_run_count = 10000;
+	TaskGraph graph;
+	std::atomic<int> task_runs{0};
+	for (int layer = 0; layer < 8; layer++) {
+		for (int i = 0; i < 8; i++) {
+			auto id = graph.add_task([&task_runs]() {
+				task_runs++;
+			});
+			if (layer > 0) {
+				graph.add_dependency(id - 8, id);
+				graph.add_dependency(id - 8 + (i + 1) % 8 - i, id);
+			}
+		}
+	}
+	timer.reset(false);
+	for (int i = 0; i < graph_run_count; i++) {
+		graph.run(manager);
+	}
+	timer.stop();
+	auto graph_time = timer.getval();
+
+	manager.stop();
+
+	log::log(INFO << worker_count << " workers: "
+	              << tiny_job_count / (tiny_time / 1e9) << " tiny jobs/s, "
+	              << tree_job_count / (tree_time / 1e9) << " fork-join jobs/s, "
+	              << loop_count / (loop_time / 1e9) << " parallel_for calls/s, "
+	              << graph_run_count / (graph_time / 1e9) << " task graph runs/s");
 }
 
 
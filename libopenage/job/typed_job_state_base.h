@@ -1,10 +1,11 @@
-// Copyright 2014-2024 the openage authors. See copying.md for legal info.
+// Copyright 2014-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
 #include <atomic>
 #include <exception>
 #include <functional>
+#include <utility>
 
 #include "../error/error.h"
 #include "../util/thread_id.h"
@@ -50,7 +51,7 @@ public:
 	/** Creates a new typed job with the given callback. */
 	TypedJobStateBase(callback_function_t<T> callback) :
 		thread_id{openage::util::get_current_thread_id()},
-		callback{callback},
+		callback{std::move(callback)},
 		finished{false} {
 	}
 
@@ -99,6 +100,10 @@ public:
 		return this->thread_id;
 	}
 
+	bool has_callback() override {
+		return static_cast<bool>(this->callback);
+	}
+
 protected:
 	/**
 	 * Executes the job and returns the result. If an exception is thrown it
@@ -1,20 +1,59 @@
-// Copyright 2015-2019 the openage authors. See copying.md for legal info.
+// Copyright 2015-2026 the openage authors. See copying.md for legal info.
 
 #include "job_aborted_exception.h"
 #include "job_manager.h"
 #include "worker.h"
 
 #include <memory>
+#include <utility>
+
+#include "config.h"
 
 
 namespace openage {
 namespace job {
 
+namespace {
+
+#if HAVE_THREAD_LOCAL_STORAGE
+/** The worker of the current thread. */
+thread_local Worker *current_worker = nullptr;
+#endif
+
+/**
+ * Takes a job out of a queue and returns the reference that kept it alive.
+ */
+std::shared_ptr<JobStateBase> dequeue(JobStateBase *job) {
+	return std::move(job->queued_ref);
+}
 
-Worker::Worker(JobManager *manager)
+} // namespace
+
+
+Worker::Worker(JobManager *manager, size_t index)
 	:
 	manager{manager},
-	is_running{false} {
+	index{index},
+	is_running{false},
+	group_batch{nullptr},
+	sleeping{false},
+	wakeups{0},
+	rng{static_cast<std::minstd_rand::result_type>(index + 1)} {
+}
+
+
+Worker::~Worker() {
+	// break the self-references of the jobs that were never executed
+	while (JobStateBase *job = this->jobs.pop()) {
+		dequeue(job);
+	}
+	for (JobStateBase *job : {this->group_batch, this->group_jobs.take_all()}) {
+		while (job != nullptr) {
+			JobStateBase *next = job->next_queued;
+			dequeue(job);
+			job = next;
+		}
+	}
 }
 
 
@@ -25,23 +64,39 @@ void Worker::start() {
 
 
 void Worker::stop() {
-	std::unique_lock<std::mutex> lock{this->pending_jobs_mutex};
 	this->is_running = false;
-	lock.unlock();
-	this->notify();
+	this->wake();
 }
 
 
 void Worker::enqueue(const std::shared_ptr<JobStateBase> &job) {
-	std::unique_lock<std::mutex> lock{this->pending_jobs_mutex};
-	this->pending_jobs.push(job);
-	lock.unlock();
-	this->notify();
+	job->queued_ref = job;
+	this->group_jobs.push(job.get());
+
+	// only this worker can execute the job
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	this->wake();
 }
 
 
-void Worker::notify() {
-	this->jobs_available.notify_all();
+bool Worker::wake() {
+	bool expected = true;
+	if (not this->sleeping.compare_exchange_strong(expected, false)) {
+		return false;
+	}
+
+	this->wakeups.fetch_add(1);
+	this->wakeups.notify_one();
+	return true;
+}
+
+
+Worker *Worker::current() {
+#if HAVE_THREAD_LOCAL_STORAGE
+	return current_worker;
+#else
+	return nullptr;
+#endif
 }
 
 
@@ -59,61 +114,122 @@ void Worker::execute_job(std::shared_ptr<JobStateBase> &job) {
 	// if the job was not aborted, tell the job manager, that the job has
 	// finished
 	if (not aborted) {
-		this->manager->finish_job(job);
+		this->manager->complete_job(job);
 	}
 }
 
 
 void Worker::process() {
-	// as long as this worker thread is running repeat all steps
-	while (true) {
-		// lock the local thread queue
-		std::unique_lock<std::mutex> lock{this->pending_jobs_mutex};
+#if HAVE_THREAD_LOCAL_STORAGE
+	current_worker = this;
+#endif
 
-		// if this thread shall not run any longer, exit the loop
-		if (not this->is_running) {
-			return;
+	// as long as this worker thread is running repeat all steps
+	while (this->is_running) {
+		auto job = this->fetch_job();
+		if (job != nullptr) {
+			this->execute_job(job);
+		}
+		else {
+			this->park();
 		}
+	}
+
+#if HAVE_THREAD_LOCAL_STORAGE
+	current_worker = nullptr;
+#endif
+}
 
-		// as long as there are no jobs from the local queue or the job manager
-		while (this->pending_jobs.empty() and not this->manager->has_job()) {
-			// the thread should wait
-			this->jobs_available.wait(lock);
 
-			// when the thread is notified, first check if the thread should be
-			// stopped
-			if (not this->is_running) {
-				return;
+std::shared_ptr<JobStateBase> Worker::fetch_job() {
+	// jobs of job groups are executed in the order they were enqueued
+	if (this->group_batch == nullptr) {
+		this->group_batch = this->group_jobs.take_all();
+	}
+	if (this->group_batch != nullptr) {
+		JobStateBase *job = this->group_batch;
+		this->group_batch = job->next_queued;
+		return dequeue(job);
+	}
+
+	return this->fetch_shared_job();
+}
+
+
+std::shared_ptr<JobStateBase> Worker::fetch_shared_job() {
+	// the newest own job is likely still in the cache
+	if (JobStateBase *job = this->jobs.pop()) {
+		return dequeue(job);
+	}
+
+	// take all jobs that were enqueued by other threads, execute the oldest
+	// one and let the other workers steal the rest
+	if (JobStateBase *job = this->manager->pending_jobs.take_all_newest_first()) {
+		if (job->next_queued != nullptr) {
+			// push the newest jobs first, so this worker pops them in the
+			// enqueued order and thieves steal the newest ones
+			while (job->next_queued != nullptr) {
+				JobStateBase *next = job->next_queued;
+				this->jobs.push(job);
+				job = next;
 			}
+			this->manager->wake_one();
 		}
+		return dequeue(job);
+	}
 
-		// check if there are jobs in the local queue
-		if (not this->pending_jobs.empty()) {
-			// fetch the job
-			auto job = this->pending_jobs.front();
-			this->pending_jobs.pop();
-			// release the local queue lock
-			lock.unlock();
-			// and execute the job
-			this->execute_job(job);
-		} else {
-			// otherwise just unlock the local queue
-			lock.unlock();
+	if (JobStateBase *job = this->steal_job()) {
+		return dequeue(job);
+	}
+
+	return nullptr;
+}
+
+
+JobStateBase *Worker::steal_job() {
+	auto &workers = this->manager->workers;
+	size_t count = workers.size();
+	if (count < 2) {
+		return nullptr;
+	}
+
+	// start at a random worker, so thieves don't all pick the same victim
+	size_t start = this->rng() % count;
+	for (size_t i = 0; i < count; i++) {
+		Worker *victim = workers[(start + i) % count].get();
+		if (victim == this) {
+			continue;
 		}
 
-		// after possibly executing a job from the local queue, check again if
-		// the thread should still continue running
-		if (not this->is_running) {
-			return;
+		if (JobStateBase *job = victim->jobs.steal()) {
+			return job;
 		}
+	}
+
+	return nullptr;
+}
 
-		// now try to fetch a job from the job manager
-		auto manager_job = this->manager->fetch_job();
-		if (manager_job.get() != nullptr) {
-			// and execute it
-			this->execute_job(manager_job);
+
+void Worker::park() {
+	this->sleeping.store(true);
+	this->manager->idle_workers.fetch_add(1);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	// jobs that were enqueued before the worker was counted as idle
+	// didn't wake anybody
+	if (not this->is_running or not this->group_jobs.empty() or this->manager->has_job()) {
+		this->sleeping.store(false);
+	}
+
+	while (true) {
+		uint32_t ticket = this->wakeups.load();
+		if (not this->sleeping.load()) {
+			break;
 		}
+		this->wakeups.wait(ticket);
 	}
+
+	this->manager->idle_workers.fetch_sub(1);
 }
 
 
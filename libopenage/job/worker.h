@@ -1,13 +1,16 @@
-// Copyright 2015-2024 the openage authors. See copying.md for legal info.
+// Copyright 2015-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
 #include <atomic>
-#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
-#include <queue>
+#include <random>
 #include <thread>
 
+#include "../datastructure/work_stealing_deque.h"
+#include "job_stack.h"
 #include "job_state_base.h"
 
 namespace openage {
@@ -18,33 +21,56 @@ class JobManager;
 /**
  * A worker encapsulates the execution of multiple jobs in a single background
  * thread.
+ *
+ * Each worker has a work-stealing deque of jobs. Jobs that are enqueued
+ * by a worker thread are pushed to its own deque, and idle workers steal
+ * jobs from the deques of the others. Workers without jobs park until
+ * the job manager wakes exactly one of them for a new job.
  */
 class Worker {
 private:
 	/** The parent job manager, this worker is fetching jobs from. */
 	JobManager *manager;
 
+	/** The index of this worker in the job manager. */
+	size_t index;
+
 	/** Whether this worker thread is still running. */
-	bool is_running;
+	std::atomic_bool is_running;
 
 	/** The executing thread. */
 	std::unique_ptr<std::thread> executor;
 
-	/** A mutex to synchronize the internal pending jobs queue. */
-	std::mutex pending_jobs_mutex;
+	/**
+	 * Jobs that can be executed by any worker. Only this worker's thread
+	 * pushes and pops, other workers steal.
+	 */
+	datastructure::WorkStealingDeque<JobStateBase> jobs;
+
+	/** Jobs of job groups that must be executed by this worker. */
+	JobStack group_jobs;
 
-	/** A queue of jobs that are to be executed. */
-	std::queue<std::shared_ptr<JobStateBase>> pending_jobs;
+	/**
+	 * Group jobs that were taken from the group job stack and are executed
+	 * next. Only used by this worker's thread.
+	 */
+	JobStateBase *group_batch;
 
-	/** A condition variable to wait for new jobs. */
-	std::condition_variable jobs_available;
+	/** Whether this worker is parked. Reset by the thread that wakes it. */
+	std::atomic_bool sleeping;
+
+	/** Incremented to wake up the parked worker thread. */
+	std::atomic<uint32_t> wakeups;
+
+	/** Selects the workers to steal from. Only used by this worker's thread. */
+	std::minstd_rand rng;
 
 public:
 	/** Constructs a new worker with the parent job manager. */
-	Worker(JobManager *manager);
+	Worker(JobManager *manager, size_t index);
 
-	/** Default destructor. */
-	~Worker() = default;
+	/** Destructor that releases the jobs that were not executed. */
+	~Worker();
 
 	/** Starts this worker. */
 	void start();
@@ -55,14 +81,19 @@ public:
 	/** Joins the internal executing thread. */
 	void join();
 
-	/** Adds the given job to the internal pending job queue. */
+	/** Adds the given job to the jobs that only this worker executes. */
 	void enqueue(const std::shared_ptr<JobStateBase> &job);
 
 	/**
-	 * Notifies this worker, that new jobs are available. This method is
-	 * although called from the parent job manager.
+	 * Wakes this worker if it is parked. Returns whether it was parked.
+	 */
+	bool wake();
+
+	/**
+	 * Returns the worker whose thread calls this method, or nullptr if it
+	 * is not called by a worker thread.
 	 */
-	void notify();
+	static Worker *current();
 
 private:
 	/**
@@ -72,11 +103,35 @@ private:
 	void execute_job(std::shared_ptr<JobStateBase> &job);
 
 	/**
-	 * Fetches pending jobs from the parent job manager and from the internal
-	 * pending job queue and executes them. If no jobs are available the
-	 * internal execution thread is wait using a condition variable.
+	 * Fetches pending jobs and executes them. If no jobs are available, the
+	 * worker is parked until new jobs are enqueued.
 	 */
 	void process();
+
+	/**
+	 * Returns the next job to execute: a job of a job group or a job from
+	 * fetch_shared_job. Returns a nullptr if there is no job.
+	 */
+	std::shared_ptr<JobStateBase> fetch_job();
+
+	/**
+	 * Returns the next job that any worker may execute: a job from this
+	 * worker's deque, a job enqueued by another thread or a job stolen from
+	 * another worker. Returns a nullptr if there is no job.
+	 */
+	std::shared_ptr<JobStateBase> fetch_shared_job();
+
+	/** Returns a job stolen from another worker or a nullptr. */
+	JobStateBase *steal_job();
+
+	/** Waits until the worker is woken up or jobs are available. */
+	void park();
+
+	/**
+	 * The job manager must be a friend of the worker in order to push to and
+	 * steal from the job deque, and to fetch jobs when a thread helps.
+	 */
+	friend class JobManager;
 };
 
 } // namespace job
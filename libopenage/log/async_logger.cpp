@@ -0,0 +1,315 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#include "async_logger.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "config.h"
+#include "log/logsink.h"
+#include "log/named_logsource.h"
+
+
+namespace openage::log {
+
+namespace {
+
+/**
+ * Interval in which the idle drain thread checks the buffers
+ * even if it was not woken up.
+ */
+constexpr auto drain_interval = std::chrono::milliseconds{10};
+
+/**
+ * Maximum time that flush() waits for another thread to finish draining.
+ */
+constexpr auto flush_timeout = std::chrono::seconds{1};
+
+/**
+ * Maximum number of messages that are drained from a buffer before the
+ * next buffer is drained, so busy threads don't delay the others.
+ */
+constexpr size_t drain_batch_size = 64;
+
+#if HAVE_THREAD_LOCAL_STORAGE
+/**
+ * Set on the drain thread. Messages that sinks log there are
+ * passed to the sinks synchronously.
+ */
+thread_local bool is_drain_thread = false;
+#endif
+
+} // namespace
+
+
+AsyncLogger::AsyncLogger() :
+	running{false},
+	draining{false},
+	policy{overflow_policy::BLOCK},
+	capacity{0},
+	dropped{0},
+	reported_dropped{0},
+	buffers{},
+	buffers_mutex{},
+	drain_list{},
+	drain_mutex{},
+	control_mutex{},
+	idle{false},
+	wakeup{},
+	wakeup_mutex{},
+	drain_thread{} {}
+
+
+AsyncLogger::~AsyncLogger() {
+	this->stop();
+}
+
+
+AsyncLogger &AsyncLogger::instance() {
+	static AsyncLogger instance;
+	return instance;
+}
+
+
+void AsyncLogger::start(size_t capacity, overflow_policy policy) {
+#if HAVE_THREAD_LOCAL_STORAGE
+	std::lock_guard<std::mutex> lock{this->control_mutex};
+	if (this->running.load()) {
+		return;
+	}
+
+	this->capacity.store(capacity);
+	this->policy.store(policy);
+
+	this->draining.store(true);
+	this->drain_thread = std::thread{&AsyncLogger::run, this};
+	this->running.store(true);
+#endif
+}
+
+
+void AsyncLogger::stop() {
+	std::lock_guard<std::mutex> control_lock{this->control_mutex};
+	if (not this->running.load()) {
+		return;
+	}
+
+	// new messages are logged synchronously from now on
+	this->running.store(false);
+
+	// wait for threads that already decided to push, the drain thread
+	// keeps running so blocked threads can finish
+	std::vector<std::shared_ptr<thread_buffer>> current;
+	{
+		std::lock_guard<std::mutex> lock{this->buffers_mutex};
+		current = this->buffers;
+	}
+	for (const auto &buffer : current) {
+		while (buffer->pushing.load()) {
+			std::this_thread::yield();
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock{this->wakeup_mutex};
+		this->draining.store(false);
+	}
+	this->wakeup.notify_one();
+	this->drain_thread.join();
+
+	std::lock_guard<std::timed_mutex> lock{this->drain_mutex};
+	this->drain();
+}
+
+
+bool AsyncLogger::is_running() const {
+	return this->running.load(std::memory_order_relaxed);
+}
+
+
+void AsyncLogger::set_overflow_policy(overflow_policy policy) {
+	this->policy.store(policy, std::memory_order_relaxed);
+}
+
+
+bool AsyncLogger::push(const message &msg, LogSource *source) {
+#if HAVE_THREAD_LOCAL_STORAGE
+	if (not this->running.load(std::memory_order_relaxed) or is_drain_thread) {
+		return false;
+	}
+
+	thread_buffer &buffer = this->get_thread_buffer();
+
+	// stop() waits while the flag is set, so the message can't be
+	// pushed after the final drain
+	buffer.pushing.store(true);
+	if (not this->running.load()) [[unlikely]] {
+		buffer.pushing.store(false, std::memory_order_release);
+		return false;
+	}
+
+	record rec{msg, source};
+	if (not buffer.ring.try_push(std::move(rec))) [[unlikely]] {
+		switch (this->policy.load(std::memory_order_relaxed)) {
+		case overflow_policy::BLOCK:
+			while (not buffer.ring.try_push(std::move(rec))) {
+				this->wakeup.notify_one();
+				std::this_thread::yield();
+			}
+			break;
+
+		case overflow_policy::DROP_OLDEST: {
+			record discarded;
+			while (not buffer.ring.try_push(std::move(rec))) {
+				if (buffer.ring.try_pop(discarded)) {
+					this->dropped.fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+			break;
+		}
+
+		case overflow_policy::DROP_NEWEST:
+			this->dropped.fetch_add(1, std::memory_order_relaxed);
+			break;
+		}
+	}
+
+	buffer.pushing.store(false, std::memory_order_release);
+
+	if (this->idle.load(std::memory_order_relaxed)) [[unlikely]] {
+		// the lock ensures that the drain thread is already waiting
+		std::lock_guard<std::mutex> lock{this->wakeup_mutex};
+		this->wakeup.notify_one();
+	}
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+void AsyncLogger::flush() {
+#if HAVE_THREAD_LOCAL_STORAGE
+	if (is_drain_thread) {
+		return;
+	}
+#endif
+
+	std::unique_lock<std::timed_mutex> lock{this->drain_mutex, flush_timeout};
+	if (not lock.owns_lock()) [[unlikely]] {
+		// a sink is stuck, there's nothing we can do
+		return;
+	}
+
+	this->drain();
+}
+
+
+size_t AsyncLogger::get_dropped() const {
+	return this->dropped.load(std::memory_order_relaxed);
+}
+
+
+#if HAVE_THREAD_LOCAL_STORAGE
+AsyncLogger::thread_buffer &AsyncLogger::get_thread_buffer() {
+	// closes the buffer when the thread exits
+	struct buffer_handle {
+		std::shared_ptr<thread_buffer> buffer;
+
+		~buffer_handle() {
+			if (this->buffer != nullptr) {
+				this->buffer->closed.store(true, std::memory_order_release);
+			}
+		}
+	};
+
+	static thread_local buffer_handle handle;
+	if (handle.buffer == nullptr) [[unlikely]] {
+		handle.buffer = std::make_shared<thread_buffer>(this->capacity.load());
+
+		std::lock_guard<std::mutex> lock{this->buffers_mutex};
+		this->buffers.push_back(handle.buffer);
+	}
+
+	return *handle.buffer;
+}
+#endif
+
+
+void AsyncLogger::run() {
+#if HAVE_THREAD_LOCAL_STORAGE
+	is_drain_thread = true;
+#endif
+
+	while (this->draining.load()) {
+		size_t count;
+		{
+			std::lock_guard<std::timed_mutex> lock{this->drain_mutex};
+			count = this->drain();
+		}
+
+		if (count == 0) {
+			std::unique_lock<std::mutex> lock{this->wakeup_mutex};
+			this->idle.store(true);
+
+			// messages that were pushed before the flag was set don't wake us up
+			if (this->draining.load() and not this->has_messages()) {
+				this->wakeup.wait_for(lock, drain_interval);
+			}
+
+			this->idle.store(false);
+		}
+	}
+}
+
+
+size_t AsyncLogger::drain() {
+	{
+		std::lock_guard<std::mutex> lock{this->buffers_mutex};
+
+		// buffers of exited threads are removed once they are empty
+		std::erase_if(this->buffers, [](const auto &buffer) {
+			return buffer->closed.load(std::memory_order_acquire) and buffer->ring.empty();
+		});
+
+		this->drain_list.assign(std::begin(this->buffers), std::end(this->buffers));
+	}
+
+	LogSinkList &sinks = LogSinkList::instance();
+
+	size_t count = 0;
+	record rec;
+	bool found;
+	do {
+		found = false;
+		for (const auto &buffer : this->drain_list) {
+			for (size_t i = 0; i < drain_batch_size and buffer->ring.try_pop(rec); ++i) {
+				sinks.log(rec.msg, rec.source);
+				found = true;
+				count += 1;
+			}
+		}
+	}
+	while (found);
+
+	size_t dropped = this->dropped.load(std::memory_order_relaxed);
+	if (dropped != this->reported_dropped) [[unlikely]] {
+		sinks.log(MSG(warn) << "Log buffers were full, dropped "
+		                    << dropped - this->reported_dropped << " messages.",
+		          &general_source());
+		this->reported_dropped = dropped;
+	}
+
+	return count;
+}
+
+
+bool AsyncLogger::has_messages() {
+	std::lock_guard<std::mutex> lock{this->buffers_mutex};
+	return std::any_of(std::begin(this->buffers), std::end(this->buffers), [](const auto &buffer) {
+		return not buffer->ring.empty();
+	});
+}
+
+} // namespace openage::log
@@ -0,0 +1,254 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../datastructure/ring_buffer.h"
+#include "../util/compiler.h"
+#include "message.h"
+
+
+namespace openage::log {
+class LogSource;
+
+/**
+ * What happens to a message that is logged while the buffer
+ * of its thread is full.
+ */
+enum class overflow_policy {
+	/// wait until the drain thread has made room
+	BLOCK,
+	/// discard the oldest message in the buffer
+	DROP_OLDEST,
+	/// discard the new message
+	DROP_NEWEST,
+};
+
+
+/**
+ * Asynchronous logging mode.
+ *
+ * While the logger is running, LogSource::log() only moves the message into
+ * a ring buffer of the calling thread and returns. A background thread
+ * drains the buffers and passes the messages to the log sinks, so threads
+ * don't wait for each other or for slow sinks when they log.
+ *
+ * Messages of one thread are passed to the sinks in order. Messages of
+ * different threads may be interleaved differently than they were logged.
+ *
+ * Log sources must not be destroyed while they have messages in the
+ * buffers, i.e. call flush() before destroying a log source.
+ *
+ * Requires thread-local storage. Without it, messages are always
+ * passed to the sinks synchronously.
+ */
+class OAAPI AsyncLogger {
+public:
+	/**
+	 * Get the global logger.
+	 */
+	static AsyncLogger &instance();
+
+	AsyncLogger(const AsyncLogger &) = delete;
+	AsyncLogger &operator=(const AsyncLogger &) = delete;
+
+	/**
+	 * Start the drain thread and log asynchronously.
+	 *
+	 * Does nothing if the logger is already running.
+	 *
+	 * @param capacity Number of messages in the buffer of each thread.
+	 * @param policy Overflow policy for full buffers.
+	 */
+	void start(size_t capacity = 1024,
+	           overflow_policy policy = overflow_policy::BLOCK);
+
+	/**
+	 * Flush all buffers, stop the drain thread and log synchronously again.
+	 */
+	void stop();
+
+	/**
+	 * Check if messages are logged asynchronously.
+	 *
+	 * @return true if the logger is running, else false.
+	 */
+	bool is_running() const;
+
+	/**
+	 * Change the overflow policy.
+	 *
+	 * @param policy Overflow policy for full buffers.
+	 */
+	void set_overflow_policy(overflow_policy policy);
+
+	/**
+	 * Add a message to the buffer of the calling thread.
+	 *
+	 * @param msg Message.
+	 * @param source Log source of the message.
+	 *
+	 * @return true if the message is handled asynchronously, false if the
+	 *         logger is not running and the caller has to log synchronously.
+	 */
+	bool push(const message &msg, LogSource *source);
+
+	/**
+	 * Pass all buffered messages to the sinks before returning.
+	 *
+	 * The calling thread drains the buffers itself, so this also works
+	 * when the drain thread is stuck. Used by the error handlers to keep
+	 * log messages from getting lost in a crash.
+	 *
+	 * Does nothing when called by the drain thread, e.g. from a sink.
+	 */
+	void flush();
+
+	/**
+	 * Get the number of messages that were discarded because a buffer was full.
+	 *
+	 * @return Number of dropped messages.
+	 */
+	size_t get_dropped() const;
+
+private:
+	AsyncLogger();
+	~AsyncLogger();
+
+	/**
+	 * Buffered message.
+	 */
+	struct record {
+		message msg;
+		LogSource *source;
+	};
+
+	/**
+	 * Buffer of a logging thread.
+	 */
+	struct thread_buffer {
+		thread_buffer(size_t capacity) :
+			ring{capacity} {}
+
+		datastructure::RingBuffer<record> ring;
+
+		/**
+		 * true while the thread is pushing a message. Lets stop() wait until
+		 * no thread is about to push a message after the final drain.
+		 */
+		std::atomic<bool> pushing{false};
+
+		/**
+		 * true when the thread has exited. The buffer is removed when it is empty.
+		 */
+		std::atomic<bool> closed{false};
+	};
+
+	/**
+	 * Get the buffer of the calling thread, creating it if needed.
+	 */
+	thread_buffer &get_thread_buffer();
+
+	/**
+	 * Main loop of the drain thread.
+	 */
+	void run();
+
+	/**
+	 * Pass the buffered messages to the sinks until all buffers are empty.
+	 * The caller must hold the drain mutex.
+	 *
+	 * @return Number of messages passed to the sinks.
+	 */
+	size_t drain();
+
+	/**
+	 * Check if any buffer holds messages.
+	 */
+	bool has_messages();
+
+	/**
+	 * Set while messages are logged asynchronously.
+	 */
+	std::atomic<bool> running;
+
+	/**
+	 * Set while the drain thread should keep draining.
+	 */
+	std::atomic<bool> draining;
+
+	/**
+	 * Overflow policy for full buffers.
+	 */
+	std::atomic<overflow_policy> policy;
+
+	/**
+	 * Capacity of new thread buffers.
+	 */
+	std::atomic<size_t> capacity;
+
+	/**
+	 * Number of discarded messages.
+	 */
+	std::atomic<size_t> dropped;
+
+	/**
+	 * Number of discarded messages that were reported to the sinks.
+	 */
+	size_t reported_dropped;
+
+	/**
+	 * Buffers of all threads that logged while the logger was running.
+	 */
+	std::vector<std::shared_ptr<thread_buffer>> buffers;
+
+	/**
+	 * Guards the buffer list.
+	 */
+	std::mutex buffers_mutex;
+
+	/**
+	 * Buffers that are drained in the current pass. Reused between passes.
+	 */
+	std::vector<std::shared_ptr<thread_buffer>> drain_list;
+
+	/**
+	 * Held while draining, so messages of a thread are never passed to the sinks
+	 * out of order by two draining threads. Timed, so crash handlers can't hang.
+	 */
+	std::timed_mutex drain_mutex;
+
+	/**
+	 * Serializes start() and stop().
+	 */
+	std::mutex control_mutex;
+
+	/**
+	 * Set while the drain thread waits for new messages.
+	 */
+	std::atomic<bool> idle;
+
+	/**
+	 * Wakes up the drain thread.
+	 */
+	std::condition_variable wakeup;
+
+	/**
+	 * Mutex for waiting on \p wakeup.
+	 */
+	std::mutex wakeup_mutex;
+
+	/**
+	 * Background thread that drains the buffers.
+	 */
+	std::thread drain_thread;
+};
+
+} // namespace openage::log
@@ -0,0 +1,214 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#include "binary_log.h"
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <unordered_map>
+
+#include "error/error.h"
+#include "log/file_logsink.h"
+#include "log/level.h"
+#include "log/message.h"
+
+
+namespace openage::log::binary {
+
+namespace {
+
+/**
+ * Reads values from the data of a log file.
+ */
+class RecordReader {
+public:
+	RecordReader(const std::vector<char> &data) :
+		data{data},
+		pos{0} {}
+
+	/**
+	 * Read a value.
+	 *
+	 * @return true if the value was read, false if the data ended.
+	 */
+	template <typename T>
+	bool get(T &value) {
+		if (this->pos + sizeof(T) > this->data.size()) {
+			return false;
+		}
+
+		std::memcpy(&value, this->data.data() + this->pos, sizeof(T));
+		this->pos += sizeof(T);
+		return true;
+	}
+
+	/**
+	 * Read a string of the given length.
+	 *
+	 * @return true if the string was read, false if the data ended.
+	 */
+	bool get(std::string &value, uint32_t length) {
+		if (this->pos + length > this->data.size()) {
+			return false;
+		}
+
+		value.assign(this->data.data() + this->pos, length);
+		this->pos += length;
+		return true;
+	}
+
+private:
+	const std::vector<char> &data;
+	size_t pos;
+};
+
+
+/**
+ * Get the log level for a numeric value.
+ *
+ * Values that are not defined by a level (e.g. from a newer version)
+ * get the next lower level.
+ */
+const level_value &to_level(int numeric) {
+	static const std::array<const level_value *, 8> levels{
+		&level::MIN,
+		&level::spam,
+		&level::dbg,
+		&level::info,
+		&level::warn,
+		&level::err,
+		&level::crit,
+		&level::MAX,
+	};
+
+	const level_value *result = levels[0];
+	for (const level_value *lvl : levels) {
+		if (lvl->numeric <= numeric) {
+			result = lvl;
+		}
+	}
+	return *result;
+}
+
+
+/**
+ * Decode the records of one file.
+ *
+ * @return Number of decoded messages.
+ */
+size_t decode_file(const std::string &file,
+                   std::ostream &out,
+                   const binary_log_filter &filter) {
+	std::ifstream in{file, std::ios_base::in | std::ios_base::binary};
+	if (not in) {
+		throw Error(MSG(err) << "Could not open binary log file " << file);
+	}
+	std::vector<char> data{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+
+	RecordReader read{data};
+
+	char file_magic[sizeof(magic)];
+	uint32_t file_version;
+	uint32_t file_byte_order;
+	for (char &c : file_magic) {
+		read.get(c);
+	}
+	if (not read.get(file_version) or not read.get(file_byte_order)
+	    or std::memcmp(file_magic, magic, sizeof(magic)) != 0) {
+		throw Error(MSG(err) << file << " is not a binary log file");
+	}
+	if (file_byte_order != byte_order_marker) {
+		throw Error(MSG(err) << file << " was written on a machine with another byte order");
+	}
+	if (file_version != version) {
+		throw Error(MSG(err) << file << " has version " << file_version
+		                     << ", but only version " << version << " is supported");
+	}
+
+	// the message metadata points into this map, so entries must not move
+	std::unordered_map<uint32_t, std::string> strings;
+
+	auto lookup = [&](uint32_t id) -> const std::string & {
+		static const std::string unknown = "<unknown>";
+		auto it = strings.find(id);
+		return it != std::end(strings) ? it->second : unknown;
+	};
+
+	size_t count = 0;
+	record_type type;
+	while (read.get(type)) {
+		if (type == record_type::STRING) {
+			uint32_t id, length;
+			std::string value;
+			if (not read.get(id) or not read.get(length) or not read.get(value, length)) {
+				break;
+			}
+			strings[id] = std::move(value);
+		}
+		else if (type == record_type::MESSAGE) {
+			int32_t lvl;
+			int64_t timestamp;
+			uint64_t thread_id;
+			uint32_t filename, lineno, functionname, source, length;
+			std::string text;
+			if (not read.get(lvl) or not read.get(timestamp) or not read.get(thread_id)
+			    or not read.get(filename) or not read.get(lineno) or not read.get(functionname)
+			    or not read.get(source) or not read.get(length) or not read.get(text, length)) {
+				break;
+			}
+
+			const std::string &source_name = lookup(source);
+			if (lvl < filter.min_level
+			    or timestamp < filter.start or timestamp > filter.end
+			    or (not filter.source.empty() and source_name != filter.source)) {
+				continue;
+			}
+
+			message msg;
+			msg.text = std::move(text);
+			msg.filename = lookup(filename).c_str();
+			msg.lineno = lineno;
+			msg.functionname = lookup(functionname).c_str();
+			msg.lvl = to_level(lvl);
+			msg.thread_id = thread_id;
+			msg.timestamp = timestamp;
+
+			write_log_line(out, msg, source_name);
+			count += 1;
+		}
+		else {
+			// END, or the rest of an incomplete file
+			break;
+		}
+	}
+
+	return count;
+}
+
+} // namespace
+
+
+size_t decode_binary_log(const std::vector<std::string> &files,
+                         const std::string &output,
+                         const binary_log_filter &filter) {
+	std::ofstream outfile;
+	if (output != "-") {
+		outfile.open(output, std::ios_base::out | std::ios_base::trunc);
+		if (not outfile) {
+			throw Error(MSG(err) << "Could not open " << output << " for writing");
+		}
+	}
+	std::ostream &out = output == "-" ? std::cout : outfile;
+
+	size_t count = 0;
+	for (const auto &file : files) {
+		count += decode_file(file, out, filter);
+	}
+	out.flush();
+
+	return count;
+}
+
+} // namespace openage::log::binary
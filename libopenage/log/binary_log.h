@@ -0,0 +1,142 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+// pxd: from libc.stdint cimport int64_t
+#include <cstdint>
+#include <cstddef>
+// pxd: from libcpp.string cimport string
+#include <string>
+// pxd: from libcpp.vector cimport vector
+#include <vector>
+
+#include "../util/compiler.h"
+
+
+namespace openage::log::binary {
+
+/*
+ * Layout of binary log files (see BinarySink).
+ *
+ * All values are stored in the byte order of the machine that wrote them.
+ *
+ * A file starts with the header:
+ *   char[8]  magic
+ *   uint32   version
+ *   uint32   byte order marker (0x01020304)
+ *
+ * followed by records, each starting with a uint8 record type:
+ *
+ * STRING, defines an id for a string in the rest of the file:
+ *   uint32   id
+ *   uint32   length
+ *   char[]   string
+ *
+ * MESSAGE:
+ *   int32    level (numeric value)
+ *   int64    timestamp (ns)
+ *   uint64   thread id
+ *   uint32   source file id
+ *   uint32   line number
+ *   uint32   function id
+ *   uint32   log source id
+ *   uint32   text length
+ *   char[]   text
+ *
+ * The unused rest of a file is zero-filled, so END marks the end of the data.
+ */
+
+/**
+ * Identifies binary log files.
+ */
+constexpr char magic[8] = {'o', 'a', 'b', 'i', 'n', 'l', 'o', 'g'};
+
+/**
+ * Version of the file layout.
+ */
+constexpr uint32_t version = 1;
+
+/**
+ * Stored after the version to detect files from machines with another byte order.
+ */
+constexpr uint32_t byte_order_marker = 0x01020304;
+
+/**
+ * Size of the file header.
+ */
+constexpr size_t header_size = sizeof(magic) + 2 * sizeof(uint32_t);
+
+/**
+ * Type of a record in the file.
+ */
+enum class record_type : uint8_t {
+	END = 0,
+	STRING = 1,
+	MESSAGE = 2,
+};
+
+/**
+ * Size of a string record without the string.
+ */
+constexpr size_t string_record_size = 1 + 2 * sizeof(uint32_t);
+
+/**
+ * Size of a message record without the text.
+ */
+constexpr size_t message_record_size = 1 + sizeof(int32_t) + sizeof(int64_t) + sizeof(uint64_t)
+                                       + 5 * sizeof(uint32_t);
+
+
+/**
+ * Selects the messages that are decoded.
+ *
+ * pxd:
+ *
+ * cppclass binary_log_filter:
+ *     int min_level
+ *     string source
+ *     int64_t start
+ *     int64_t end
+ */
+struct binary_log_filter {
+	/**
+	 * Numeric value of the lowest decoded log level.
+	 */
+	int min_level = INT32_MIN;
+
+	/**
+	 * Only decode messages of the log source with this name. Empty for all sources.
+	 */
+	std::string source = "";
+
+	/**
+	 * Only decode messages with a timestamp (ns) in [start, end].
+	 */
+	int64_t start = INT64_MIN;
+	int64_t end = INT64_MAX;
+};
+
+
+/**
+ * Decode binary log files into the text format of FileSink.
+ *
+ * Files are decoded in the given order. Decoding a file stops at
+ * the first incomplete record, e.g. after a crash.
+ *
+ * pxd:
+ *
+ * size_t decode_binary_log(const vector[string] &files,
+ *                          const string &output,
+ *                          const binary_log_filter &filter) except +
+ *
+ * @param files Paths of the log files.
+ * @param output Path of the text file, or "-" for stdout.
+ * @param filter Selects the decoded messages.
+ *
+ * @return Number of decoded messages.
+ */
+OAAPI size_t decode_binary_log(const std::vector<std::string> &files,
+                               const std::string &output,
+                               const binary_log_filter &filter);
+
+} // namespace openage::log::binary
@@ -0,0 +1,292 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#include "binary_logsink.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "error/error.h"
+#include "log/binary_log.h"
+#include "log/level.h"
+#include "log/logsource.h"
+#include "log/message.h"
+
+
+namespace openage::log {
+
+namespace {
+
+/**
+ * Write a value at the position and advance it.
+ */
+template <typename T>
+void put(uint8_t *&pos, T value) {
+	std::memcpy(pos, &value, sizeof(T));
+	pos += sizeof(T);
+}
+
+} // namespace
+
+
+#ifdef _WIN32
+struct BinarySink::mapping {
+	mapping(const std::string &path, size_t size) {
+		this->file = ::CreateFileA(path.c_str(),
+		                           GENERIC_READ | GENERIC_WRITE,
+		                           FILE_SHARE_READ | FILE_SHARE_DELETE,
+		                           nullptr,
+		                           CREATE_ALWAYS,
+		                           FILE_ATTRIBUTE_NORMAL,
+		                           nullptr);
+		if (this->file == INVALID_HANDLE_VALUE) {
+			throw Error(MSG(err) << "Could not open binary log file " << path
+			                     << ": error " << ::GetLastError());
+		}
+
+		// the mapping extends the file with zeros, which mark the end of the records
+		uint64_t mapping_size = size;
+		this->file_mapping = ::CreateFileMappingA(this->file,
+		                                          nullptr,
+		                                          PAGE_READWRITE,
+		                                          static_cast<DWORD>(mapping_size >> 32),
+		                                          static_cast<DWORD>(mapping_size & 0xffffffff),
+		                                          nullptr);
+		if (this->file_mapping == nullptr) {
+			DWORD error = ::GetLastError();
+			::CloseHandle(this->file);
+			throw Error(MSG(err) << "Could not resize binary log file " << path
+			                     << ": error " << error);
+		}
+
+		void *addr = ::MapViewOfFile(this->file_mapping, FILE_MAP_WRITE, 0, 0, size);
+		if (addr == nullptr) {
+			DWORD error = ::GetLastError();
+			::CloseHandle(this->file_mapping);
+			::CloseHandle(this->file);
+			throw Error(MSG(err) << "Could not map binary log file " << path
+			                     << ": error " << error);
+		}
+		this->data = static_cast<uint8_t *>(addr);
+	}
+
+	void close(size_t used) {
+		::UnmapViewOfFile(this->data);
+		::CloseHandle(this->file_mapping);
+
+		// remove the unused zeros
+		LARGE_INTEGER end;
+		end.QuadPart = static_cast<LONGLONG>(used);
+		if (::SetFilePointerEx(this->file, end, nullptr, FILE_BEGIN)) {
+			::SetEndOfFile(this->file);
+		}
+		::CloseHandle(this->file);
+	}
+
+	uint8_t *get() {
+		return this->data;
+	}
+
+	HANDLE file;
+	HANDLE file_mapping;
+	uint8_t *data;
+};
+#else
+struct BinarySink::mapping {
+	mapping(const std::string &path, size_t size) :
+		size{size} {
+		this->fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+		if (this->fd < 0) {
+			throw Error(MSG(err) << "Could not open binary log file " << path
+			                     << ": " << std::strerror(errno));
+		}
+
+		// the file is zero-filled, which marks the end of the records
+		if (::ftruncate(this->fd, size) != 0) {
+			::close(this->fd);
+			throw Error(MSG(err) << "Could not resize binary log file " << path
+			                     << ": " << std::strerror(errno));
+		}
+
+		void *addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0);
+		if (addr == MAP_FAILED) {
+			::close(this->fd);
+			throw Error(MSG(err) << "Could not map binary log file " << path
+			                     << ": " << std::strerror(errno));
+		}
+		this->data = static_cast<uint8_t *>(addr);
+	}
+
+	void close(size_t used) {
+		::munmap(this->data, this->size);
+
+		// remove the unused zeros
+		[[maybe_unused]] int result = ::ftruncate(this->fd, used);
+		::close(this->fd);
+	}
+
+	uint8_t *get() {
+		return this->data;
+	}
+
+	int fd;
+	uint8_t *data;
+	size_t size;
+};
+#endif
+
+
+BinarySink::BinarySink(const std::string &path,
+                       size_t file_size,
+                       size_t file_count) :
+	path{path},
+	file_size{file_size},
+	file_count{file_count},
+	file_number{0},
+	file{nullptr},
+	offset{0},
+	static_ids{},
+	source_ids{},
+	next_id{0} {
+	ENSURE(file_size >= binary::header_size + binary::message_record_size + 1024,
+	       "binary log files must be at least 1 KiB larger than the header, but got "
+	           << file_size << " bytes");
+	ENSURE(file_count > 0, "at least one binary log file must be kept");
+
+	this->rotate();
+}
+
+
+BinarySink::~BinarySink() {
+	this->file->close(this->offset);
+}
+
+
+std::string BinarySink::get_current_file() const {
+	return this->path + "." + std::to_string(this->file_number - 1);
+}
+
+
+void BinarySink::output_log_message(const message &msg, LogSource *source) {
+	// LogSinkList::log() holds the sink list mutex, so no locking is needed here.
+
+	// the strings are written before the message, so the message record
+	// can't be separated from them by a rotation
+	std::string source_name = source->logsource_name();
+	size_t strings_size = 3 * binary::string_record_size + source_name.size()
+	                      + std::strlen(msg.filename) + std::strlen(msg.functionname);
+
+	// messages that don't fit into an empty file are cut off
+	size_t max_text_size = this->file_size - binary::header_size - binary::message_record_size;
+	max_text_size = max_text_size > strings_size ? max_text_size - strings_size : 0;
+	size_t text_size = std::min(msg.text.size(), max_text_size);
+	if (this->offset + strings_size + binary::message_record_size + text_size > this->file_size) {
+		this->rotate();
+	}
+
+	uint32_t filename = this->intern(msg.filename);
+	uint32_t functionname = this->intern(msg.functionname);
+	uint32_t source_id = this->intern(source_name);
+
+	uint8_t *pos = this->reserve(binary::message_record_size + text_size);
+	put(pos, binary::record_type::MESSAGE);
+	put(pos, static_cast<int32_t>(msg.lvl->numeric));
+	put(pos, static_cast<int64_t>(msg.timestamp));
+	put(pos, static_cast<uint64_t>(msg.thread_id));
+	put(pos, filename);
+	put(pos, static_cast<uint32_t>(msg.lineno));
+	put(pos, functionname);
+	put(pos, source_id);
+	put(pos, static_cast<uint32_t>(text_size));
+	std::memcpy(pos, msg.text.data(), text_size);
+}
+
+
+void BinarySink::rotate() {
+	if (this->file != nullptr) {
+		this->file->close(this->offset);
+	}
+
+	if (this->file_number >= this->file_count) {
+		std::string oldest = this->path + "." + std::to_string(this->file_number - this->file_count);
+		std::remove(oldest.c_str());
+	}
+
+	std::string filename = this->path + "." + std::to_string(this->file_number);
+	this->file = std::make_unique<mapping>(filename, this->file_size);
+	this->file_number += 1;
+
+	uint8_t *pos = this->file->get();
+	std::memcpy(pos, binary::magic, sizeof(binary::magic));
+	pos += sizeof(binary::magic);
+	put(pos, binary::version);
+	put(pos, binary::byte_order_marker);
+	this->offset = binary::header_size;
+
+	// every file is decodable on its own
+	this->static_ids.clear();
+	this->source_ids.clear();
+	this->next_id = 0;
+}
+
+
+uint32_t BinarySink::intern(const char *str) {
+	auto it = this->static_ids.find(str);
+	if (it != std::end(this->static_ids)) [[likely]] {
+		return it->second;
+	}
+
+	uint32_t id = this->write_string(str);
+	this->static_ids.emplace(str, id);
+	return id;
+}
+
+
+uint32_t BinarySink::intern(const std::string &str) {
+	auto it = this->source_ids.find(str);
+	if (it != std::end(this->source_ids)) [[likely]] {
+		return it->second;
+	}
+
+	uint32_t id = this->write_string(str);
+	this->source_ids.emplace(str, id);
+	return id;
+}
+
+
+uint32_t BinarySink::write_string(std::string_view str) {
+	uint32_t id = this->next_id;
+	this->next_id += 1;
+
+	uint8_t *pos = this->reserve(binary::string_record_size + str.size());
+	put(pos, binary::record_type::STRING);
+	put(pos, id);
+	put(pos, static_cast<uint32_t>(str.size()));
+	std::memcpy(pos, str.data(), str.size());
+
+	return id;
+}
+
+
+uint8_t *BinarySink::reserve(size_t size) {
+	// output_log_message() rotates the file before writing a message,
+	// so the message and its strings always fit
+	ENSURE(this->offset + size <= this->file_size, "binary log record does not fit into the file");
+
+	uint8_t *pos = this->file->get() + this->offset;
+	this->offset += size;
+	return pos;
+}
+
+} // namespace openage::log
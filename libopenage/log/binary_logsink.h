@@ -0,0 +1,139 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "../util/compiler.h"
+#include "logsink.h"
+
+namespace openage::log {
+class LogSource;
+struct message;
+
+/**
+ * Log sink that writes compact binary records to memory-mapped files.
+ *
+ * Source files, function names and log source names are stored once per
+ * file and then referenced by id, so a message only costs its text and
+ * a few integers. Because the files are mapped, the messages are written
+ * by the OS even if the process crashes.
+ *
+ * When a file is full, the sink continues in the next one and deletes the
+ * oldest file if there are more than \p file_count. Files are named
+ * <path>.<number>, counting up from 0.
+ *
+ * Use binary::decode_binary_log() or `openage log-decode` to convert the files
+ * to the text format of FileSink.
+ */
+class OAAPI BinarySink : public LogSink {
+public:
+	/**
+	 * Create a new binary log sink.
+	 *
+	 * Existing files with the same path are overwritten.
+	 *
+	 * @param path Path of the log files without the file number.
+	 * @param file_size Size of one log file in bytes.
+	 * @param file_count Maximum number of log files that are kept.
+	 */
+	BinarySink(const std::string &path,
+	           size_t file_size = 16 * 1024 * 1024,
+	           size_t file_count = 4);
+	~BinarySink();
+
+	/**
+	 * Get the path of the file that is currently written.
+	 *
+	 * @return Path of the current log file.
+	 */
+	std::string get_current_file() const;
+
+private:
+	void output_log_message(const message &msg, LogSource *source) override;
+
+	/**
+	 * Close the current file and open the next one.
+	 */
+	void rotate();
+
+	/**
+	 * Get the id of a string with static storage, e.g. message::filename,
+	 * and write the string to the file if it was not used in it before.
+	 */
+	uint32_t intern(const char *str);
+
+	/**
+	 * Get the id of a log source name, writing it to the file if necessary.
+	 */
+	uint32_t intern(const std::string &str);
+
+	/**
+	 * Write a string record to the file.
+	 */
+	uint32_t write_string(std::string_view str);
+
+	/**
+	 * Make room for a record in the current file, rotating it if necessary.
+	 *
+	 * @return Pointer to the reserved space.
+	 */
+	uint8_t *reserve(size_t size);
+
+	/**
+	 * Memory-mapped file, defined by the platform-specific implementation.
+	 */
+	struct mapping;
+
+	/**
+	 * Path of the log files without the file number.
+	 */
+	const std::string path;
+
+	/**
+	 * Size of one log file.
+	 */
+	const size_t file_size;
+
+	/**
+	 * Maximum number of log files that are kept.
+	 */
+	const size_t file_count;
+
+	/**
+	 * Number of the current file.
+	 */
+	size_t file_number;
+
+	/**
+	 * Current file.
+	 */
+	std::unique_ptr<mapping> file;
+
+	/**
+	 * Write position in the current file.
+	 */
+	size_t offset;
+
+	/**
+	 * Ids of the static strings in the current file.
+	 */
+	std::unordered_map<const char *, uint32_t> static_ids;
+
+	/**
+	 * Ids of the log source names in the current file.
+	 */
+	std::unordered_map<std::string, uint32_t> source_ids;
+
+	/**
+	 * Next free string id in the current file.
+	 */
+	uint32_t next_id;
+};
+
+} // namespace openage::log
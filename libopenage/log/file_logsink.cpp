@@ -1,8 +1,9 @@
-// Copyright 2015-2023 the openage authors. See copying.md for legal info.
+// Copyright 2015-2026 the openage authors. See copying.md for legal info.
 
 #include "file_logsink.h"
 
 #include <iomanip>
+#include <ostream>
 #include <string>
 
 #include "log/level.h"
@@ -18,13 +19,19 @@ FileSink::FileSink(const char *filename, bool append) :
 
 
 void FileSink::output_log_message(const message &msg, LogSource *source) {
-	this->outfile << msg.lvl->name << "|";
-	this->outfile << source->logsource_name() << "|";
-	this->outfile << msg.filename << ":" << msg.lineno << "|";
-	this->outfile << msg.functionname << "|";
-	this->outfile << msg.thread_id << "|";
-	this->outfile << std::setprecision(7) << std::fixed << msg.timestamp / 1e9 << "|";
-	this->outfile << msg.text << std::endl;
+	write_log_line(this->outfile, msg, source->logsource_name());
+	this->outfile.flush();
+}
+
+
+void write_log_line(std::ostream &out, const message &msg, const std::string &source_name) {
+	out << msg.lvl->name << "|";
+	out << source_name << "|";
+	out << msg.filename << ":" << msg.lineno << "|";
+	out << msg.functionname << "|";
+	out << msg.thread_id << "|";
+	out << std::setprecision(7) << std::fixed << msg.timestamp / 1e9 << "|";
+	out << msg.text << "\n";
 }
 
 } // namespace openage::log
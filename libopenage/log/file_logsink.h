@@ -1,8 +1,10 @@
-// Copyright 2015-2023 the openage authors. See copying.md for legal info.
+// Copyright 2015-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
 #include <fstream>
+#include <iosfwd>
+#include <string>
 
 #include "logsink.h"
 
@@ -21,5 +23,15 @@ private:
 	std::ofstream outfile;
 };
 
+
+/**
+ * Write a message as a line in the text format of FileSink.
+ *
+ * @param out Output stream.
+ * @param msg Message.
+ * @param source_name Name of the log source of the message.
+ */
+void write_log_line(std::ostream &out, const message &msg, const std::string &source_name);
+
 } // namespace log
 } // namespace openage
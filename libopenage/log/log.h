@@ -1,10 +1,11 @@
-// Copyright 2015-2023 the openage authors. See copying.md for legal info.
+// Copyright 2015-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
 // pxd: from libopenage.log.level cimport level
 #include "../util/compiler.h"
 #include "./level.h"
+#include "./logsink.h"
 #include "./message.h"
 
 
@@ -31,3 +32,36 @@ OAAPI void set_level(level lvl);
 
 } // namespace log
 } // namespace openage
+
+
+// Level-gated logging.
+//
+// Unlike log::log(MSG(...) << ...), the message is only built, and its
+// arguments are only evaluated, if a log sink accepts the level.
+// Levels below LOG_MIN_LEVEL (a build option) are removed at compile time.
+//
+// LOG_DBG("inserting event " << event->get_eventhandler()->id());
+
+
+// true if messages of the level are compiled in and accepted by a log sink
+#define LOG_ENABLED(LVL) \
+	(::openage::log::level::LVL >= ::openage::log::level::LOG_MIN_LEVEL \
+	 and ::openage::log::LogSinkList::instance().supports_loglevel(::openage::log::level::LVL))
+
+
+// for use with log::level literals, like MSG
+#define LOG_MSG(LVL, ...) \
+	do { \
+		if constexpr (::openage::log::level::LVL >= ::openage::log::level::LOG_MIN_LEVEL) { \
+			if (::openage::log::LogSinkList::instance().supports_loglevel( \
+					::openage::log::level::LVL)) [[unlikely]] { \
+				::openage::log::log(MSG(LVL) << __VA_ARGS__); \
+			} \
+		} \
+	} \
+	while (0)
+
+
+// convenience shorteners for the levels that are usually disabled
+#define LOG_SPAM(...) LOG_MSG(spam, __VA_ARGS__)
+#define LOG_DBG(...) LOG_MSG(dbg, __VA_ARGS__)
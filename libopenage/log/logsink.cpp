@@ -1,4 +1,4 @@
-// Copyright 2015-2018 the openage authors. See copying.md for legal info.
+// Copyright 2015-2026 the openage authors. See copying.md for legal info.
 
 #include "logsink.h"
 
@@ -64,10 +64,11 @@ void LogSinkList::loglevel_changed() {
 
 
 void LogSinkList::set_lowest_loglevel() {
-	this->lowest_loglevel = level::MAX;
+	level lowest = level::MAX;
 	for (auto *sink : this->sinks) {
-		this->lowest_loglevel = std::min(this->lowest_loglevel, sink->loglevel);
+		lowest = std::min(lowest, sink->loglevel);
 	}
+	this->lowest_loglevel.store(lowest->numeric, std::memory_order_relaxed);
 }
 
 
@@ -78,9 +79,4 @@ void LogSinkList::remove(LogSink *sink) {
 }
 
 
-bool LogSinkList::supports_loglevel(level loglevel) const {
-	std::lock_guard<std::mutex> lock(this->sinks_mutex);
-	return loglevel >= this->lowest_loglevel;
-}
-
 }} // namespace openage::log
@@ -1,7 +1,8 @@
-// Copyright 2015-2024 the openage authors. See copying.md for legal info.
+// Copyright 2015-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
+#include <atomic>
 #include <list>
 #include <mutex>
 
@@ -63,7 +64,15 @@ public:
 
 	void remove(LogSink *sink);
 
-	bool supports_loglevel(level loglevel) const;
+	/**
+	 * Check if any sink accepts messages of a log level.
+	 *
+	 * Does not lock the sink list, so it is cheap enough to be
+	 * checked before a message is built (see LOG_MSG).
+	 */
+	inline bool supports_loglevel(level loglevel) const {
+		return loglevel->numeric >= this->lowest_loglevel.load(std::memory_order_relaxed);
+	}
 
 	void loglevel_changed();
 
@@ -76,7 +85,10 @@ private:
 
 	void set_lowest_loglevel();
 
-	level lowest_loglevel;
+	/**
+	 * Numeric value of the lowest log level that is accepted by any sink.
+	 */
+	std::atomic<int> lowest_loglevel;
 };
 
 
@@ -1,10 +1,11 @@
-// Copyright 2015-2023 the openage authors. See copying.md for legal info.
+// Copyright 2015-2026 the openage authors. See copying.md for legal info.
 
 #include "logsource.h"
 
 #include <cstddef>
 #include <string>
 
+#include "log/async_logger.h"
 #include "log/logsink.h"
 #include "log/stdout_logsink.h"
 #include "util/compiler.h"
@@ -23,6 +24,10 @@ void LogSource::log(const message &msg) {
 	// (and thus at least one sink exists).
 	global_stdoutsink();
 
+	if (AsyncLogger::instance().push(msg, this)) {
+		return;
+	}
+
 	LogSinkList::instance().log(msg, this);
 }
 
@@ -1,13 +1,27 @@
-// Copyright 2014-2023 the openage authors. See copying.md for legal info.
+// Copyright 2014-2026 the openage authors. See copying.md for legal info.
 
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
 #include <string>
 #include <thread>
+#include <vector>
 
+#include "log/async_logger.h"
+#include "log/binary_log.h"
+#include "log/binary_logsink.h"
+#include "log/log.h"
 #include "log/logsink.h"
 #include "log/logsource.h"
 #include "log/message.h"
+#include "testing/testing.h"
 #include "util/stringformatter.h"
+#include "util/timing.h"
 #include "util/strings.h"
 
 
@@ -62,4 +76,247 @@ void demo() {
 	t1.join();
 }
 
+
+void level_gate() {
+	std::ostringstream out;
+	TestLogSink sink{out};
+	sink.set_loglevel(level::crit);
+
+	int evaluated = 0;
+	auto evaluate = [&]() {
+		evaluated += 1;
+		return evaluated;
+	};
+
+	// accepted messages are built as usual
+	LOG_MSG(crit, "evaluated " << evaluate());
+	TESTEQUALS(evaluated, 1);
+	(out.str().find("evaluated 1") != std::string::npos) or TESTFAIL;
+
+	// the sink list tracks the lowest level of the sinks
+	sink.set_loglevel(level::MIN);
+	LogSinkList::instance().supports_loglevel(level::MIN) or TESTFAIL;
+	sink.set_loglevel(level::crit);
+	(not LogSinkList::instance().supports_loglevel(level::MIN)) or TESTFAIL;
+
+	// levels below LOG_MIN_LEVEL are never evaluated, even if a sink accepts them
+	sink.set_loglevel(level::MIN);
+	LOG_MSG(MIN, "evaluated " << evaluate());
+	TESTEQUALS(evaluated, 1);
+	(not LOG_ENABLED(MIN)) or TESTFAIL;
+}
+
+
+/**
+ * Sink that records the messages it receives.
+ */
+class RecordingLogSink : public LogSink {
+public:
+	RecordingLogSink() {
+		this->set_loglevel(level::MIN);
+	}
+
+	std::vector<std::string> get_messages() {
+		std::lock_guard<std::mutex> lock{this->mutex};
+		return this->messages;
+	}
+
+	/**
+	 * While set, the sink blocks the thread that passes a message to it.
+	 */
+	std::atomic<bool> blocked{false};
+
+private:
+	void output_log_message(const message &msg, LogSource * /*source*/) override {
+		while (this->blocked.load()) {
+			std::this_thread::yield();
+		}
+
+		std::lock_guard<std::mutex> lock{this->mutex};
+		this->messages.push_back(msg.text);
+	}
+
+	std::mutex mutex;
+	std::vector<std::string> messages;
+};
+
+
+void async_logger() {
+	constexpr int thread_count = 4;
+	constexpr int message_count = 1000;
+
+	TestLogSource logger;
+	AsyncLogger &async = AsyncLogger::instance();
+	async.start(64);
+	async.is_running() or TESTFAIL;
+
+	// messages of every thread arrive completely and in order
+	{
+		RecordingLogSink sink;
+
+		std::vector<std::thread> threads;
+		for (int t = 0; t < thread_count; ++t) {
+			threads.emplace_back([&, t]() {
+				for (int i = 0; i < message_count; ++i) {
+					logger.log(MSG(spam) << t << " " << i);
+				}
+			});
+		}
+		for (auto &thread : threads) {
+			thread.join();
+		}
+		async.flush();
+
+		auto messages = sink.get_messages();
+		TESTEQUALS(messages.size(), static_cast<size_t>(thread_count * message_count));
+
+		std::map<int, int> next;
+		for (const auto &text : messages) {
+			std::istringstream in{text};
+			int t, i;
+			in >> t >> i;
+			TESTEQUALS(i, next[t]);
+			next[t] += 1;
+		}
+	}
+
+	// full buffers drop messages when the sink is stuck
+	for (auto policy : {overflow_policy::DROP_NEWEST, overflow_policy::DROP_OLDEST}) {
+		RecordingLogSink sink;
+		async.set_overflow_policy(policy);
+		size_t dropped_before = async.get_dropped();
+
+		sink.blocked.store(true);
+
+		// threads get fresh buffers
+		std::thread producer{[&]() {
+			for (int i = 0; i < message_count; ++i) {
+				logger.log(MSG(spam) << i);
+			}
+		}};
+		producer.join();
+
+		(async.get_dropped() > dropped_before) or TESTFAIL;
+
+		sink.blocked.store(false);
+		async.flush();
+
+		// no message was lost without being counted
+		size_t received = 0;
+		for (const auto &text : sink.get_messages()) {
+			if (text.find("dropped") == std::string::npos) {
+				received += 1;
+			}
+		}
+		TESTEQUALS(received + async.get_dropped() - dropped_before, static_cast<size_t>(message_count));
+	}
+
+	// messages are logged synchronously after stopping
+	async.stop();
+	(not async.is_running()) or TESTFAIL;
+	{
+		RecordingLogSink sink;
+		logger.log(MSG(spam) << "sync");
+		TESTEQUALS(sink.get_messages().size(), 1u);
+	}
+}
+
+
+class OtherLogSource : public LogSource {
+public:
+	std::string logsource_name() override {
+		return "OtherLogSource";
+	}
+};
+
+
+void binary_log() {
+	constexpr int message_count = 1000;
+
+	auto dir = std::filesystem::temp_directory_path() / "openage_binary_log_test";
+	std::filesystem::remove_all(dir);
+	std::filesystem::create_directories(dir);
+	std::string path = (dir / "log").string();
+
+	TestLogSource logger;
+	OtherLogSource other;
+
+	int64_t middle_time = 0;
+	{
+		// small files, so the sink has to rotate
+		BinarySink sink{path, 16 * 1024, 3};
+		sink.set_loglevel(level::MIN);
+
+		for (int i = 0; i < message_count; ++i) {
+			if (i == message_count / 2) {
+				middle_time = timing::get_real_time();
+			}
+			logger.log(MSG(spam) << "spam " << i);
+			other.log(MSG(warn) << "warn " << i);
+		}
+
+		// too long for one file
+		logger.log(MSG(spam) << std::string(32 * 1024, 'x'));
+	}
+
+	// only the newest files are kept
+	std::vector<std::string> files;
+	for (int i = 0; i < message_count; ++i) {
+		std::string file = path + "." + std::to_string(i);
+		if (std::filesystem::exists(file)) {
+			files.push_back(file);
+		}
+	}
+	TESTEQUALS(files.size(), 3u);
+	(files[0] != path + ".0") or TESTFAIL;
+
+	std::string output = (dir / "log.txt").string();
+	auto read_lines = [&]() {
+		std::ifstream in{output};
+		std::vector<std::string> lines;
+		for (std::string line; std::getline(in, line);) {
+			lines.push_back(line);
+		}
+		return lines;
+	};
+	auto count_lines = [](const std::vector<std::string> &lines, const std::string &prefix) {
+		return static_cast<size_t>(std::count_if(std::begin(lines), std::end(lines), [&](const auto &line) {
+			return line.starts_with(prefix);
+		}));
+	};
+
+	// the decoded messages use the text format of FileSink
+	binary::binary_log_filter filter;
+	size_t count = binary::decode_binary_log(files, output, filter);
+	auto lines = read_lines();
+	TESTEQUALS(lines.size(), count);
+	(count > 2) or TESTFAIL;
+	(lines[lines.size() - 2].ends_with("|warn " + std::to_string(message_count - 1))) or TESTFAIL;
+	(lines.back().starts_with("SPAM|TestLogSource|")) or TESTFAIL;
+	(lines.back().find(std::string(1024, 'x')) != std::string::npos) or TESTFAIL;
+
+	size_t warn_count = count_lines(lines, "WARN|OtherLogSource|");
+	size_t spam_count = count_lines(lines, "SPAM|TestLogSource|");
+	TESTEQUALS(warn_count + spam_count, count);
+
+	// filter by level
+	filter.min_level = level::warn.numeric;
+	TESTEQUALS(binary::decode_binary_log(files, output, filter), warn_count);
+
+	// filter by source
+	filter.min_level = level::MIN.numeric;
+	filter.source = "TestLogSource";
+	TESTEQUALS(binary::decode_binary_log(files, output, filter), spam_count);
+
+	// filter by time
+	filter.source = "";
+	filter.end = middle_time;
+	size_t before = binary::decode_binary_log(files, output, filter);
+	(before < count) or TESTFAIL;
+	for (const auto &line : read_lines()) {
+		(line.find("|warn " + std::to_string(message_count / 2)) == std::string::npos) or TESTFAIL;
+	}
+
+	std::filesystem::remove_all(dir);
+}
 } // namespace openage::log::tests
@@ -1,4 +1,4 @@
-// Copyright 2015-2023 the openage authors. See copying.md for legal info.
+// Copyright 2015-2026 the openage authors. See copying.md for legal info.
 
 #include "main.h"
 
@@ -6,6 +6,8 @@
 
 #include "cvar/cvar.h"
 #include "engine/engine.h"
+#include "log/async_logger.h"
+#include "log/binary_logsink.h"
 #include "util/timer.h"
 
 namespace openage {
@@ -31,9 +33,27 @@ int run_game(const main_arguments &args) {
 		run_mode = openage::engine::Engine::mode::HEADLESS;
 	}
 
-	openage::engine::Engine engine{run_mode, args.root_path, args.mods, args.gl_debug};
+	// compact log of all debug messages
+	std::unique_ptr<log::BinarySink> binary_log;
+	if (not args.binary_log.empty()) {
+		binary_log = std::make_unique<log::BinarySink>(args.binary_log);
+	}
+
+	// the simulation, presenter and job threads don't wait for the log sinks
+	log::AsyncLogger::instance().start();
+
+	try {
+		openage::engine::Engine engine{run_mode, args.root_path, args.mods, args.gl_debug};
+
+		engine.loop();
+	}
+	catch (...) {
+		// log everything before the exception is reported
+		log::AsyncLogger::instance().stop();
+		throw;
+	}
 
-	engine.loop();
+	log::AsyncLogger::instance().stop();
 
 	return 0;
 }
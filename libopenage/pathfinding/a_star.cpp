@@ -1,4 +1,4 @@
-// Copyright 2014-2023 the openage authors. See copying.md for legal info.
+// Copyright 2014-2026 the openage authors. See copying.md for legal info.
 
 /** @file
  *
@@ -14,7 +14,7 @@
 
 #include <cmath>
 
-#include "../datastructure/pairing_heap.h"
+#include "../datastructure/pooled_pairing_heap.h"
 #include "../log/log.h"
 #include "../util/strings.h"
 #include "heuristics.h"
@@ -58,7 +58,6 @@ Path a_star(coord::phys3 start,
 	// add starting node
 	node_pt start_node = std::make_shared<Node>(start, nullptr, .0f, heuristic(start));
 	visited_tiles[start_node->position] = start_node;
-	node_candidates.push(start_node);
 
 	start_node->heap_node = node_candidates.push(start_node);
 
@@ -0,0 +1,44 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#include "cost_field.h"
+
+#include "error/error.h"
+
+
+namespace openage::path {
+
+CostField::CostField(const util::Vector2s &size,
+                     tile_cost_t cost) :
+	size{size},
+	costs(size[0] * size[1], cost),
+	changes{0} {}
+
+const util::Vector2s &CostField::get_size() const {
+	return this->size;
+}
+
+void CostField::set_cost(const coord::tile_delta &pos, tile_cost_t cost) {
+	ENSURE(pos.ne >= 0 and static_cast<size_t>(pos.ne) < this->size[0]
+	           and pos.se >= 0 and static_cast<size_t>(pos.se) < this->size[1],
+	       "tile " << pos << " is outside of cost field");
+
+	this->costs[pos.ne * this->size[1] + pos.se] = cost;
+	this->changes += 1;
+}
+
+void CostField::set_cost(size_t idx, tile_cost_t cost) {
+	ENSURE(idx < this->costs.size(), "tile index " << idx << " is outside of cost field");
+
+	this->costs[idx] = cost;
+	this->changes += 1;
+}
+
+const std::vector<tile_cost_t> &CostField::get_costs() const {
+	return this->costs;
+}
+
+size_t CostField::get_changes() const {
+	return this->changes;
+}
+
+} // namespace openage::path
@@ -0,0 +1,113 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "coord/tile.h"
+#include "pathfinding/definitions.h"
+#include "util/vector.h"
+
+
+namespace openage::path {
+
+/**
+ * Movement costs of the tiles in a rectangular area, e.g. a terrain chunk.
+ *
+ * Costs are stored in a flat array with the same layout as the tiles
+ * of a terrain chunk, i.e. `index = ne * size[1] + se`.
+ */
+class CostField {
+public:
+	/**
+	 * Create a cost field with the same cost for every tile.
+	 *
+	 * @param size Size of the field (in tiles).
+	 * @param cost Initial cost of the tiles.
+	 */
+	CostField(const util::Vector2s &size,
+	          tile_cost_t cost = COST_MIN);
+
+	~CostField() = default;
+
+	/**
+	 * Get the size of the field.
+	 *
+	 * @return Size of the field (in tiles).
+	 */
+	const util::Vector2s &get_size() const;
+
+	/**
+	 * Get the cost of a tile.
+	 *
+	 * @param pos Position of the tile relative to the field origin.
+	 *
+	 * @return Movement cost of the tile.
+	 */
+	tile_cost_t get_cost(const coord::tile_delta &pos) const {
+		return this->costs[pos.ne * this->size[1] + pos.se];
+	}
+
+	/**
+	 * Get the cost of a tile.
+	 *
+	 * @param idx Index of the tile in the field.
+	 *
+	 * @return Movement cost of the tile.
+	 */
+	tile_cost_t get_cost(size_t idx) const {
+		return this->costs[idx];
+	}
+
+	/**
+	 * Set the cost of a tile.
+	 *
+	 * @param pos Position of the tile relative to the field origin.
+	 * @param cost New movement cost of the tile.
+	 */
+	void set_cost(const coord::tile_delta &pos, tile_cost_t cost);
+
+	/**
+	 * Set the cost of a tile.
+	 *
+	 * @param idx Index of the tile in the field.
+	 * @param cost New movement cost of the tile.
+	 */
+	void set_cost(size_t idx, tile_cost_t cost);
+
+	/**
+	 * Get the costs of all tiles.
+	 *
+	 * @return Costs of the tiles.
+	 */
+	const std::vector<tile_cost_t> &get_costs() const;
+
+	/**
+	 * Get the number of changes to the costs since the field was created.
+	 *
+	 * Can be used by users of the field that cache the costs
+	 * to check whether they are still up to date.
+	 *
+	 * @return Change counter of the field.
+	 */
+	size_t get_changes() const;
+
+private:
+	/**
+	 * Size of the field.
+	 */
+	util::Vector2s size;
+
+	/**
+	 * Costs of the tiles.
+	 */
+	std::vector<tile_cost_t> costs;
+
+	/**
+	 * Number of changes to the costs.
+	 */
+	size_t changes;
+};
+
+} // namespace openage::path
@@ -0,0 +1,8 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#include "definitions.h"
+
+
+namespace openage::path {
+
+} // namespace openage::path
@@ -0,0 +1,86 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+
+#include "coord/tile.h"
+
+
+namespace openage::path {
+
+/**
+ * Movement cost of a single tile on the pathfinding grid.
+ */
+using tile_cost_t = uint8_t;
+
+/**
+ * Minimum movement cost of a passable tile.
+ */
+constexpr tile_cost_t COST_MIN = 1;
+
+/**
+ * Maximum movement cost of a passable tile.
+ */
+constexpr tile_cost_t COST_MAX = 254;
+
+/**
+ * Cost of tiles that can't be passed.
+ */
+constexpr tile_cost_t COST_IMPASSABLE = 255;
+
+/**
+ * Direction from a tile to one of its neighbors, i.e. an index into \p DIRECTIONS.
+ */
+using flow_t = uint8_t;
+
+/**
+ * Direction of tiles without a next tile, e.g. the target of a flow field.
+ */
+constexpr flow_t FLOW_NONE = 8;
+
+/**
+ * Offsets of the neighbors of a tile. Straight neighbors come first,
+ * and the opposite of direction \p i is `(i + 2) % 4` (plus 4 for diagonals).
+ */
+constexpr std::array<coord::tile_delta, 8> DIRECTIONS{
+	coord::tile_delta{1, 0},
+	coord::tile_delta{0, 1},
+	coord::tile_delta{-1, 0},
+	coord::tile_delta{0, -1},
+	coord::tile_delta{1, 1},
+	coord::tile_delta{-1, 1},
+	coord::tile_delta{-1, -1},
+	coord::tile_delta{1, -1},
+};
+
+/**
+ * Path cost of a straight step onto a tile with cost 1.
+ */
+constexpr uint32_t STEP_COST_STRAIGHT = 10;
+
+/**
+ * Path cost of a diagonal step onto a tile with cost 1 (approx. `10 * sqrt(2)`).
+ */
+constexpr uint32_t STEP_COST_DIAGONAL = 14;
+
+/**
+ * Lowest possible path cost between two tiles (octile distance).
+ *
+ * @param from Start tile.
+ * @param to Target tile.
+ *
+ * @return Path cost if all tiles in between have the cost \p COST_MIN.
+ */
+inline uint32_t octile_distance(const coord::tile &from, const coord::tile &to) {
+	auto delta_ne = static_cast<uint32_t>(std::abs(to.ne - from.ne));
+	auto delta_se = static_cast<uint32_t>(std::abs(to.se - from.se));
+	auto [shorter, longer] = std::minmax(delta_ne, delta_se);
+
+	return STEP_COST_STRAIGHT * COST_MIN * (longer - shorter) + STEP_COST_DIAGONAL * COST_MIN * shorter;
+}
+
+} // namespace openage::path
@@ -0,0 +1,125 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#include "flow_field.h"
+
+#include "error/error.h"
+#include "pathfinding/cost_field.h"
+#include "pathfinding/grid.h"
+
+
+namespace openage::path {
+
+FlowField::FlowField(const std::shared_ptr<Grid> &grid,
+                     const coord::tile &target,
+                     std::vector<std::vector<Integrator::source>> &&sources) :
+	grid{grid},
+	target{target},
+	sources{std::move(sources)},
+	costs{},
+	flows{},
+	integrated_chunks{0},
+	integrator{} {
+	size_t chunk_count = this->grid->get_size()[0] * this->grid->get_size()[1];
+	ENSURE(this->sources.size() == chunk_count,
+	       "flow field needs sources for " << chunk_count
+	                                       << " chunks, but got " << this->sources.size());
+
+	this->costs.resize(chunk_count);
+	this->flows.resize(chunk_count);
+}
+
+const coord::tile &FlowField::get_target() const {
+	return this->target;
+}
+
+uint32_t FlowField::get_cost(const coord::tile &tile) {
+	if (not this->grid->contains(tile)) [[unlikely]] {
+		return Integrator::unreachable;
+	}
+
+	auto [chunk, idx] = this->to_index(tile);
+	this->integrate_chunk(chunk);
+
+	return this->costs[chunk][idx];
+}
+
+flow_t FlowField::get_flow(const coord::tile &tile) {
+	if (not this->grid->contains(tile)) [[unlikely]] {
+		return FLOW_NONE;
+	}
+
+	auto [chunk, idx] = this->to_index(tile);
+	this->integrate_chunk(chunk);
+
+	return this->flows[chunk][idx];
+}
+
+std::vector<coord::tile> FlowField::get_path(const coord::tile &start) {
+	if (not this->grid->contains(start)) [[unlikely]] {
+		return {};
+	}
+
+	std::vector<coord::tile> waypoints{start};
+
+	// path costs decrease along the flow, so this limit is never reached
+	// unless the cost fields changed after the flow field was created
+	auto &tile_size = this->grid->get_tile_size();
+	size_t max_steps = tile_size[0] * tile_size[1];
+
+	coord::tile tile = start;
+	flow_t direction = FLOW_NONE;
+	for (size_t step = 0; step < max_steps; ++step) {
+		flow_t flow = this->get_flow(tile);
+		if (flow == FLOW_NONE) {
+			break;
+		}
+
+		// only keep tiles where the direction changes
+		if (step > 0 and flow != direction) {
+			waypoints.push_back(tile);
+		}
+
+		direction = flow;
+		tile = tile + DIRECTIONS[flow];
+	}
+
+	if (tile != waypoints.back()) {
+		waypoints.push_back(tile);
+	}
+
+	return waypoints;
+}
+
+size_t FlowField::get_integrated_chunks() const {
+	return this->integrated_chunks;
+}
+
+void FlowField::integrate_chunk(size_t chunk) {
+	if (not this->costs[chunk].empty()) [[likely]] {
+		return;
+	}
+
+	auto &size = this->grid->get_size();
+	const CostField &field = *this->grid->get_chunk({chunk / size[1], chunk % size[1]});
+
+	this->integrator.integrate(field,
+	                           this->sources[chunk],
+	                           true,
+	                           this->costs[chunk],
+	                           &this->flows[chunk]);
+	this->integrated_chunks += 1;
+}
+
+std::pair<size_t, uint32_t> FlowField::to_index(const coord::tile &tile) const {
+	auto &size = this->grid->get_size();
+	auto &chunk_size = this->grid->get_chunk_size();
+
+	size_t chunk_ne = tile.ne / chunk_size[0];
+	size_t chunk_se = tile.se / chunk_size[1];
+	auto local_ne = static_cast<uint32_t>(tile.ne - chunk_ne * chunk_size[0]);
+	auto local_se = static_cast<uint32_t>(tile.se - chunk_se * chunk_size[1]);
+
+	return {chunk_ne * size[1] + chunk_se, local_ne * static_cast<uint32_t>(chunk_size[1]) + local_se};
+}
+
+} // namespace openage::path
@@ -0,0 +1,144 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "coord/tile.h"
+#include "pathfinding/definitions.h"
+#include "pathfinding/integrator.h"
+
+
+namespace openage::path {
+class Grid;
+
+/**
+ * Flow field that leads to a target tile from every tile of a grid.
+ *
+ * A flow field has an integration field, i.e. the path cost from each tile
+ * to the target, and a direction field, i.e. the direction of the next tile
+ * on the path. Units that move to the same target can share the field and
+ * look up the next tile in constant time.
+ *
+ * The fields of a chunk are computed the first time one of its tiles is
+ * sampled. Paths between chunks pass the portals of the hierarchical
+ * pathfinder, which also provides the path costs from the portals
+ * to the target (see \p HierarchicalPathfinder::get_flow_field()).
+ *
+ * Sampling is not thread-safe, because it may compute the fields of a chunk.
+ */
+class FlowField {
+public:
+	/**
+	 * Create a new flow field.
+	 *
+	 * @param grid Grid of the field.
+	 * @param target Target tile.
+	 * @param sources Source tiles for integrating each chunk, i.e. the target
+	 *                and the portal tiles with their path costs to the target.
+	 */
+	FlowField(const std::shared_ptr<Grid> &grid,
+	          const coord::tile &target,
+	          std::vector<std::vector<Integrator::source>> &&sources);
+
+	~FlowField() = default;
+
+	/**
+	 * Get the target of the field.
+	 *
+	 * @return Target tile.
+	 */
+	const coord::tile &get_target() const;
+
+	/**
+	 * Get the path cost from a tile to the target.
+	 *
+	 * @param tile Tile on the grid.
+	 *
+	 * @return Path cost. \p Integrator::unreachable if the target can't be reached.
+	 */
+	uint32_t get_cost(const coord::tile &tile);
+
+	/**
+	 * Get the direction of the next tile on the path to the target.
+	 *
+	 * @param tile Tile on the grid.
+	 *
+	 * @return Flow direction. \p FLOW_NONE for the target and tiles
+	 *         that can't reach the target.
+	 */
+	flow_t get_flow(const coord::tile &tile);
+
+	/**
+	 * Follow the flow from a tile.
+	 *
+	 * @param start Start tile.
+	 *
+	 * @return Waypoints of the path, including the start and the end tile.
+	 *         Only tiles where the path changes direction are waypoints.
+	 *         The path ends before the target if it can't be reached.
+	 *         Empty if the start is not on the grid.
+	 */
+	std::vector<coord::tile> get_path(const coord::tile &start);
+
+	/**
+	 * Get the number of chunks whose fields have been computed.
+	 *
+	 * @return Number of integrated chunks.
+	 */
+	size_t get_integrated_chunks() const;
+
+private:
+	/**
+	 * Compute the fields of a chunk if they don't exist yet.
+	 *
+	 * @param chunk Index of the chunk.
+	 */
+	void integrate_chunk(size_t chunk);
+
+	/**
+	 * Get the index of a chunk and the index of a tile in the chunk.
+	 */
+	std::pair<size_t, uint32_t> to_index(const coord::tile &tile) const;
+
+	/**
+	 * Grid of the field.
+	 */
+	std::shared_ptr<Grid> grid;
+
+	/**
+	 * Target tile.
+	 */
+	coord::tile target;
+
+	/**
+	 * Source tiles for integrating each chunk.
+	 */
+	std::vector<std::vector<Integrator::source>> sources;
+
+	/**
+	 * Integration field of each chunk. Empty if the chunk hasn't been integrated.
+	 */
+	std::vector<std::vector<uint32_t>> costs;
+
+	/**
+	 * Direction field of each chunk. Empty if the chunk hasn't been integrated.
+	 */
+	std::vector<std::vector<flow_t>> flows;
+
+	/**
+	 * Number of chunks that have been integrated.
+	 */
+	size_t integrated_chunks;
+
+	/**
+	 * Integrator for the chunks.
+	 */
+	Integrator integrator;
+};
+
+} // namespace openage::path
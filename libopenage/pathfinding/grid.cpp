@@ -0,0 +1,52 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#include "grid.h"
+
+#include "error/error.h"
+
+
+namespace openage::path {
+
+Grid::Grid(const util::Vector2s &size,
+           const util::Vector2s &chunk_size) :
+	size{size},
+	chunk_size{chunk_size},
+	tile_size{size[0] * chunk_size[0], size[1] * chunk_size[1]},
+	chunks{} {
+	ENSURE(chunk_size[0] > 0 and chunk_size[1] > 0, "grid chunks must not be empty");
+
+	// chunks that are not set are impassable
+	auto impassable = std::make_shared<CostField>(chunk_size, COST_IMPASSABLE);
+	this->chunks.resize(size[0] * size[1], impassable);
+}
+
+const util::Vector2s &Grid::get_size() const {
+	return this->size;
+}
+
+const util::Vector2s &Grid::get_chunk_size() const {
+	return this->chunk_size;
+}
+
+const util::Vector2s &Grid::get_tile_size() const {
+	return this->tile_size;
+}
+
+void Grid::set_chunk(const util::Vector2s &pos,
+                     const std::shared_ptr<CostField> &field) {
+	ENSURE(pos[0] < this->size[0] and pos[1] < this->size[1],
+	       "chunk (" << pos[0] << ", " << pos[1] << ") is outside of the grid");
+	ENSURE(field->get_size() == this->chunk_size,
+	       "cost field size does not match the grid chunk size");
+
+	this->chunks[pos[0] * this->size[1] + pos[1]] = field;
+}
+
+const std::shared_ptr<CostField> &Grid::get_chunk(const util::Vector2s &pos) const {
+	ENSURE(pos[0] < this->size[0] and pos[1] < this->size[1],
+	       "chunk (" << pos[0] << ", " << pos[1] << ") is outside of the grid");
+
+	return this->chunks[pos[0] * this->size[1] + pos[1]];
+}
+
+} // namespace openage::path
@@ -0,0 +1,133 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "coord/tile.h"
+#include "pathfinding/cost_field.h"
+#include "pathfinding/definitions.h"
+#include "util/vector.h"
+
+
+namespace openage::path {
+
+/**
+ * Pathfinding grid of a map, made of equally sized chunks.
+ *
+ * Every chunk has its own cost field. Tiles outside of the grid
+ * and tiles of chunks that were not set are impassable.
+ */
+class Grid {
+public:
+	/**
+	 * Create a new grid.
+	 *
+	 * @param size Size of the grid (in chunks).
+	 * @param chunk_size Size of a chunk (in tiles).
+	 */
+	Grid(const util::Vector2s &size,
+	     const util::Vector2s &chunk_size);
+
+	~Grid() = default;
+
+	/**
+	 * Get the size of the grid.
+	 *
+	 * @return Size of the grid (in chunks).
+	 */
+	const util::Vector2s &get_size() const;
+
+	/**
+	 * Get the size of a chunk.
+	 *
+	 * @return Size of a chunk (in tiles).
+	 */
+	const util::Vector2s &get_chunk_size() const;
+
+	/**
+	 * Get the size of the grid in tiles.
+	 *
+	 * @return Size of the grid (in tiles).
+	 */
+	const util::Vector2s &get_tile_size() const;
+
+	/**
+	 * Set the cost field of a chunk.
+	 *
+	 * @param pos Position of the chunk (in chunks).
+	 * @param field Cost field of the chunk. Must have the chunk size of the grid.
+	 */
+	void set_chunk(const util::Vector2s &pos,
+	               const std::shared_ptr<CostField> &field);
+
+	/**
+	 * Get the cost field of a chunk.
+	 *
+	 * @param pos Position of the chunk (in chunks).
+	 *
+	 * @return Cost field of the chunk.
+	 */
+	const std::shared_ptr<CostField> &get_chunk(const util::Vector2s &pos) const;
+
+	/**
+	 * Check whether a tile is on the grid.
+	 *
+	 * @param tile Tile position.
+	 *
+	 * @return true if the tile is on the grid, else false.
+	 */
+	bool contains(const coord::tile &tile) const {
+		return tile.ne >= 0 and tile.se >= 0
+		       and static_cast<size_t>(tile.ne) < this->tile_size[0]
+		       and static_cast<size_t>(tile.se) < this->tile_size[1];
+	}
+
+	/**
+	 * Get the movement cost of a tile.
+	 *
+	 * @param tile Tile position.
+	 *
+	 * @return Movement cost of the tile. \p COST_IMPASSABLE if the tile is not on the grid.
+	 */
+	tile_cost_t get_cost(const coord::tile &tile) const {
+		if (not this->contains(tile)) [[unlikely]] {
+			return COST_IMPASSABLE;
+		}
+
+		size_t chunk_ne = tile.ne / this->chunk_size[0];
+		size_t chunk_se = tile.se / this->chunk_size[1];
+		coord::tile_delta local{
+			static_cast<coord::tile_t>(tile.ne - chunk_ne * this->chunk_size[0]),
+			static_cast<coord::tile_t>(tile.se - chunk_se * this->chunk_size[1])};
+
+		return this->chunks[chunk_ne * this->size[1] + chunk_se]->get_cost(local);
+	}
+
+private:
+	/**
+	 * Size of the grid (in chunks).
+	 */
+	util::Vector2s size;
+
+	/**
+	 * Size of a chunk (in tiles).
+	 */
+	util::Vector2s chunk_size;
+
+	/**
+	 * Size of the grid (in tiles).
+	 */
+	util::Vector2s tile_size;
+
+	/**
+	 * Cost fields of the chunks.
+	 *
+	 * Layout is the same as for the tiles in a chunk, i.e. `index = ne * size[1] + se`.
+	 */
+	std::vector<std::shared_ptr<CostField>> chunks;
+};
+
+} // namespace openage::path
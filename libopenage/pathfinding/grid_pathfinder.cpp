@@ -0,0 +1,252 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#include "grid_pathfinder.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "error/error.h"
+#include "pathfinding/cost_field.h"
+#include "pathfinding/grid.h"
+
+
+namespace openage::path {
+
+GridPathfinder::GridPathfinder(const std::shared_ptr<Grid> &grid) :
+	grid{grid},
+	stride{0},
+	neighbor_offsets{},
+	costs{},
+	chunk_changes{},
+	tiles{},
+	corridor_tiles{},
+	open_list{},
+	search{0} {
+	auto &size = this->grid->get_tile_size();
+	size_t tile_count = (size[0] + 2) * (size[1] + 2);
+	ENSURE(tile_count < std::numeric_limits<int32_t>::max(),
+	       "grid is too large for the pathfinder");
+
+	// tiles on the border stay impassable
+	this->stride = static_cast<uint32_t>(size[1] + 2);
+	this->costs.resize(tile_count, COST_IMPASSABLE);
+	this->tiles.resize(tile_count, tile_state{0, 0, 0, heap_t::invalid_handle});
+	this->chunk_changes.resize(this->grid->get_size()[0] * this->grid->get_size()[1]);
+
+	for (size_t i = 0; i < DIRECTIONS.size(); ++i) {
+		this->neighbor_offsets[i] = static_cast<int32_t>(DIRECTIONS[i].ne * this->stride + DIRECTIONS[i].se);
+	}
+}
+
+const std::shared_ptr<Grid> &GridPathfinder::get_grid() const {
+	return this->grid;
+}
+
+std::vector<coord::tile> GridPathfinder::find_path(const coord::tile &start,
+                                                   const coord::tile &target) {
+	if (not this->grid->contains(start)) [[unlikely]] {
+		return {};
+	}
+
+	this->update_costs();
+	this->next_search();
+
+	return this->search_path(start, target, false);
+}
+
+std::vector<coord::tile> GridPathfinder::find_path(const coord::tile &start,
+                                                   const coord::tile &target,
+                                                   const std::vector<util::Vector2s> &corridor) {
+	if (not this->grid->contains(start)) [[unlikely]] {
+		return {};
+	}
+
+	this->update_costs();
+	this->next_search();
+
+	if (this->corridor_tiles.empty()) [[unlikely]] {
+		this->corridor_tiles.resize(this->tiles.size(), 0);
+	}
+
+	// mark the tiles of the corridor chunks for this search
+	auto &chunk_size = this->grid->get_chunk_size();
+	for (const auto &chunk : corridor) {
+		for (size_t ne = 0; ne < chunk_size[0]; ++ne) {
+			coord::tile row_start{static_cast<coord::tile_t>(chunk[0] * chunk_size[0] + ne),
+			                      static_cast<coord::tile_t>(chunk[1] * chunk_size[1])};
+			std::fill_n(std::begin(this->corridor_tiles) + this->to_index(row_start),
+			            chunk_size[1],
+			            this->search);
+		}
+	}
+
+	return this->search_path(start, target, true);
+}
+
+void GridPathfinder::next_search() {
+	this->search += 1;
+	if (this->search == 0) [[unlikely]] {
+		// the search ID wrapped around, so old states could look valid
+		for (auto &state : this->tiles) {
+			state.search = 0;
+		}
+		std::fill(std::begin(this->corridor_tiles), std::end(this->corridor_tiles), 0);
+		this->search = 1;
+	}
+	this->open_list.clear();
+}
+
+std::vector<coord::tile> GridPathfinder::search_path(const coord::tile &start,
+                                                     const coord::tile &target,
+                                                     bool restricted) {
+	uint32_t start_idx = this->to_index(start);
+	uint32_t start_heuristic = octile_distance(start, target);
+
+	tile_state &start_state = this->tiles[start_idx];
+	start_state.search = this->search;
+	start_state.past_cost = 0;
+	start_state.predecessor = start_idx;
+	start_state.heap_node = this->open_list.push(open_elem{start_heuristic, start_heuristic, start_idx});
+
+	// track the closest we can get to the target
+	// used when no path is found
+	uint32_t closest_idx = start_idx;
+	uint32_t closest_heuristic = start_heuristic;
+
+	while (not this->open_list.empty()) {
+		open_elem best = this->open_list.pop();
+		tile_state &best_state = this->tiles[best.tile];
+		best_state.heap_node = heap_t::invalid_handle;
+
+		if (best.heuristic_cost == 0) {
+			return this->backtrace(best.tile);
+		}
+
+		if (best.heuristic_cost < closest_heuristic) {
+			closest_idx = best.tile;
+			closest_heuristic = best.heuristic_cost;
+		}
+
+		coord::tile pos = this->to_tile(best.tile);
+
+		// passability of the straight neighbors, for checking the diagonal moves
+		std::array<bool, 4> straight_passable;
+
+		for (size_t i = 0; i < DIRECTIONS.size(); ++i) {
+			uint32_t neighbor_idx = best.tile + this->neighbor_offsets[i];
+			tile_cost_t cost = this->costs[neighbor_idx];
+
+			uint32_t step_cost;
+			if (i < 4) {
+				straight_passable[i] = (cost != COST_IMPASSABLE);
+				step_cost = STEP_COST_STRAIGHT * cost;
+			}
+			else {
+				// don't cut corners
+				if (not straight_passable[i - 4] or not straight_passable[(i - 3) % 4]) {
+					continue;
+				}
+				step_cost = STEP_COST_DIAGONAL * cost;
+			}
+
+			if (cost == COST_IMPASSABLE) {
+				continue;
+			}
+
+			if (restricted and this->corridor_tiles[neighbor_idx] != this->search) {
+				continue;
+			}
+
+			tile_state &state = this->tiles[neighbor_idx];
+			uint32_t past_cost = best_state.past_cost + step_cost;
+
+			if (state.search != this->search) {
+				// not visited yet
+				uint32_t heuristic_cost = octile_distance(pos + DIRECTIONS[i], target);
+
+				state.search = this->search;
+				state.past_cost = past_cost;
+				state.predecessor = best.tile;
+				state.heap_node = this->open_list.push(open_elem{past_cost + heuristic_cost,
+				                                                 heuristic_cost,
+				                                                 neighbor_idx});
+			}
+			else if (state.heap_node != heap_t::invalid_handle
+			         and past_cost < state.past_cost) {
+				// cheaper path to a tile in the open list
+				open_elem &elem = this->open_list.get(state.heap_node);
+				elem.future_cost = past_cost + elem.heuristic_cost;
+
+				state.past_cost = past_cost;
+				state.predecessor = best.tile;
+				this->open_list.decrease(state.heap_node);
+			}
+		}
+	}
+
+	return this->backtrace(closest_idx);
+}
+
+void GridPathfinder::update_costs() {
+	auto &size = this->grid->get_size();
+	auto &chunk_size = this->grid->get_chunk_size();
+
+	for (size_t chunk_ne = 0; chunk_ne < size[0]; ++chunk_ne) {
+		for (size_t chunk_se = 0; chunk_se < size[1]; ++chunk_se) {
+			auto &field = this->grid->get_chunk({chunk_ne, chunk_se});
+			auto &cached = this->chunk_changes[chunk_ne * size[1] + chunk_se];
+			if (cached.first == field and cached.second == field->get_changes()) [[likely]] {
+				continue;
+			}
+
+			auto &field_costs = field->get_costs();
+			for (size_t ne = 0; ne < chunk_size[0]; ++ne) {
+				coord::tile row_start{static_cast<coord::tile_t>(chunk_ne * chunk_size[0] + ne),
+				                      static_cast<coord::tile_t>(chunk_se * chunk_size[1])};
+				std::copy_n(std::begin(field_costs) + ne * chunk_size[1],
+				            chunk_size[1],
+				            std::begin(this->costs) + this->to_index(row_start));
+			}
+
+			cached = {field, field->get_changes()};
+		}
+	}
+}
+
+uint32_t GridPathfinder::to_index(const coord::tile &tile) const {
+	return static_cast<uint32_t>((tile.ne + 1) * this->stride + tile.se + 1);
+}
+
+coord::tile GridPathfinder::to_tile(uint32_t idx) const {
+	return coord::tile{static_cast<coord::tile_t>(idx / this->stride) - 1,
+	                   static_cast<coord::tile_t>(idx % this->stride) - 1};
+}
+
+std::vector<coord::tile> GridPathfinder::backtrace(uint32_t end) const {
+	std::vector<coord::tile> waypoints;
+
+	uint32_t current = end;
+	coord::tile_delta direction{0, 0};
+	waypoints.push_back(this->to_tile(current));
+	while (this->tiles[current].predecessor != current) {
+		uint32_t next = this->tiles[current].predecessor;
+		coord::tile_delta next_direction = this->to_tile(next) - this->to_tile(current);
+
+		// only keep tiles where the direction changes
+		if (waypoints.size() > 1 and next_direction == direction) {
+			waypoints.back() = this->to_tile(next);
+		}
+		else {
+			waypoints.push_back(this->to_tile(next));
+		}
+
+		direction = next_direction;
+		current = next;
+	}
+
+	std::reverse(std::begin(waypoints), std::end(waypoints));
+
+	return waypoints;
+}
+
+} // namespace openage::path
@@ -0,0 +1,229 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "coord/tile.h"
+#include "datastructure/pooled_pairing_heap.h"
+#include "pathfinding/definitions.h"
+#include "util/vector.h"
+
+
+namespace openage::path {
+class CostField;
+class Grid;
+
+/**
+ * A* search for tile paths on a pathfinding grid.
+ *
+ * Tiles are connected to their 8 neighbors. Diagonal moves are only
+ * allowed if both adjacent straight tiles are passable, so paths don't
+ * cut corners of obstacles.
+ *
+ * The tile costs of the grid chunks are copied into one flat array with
+ * a border of impassable tiles, so looking up neighbors needs neither
+ * chunk lookups nor bounds checks. The copy is updated when the cost
+ * field of a chunk changes.
+ *
+ * The search state is stored in flat arrays indexed by tile and reused
+ * between searches, so a search doesn't allocate once the pathfinder
+ * is warmed up. A pathfinder must only be used by one thread at a time.
+ */
+class GridPathfinder {
+public:
+	/**
+	 * Create a new pathfinder.
+	 *
+	 * @param grid Grid that is searched.
+	 */
+	GridPathfinder(const std::shared_ptr<Grid> &grid);
+
+	~GridPathfinder() = default;
+
+	/**
+	 * Get the grid that is searched.
+	 *
+	 * @return Pathfinding grid.
+	 */
+	const std::shared_ptr<Grid> &get_grid() const;
+
+	/**
+	 * Find a path between two tiles.
+	 *
+	 * If the target can't be reached, the path leads to the reachable tile
+	 * that is closest to the target.
+	 *
+	 * @param start Start tile.
+	 * @param target Target tile.
+	 *
+	 * @return Waypoints of the path, including the start and the end tile.
+	 *         Only tiles where the path changes direction are waypoints.
+	 *         Empty if the start is not on the grid.
+	 */
+	std::vector<coord::tile> find_path(const coord::tile &start,
+	                                   const coord::tile &target);
+
+	/**
+	 * Find a path between two tiles that only passes the given chunks.
+	 *
+	 * Used for refining the paths of the hierarchical pathfinder,
+	 * which determines the chunks on the path.
+	 *
+	 * @param start Start tile.
+	 * @param target Target tile.
+	 * @param corridor Positions of the chunks (in chunks) the path may pass.
+	 *                 Must contain the chunk of the start tile.
+	 *
+	 * @return Waypoints of the path, see \p find_path(start, target).
+	 */
+	std::vector<coord::tile> find_path(const coord::tile &start,
+	                                   const coord::tile &target,
+	                                   const std::vector<util::Vector2s> &corridor);
+
+private:
+	/**
+	 * Entry in the open list.
+	 */
+	struct open_elem {
+		/**
+		 * Past cost + heuristic cost.
+		 */
+		uint32_t future_cost;
+
+		/**
+		 * Heuristic cost. Prefers tiles closer to the target if the future cost is equal.
+		 */
+		uint32_t heuristic_cost;
+
+		/**
+		 * Index of the tile.
+		 */
+		uint32_t tile;
+
+		bool operator<(const open_elem &other) const {
+			return this->future_cost < other.future_cost
+			       or (this->future_cost == other.future_cost
+			           and this->heuristic_cost < other.heuristic_cost);
+		}
+	};
+
+	using heap_t = datastructure::PooledPairingHeap<open_elem>;
+
+	/**
+	 * Search state of a tile.
+	 */
+	struct tile_state {
+		/**
+		 * ID of the search that last visited the tile. The other members
+		 * are only valid if this is the ID of the current search.
+		 */
+		uint32_t search;
+
+		/**
+		 * Cost of the cheapest known path from the start.
+		 */
+		uint32_t past_cost;
+
+		/**
+		 * Tile where this one was reached by least cost.
+		 */
+		uint32_t predecessor;
+
+		/**
+		 * Open list node of the tile. Invalid if the tile was closed.
+		 */
+		heap_t::handle_t heap_node;
+	};
+
+	/**
+	 * Copy the costs of chunks that changed since the last search.
+	 */
+	void update_costs();
+
+	/**
+	 * Start a new search and invalidate the search state of the previous one.
+	 */
+	void next_search();
+
+	/**
+	 * Run the A* search for a path.
+	 *
+	 * @param start Start tile.
+	 * @param target Target tile.
+	 * @param restricted If true, only tiles marked in \p corridor_tiles are searched.
+	 *
+	 * @return Waypoints of the path.
+	 */
+	std::vector<coord::tile> search_path(const coord::tile &start,
+	                                     const coord::tile &target,
+	                                     bool restricted);
+
+	/**
+	 * Get the tile index of a tile on the grid.
+	 */
+	uint32_t to_index(const coord::tile &tile) const;
+
+	/**
+	 * Get the tile of a tile index.
+	 */
+	coord::tile to_tile(uint32_t idx) const;
+
+	/**
+	 * Create the waypoints of the path ending at a tile.
+	 */
+	std::vector<coord::tile> backtrace(uint32_t end) const;
+
+	/**
+	 * Grid that is searched.
+	 */
+	std::shared_ptr<Grid> grid;
+
+	/**
+	 * Number of tiles in a row of the tile arrays, i.e. the grid height plus the border.
+	 */
+	uint32_t stride;
+
+	/**
+	 * Index offsets of the neighbors of a tile. Straight neighbors come first.
+	 */
+	std::array<int32_t, 8> neighbor_offsets;
+
+	/**
+	 * Costs of all tiles on the grid and the border.
+	 */
+	std::vector<tile_cost_t> costs;
+
+	/**
+	 * Cost field and its change counter for each chunk when its costs were copied.
+	 */
+	std::vector<std::pair<std::shared_ptr<const CostField>, size_t>> chunk_changes;
+
+	/**
+	 * Search state of all tiles on the grid and the border.
+	 */
+	std::vector<tile_state> tiles;
+
+	/**
+	 * ID of the last search that was allowed to pass a tile.
+	 * Only used for searches in a corridor.
+	 */
+	std::vector<uint32_t> corridor_tiles;
+
+	/**
+	 * Open list of the search.
+	 */
+	heap_t open_list;
+
+	/**
+	 * ID of the current search.
+	 */
+	uint32_t search;
+};
+
+} // namespace openage::path
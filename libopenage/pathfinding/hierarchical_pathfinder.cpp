@@ -0,0 +1,593 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#include "hierarchical_pathfinder.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
+#include "error/error.h"
+#include "pathfinding/cost_field.h"
+#include "pathfinding/flow_field.h"
+#include "pathfinding/grid.h"
+#include "pathfinding/integrator.h"
+
+
+namespace openage::path {
+
+namespace {
+
+/**
+ * Append the waypoints of a path to the waypoints of a path that ends
+ * at its start.
+ *
+ * @param waypoints Waypoints of the first path.
+ * @param section Waypoints of the appended path.
+ */
+void append_waypoints(std::vector<coord::tile> &waypoints,
+                      const std::vector<coord::tile> &section) {
+	auto direction = [](const coord::tile &from, const coord::tile &to) {
+		coord::tile_delta delta = to - from;
+		return coord::tile_delta{(delta.ne > 0) - (delta.ne < 0), (delta.se > 0) - (delta.se < 0)};
+	};
+
+	for (size_t i = 1; i < section.size(); ++i) {
+		// drop the last waypoint if the path goes on in the same direction
+		size_t count = waypoints.size();
+		if (count > 1
+		    and direction(waypoints[count - 2], waypoints[count - 1])
+		            == direction(waypoints[count - 1], section[i])) {
+			waypoints.back() = section[i];
+		}
+		else {
+			waypoints.push_back(section[i]);
+		}
+	}
+}
+
+} // namespace
+
+
+HierarchicalPathfinder::HierarchicalPathfinder(const std::shared_ptr<Grid> &grid) :
+	grid{grid},
+	grid_pathfinder{grid},
+	borders{},
+	chunks{},
+	chunk_changes{},
+	nodes{},
+	states{},
+	open_list{},
+	search{0},
+	integrator{},
+	local_costs{},
+	start_costs{},
+	target_costs{},
+	flow_fields{} {
+	auto &size = this->grid->get_size();
+	size_t chunk_count = size[0] * size[1];
+
+	this->borders.resize(2 * chunk_count);
+	this->chunks.resize(chunk_count);
+	this->chunk_changes.resize(chunk_count);
+
+	// no chunk has been built yet, so this builds the whole graph
+	this->update_graph();
+}
+
+const std::shared_ptr<Grid> &HierarchicalPathfinder::get_grid() const {
+	return this->grid;
+}
+
+std::vector<coord::tile> HierarchicalPathfinder::find_path(const coord::tile &start,
+                                                           const coord::tile &target) {
+	if (not this->grid->contains(start)) [[unlikely]] {
+		return {};
+	}
+
+	if (not this->grid->contains(target)
+	    or this->grid->get_cost(target) == COST_IMPASSABLE) [[unlikely]] {
+		// only the grid pathfinder can find the closest reachable tile
+		return this->grid_pathfinder.find_path(start, target);
+	}
+
+	if (start == target) [[unlikely]] {
+		return {start};
+	}
+
+	this->update_graph();
+
+	size_t start_chunk = this->to_chunk(start);
+	size_t target_chunk = this->to_chunk(target);
+	const chunk_graph &start_graph = this->chunks[start_chunk];
+	const chunk_graph &target_graph = this->chunks[target_chunk];
+
+	// connect the start and the target to the portals of their chunks
+	this->search_chunk(start_chunk, start, false);
+	this->start_costs.clear();
+	for (const auto &portal : start_graph.portals) {
+		this->start_costs.push_back(this->local_costs[this->to_local(portal)]);
+	}
+	uint32_t direct_cost = no_path;
+	if (start_chunk == target_chunk) {
+		direct_cost = this->local_costs[this->to_local(target)];
+	}
+
+	this->search_chunk(target_chunk, target, true);
+	this->target_costs.clear();
+	for (const auto &portal : target_graph.portals) {
+		this->target_costs.push_back(this->local_costs[this->to_local(portal)]);
+	}
+
+	// search the abstract graph
+	auto start_node = static_cast<uint32_t>(this->nodes.size());
+	auto target_node = start_node + 1;
+
+	auto node_tile = [&](uint32_t node) -> const coord::tile & {
+		if (node == start_node) {
+			return start;
+		}
+		if (node == target_node) {
+			return target;
+		}
+		return this->nodes[node].tile;
+	};
+
+	this->next_search();
+
+	auto visit = [&](uint32_t node, uint32_t predecessor, uint32_t past_cost) {
+		this->visit(node, predecessor, past_cost, octile_distance(node_tile(node), target));
+	};
+
+	uint32_t start_heuristic = octile_distance(start, target);
+	node_state &start_state = this->states[start_node];
+	start_state.search = this->search;
+	start_state.past_cost = 0;
+	start_state.predecessor = start_node;
+	start_state.heap_node = this->open_list.push(open_elem{start_heuristic, start_heuristic, start_node});
+
+	bool found = false;
+	while (not this->open_list.empty()) {
+		open_elem best = this->open_list.pop();
+		node_state &best_state = this->states[best.node];
+		best_state.heap_node = heap_t::invalid_handle;
+		uint32_t past_cost = best_state.past_cost;
+
+		if (best.node == target_node) {
+			found = true;
+			break;
+		}
+
+		if (best.node == start_node) {
+			for (uint32_t i = 0; i < this->start_costs.size(); ++i) {
+				if (this->start_costs[i] != no_path) {
+					visit(start_graph.first_node + i, start_node, past_cost + this->start_costs[i]);
+				}
+			}
+			if (direct_cost != no_path) {
+				visit(target_node, start_node, past_cost + direct_cost);
+			}
+			continue;
+		}
+
+		const node &current = this->nodes[best.node];
+
+		// step through the portal
+		tile_cost_t exit_cost = this->grid->get_cost(this->nodes[current.exit].tile);
+		visit(current.exit, best.node, past_cost + STEP_COST_STRAIGHT * exit_cost);
+
+		// move to the other portals of the chunk
+		const chunk_graph &graph = this->chunks[current.chunk];
+		size_t portal_count = graph.portals.size();
+		for (uint32_t i = 0; i < portal_count; ++i) {
+			uint32_t distance = graph.distances[current.portal * portal_count + i];
+			if (i != current.portal and distance != no_path) {
+				visit(graph.first_node + i, best.node, past_cost + distance);
+			}
+		}
+
+		if (current.chunk == target_chunk
+		    and this->target_costs[current.portal] != no_path) {
+			visit(target_node, best.node, past_cost + this->target_costs[current.portal]);
+		}
+	}
+
+	if (not found) {
+		// the grid pathfinder finds the closest reachable tile
+		return this->grid_pathfinder.find_path(start, target);
+	}
+
+	std::vector<uint32_t> abstract_path;
+	for (uint32_t node = target_node; node != start_node; node = this->states[node].predecessor) {
+		abstract_path.push_back(node);
+	}
+	std::reverse(std::begin(abstract_path), std::end(abstract_path));
+
+	// refine the path on the tile level in sections of a few chunks,
+	// searching only the chunks that the abstract path passes
+	auto &size = this->grid->get_size();
+	std::vector<coord::tile> waypoints{start};
+	coord::tile section_start = start;
+	std::vector<util::Vector2s> corridor{{start_chunk / size[1], start_chunk % size[1]}};
+	for (size_t i = 0; i < abstract_path.size(); ++i) {
+		const coord::tile &tile = node_tile(abstract_path[i]);
+		size_t chunk = this->to_chunk(tile);
+		util::Vector2s chunk_pos{chunk / size[1], chunk % size[1]};
+
+		bool entered_chunk = false;
+		if (corridor.back() != chunk_pos) {
+			corridor.push_back(chunk_pos);
+			entered_chunk = true;
+		}
+
+		bool is_target = (i + 1 == abstract_path.size());
+		if (is_target or (entered_chunk and corridor.size() >= refine_section_length)) {
+			auto section = this->grid_pathfinder.find_path(section_start, tile, corridor);
+			append_waypoints(waypoints, section);
+
+			section_start = tile;
+			corridor = {chunk_pos};
+		}
+	}
+
+	return waypoints;
+}
+
+std::shared_ptr<FlowField> HierarchicalPathfinder::get_flow_field(const coord::tile &target) {
+	if (not this->grid->contains(target)
+	    or this->grid->get_cost(target) == COST_IMPASSABLE) [[unlikely]] {
+		return nullptr;
+	}
+
+	this->update_graph();
+
+	for (const auto &field : this->flow_fields) {
+		if (field->get_target() == target) {
+			return field;
+		}
+	}
+
+	// search the abstract graph backwards from the target,
+	// so the past costs are the path costs to the target
+	size_t target_chunk = this->to_chunk(target);
+	const chunk_graph &target_graph = this->chunks[target_chunk];
+	auto target_node = static_cast<uint32_t>(this->nodes.size()) + 1;
+
+	this->next_search();
+
+	this->search_chunk(target_chunk, target, true);
+	for (uint32_t i = 0; i < target_graph.portals.size(); ++i) {
+		uint32_t cost = this->local_costs[this->to_local(target_graph.portals[i])];
+		if (cost != no_path) {
+			this->visit(target_graph.first_node + i, target_node, cost, 0);
+		}
+	}
+
+	while (not this->open_list.empty()) {
+		open_elem best = this->open_list.pop();
+		node_state &best_state = this->states[best.node];
+		best_state.heap_node = heap_t::invalid_handle;
+		uint32_t past_cost = best_state.past_cost;
+
+		const node &current = this->nodes[best.node];
+
+		// step through the portal from the other side
+		tile_cost_t step_cost = this->grid->get_cost(current.tile);
+		this->visit(current.exit, best.node, past_cost + STEP_COST_STRAIGHT * step_cost, 0);
+
+		// move from the other portals of the chunk
+		const chunk_graph &graph = this->chunks[current.chunk];
+		size_t portal_count = graph.portals.size();
+		for (uint32_t i = 0; i < portal_count; ++i) {
+			uint32_t distance = graph.distances[i * portal_count + current.portal];
+			if (i != current.portal and distance != no_path) {
+				this->visit(graph.first_node + i, best.node, past_cost + distance, 0);
+			}
+		}
+	}
+
+	// the target and the portals where paths leave their chunk are the
+	// sources for integrating the chunks. Paths to the other portals
+	// lead through the chunk, so the integration finds them anyway.
+	std::vector<std::vector<Integrator::source>> sources(this->chunks.size());
+	sources[target_chunk].push_back(Integrator::source{this->to_local(target), 0, FLOW_NONE});
+	for (uint32_t id = 0; id < this->nodes.size(); ++id) {
+		const node_state &state = this->states[id];
+		const node &current = this->nodes[id];
+		if (state.search != this->search or state.predecessor != current.exit) {
+			continue;
+		}
+
+		coord::tile_delta step = this->nodes[current.exit].tile - current.tile;
+		auto flow = static_cast<flow_t>(std::distance(std::begin(DIRECTIONS),
+		                                              std::find(std::begin(DIRECTIONS),
+		                                                        std::end(DIRECTIONS),
+		                                                        step)));
+		sources[current.chunk].push_back(Integrator::source{this->to_local(current.tile),
+		                                                    state.past_cost,
+		                                                    flow});
+	}
+
+	auto field = std::make_shared<FlowField>(this->grid, target, std::move(sources));
+
+	if (this->flow_fields.size() >= flow_field_cache_size) {
+		this->flow_fields.pop_front();
+	}
+	this->flow_fields.push_back(field);
+
+	return field;
+}
+
+size_t HierarchicalPathfinder::get_portal_count() {
+	this->update_graph();
+
+	return this->nodes.size();
+}
+
+void HierarchicalPathfinder::update_graph() {
+	auto &size = this->grid->get_size();
+	size_t chunk_count = size[0] * size[1];
+
+	std::vector<bool> changed;
+	for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+		auto &field = this->grid->get_chunk({chunk / size[1], chunk % size[1]});
+		auto &cached = this->chunk_changes[chunk];
+		if (cached.first == field and cached.second == field->get_changes()) [[likely]] {
+			continue;
+		}
+
+		if (changed.empty()) {
+			changed.resize(chunk_count, false);
+		}
+		changed[chunk] = true;
+		cached = {field, field->get_changes()};
+	}
+
+	if (changed.empty()) [[likely]] {
+		return;
+	}
+
+	// the portals of changed chunks change the graphs of their neighbors
+	std::vector<bool> rebuild(chunk_count, false);
+	for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+		if (not changed[chunk]) {
+			continue;
+		}
+
+		size_t chunk_ne = chunk / size[1];
+		size_t chunk_se = chunk % size[1];
+
+		this->build_border(chunk, 0);
+		this->build_border(chunk, 1);
+		rebuild[chunk] = true;
+
+		if (chunk_ne > 0) {
+			this->build_border(chunk - size[1], 0);
+			rebuild[chunk - size[1]] = true;
+		}
+		if (chunk_ne + 1 < size[0]) {
+			rebuild[chunk + size[1]] = true;
+		}
+		if (chunk_se > 0) {
+			this->build_border(chunk - 1, 1);
+			rebuild[chunk - 1] = true;
+		}
+		if (chunk_se + 1 < size[1]) {
+			rebuild[chunk + 1] = true;
+		}
+	}
+
+	for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+		if (rebuild[chunk]) {
+			this->build_chunk(chunk);
+		}
+	}
+
+	this->link_nodes();
+
+	// the cached flow fields lead over the old portals
+	this->flow_fields.clear();
+}
+
+void HierarchicalPathfinder::next_search() {
+	this->search += 1;
+	if (this->search == 0) [[unlikely]] {
+		// the search ID wrapped around, so old states could look valid
+		for (auto &state : this->states) {
+			state.search = 0;
+		}
+		this->search = 1;
+	}
+	this->open_list.clear();
+}
+
+void HierarchicalPathfinder::visit(uint32_t node,
+                                   uint32_t predecessor,
+                                   uint32_t past_cost,
+                                   uint32_t heuristic_cost) {
+	node_state &state = this->states[node];
+	if (state.search != this->search) {
+		// not visited yet
+		state.search = this->search;
+		state.past_cost = past_cost;
+		state.predecessor = predecessor;
+		state.heap_node = this->open_list.push(open_elem{past_cost + heuristic_cost,
+		                                                 heuristic_cost,
+		                                                 node});
+	}
+	else if (state.heap_node != heap_t::invalid_handle
+	         and past_cost < state.past_cost) {
+		// cheaper path to a node in the open list
+		open_elem &elem = this->open_list.get(state.heap_node);
+		elem.future_cost = past_cost + elem.heuristic_cost;
+
+		state.past_cost = past_cost;
+		state.predecessor = predecessor;
+		this->open_list.decrease(state.heap_node);
+	}
+}
+
+void HierarchicalPathfinder::build_border(size_t chunk, size_t direction) {
+	auto &size = this->grid->get_size();
+	auto &chunk_size = this->grid->get_chunk_size();
+	size_t chunk_ne = chunk / size[1];
+	size_t chunk_se = chunk % size[1];
+
+	auto &border = this->borders[2 * chunk + direction];
+	border.clear();
+
+	bool north_east = (direction == 0);
+	if ((north_east and chunk_ne + 1 >= size[0])
+	    or (not north_east and chunk_se + 1 >= size[1])) {
+		// no neighbor on this side
+		return;
+	}
+
+	// the border runs along the last row of tiles in the chunk
+	auto width = static_cast<coord::tile_t>(chunk_size[0]);
+	auto height = static_cast<coord::tile_t>(chunk_size[1]);
+	coord::tile origin{static_cast<coord::tile_t>(chunk_ne) * width,
+	                   static_cast<coord::tile_t>(chunk_se) * height};
+	coord::tile first = north_east ? origin + coord::tile_delta{width - 1, 0}
+	                               : origin + coord::tile_delta{0, height - 1};
+	coord::tile_delta across = north_east ? coord::tile_delta{1, 0} : coord::tile_delta{0, 1};
+	coord::tile_delta along = north_east ? coord::tile_delta{0, 1} : coord::tile_delta{1, 0};
+	coord::tile_t length = north_east ? height : width;
+
+	auto add_portal = [&](coord::tile_t pos) {
+		coord::tile tile = first + coord::tile_delta{along.ne * pos, along.se * pos};
+		border.emplace_back(tile, tile + across);
+	};
+
+	// entrances are the longest runs of tiles that are passable on both sides
+	coord::tile_t entrance_start = 0;
+	bool in_entrance = false;
+	for (coord::tile_t pos = 0; pos <= length; ++pos) {
+		bool passable = false;
+		if (pos < length) {
+			coord::tile tile = first + coord::tile_delta{along.ne * pos, along.se * pos};
+			passable = this->grid->get_cost(tile) != COST_IMPASSABLE
+			           and this->grid->get_cost(tile + across) != COST_IMPASSABLE;
+		}
+
+		if (passable and not in_entrance) {
+			entrance_start = pos;
+			in_entrance = true;
+		}
+		else if (not passable and in_entrance) {
+			coord::tile_t entrance_length = pos - entrance_start;
+			if (entrance_length >= double_portal_length) {
+				add_portal(entrance_start);
+				add_portal(pos - 1);
+			}
+			else {
+				add_portal(entrance_start + entrance_length / 2);
+			}
+			in_entrance = false;
+		}
+	}
+}
+
+void HierarchicalPathfinder::build_chunk(size_t chunk) {
+	auto &size = this->grid->get_size();
+	size_t chunk_ne = chunk / size[1];
+	size_t chunk_se = chunk % size[1];
+
+	chunk_graph &graph = this->chunks[chunk];
+	graph.portals.clear();
+
+	graph.border_start[0] = graph.portals.size();
+	for (const auto &portal : this->borders[2 * chunk]) {
+		graph.portals.push_back(portal.first);
+	}
+	graph.border_start[1] = graph.portals.size();
+	for (const auto &portal : this->borders[2 * chunk + 1]) {
+		graph.portals.push_back(portal.first);
+	}
+	graph.border_start[2] = graph.portals.size();
+	if (chunk_ne > 0) {
+		for (const auto &portal : this->borders[2 * (chunk - size[1])]) {
+			graph.portals.push_back(portal.second);
+		}
+	}
+	graph.border_start[3] = graph.portals.size();
+	if (chunk_se > 0) {
+		for (const auto &portal : this->borders[2 * (chunk - 1) + 1]) {
+			graph.portals.push_back(portal.second);
+		}
+	}
+
+	size_t portal_count = graph.portals.size();
+	graph.distances.assign(portal_count * portal_count, no_path);
+	for (size_t from = 0; from < portal_count; ++from) {
+		this->search_chunk(chunk, graph.portals[from], false);
+		for (size_t to = 0; to < portal_count; ++to) {
+			graph.distances[from * portal_count + to] = this->local_costs[this->to_local(graph.portals[to])];
+		}
+	}
+}
+
+void HierarchicalPathfinder::link_nodes() {
+	auto &size = this->grid->get_size();
+
+	this->nodes.clear();
+	for (size_t chunk = 0; chunk < this->chunks.size(); ++chunk) {
+		chunk_graph &graph = this->chunks[chunk];
+		graph.first_node = static_cast<uint32_t>(this->nodes.size());
+		for (uint32_t i = 0; i < graph.portals.size(); ++i) {
+			this->nodes.push_back(node{graph.portals[i], static_cast<uint32_t>(chunk), i, 0});
+		}
+	}
+
+	// portals on a border of the chunk are on the opposite border of the neighbor
+	constexpr std::array<size_t, 4> opposite{2, 3, 0, 1};
+
+	for (size_t chunk = 0; chunk < this->chunks.size(); ++chunk) {
+		const chunk_graph &graph = this->chunks[chunk];
+
+		// only accessed for borders with portals, so the neighbors exist
+		std::array<size_t, 4> neighbor_chunks{chunk + size[1], chunk + 1, chunk - size[1], chunk - 1};
+
+		for (size_t border = 0; border < 4; ++border) {
+			uint32_t begin = graph.border_start[border];
+			uint32_t end = (border < 3) ? graph.border_start[border + 1] : graph.portals.size();
+			if (begin == end) {
+				continue;
+			}
+
+			const chunk_graph &neighbor = this->chunks[neighbor_chunks[border]];
+			uint32_t neighbor_begin = neighbor.first_node + neighbor.border_start[opposite[border]];
+			for (uint32_t i = begin; i < end; ++i) {
+				this->nodes[graph.first_node + i].exit = neighbor_begin + (i - begin);
+			}
+		}
+	}
+
+	// states of the nodes and the start and target nodes
+	this->states.assign(this->nodes.size() + 2, node_state{0, 0, 0, heap_t::invalid_handle});
+	this->search = 0;
+}
+
+void HierarchicalPathfinder::search_chunk(size_t chunk,
+                                          const coord::tile &source,
+                                          bool reverse) {
+	auto &size = this->grid->get_size();
+	const CostField &field = *this->grid->get_chunk({chunk / size[1], chunk % size[1]});
+
+	Integrator::source src{this->to_local(source), 0, FLOW_NONE};
+	this->integrator.integrate(field, {&src, 1}, reverse, this->local_costs);
+}
+
+size_t HierarchicalPathfinder::to_chunk(const coord::tile &tile) const {
+	auto &size = this->grid->get_size();
+	auto &chunk_size = this->grid->get_chunk_size();
+
+	return (tile.ne / chunk_size[0]) * size[1] + tile.se / chunk_size[1];
+}
+
+uint32_t HierarchicalPathfinder::to_local(const coord::tile &tile) const {
+	auto &chunk_size = this->grid->get_chunk_size();
+
+	return static_cast<uint32_t>((tile.ne % chunk_size[0]) * chunk_size[1] + tile.se % chunk_size[1]);
+}
+
+} // namespace openage::path
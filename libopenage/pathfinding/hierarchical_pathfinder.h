@@ -0,0 +1,379 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "coord/tile.h"
+#include "datastructure/pooled_pairing_heap.h"
+#include "pathfinding/definitions.h"
+#include "pathfinding/grid_pathfinder.h"
+#include "pathfinding/integrator.h"
+
+
+namespace openage::path {
+class CostField;
+class FlowField;
+class Grid;
+
+/**
+ * Hierarchical pathfinder (HPA*) for a pathfinding grid.
+ *
+ * The chunks of the grid are connected by portals, i.e. pairs of adjacent
+ * passable tiles on the border between two chunks. Portals form an abstract
+ * graph whose edges are the path costs between the portals of a chunk and
+ * the steps between the two tiles of a portal.
+ *
+ * A path is searched on the abstract graph first. Afterwards, the path is
+ * refined on the tile level in sections of a few chunks, searching only the
+ * chunks along the abstract path. The resulting paths are not always
+ * optimal, but much fewer tiles have to be visited than with a search
+ * on the full grid.
+ *
+ * When the cost field of a chunk changes, only the portals of the chunk and
+ * the graphs of the chunk and its neighbors are rebuilt.
+ *
+ * A pathfinder must only be used by one thread at a time.
+ */
+class HierarchicalPathfinder {
+public:
+	/**
+	 * Create a new pathfinder and build the abstract graph.
+	 *
+	 * @param grid Grid that is searched.
+	 */
+	HierarchicalPathfinder(const std::shared_ptr<Grid> &grid);
+
+	~HierarchicalPathfinder() = default;
+
+	/**
+	 * Get the grid that is searched.
+	 *
+	 * @return Pathfinding grid.
+	 */
+	const std::shared_ptr<Grid> &get_grid() const;
+
+	/**
+	 * Find a path between two tiles.
+	 *
+	 * If the target can't be reached, the grid pathfinder is used instead,
+	 * so the path leads to the reachable tile that is closest to the target.
+	 *
+	 * @param start Start tile.
+	 * @param target Target tile.
+	 *
+	 * @return Waypoints of the path, including the start and the end tile.
+	 *         Only tiles where the path changes direction are waypoints.
+	 *         Empty if the start is not on the grid.
+	 */
+	std::vector<coord::tile> find_path(const coord::tile &start,
+	                                   const coord::tile &target);
+
+	/**
+	 * Get a flow field that leads to a tile.
+	 *
+	 * The path costs from all portals to the target are computed on the
+	 * abstract graph. The fields of a chunk are only computed when units
+	 * sample them. Recently requested fields are cached until the cost
+	 * fields of the grid change.
+	 *
+	 * @param target Target tile.
+	 *
+	 * @return Flow field to the target. \p nullptr if the target is not
+	 *         on the grid or impassable.
+	 */
+	std::shared_ptr<FlowField> get_flow_field(const coord::tile &target);
+
+	/**
+	 * Get the number of portal tiles in the abstract graph.
+	 *
+	 * Every portal between two chunks has one tile in each chunk.
+	 *
+	 * @return Number of portal tiles.
+	 */
+	size_t get_portal_count();
+
+private:
+	/**
+	 * Entrances that are at least this long get a portal at both ends
+	 * instead of one portal in the middle.
+	 */
+	static constexpr coord::tile_t double_portal_length = 6;
+
+	/**
+	 * Number of chunks that are searched together when refining a path.
+	 */
+	static constexpr size_t refine_section_length = 4;
+
+	/**
+	 * Path cost between unconnected nodes.
+	 */
+	static constexpr uint32_t no_path = std::numeric_limits<uint32_t>::max();
+
+	/**
+	 * Maximum number of cached flow fields.
+	 */
+	static constexpr size_t flow_field_cache_size = 16;
+
+	/**
+	 * Portals and intra-chunk path costs of a chunk.
+	 */
+	struct chunk_graph {
+		/**
+		 * Tiles of the portals in the chunk.
+		 *
+		 * Ordered by the borders they are on: north-east, south-east,
+		 * south-west, north-west.
+		 */
+		std::vector<coord::tile> portals;
+
+		/**
+		 * Index of the first portal of each border in \p portals.
+		 */
+		std::array<uint32_t, 4> border_start;
+
+		/**
+		 * Path costs between the portals, i.e. `distances[from * size + to]`.
+		 * \p no_path if a portal can't be reached from another one inside the chunk.
+		 */
+		std::vector<uint32_t> distances;
+
+		/**
+		 * ID of the node of the first portal in the abstract graph.
+		 */
+		uint32_t first_node;
+	};
+
+	/**
+	 * Node of the abstract graph.
+	 */
+	struct node {
+		/**
+		 * Portal tile.
+		 */
+		coord::tile tile;
+
+		/**
+		 * Index of the chunk containing the tile.
+		 */
+		uint32_t chunk;
+
+		/**
+		 * Index of the portal in the chunk.
+		 */
+		uint32_t portal;
+
+		/**
+		 * Node on the other side of the portal.
+		 */
+		uint32_t exit;
+	};
+
+	/**
+	 * Entry in the open list of the abstract search.
+	 */
+	struct open_elem {
+		/**
+		 * Past cost + heuristic cost.
+		 */
+		uint32_t future_cost;
+
+		/**
+		 * Heuristic cost. Prefers nodes closer to the target if the future cost is equal.
+		 */
+		uint32_t heuristic_cost;
+
+		/**
+		 * ID of the node.
+		 */
+		uint32_t node;
+
+		bool operator<(const open_elem &other) const {
+			return this->future_cost < other.future_cost
+			       or (this->future_cost == other.future_cost
+			           and this->heuristic_cost < other.heuristic_cost);
+		}
+	};
+
+	using heap_t = datastructure::PooledPairingHeap<open_elem>;
+
+	/**
+	 * Search state of a node in the abstract graph.
+	 */
+	struct node_state {
+		/**
+		 * ID of the search that last visited the node. The other members
+		 * are only valid if this is the ID of the current search.
+		 */
+		uint32_t search;
+
+		/**
+		 * Cost of the cheapest known path from the start.
+		 */
+		uint32_t past_cost;
+
+		/**
+		 * Node where this one was reached by least cost.
+		 */
+		uint32_t predecessor;
+
+		/**
+		 * Open list node of the node. Invalid if the node was closed.
+		 */
+		heap_t::handle_t heap_node;
+	};
+
+	/**
+	 * Rebuild the abstract graph for chunks whose cost fields changed.
+	 */
+	void update_graph();
+
+	/**
+	 * Start a new abstract search, invalidating the states of the previous one.
+	 */
+	void next_search();
+
+	/**
+	 * Visit a node in the abstract search.
+	 *
+	 * Adds the node to the open list or updates its cost if the new path is cheaper.
+	 *
+	 * @param node ID of the node.
+	 * @param predecessor ID of the node where the node is reached from.
+	 * @param past_cost Path cost of the node.
+	 * @param heuristic_cost Heuristic cost of the node.
+	 */
+	void visit(uint32_t node,
+	           uint32_t predecessor,
+	           uint32_t past_cost,
+	           uint32_t heuristic_cost);
+
+	/**
+	 * Find the portals on the border from a chunk to its
+	 * north-east or south-east neighbor.
+	 *
+	 * @param chunk Index of the chunk.
+	 * @param direction 0 for the north-east border, 1 for the south-east border.
+	 */
+	void build_border(size_t chunk, size_t direction);
+
+	/**
+	 * Collect the portals of a chunk and compute the path costs between them.
+	 *
+	 * @param chunk Index of the chunk.
+	 */
+	void build_chunk(size_t chunk);
+
+	/**
+	 * Assign node IDs to the portals of all chunks and connect the
+	 * nodes on both sides of each portal.
+	 */
+	void link_nodes();
+
+	/**
+	 * Compute the path costs between a tile and the other tiles of its chunk.
+	 *
+	 * Path costs are stored in \p local_costs.
+	 *
+	 * @param chunk Index of the chunk.
+	 * @param source Source tile. Must be in the chunk.
+	 * @param reverse If true, costs are for paths leading to the source instead
+	 *                of paths starting at the source.
+	 */
+	void search_chunk(size_t chunk,
+	                  const coord::tile &source,
+	                  bool reverse);
+
+	/**
+	 * Get the index of a chunk on the grid.
+	 */
+	size_t to_chunk(const coord::tile &tile) const;
+
+	/**
+	 * Get the index of a tile in its chunk.
+	 */
+	uint32_t to_local(const coord::tile &tile) const;
+
+	/**
+	 * Grid that is searched.
+	 */
+	std::shared_ptr<Grid> grid;
+
+	/**
+	 * Pathfinder for refining the abstract paths and for the fallback
+	 * search if the target is unreachable.
+	 */
+	GridPathfinder grid_pathfinder;
+
+	/**
+	 * Portals on the borders from each chunk to its north-east (index `2 * chunk`)
+	 * and south-east neighbor (index `2 * chunk + 1`).
+	 *
+	 * Each portal is stored as the pair of its tiles in the chunk and in the neighbor.
+	 */
+	std::vector<std::vector<std::pair<coord::tile, coord::tile>>> borders;
+
+	/**
+	 * Abstract graphs of the chunks.
+	 */
+	std::vector<chunk_graph> chunks;
+
+	/**
+	 * Cost field and its change counter for each chunk when its graph was built.
+	 */
+	std::vector<std::pair<std::shared_ptr<const CostField>, size_t>> chunk_changes;
+
+	/**
+	 * Nodes of the abstract graph.
+	 */
+	std::vector<node> nodes;
+
+	/**
+	 * Search state of the nodes, followed by the start and the target node.
+	 */
+	std::vector<node_state> states;
+
+	/**
+	 * Open list of the abstract search.
+	 */
+	heap_t open_list;
+
+	/**
+	 * ID of the current abstract search.
+	 */
+	uint32_t search;
+
+	/**
+	 * Integrator for searching chunks.
+	 */
+	Integrator integrator;
+
+	/**
+	 * Path costs of the tiles in the last searched chunk.
+	 */
+	std::vector<uint32_t> local_costs;
+
+	/**
+	 * Path costs from the start to the portals of its chunk.
+	 */
+	std::vector<uint32_t> start_costs;
+
+	/**
+	 * Path costs from the portals of the target chunk to the target.
+	 */
+	std::vector<uint32_t> target_costs;
+
+	/**
+	 * Recently requested flow fields, oldest first.
+	 */
+	std::deque<std::shared_ptr<FlowField>> flow_fields;
+};
+
+} // namespace openage::path
@@ -0,0 +1,104 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#include "integrator.h"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+
+#include "coord/tile.h"
+#include "pathfinding/cost_field.h"
+
+
+namespace openage::path {
+
+void Integrator::integrate(const CostField &field,
+                           std::span<const source> sources,
+                           bool reverse,
+                           std::vector<uint32_t> &costs,
+                           std::vector<flow_t> *flows) {
+	auto width = static_cast<coord::tile_t>(field.get_size()[0]);
+	auto height = static_cast<coord::tile_t>(field.get_size()[1]);
+	size_t tile_count = width * height;
+
+	costs.assign(tile_count, unreachable);
+	if (flows != nullptr) {
+		flows->assign(tile_count, FLOW_NONE);
+	}
+
+	auto &open = this->open_list;
+	open.clear();
+	for (const auto &src : sources) {
+		if (src.cost < costs[src.tile]) {
+			costs[src.tile] = src.cost;
+			if (flows != nullptr) {
+				(*flows)[src.tile] = src.flow;
+			}
+			open.emplace_back(src.cost, src.tile);
+		}
+	}
+	std::make_heap(std::begin(open), std::end(open), std::greater<>{});
+
+	while (not open.empty()) {
+		std::pop_heap(std::begin(open), std::end(open), std::greater<>{});
+		auto [past_cost, idx] = open.back();
+		open.pop_back();
+
+		if (past_cost > costs[idx]) {
+			// outdated entry, the tile was reached cheaper
+			continue;
+		}
+
+		coord::tile_t ne = idx / height;
+		coord::tile_t se = idx % height;
+		tile_cost_t current_cost = field.get_cost(idx);
+
+		// passability of the straight neighbors, for checking the diagonal moves
+		std::array<bool, 4> straight_passable;
+
+		for (size_t i = 0; i < DIRECTIONS.size(); ++i) {
+			coord::tile_t neighbor_ne = ne + DIRECTIONS[i].ne;
+			coord::tile_t neighbor_se = se + DIRECTIONS[i].se;
+			auto neighbor_idx = static_cast<uint32_t>(neighbor_ne * height + neighbor_se);
+
+			tile_cost_t cost = COST_IMPASSABLE;
+			if (neighbor_ne >= 0 and neighbor_ne < width
+			    and neighbor_se >= 0 and neighbor_se < height) {
+				cost = field.get_cost(neighbor_idx);
+			}
+
+			uint32_t step_cost;
+			if (i < 4) {
+				straight_passable[i] = (cost != COST_IMPASSABLE);
+				step_cost = STEP_COST_STRAIGHT;
+			}
+			else {
+				// don't cut corners
+				if (not straight_passable[i - 4] or not straight_passable[(i - 3) % 4]) {
+					continue;
+				}
+				step_cost = STEP_COST_DIAGONAL;
+			}
+
+			if (cost == COST_IMPASSABLE) {
+				continue;
+			}
+
+			// steps cost the cost of the tile that is entered
+			step_cost *= reverse ? current_cost : cost;
+
+			uint32_t neighbor_cost = past_cost + step_cost;
+			if (neighbor_cost < costs[neighbor_idx]) {
+				costs[neighbor_idx] = neighbor_cost;
+				if (flows != nullptr) {
+					// the neighbor flows back to this tile
+					(*flows)[neighbor_idx] = (i < 4) ? (i + 2) % 4 : 4 + (i - 2) % 4;
+				}
+				open.emplace_back(neighbor_cost, neighbor_idx);
+				std::push_heap(std::begin(open), std::end(open), std::greater<>{});
+			}
+		}
+	}
+}
+
+} // namespace openage::path
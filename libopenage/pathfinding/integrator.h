@@ -0,0 +1,79 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "pathfinding/definitions.h"
+
+
+namespace openage::path {
+class CostField;
+
+/**
+ * Computes the path costs between the tiles of a cost field
+ * and a set of source tiles (Dijkstra's algorithm).
+ *
+ * Paths only pass tiles of the cost field. The integrator keeps its
+ * open list between runs, so it only allocates until it is warmed up.
+ */
+class Integrator {
+public:
+	/**
+	 * Path cost of tiles that can't be reached.
+	 */
+	static constexpr uint32_t unreachable = std::numeric_limits<uint32_t>::max();
+
+	/**
+	 * Source tile of an integration.
+	 */
+	struct source {
+		/**
+		 * Index of the tile in the cost field.
+		 */
+		uint32_t tile;
+
+		/**
+		 * Initial path cost of the tile.
+		 */
+		uint32_t cost;
+
+		/**
+		 * Flow direction of the tile if it is not reached cheaper from another tile.
+		 */
+		flow_t flow;
+	};
+
+	Integrator() = default;
+	~Integrator() = default;
+
+	/**
+	 * Compute the path costs of all tiles in a cost field.
+	 *
+	 * @param field Cost field.
+	 * @param sources Source tiles.
+	 * @param reverse If false, costs are for paths starting at a source. If true,
+	 *                costs are for paths leading to a source, e.g. to a target.
+	 * @param costs Output for the path costs, indexed like the tiles of the field.
+	 * @param flows Output for the flow directions, i.e. the directions of the next tiles
+	 *              on the paths to the sources. Only useful for \p reverse integrations.
+	 *              Can be \p nullptr.
+	 */
+	void integrate(const CostField &field,
+	               std::span<const source> sources,
+	               bool reverse,
+	               std::vector<uint32_t> &costs,
+	               std::vector<flow_t> *flows = nullptr);
+
+private:
+	/**
+	 * Open list as a binary heap of (path cost, tile index) pairs.
+	 */
+	std::vector<std::pair<uint32_t, uint32_t>> open_list;
+};
+
+} // namespace openage::path
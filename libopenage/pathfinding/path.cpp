@@ -1,4 +1,4 @@
-// Copyright 2014-2023 the openage authors. See copying.md for legal info.
+// Copyright 2014-2026 the openage authors. See copying.md for legal info.
 
 #include <cmath>
 
@@ -21,7 +21,7 @@ Node::Node(const coord::phys3 &pos, node_pt prev) :
 	was_best{false},
 	factor{1.0f},
 	path_predecessor{prev},
-	heap_node(nullptr) {
+	heap_node(heap_t::invalid_handle) {
 	if (prev) {
 		this->direction = (this->position - prev->position).normalize();
 
@@ -1,4 +1,4 @@
-// Copyright 2014-2023 the openage authors. See copying.md for legal info.
+// Copyright 2014-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -9,7 +9,7 @@
 
 #include "../coord/phys.h"
 #include "../coord/tile.h"
-#include "../datastructure/pairing_heap.h"
+#include "../datastructure/pooled_pairing_heap.h"
 #include "../util/hash.h"
 #include "../util/misc.h"
 
@@ -49,7 +49,7 @@ struct compare_node_cost {
 /**
  * Priority queue node item type.
  */
-using heap_t = datastructure::PairingHeap<node_pt, compare_node_cost>;
+using heap_t = datastructure::PooledPairingHeap<node_pt, compare_node_cost>;
 
 /**
  * Size of phys-coord grid for path nodes.
@@ -165,7 +165,7 @@ public:
 	/**
 	 * Priority queue node that contains this path node.
 	 */
-	heap_t::element_t heap_node;
+	heap_t::handle_t heap_node;
 };
 
 
@@ -1,9 +1,25 @@
-// Copyright 2015-2018 the openage authors. See copying.md for legal info.
+// Copyright 2015-2026 the openage authors. See copying.md for legal info.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
 
 #include "../log/log.h"
 #include "../testing/testing.h"
+#include "../util/timer.h"
 
+#include "cost_field.h"
+#include "flow_field.h"
+#include "grid.h"
+#include "grid_pathfinder.h"
 #include "heuristics.h"
+#include "hierarchical_pathfinder.h"
 #include "path.h"
 
 namespace openage {
@@ -311,6 +327,704 @@ void path_node() {
 	node_passable_line_0();
 }
 
+
+/**
+ * Create a grid with a cost field for every chunk.
+ */
+std::shared_ptr<Grid> make_grid(const util::Vector2s &size, const util::Vector2s &chunk_size) {
+	auto grid = std::make_shared<Grid>(size, chunk_size);
+	for (size_t ne = 0; ne < size[0]; ++ne) {
+		for (size_t se = 0; se < size[1]; ++se) {
+			grid->set_chunk({ne, se}, std::make_shared<CostField>(chunk_size));
+		}
+	}
+	return grid;
+}
+
+/**
+ * Set the cost of a tile on a grid.
+ */
+void set_grid_cost(const std::shared_ptr<Grid> &grid, const coord::tile &tile, tile_cost_t cost) {
+	auto &chunk_size = grid->get_chunk_size();
+	util::Vector2s chunk{tile.ne / chunk_size[0], tile.se / chunk_size[1]};
+	coord::tile_delta local{static_cast<coord::tile_t>(tile.ne % chunk_size[0]),
+	                        static_cast<coord::tile_t>(tile.se % chunk_size[1])};
+	grid->get_chunk(chunk)->set_cost(local, cost);
+}
+
+/**
+ * Calculate the cost of a path the same way as the pathfinder.
+ * Checks that every step of the path is allowed.
+ */
+uint32_t path_cost(const std::shared_ptr<Grid> &grid, const std::vector<coord::tile> &waypoints) {
+	uint32_t cost = 0;
+	for (size_t i = 1; i < waypoints.size(); ++i) {
+		coord::tile_delta delta = waypoints[i] - waypoints[i - 1];
+		coord::tile_t steps = std::max(std::abs(delta.ne), std::abs(delta.se));
+		coord::tile_delta step{delta.ne / steps, delta.se / steps};
+
+		// legs must be straight or diagonal lines
+		(step.ne * steps == delta.ne and step.se * steps == delta.se) or TESTFAIL;
+
+		coord::tile pos = waypoints[i - 1];
+		for (coord::tile_t j = 0; j < steps; ++j) {
+			coord::tile next = pos + step;
+			tile_cost_t tile_cost = grid->get_cost(next);
+			(tile_cost != COST_IMPASSABLE) or TESTFAIL;
+
+			if (step.ne != 0 and step.se != 0) {
+				// no corner cutting
+				(grid->get_cost(pos + coord::tile_delta{step.ne, 0}) != COST_IMPASSABLE) or TESTFAIL;
+				(grid->get_cost(pos + coord::tile_delta{0, step.se}) != COST_IMPASSABLE) or TESTFAIL;
+				cost += 14 * tile_cost;
+			}
+			else {
+				cost += 10 * tile_cost;
+			}
+			pos = next;
+		}
+	}
+	return cost;
+}
+
+/**
+ * Cost of the cheapest path between two tiles, calculated with Dijkstra.
+ */
+uint32_t reference_cost(const std::shared_ptr<Grid> &grid, const coord::tile &start, const coord::tile &target) {
+	auto &size = grid->get_tile_size();
+	auto index = [&](const coord::tile &tile) {
+		return tile.ne * size[1] + tile.se;
+	};
+
+	std::vector<uint32_t> costs(size[0] * size[1], std::numeric_limits<uint32_t>::max());
+	using entry_t = std::pair<uint32_t, coord::tile>;
+	auto cmp = [](const entry_t &a, const entry_t &b) { return a.first > b.first; };
+	std::priority_queue<entry_t, std::vector<entry_t>, decltype(cmp)> queue{cmp};
+
+	costs[index(start)] = 0;
+	queue.emplace(0, start);
+	while (not queue.empty()) {
+		auto [cost, pos] = queue.top();
+		queue.pop();
+		if (pos == target) {
+			return cost;
+		}
+		if (cost > costs[index(pos)]) {
+			continue;
+		}
+
+		for (coord::tile_t dne = -1; dne <= 1; ++dne) {
+			for (coord::tile_t dse = -1; dse <= 1; ++dse) {
+				coord::tile next = pos + coord::tile_delta{dne, dse};
+				tile_cost_t tile_cost = grid->get_cost(next);
+				if ((dne == 0 and dse == 0) or tile_cost == COST_IMPASSABLE) {
+					continue;
+				}
+
+				uint32_t step = 10 * tile_cost;
+				if (dne != 0 and dse != 0) {
+					if (grid->get_cost(pos + coord::tile_delta{dne, 0}) == COST_IMPASSABLE
+					    or grid->get_cost(pos + coord::tile_delta{0, dse}) == COST_IMPASSABLE) {
+						continue;
+					}
+					step = 14 * tile_cost;
+				}
+
+				if (cost + step < costs[index(next)]) {
+					costs[index(next)] = cost + step;
+					queue.emplace(cost + step, next);
+				}
+			}
+		}
+	}
+
+	return std::numeric_limits<uint32_t>::max();
+}
+
+/**
+ * Paths on a grid without obstacles.
+ */
+void grid_pathfinder_0() {
+	auto grid = make_grid({2, 2}, {10, 10});
+	GridPathfinder pathfinder{grid};
+
+	// straight line
+	auto waypoints = pathfinder.find_path({0, 0}, {15, 0});
+	TESTEQUALS(waypoints.size(), 2);
+	(waypoints[0] == coord::tile{0, 0}) or TESTFAIL;
+	(waypoints[1] == coord::tile{15, 0}) or TESTFAIL;
+
+	// diagonal, then straight
+	waypoints = pathfinder.find_path({0, 0}, {19, 5});
+	TESTEQUALS(path_cost(grid, waypoints), 14 * 5 + 10 * 14);
+	TESTEQUALS(waypoints.size(), 3);
+
+	// start is the target
+	waypoints = pathfinder.find_path({3, 3}, {3, 3});
+	TESTEQUALS(waypoints.size(), 1);
+
+	// start is not on the grid
+	TESTEQUALS(pathfinder.find_path({-1, 0}, {3, 3}).size(), 0);
+}
+
+/**
+ * Paths around obstacles.
+ */
+void grid_pathfinder_1() {
+	auto grid = make_grid({2, 2}, {10, 10});
+	GridPathfinder pathfinder{grid};
+
+	// wall at ne = 10 with a gap at se = 17
+	for (coord::tile_t se = 0; se < 20; ++se) {
+		if (se != 17) {
+			set_grid_cost(grid, {10, se}, COST_IMPASSABLE);
+		}
+	}
+
+	auto waypoints = pathfinder.find_path({2, 2}, {18, 2});
+	(waypoints.back() == coord::tile{18, 2}) or TESTFAIL;
+	TESTEQUALS(path_cost(grid, waypoints), reference_cost(grid, {2, 2}, {18, 2}));
+
+	// close the gap, the closest reachable tile is right in front of the wall
+	set_grid_cost(grid, {10, 17}, COST_IMPASSABLE);
+	waypoints = pathfinder.find_path({2, 2}, {18, 2});
+	(waypoints.back() == coord::tile{9, 2}) or TESTFAIL;
+
+	// expensive terrain is avoided
+	grid = make_grid({1, 1}, {10, 10});
+	for (coord::tile_t se = 0; se < 9; ++se) {
+		set_grid_cost(grid, {5, se}, 20);
+	}
+	GridPathfinder expensive_pathfinder{grid};
+	waypoints = expensive_pathfinder.find_path({0, 0}, {9, 0});
+	TESTEQUALS(path_cost(grid, waypoints), reference_cost(grid, {0, 0}, {9, 0}));
+	TESTEQUALS(path_cost(grid, waypoints) < 10 * 8 + 10 * 20, true);
+}
+
+/**
+ * Compare path costs with Dijkstra on random grids.
+ */
+void grid_pathfinder_2() {
+	std::mt19937 rng{4242};
+	std::uniform_int_distribution<int> cost_dist{0, 9};
+	std::uniform_int_distribution<coord::tile_t> pos_dist{0, 31};
+
+	for (int round = 0; round < 20; ++round) {
+		auto grid = make_grid({2, 2}, {16, 16});
+		for (coord::tile_t ne = 0; ne < 32; ++ne) {
+			for (coord::tile_t se = 0; se < 32; ++se) {
+				int cost = cost_dist(rng);
+				if (cost < 2) {
+					set_grid_cost(grid, {ne, se}, COST_IMPASSABLE);
+				}
+				else if (cost < 4) {
+					set_grid_cost(grid, {ne, se}, static_cast<tile_cost_t>(cost * 3));
+				}
+			}
+		}
+
+		// one pathfinder for multiple searches, so the search state is reused
+		GridPathfinder pathfinder{grid};
+		for (int i = 0; i < 10; ++i) {
+			coord::tile start{pos_dist(rng), pos_dist(rng)};
+			coord::tile target{pos_dist(rng), pos_dist(rng)};
+
+			auto waypoints = pathfinder.find_path(start, target);
+			(waypoints.front() == start) or TESTFAIL;
+
+			uint32_t expected = reference_cost(grid, start, target);
+			if (expected != std::numeric_limits<uint32_t>::max()) {
+				(waypoints.back() == target) or TESTFAIL;
+				TESTEQUALS(path_cost(grid, waypoints), expected);
+			}
+			else {
+				(waypoints.back() != target) or TESTFAIL;
+				path_cost(grid, waypoints);
+			}
+		}
+	}
+}
+
+/**
+ * Top level grid pathfinder test.
+ */
+void grid_pathfinder() {
+	grid_pathfinder_0();
+	grid_pathfinder_1();
+	grid_pathfinder_2();
+}
+
+
+/**
+ * Check that a path reaches the target and costs at most 50% more than the best path.
+ */
+bool near_optimal(const std::shared_ptr<Grid> &grid,
+                  const std::vector<coord::tile> &waypoints,
+                  const coord::tile &start,
+                  const coord::tile &target) {
+	if (waypoints.front() != start or waypoints.back() != target) {
+		return false;
+	}
+
+	uint32_t cost = path_cost(grid, waypoints);
+	uint32_t expected = reference_cost(grid, start, target);
+
+	return cost >= expected and cost <= expected * 3 / 2;
+}
+
+/**
+ * Portals and paths on a grid without obstacles.
+ */
+void hierarchical_pathfinder_0() {
+	auto grid = make_grid({2, 2}, {16, 16});
+	HierarchicalPathfinder pathfinder{grid};
+
+	// every border is one long entrance with a portal at both ends
+	TESTEQUALS(pathfinder.get_portal_count(), 4 * 2 * 2);
+
+	// path over all chunks
+	auto waypoints = pathfinder.find_path({0, 0}, {31, 31});
+	(waypoints.front() == coord::tile{0, 0}) or TESTFAIL;
+	(waypoints.back() == coord::tile{31, 31}) or TESTFAIL;
+	TESTEQUALS(path_cost(grid, waypoints), reference_cost(grid, {0, 0}, {31, 31}));
+
+	// path inside of a chunk
+	waypoints = pathfinder.find_path({2, 2}, {12, 2});
+	TESTEQUALS(waypoints.size(), 2);
+	TESTEQUALS(path_cost(grid, waypoints), 10 * 10);
+
+	// start is the target
+	waypoints = pathfinder.find_path({3, 3}, {3, 3});
+	TESTEQUALS(waypoints.size(), 1);
+
+	// start is not on the grid
+	TESTEQUALS(pathfinder.find_path({-1, 0}, {3, 3}).size(), 0);
+}
+
+/**
+ * Repair the abstract graph when the costs of a chunk change.
+ */
+void hierarchical_pathfinder_1() {
+	auto grid = make_grid({2, 2}, {16, 16});
+	HierarchicalPathfinder pathfinder{grid};
+
+	// wall at ne = 8 with a gap at se = 20
+	for (coord::tile_t se = 0; se < 32; ++se) {
+		if (se != 20) {
+			set_grid_cost(grid, {8, se}, COST_IMPASSABLE);
+		}
+	}
+
+	auto waypoints = pathfinder.find_path({2, 2}, {30, 2});
+	near_optimal(grid, waypoints, {2, 2}, {30, 2}) or TESTFAIL;
+
+	// close the gap, the closest reachable tile is right in front of the wall
+	set_grid_cost(grid, {8, 20}, COST_IMPASSABLE);
+	waypoints = pathfinder.find_path({2, 2}, {30, 2});
+	(waypoints.back() == coord::tile{7, 2}) or TESTFAIL;
+
+	// block the border between the chunks at se = 16, but open the wall again
+	size_t portal_count = pathfinder.get_portal_count();
+	for (coord::tile_t ne = 0; ne < 16; ++ne) {
+		set_grid_cost(grid, {ne, 16}, COST_IMPASSABLE);
+	}
+	set_grid_cost(grid, {8, 4}, COST_MIN);
+
+	// the two entrances on both sides of the wall are gone
+	TESTEQUALS(pathfinder.get_portal_count(), portal_count - 2 * 2 * 2);
+
+	waypoints = pathfinder.find_path({2, 2}, {30, 2});
+	near_optimal(grid, waypoints, {2, 2}, {30, 2}) or TESTFAIL;
+
+	// detour around the blocked border
+	waypoints = pathfinder.find_path({2, 2}, {12, 30});
+	near_optimal(grid, waypoints, {2, 2}, {12, 30}) or TESTFAIL;
+}
+
+/**
+ * Compare reachability and path costs with Dijkstra on random grids.
+ */
+void hierarchical_pathfinder_2() {
+	std::mt19937 rng{4242};
+	std::uniform_int_distribution<int> cost_dist{0, 9};
+	std::uniform_int_distribution<coord::tile_t> pos_dist{0, 63};
+
+	for (int round = 0; round < 10; ++round) {
+		auto grid = make_grid({4, 4}, {16, 16});
+		for (coord::tile_t ne = 0; ne < 64; ++ne) {
+			for (coord::tile_t se = 0; se < 64; ++se) {
+				int cost = cost_dist(rng);
+				if (cost < 2) {
+					set_grid_cost(grid, {ne, se}, COST_IMPASSABLE);
+				}
+				else if (cost < 4) {
+					set_grid_cost(grid, {ne, se}, static_cast<tile_cost_t>(cost * 3));
+				}
+			}
+		}
+
+		HierarchicalPathfinder pathfinder{grid};
+		for (int i = 0; i < 20; ++i) {
+			coord::tile start{pos_dist(rng), pos_dist(rng)};
+			coord::tile target{pos_dist(rng), pos_dist(rng)};
+
+			auto waypoints = pathfinder.find_path(start, target);
+			(waypoints.front() == start) or TESTFAIL;
+
+			uint32_t expected = reference_cost(grid, start, target);
+			if (expected != std::numeric_limits<uint32_t>::max()) {
+				near_optimal(grid, waypoints, start, target) or TESTFAIL;
+			}
+			else {
+				(waypoints.back() != target) or TESTFAIL;
+				path_cost(grid, waypoints);
+			}
+		}
+	}
+}
+
+/**
+ * Top level hierarchical pathfinder test.
+ */
+void hierarchical_pathfinder() {
+	hierarchical_pathfinder_0();
+	hierarchical_pathfinder_1();
+	hierarchical_pathfinder_2();
+}
+
+
+/**
+ * Flow fields on a grid with a walled in area.
+ */
+void flow_field_0() {
+	auto grid = make_grid({2, 2}, {16, 16});
+	HierarchicalPathfinder pathfinder{grid};
+
+	auto field = pathfinder.get_flow_field({31, 31});
+	(field != nullptr) or TESTFAIL;
+	(field->get_target() == coord::tile{31, 31}) or TESTFAIL;
+	TESTEQUALS(field->get_integrated_chunks(), 0);
+
+	// only the chunk of the target is needed for a path inside of it
+	auto waypoints = field->get_path({20, 20});
+	TESTEQUALS(waypoints.size(), 2);
+	TESTEQUALS(path_cost(grid, waypoints), 14 * 11);
+	TESTEQUALS(field->get_integrated_chunks(), 1);
+	TESTEQUALS(field->get_flow({31, 31}), FLOW_NONE);
+	TESTEQUALS(field->get_cost({31, 31}), 0);
+
+	waypoints = field->get_path({0, 0});
+	near_optimal(grid, waypoints, {0, 0}, {31, 31}) or TESTFAIL;
+	TESTEQUALS(path_cost(grid, waypoints), field->get_cost({0, 0}));
+
+	// fields are shared until the costs change
+	(pathfinder.get_flow_field({31, 31}) == field) or TESTFAIL;
+
+	// wall around the target
+	for (coord::tile_t i = 26; i < 32; ++i) {
+		set_grid_cost(grid, {26, i}, COST_IMPASSABLE);
+		set_grid_cost(grid, {i, 26}, COST_IMPASSABLE);
+	}
+	auto walled = pathfinder.get_flow_field({31, 31});
+	(walled != field) or TESTFAIL;
+
+	waypoints = walled->get_path({0, 0});
+	TESTEQUALS(waypoints.size(), 1);
+	TESTEQUALS(walled->get_cost({0, 0}), Integrator::unreachable);
+	TESTEQUALS(walled->get_flow({0, 0}), FLOW_NONE);
+
+	waypoints = walled->get_path({28, 28});
+	(waypoints.back() == coord::tile{31, 31}) or TESTFAIL;
+
+	// impassable or off-grid targets have no field
+	(pathfinder.get_flow_field({26, 30}) == nullptr) or TESTFAIL;
+	(pathfinder.get_flow_field({32, 0}) == nullptr) or TESTFAIL;
+
+	// off-grid starts have no path
+	TESTEQUALS(walled->get_path({-1, 0}).size(), 0);
+}
+
+/**
+ * Compare reachability and path costs with Dijkstra on random grids.
+ */
+void flow_field_1() {
+	std::mt19937 rng{2323};
+	std::uniform_int_distribution<int> cost_dist{0, 9};
+	std::uniform_int_distribution<coord::tile_t> pos_dist{0, 63};
+
+	for (int round = 0; round < 10; ++round) {
+		auto grid = make_grid({4, 4}, {16, 16});
+		for (coord::tile_t ne = 0; ne < 64; ++ne) {
+			for (coord::tile_t se = 0; se < 64; ++se) {
+				int cost = cost_dist(rng);
+				if (cost < 2) {
+					set_grid_cost(grid, {ne, se}, COST_IMPASSABLE);
+				}
+				else if (cost < 4) {
+					set_grid_cost(grid, {ne, se}, static_cast<tile_cost_t>(cost * 3));
+				}
+			}
+		}
+
+		HierarchicalPathfinder pathfinder{grid};
+		coord::tile target{pos_dist(rng), pos_dist(rng)};
+		while (grid->get_cost(target) == COST_IMPASSABLE) {
+			target = coord::tile{pos_dist(rng), pos_dist(rng)};
+		}
+
+		auto field = pathfinder.get_flow_field(target);
+		(field != nullptr) or TESTFAIL;
+
+		for (int i = 0; i < 20; ++i) {
+			coord::tile start{pos_dist(rng), pos_dist(rng)};
+
+			auto waypoints = field->get_path(start);
+			(waypoints.front() == start) or TESTFAIL;
+
+			uint32_t expected = reference_cost(grid, start, target);
+			if (expected != std::numeric_limits<uint32_t>::max()
+			    and grid->get_cost(start) != COST_IMPASSABLE) {
+				// paths only cross chunk borders at portals, which makes short
+				// paths between neighboring chunks up to twice as expensive
+				(waypoints.back() == target) or TESTFAIL;
+				uint32_t cost = path_cost(grid, waypoints);
+				(cost >= expected and cost <= expected * 3) or TESTFAIL;
+				(cost <= field->get_cost(start)) or TESTFAIL;
+			}
+			else {
+				(waypoints.back() != target or start == target) or TESTFAIL;
+				path_cost(grid, waypoints);
+			}
+		}
+	}
+}
+
+/**
+ * Top level flow field test.
+ */
+void flow_field() {
+	flow_field_0();
+	flow_field_1();
+}
+
+
+/**
+ * Benchmark the grid pathfinder on a 256x256 map with random obstacles
+ * and log the number of paths per second.
+ */
+void benchmark_grid_pathfinder() {
+	constexpr size_t paths = 1000;
+
+	std::mt19937 rng{42};
+	std::uniform_int_distribution<int> cost_dist{0, 99};
+	std::uniform_int_distribution<coord::tile_t> pos_dist{0, 255};
+
+	auto grid = make_grid({16, 16}, {16, 16});
+	for (coord::tile_t ne = 0; ne < 256; ++ne) {
+		for (coord::tile_t se = 0; se < 256; ++se) {
+			int cost = cost_dist(rng);
+			if (cost < 20) {
+				set_grid_cost(grid, {ne, se}, COST_IMPASSABLE);
+			}
+			else if (cost < 30) {
+				set_grid_cost(grid, {ne, se}, 3);
+			}
+		}
+	}
+
+	// units stand on passable tiles and are usually sent to passable tiles
+	auto passable_tile = [&]() {
+		coord::tile tile{pos_dist(rng), pos_dist(rng)};
+		while (grid->get_cost(tile) == COST_IMPASSABLE) {
+			tile = coord::tile{pos_dist(rng), pos_dist(rng)};
+		}
+		return tile;
+	};
+
+	std::vector<std::pair<coord::tile, coord::tile>> requests;
+	requests.reserve(paths);
+	for (size_t i = 0; i < paths; ++i) {
+		auto start = passable_tile();
+		requests.emplace_back(start, passable_tile());
+	}
+
+	GridPathfinder pathfinder{grid};
+	util::Timer timer;
+	size_t waypoints = 0;
+
+	timer.start();
+	for (const auto &[start, target] : requests) {
+		waypoints += pathfinder.find_path(start, target).size();
+	}
+	timer.stop();
+
+	log::log(INFO << "256x256 grid: " << paths * 1e9 / timer.getval()
+	              << " paths/s (" << static_cast<double>(timer.getval()) / paths / 1000
+	              << " us/path, " << waypoints << " waypoints)");
+}
+
+
+/**
+ * Create a 512x512 grid with random obstacles and rough terrain for benchmarks.
+ */
+std::shared_ptr<Grid> make_benchmark_grid(std::mt19937 &rng) {
+	std::uniform_int_distribution<int> cost_dist{0, 99};
+	std::uniform_int_distribution<coord::tile_t> pos_dist{0, 511};
+
+	// scattered obstacles and rough terrain
+	auto grid = make_grid({32, 32}, {16, 16});
+	for (coord::tile_t ne = 0; ne < 512; ++ne) {
+		for (coord::tile_t se = 0; se < 512; ++se) {
+			int cost = cost_dist(rng);
+			if (cost < 10) {
+				set_grid_cost(grid, {ne, se}, COST_IMPASSABLE);
+			}
+			else if (cost < 20) {
+				set_grid_cost(grid, {ne, se}, 3);
+			}
+		}
+	}
+
+	// large obstacles like lakes and forests
+	std::uniform_int_distribution<coord::tile_t> extent_dist{4, 40};
+	for (int i = 0; i < 150; ++i) {
+		coord::tile corner{pos_dist(rng), pos_dist(rng)};
+		coord::tile_delta extent{extent_dist(rng), extent_dist(rng)};
+		for (coord::tile_t ne = corner.ne; ne < std::min<coord::tile_t>(corner.ne + extent.ne, 512); ++ne) {
+			for (coord::tile_t se = corner.se; se < std::min<coord::tile_t>(corner.se + extent.se, 512); ++se) {
+				set_grid_cost(grid, {ne, se}, COST_IMPASSABLE);
+			}
+		}
+	}
+
+	return grid;
+}
+
+
+/**
+ * Benchmark the hierarchical pathfinder against the grid pathfinder on
+ * a 512x512 map with random obstacles and log the number of paths per second.
+ */
+void benchmark_hierarchical_pathfinder() {
+	constexpr size_t paths = 200;
+
+	std::mt19937 rng{42};
+	std::uniform_int_distribution<coord::tile_t> pos_dist{0, 511};
+	auto grid = make_benchmark_grid(rng);
+
+	auto passable_tile = [&]() {
+		coord::tile tile{pos_dist(rng), pos_dist(rng)};
+		while (grid->get_cost(tile) == COST_IMPASSABLE) {
+			tile = coord::tile{pos_dist(rng), pos_dist(rng)};
+		}
+		return tile;
+	};
+
+	std::vector<std::pair<coord::tile, coord::tile>> requests;
+	requests.reserve(paths);
+	for (size_t i = 0; i < paths; ++i) {
+		auto start = passable_tile();
+		requests.emplace_back(start, passable_tile());
+	}
+
+	util::Timer timer;
+
+	timer.start();
+	HierarchicalPathfinder hierarchical{grid};
+	timer.stop();
+	log::log(INFO << "512x512 grid: building " << hierarchical.get_portal_count()
+	              << " portals took " << static_cast<double>(timer.getval()) / 1000000 << " ms");
+
+	auto bench = [&](const char *name, auto &pathfinder) {
+		size_t waypoints = 0;
+		timer.reset();
+		timer.start();
+		for (const auto &[start, target] : requests) {
+			waypoints += pathfinder.find_path(start, target).size();
+		}
+		timer.stop();
+
+		log::log(INFO << "512x512 grid, " << name << ": " << paths * 1e9 / timer.getval()
+		              << " paths/s (" << static_cast<double>(timer.getval()) / paths / 1000
+		              << " us/path, " << waypoints << " waypoints)");
+	};
+
+	GridPathfinder flat{grid};
+	bench("grid", flat);
+	bench("hierarchical", hierarchical);
+}
+
+
+
+/**
+ * Benchmark a group of units that moves to one target with a flow field
+ * against a search for each unit on a 512x512 map with random obstacles.
+ */
+void benchmark_flow_field() {
+	constexpr size_t groups = 20;
+	constexpr size_t units = 100;
+
+	std::mt19937 rng{42};
+	std::uniform_int_distribution<coord::tile_t> pos_dist{0, 511};
+	std::uniform_int_distribution<coord::tile_t> offset_dist{-10, 10};
+	auto grid = make_benchmark_grid(rng);
+
+	auto passable_tile = [&]() {
+		coord::tile tile{pos_dist(rng), pos_dist(rng)};
+		while (grid->get_cost(tile) == COST_IMPASSABLE) {
+			tile = coord::tile{pos_dist(rng), pos_dist(rng)};
+		}
+		return tile;
+	};
+
+	// the units of a group stand close together
+	std::vector<std::pair<std::vector<coord::tile>, coord::tile>> requests;
+	for (size_t i = 0; i < groups; ++i) {
+		coord::tile center = passable_tile();
+		std::vector<coord::tile> starts;
+		while (starts.size() < units) {
+			coord::tile start = center + coord::tile_delta{offset_dist(rng), offset_dist(rng)};
+			if (grid->contains(start) and grid->get_cost(start) != COST_IMPASSABLE) {
+				starts.push_back(start);
+			}
+		}
+		requests.emplace_back(std::move(starts), passable_tile());
+	}
+
+	HierarchicalPathfinder pathfinder{grid};
+	util::Timer timer;
+
+	size_t waypoints = 0;
+	timer.start();
+	for (const auto &[starts, target] : requests) {
+		for (const auto &start : starts) {
+			waypoints += pathfinder.find_path(start, target).size();
+		}
+	}
+	timer.stop();
+	log::log(INFO << "512x512 grid, " << units << " units, hierarchical: "
+	              << static_cast<double>(timer.getval()) / groups / 1000000 << " ms/group ("
+	              << waypoints << " waypoints)");
+
+	waypoints = 0;
+	size_t integrated_chunks = 0;
+	timer.reset();
+	timer.start();
+	for (const auto &[starts, target] : requests) {
+		auto field = pathfinder.get_flow_field(target);
+		for (const auto &start : starts) {
+			waypoints += field->get_path(start).size();
+		}
+		integrated_chunks += field->get_integrated_chunks();
+	}
+	timer.stop();
+	log::log(INFO << "512x512 grid, " << units << " units, flow field: "
+	              << static_cast<double>(timer.getval()) / groups / 1000000 << " ms/group ("
+	              << waypoints << " waypoints, "
+	              << integrated_chunks / groups << " of " << 32 * 32 << " chunks integrated)");
+}
+
 } // namespace tests
-} // namespace pathfinding
+} // namespace path
 } // namespace openage
+
@@ -1,4 +1,4 @@
-// Copyright 2019-2024 the openage authors. See copying.md for legal info.
+// Copyright 2019-2026 the openage authors. See copying.md for legal info.
 
 #include "presenter.h"
 
@@ -16,6 +16,7 @@
 #include "input/controller/hud/controller.h"
 #include "input/input_context.h"
 #include "input/input_manager.h"
+#include "job/main_thread_executor.h"
 #include "log/log.h"
 #include "renderer/camera/camera.h"
 #include "renderer/gui/gui.h"
@@ -45,7 +46,8 @@ Presenter::Presenter(const util::Path &root_dir,
 	root_dir{root_dir},
 	render_passes{},
 	simulation{simulation},
-	time_loop{time_loop} {}
+	time_loop{time_loop},
+	main_thread_executor{std::make_shared<job::MainThreadExecutor>()} {}
 
 
 void Presenter::run(bool debug_graphics) {
@@ -59,6 +61,10 @@ void Presenter::run(bool debug_graphics) {
 		this->gui_app->process_events();
 		// TODO: pass button presses and events from GUI to controller
 
+		// continue coroutines that wait for the presenter thread,
+		// e.g. to add loaded assets to the cache
+		this->main_thread_executor->run_pending();
+
 		this->render();
 
 		this->renderer->check_error();
@@ -89,6 +95,10 @@ void Presenter::set_time_loop(const std::shared_ptr<time::TimeLoop> &time_loop)
 	this->time_loop = time_loop;
 }
 
+const std::shared_ptr<job::MainThreadExecutor> &Presenter::get_main_thread_executor() const {
+	return this->main_thread_executor;
+}
+
 std::shared_ptr<qtgui::GuiApplication> Presenter::init_window_system() {
 	return std::make_shared<renderer::gui::GuiApplicationWithLogger>();
 }
@@ -1,4 +1,4 @@
-// Copyright 2019-2024 the openage authors. See copying.md for legal info.
+// Copyright 2019-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -21,6 +21,10 @@ namespace input {
 class InputManager;
 }
 
+namespace job {
+class MainThreadExecutor;
+}
+
 namespace time {
 class TimeLoop;
 }
@@ -105,6 +109,15 @@ public:
 	 */
 	void set_time_loop(const std::shared_ptr<time::TimeLoop> &time_loop);
 
+	/**
+	 * Get the executor that resumes coroutines on the presenter thread, e.g.
+	 * to add asynchronously loaded assets to the asset manager. Scheduled
+	 * coroutines are resumed once per frame.
+	 *
+	 * @return Executor of the presenter thread.
+	 */
+	const std::shared_ptr<job::MainThreadExecutor> &get_main_thread_executor() const;
+
 	/**
 	 * Initialize the Qt application managing the graphical views. Required
 	 * for creating windows.
@@ -228,6 +241,11 @@ protected:
 	 * Input manager.
 	 */
 	std::shared_ptr<input::InputManager> input_manager;
+
+	/**
+	 * Resumes coroutines that continue on the presenter thread.
+	 */
+	std::shared_ptr<job::MainThreadExecutor> main_thread_executor;
 };
 
 } // namespace presenter
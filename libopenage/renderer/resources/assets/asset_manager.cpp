@@ -1,8 +1,12 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2026 the openage authors. See copying.md for legal info.
 
 #include "asset_manager.h"
 
+#include <exception>
+
 #include "error/error.h"
+#include "job/main_thread_executor.h"
+#include "job/task.h"
 #include "log/log.h"
 #include "log/message.h"
 
@@ -165,6 +169,75 @@ const std::shared_ptr<Texture2dInfo> &AssetManager::request_texture(const util::
 	return this->cache->get_texture(path);
 }
 
+job::Task<std::shared_ptr<Animation2dInfo>> AssetManager::request_animation_async(util::Path path,
+                                                                                  job::JobManager &job_manager,
+                                                                                  job::MainThreadExecutor &main_thread) {
+	if (this->cache->check_animation_cache(path)) {
+		co_return this->cache->get_animation(path);
+	}
+
+	co_await job::resume_on(job_manager);
+	std::shared_ptr<Animation2dInfo> info;
+	std::exception_ptr error;
+	try {
+		// the cache can only be used on the main thread
+		info = std::make_shared<Animation2dInfo>(parser::parse_sprite_file(path));
+	}
+	catch (const Error &) {
+		error = std::current_exception();
+	}
+	co_await main_thread.schedule();
+
+	if (error != nullptr) {
+		if (this->placeholder_animation) {
+			log::log(MSG(warn) << "Failed to load animation file from: " << path
+			                   << " - using placeholder instead.");
+			co_return (*this->placeholder_animation).second;
+		}
+		std::rethrow_exception(error);
+	}
+
+	// another request may have loaded the animation meanwhile
+	if (not this->cache->check_animation_cache(path)) {
+		this->cache->add_animation(path, info);
+	}
+	co_return this->cache->get_animation(path);
+}
+
+job::Task<std::shared_ptr<Texture2dInfo>> AssetManager::request_texture_async(util::Path path,
+                                                                              job::JobManager &job_manager,
+                                                                              job::MainThreadExecutor &main_thread) {
+	if (this->cache->check_texture_cache(path)) {
+		co_return this->cache->get_texture(path);
+	}
+
+	co_await job::resume_on(job_manager);
+	std::shared_ptr<Texture2dInfo> info;
+	std::exception_ptr error;
+	try {
+		info = std::make_shared<Texture2dInfo>(parser::parse_texture_file(path));
+	}
+	catch (const Error &) {
+		error = std::current_exception();
+	}
+	co_await main_thread.schedule();
+
+	if (error != nullptr) {
+		if (this->placeholder_texture) {
+			log::log(MSG(warn) << "Failed to load texture file from: " << path
+			                   << " - using placeholder instead.");
+			co_return (*this->placeholder_texture).second;
+		}
+		std::rethrow_exception(error);
+	}
+
+	// another request may have loaded the texture meanwhile
+	if (not this->cache->check_texture_cache(path)) {
+		this->cache->add_texture(path, info);
+	}
+	co_return this->cache->get_texture(path);
+}
+
 const std::shared_ptr<Animation2dInfo> &AssetManager::request_animation(const std::string &rel_path) {
 	return this->request_animation(this->asset_base_dir / rel_path);
 }
@@ -1,4 +1,4 @@
-// Copyright 2023-2024 the openage authors. See copying.md for legal info.
+// Copyright 2023-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -10,7 +10,16 @@
 #include "util/path.h"
 
 
-namespace openage::renderer {
+namespace openage {
+namespace job {
+class JobManager;
+class MainThreadExecutor;
+
+template <class T>
+class Task;
+} // namespace job
+
+namespace renderer {
 class Renderer;
 
 namespace resources {
@@ -87,6 +96,31 @@ public:
 	const std::shared_ptr<TerrainInfo> &request_terrain(const std::string &rel_path);
 	const std::shared_ptr<Texture2dInfo> &request_texture(const std::string &rel_path);
 
+	/**
+	 * Get the corresponding asset for the specified path without blocking
+	 * the calling thread.
+	 *
+	 * If the asset does not exist in the cache yet, the file is parsed on a
+	 * worker thread and the result is added to the cache on the thread of
+	 * \p main_thread. The task must be started or awaited on that thread,
+	 * because the cache is not synchronized.
+	 *
+	 * Textures of an animation loaded this way are not shared with the
+	 * texture cache.
+	 *
+	 * @param path Path to the asset resource.
+	 * @param job_manager Job manager whose workers parse the file.
+	 * @param main_thread Executor of the thread that uses this asset manager.
+	 *
+	 * @return Task that returns the asset resource at the given path.
+	 */
+	job::Task<std::shared_ptr<Animation2dInfo>> request_animation_async(util::Path path,
+	                                                                    job::JobManager &job_manager,
+	                                                                    job::MainThreadExecutor &main_thread);
+	job::Task<std::shared_ptr<Texture2dInfo>> request_texture_async(util::Path path,
+	                                                                job::JobManager &job_manager,
+	                                                                job::MainThreadExecutor &main_thread);
+
 	using placeholder_anim_t = std::optional<std::pair<util::Path, std::shared_ptr<Animation2dInfo>>>;
 	using placeholder_blpattern_t = std::optional<std::pair<util::Path, std::shared_ptr<BlendPatternInfo>>>;
 	using placeholder_bltable_t = std::optional<std::pair<util::Path, std::shared_ptr<BlendTableInfo>>>;
@@ -162,4 +196,5 @@ private:
 };
 
 } // namespace resources
-} // namespace openage::renderer
+} // namespace renderer
+} // namespace openage
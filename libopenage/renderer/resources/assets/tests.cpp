@@ -0,0 +1,154 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "error/error.h"
+#include "job/job_manager.h"
+#include "job/main_thread_executor.h"
+#include "job/task.h"
+#include "renderer/resources/animation/animation_info.h"
+#include "renderer/resources/assets/asset_manager.h"
+#include "renderer/resources/texture_info.h"
+#include "testing/testing.h"
+#include "util/fslike/directory.h"
+#include "util/path.h"
+
+
+namespace openage::renderer::resources::tests {
+
+namespace {
+
+const std::string test_texture = R"(version 1
+imagefile "test.png"
+size 64 32
+pxformat rgba8 cbits=True
+subtex 0 0 32 32 16 16
+subtex 32 0 32 32 16 16
+)";
+
+const std::string test_sprite = R"(version 2
+texture 0 "test.texture"
+scalefactor 1.0
+layer 0 mode=off
+angle 0
+frame 0 0 0 0 0
+frame 1 0 0 0 1
+)";
+
+
+/**
+ * Start a task on the calling thread and resume the coroutines of
+ * \p main_thread until the task has finished.
+ *
+ * @return Result of the task.
+ */
+template <typename T>
+T run_task(job::Task<T> task, job::MainThreadExecutor &main_thread) {
+	bool finished = false;
+	T result;
+	std::exception_ptr error;
+	task.start([&](const job::result_function_t<T> &get_result) {
+		// the task finishes on the main thread
+		try {
+			result = get_result();
+		}
+		catch (...) {
+			error = std::current_exception();
+		}
+		finished = true;
+	});
+
+	while (not finished) {
+		if (main_thread.run_pending() == 0) {
+			std::this_thread::yield();
+		}
+	}
+
+	if (error != nullptr) {
+		std::rethrow_exception(error);
+	}
+	return result;
+}
+
+} // namespace
+
+
+void asset_manager() {
+	auto dir = std::filesystem::temp_directory_path() / "openage_asset_manager_test";
+	std::filesystem::remove_all(dir);
+	std::filesystem::create_directories(dir);
+	std::ofstream{dir / "test.texture"} << test_texture;
+	std::ofstream{dir / "test.sprite"} << test_sprite;
+
+	util::Path root{std::make_shared<util::fslike::Directory>(dir.string())};
+	AssetManager manager{nullptr, root};
+
+	job::JobManager job_manager{2};
+	job_manager.start();
+	job::MainThreadExecutor main_thread;
+
+	// files are parsed on the workers and cached on the main thread
+	auto texture = run_task(manager.request_texture_async(root / "test.texture", job_manager, main_thread),
+	                        main_thread);
+	TESTEQUALS(texture->get_size().first, 64);
+	TESTEQUALS(texture->get_size().second, 32);
+	TESTEQUALS(texture->get_subtex_count(), 2);
+	TESTEQUALS(manager.request_texture(root / "test.texture"), texture);
+
+	auto animation = run_task(manager.request_animation_async(root / "test.sprite", job_manager, main_thread),
+	                          main_thread);
+	TESTEQUALS(animation->get_texture_count(), 1);
+	TESTEQUALS(animation->get_layer_count(), 1);
+	TESTEQUALS(animation->get_texture(0)->get_subtex_count(), 2);
+	TESTEQUALS(manager.request_animation(root / "test.sprite"), animation);
+
+	// cached assets are returned without waiting
+	auto cached = manager.request_texture_async(root / "test.texture", job_manager, main_thread);
+	bool returned = false;
+	cached.start([&](const job::result_function_t<std::shared_ptr<Texture2dInfo>> &get_result) {
+		returned = (get_result() == texture);
+	});
+	TESTEQUALS(returned, true);
+	main_thread.has_pending() and TESTFAIL;
+
+	// concurrent requests of a file that is not cached yet return the same asset
+	std::ofstream{dir / "other.texture"} << test_texture;
+	auto other_path = root / "other.texture";
+	std::shared_ptr<Texture2dInfo> first;
+	std::shared_ptr<Texture2dInfo> second;
+	using texture_result_t = job::result_function_t<std::shared_ptr<Texture2dInfo>>;
+	manager.request_texture_async(other_path, job_manager, main_thread).start([&](const texture_result_t &get_result) {
+		first = get_result();
+	});
+	manager.request_texture_async(other_path, job_manager, main_thread).start([&](const texture_result_t &get_result) {
+		second = get_result();
+	});
+	while (first == nullptr or second == nullptr) {
+		if (main_thread.run_pending() == 0) {
+			std::this_thread::yield();
+		}
+	}
+	TESTEQUALS(first, second);
+	TESTEQUALS(manager.request_texture(other_path), first);
+
+	// errors are rethrown on the main thread without placeholder
+	TESTTHROWS(run_task(manager.request_texture_async(root / "missing.texture", job_manager, main_thread),
+	                    main_thread));
+
+	// and replaced by the placeholder otherwise
+	manager.set_placeholder_texture(root / "test.texture");
+	auto placeholder = run_task(manager.request_texture_async(root / "missing.texture", job_manager, main_thread),
+	                            main_thread);
+	TESTEQUALS(placeholder, manager.get_placeholder_texture()->second);
+
+	job_manager.stop();
+	std::filesystem::remove_all(dir);
+}
+
+} // namespace openage::renderer::resources::tests
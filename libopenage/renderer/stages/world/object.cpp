@@ -1,4 +1,4 @@
-// Copyright 2022-2024 the openage authors. See copying.md for legal info.
+// Copyright 2022-2026 the openage authors. See copying.md for legal info.
 
 #include "object.h"
 
@@ -36,8 +36,9 @@ WorldObject::WorldObject(const std::shared_ptr<renderer::resources::AssetManager
 	asset_manager{asset_manager},
 	render_entity{nullptr},
 	ref_id{0},
-	position{nullptr, 0, "", nullptr, SCENE_ORIGIN},
-	angle{nullptr, 0, "", nullptr, 0},
+	position{SCENE_ORIGIN},
+	angle{0},
+	animation_path{},
 	animation_info{nullptr, 0},
 	layer_uniforms{},
 	last_update{0.0} {
@@ -45,6 +46,9 @@ WorldObject::WorldObject(const std::shared_ptr<renderer::resources::AssetManager
 
 void WorldObject::set_render_entity(const std::shared_ptr<WorldRenderEntity> &entity) {
 	this->render_entity = entity;
+	this->position = this->render_entity->get_position().reader();
+	this->angle = this->render_entity->get_angle().reader();
+	this->animation_path = this->render_entity->get_animation_path().reader();
 	this->fetch_updates();
 }
 
@@ -61,10 +65,18 @@ void WorldObject::fetch_updates(const time::time_t &time) {
 		return;
 	}
 
+	// Clear the flag before fetching, so that updates that are published
+	// in the meantime are fetched by the next call
+	this->render_entity->clear_changed_flag();
+
 	// Get data from render entity
 	this->ref_id = this->render_entity->get_id();
-	this->position.sync(this->render_entity->get_position());
-	this->animation_info.sync(this->render_entity->get_animation_path(),
+	this->position.update();
+	this->angle.update();
+	this->animation_path.update();
+
+	// only new animation paths are converted, so assets are requested once per keyframe
+	this->animation_info.sync(this->animation_path,
 	                          std::function<std::shared_ptr<renderer::resources::Animation2dInfo>(const std::string &)>(
 								  [&](const std::string &path) {
 									  if (path.empty()) {
@@ -77,32 +89,32 @@ void WorldObject::fetch_updates(const time::time_t &time) {
 									  return this->asset_manager->request_animation(path);
 								  }),
 	                          this->last_update);
-	this->angle.sync(this->render_entity->get_angle(), this->last_update);
 
 	// Set self to changed so that world renderer can update the renderable
 	this->changed = true;
-	this->render_entity->clear_changed_flag();
 	this->last_update = time;
 }
 
-void WorldObject::update_uniforms(const time::time_t &time) {
+void WorldObject::update_uniforms(const time::time_t &time,
+                                  const coord::scene3 &position,
+                                  const coord::phys_angle_t &direction) {
 	// TODO: Only update uniforms that changed since last update
 	if (this->layer_uniforms.empty()) [[unlikely]] {
 		return;
 	}
 
 	// Object world position
-	auto current_pos = this->position.get(time);
+	auto world_pos = position.to_world_space();
 
 	// Direction angle the object is facing towards currently
-	auto angle_degrees = this->angle.get(time).to_float();
+	auto angle_degrees = direction.to_float();
 
 	// Animation information
 	auto animation_info = this->animation_info.get(time);
 
 	for (size_t layer_idx = 0; layer_idx < this->layer_uniforms.size(); ++layer_idx) {
 		auto &layer_unifs = this->layer_uniforms.at(layer_idx);
-		layer_unifs->update(this->obj_world_position, current_pos.to_world_space());
+		layer_unifs->update(this->obj_world_position, world_pos);
 
 		// Frame subtexture
 		auto &layer = animation_info->get_layer(layer_idx);
@@ -168,6 +180,14 @@ void WorldObject::update_uniforms(const time::time_t &time) {
 	}
 }
 
+curve::Reader<coord::scene3> &WorldObject::get_position() {
+	return this->position;
+}
+
+curve::Reader<coord::phys_angle_t> &WorldObject::get_angle() {
+	return this->angle;
+}
+
 uint32_t WorldObject::get_id() {
 	return this->ref_id;
 }
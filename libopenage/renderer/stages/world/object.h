@@ -1,4 +1,4 @@
-// Copyright 2022-2024 the openage authors. See copying.md for legal info.
+// Copyright 2022-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -10,7 +10,7 @@
 #include "coord/scene.h"
 #include "curve/continuous.h"
 #include "curve/discrete.h"
-#include "curve/segmented.h"
+#include "curve/reader.h"
 #include "renderer/resources/mesh_data.h"
 #include "renderer/types.h"
 #include "time/time.h"
@@ -61,9 +61,30 @@ public:
 	/**
 	 * Update the uniforms of the renderable associated with this object.
 	 *
+	 * The render stage samples the position and angle of all objects at once
+	 * (see \p get_position() and \p get_angle()) and passes them in.
+	 *
 	 * @param time Current simulation time.
+	 * @param position Position of the object at \p time.
+	 * @param direction Angle of the object at \p time.
+	 */
+	void update_uniforms(const time::time_t &time,
+	                     const coord::scene3 &position,
+	                     const coord::phys_angle_t &direction);
+
+	/**
+	 * Get the reader for the position of the object.
+	 *
+	 * @return Position reader.
 	 */
-	void update_uniforms(const time::time_t &time = 0.0);
+	curve::Reader<coord::scene3> &get_position();
+
+	/**
+	 * Get the reader for the angle of the object.
+	 *
+	 * @return Angle reader.
+	 */
+	curve::Reader<coord::phys_angle_t> &get_angle();
 
 	/**
 	 * Get the ID of the corresponding game entity.
@@ -176,13 +197,24 @@ private:
 
 	/**
 	 * Position of the object.
+	 *
+	 * Reads the published position of the render entity.
 	 */
-	curve::Continuous<coord::scene3> position;
+	curve::Reader<coord::scene3> position;
 
 	/**
 	 * Angle of the object.
+	 *
+	 * Reads the published angle of the render entity.
+	 */
+	curve::Reader<coord::phys_angle_t> angle;
+
+	/**
+	 * Animation path of the object.
+	 *
+	 * Reads the published animation path of the render entity.
 	 */
-	curve::Segmented<coord::phys_angle_t> angle;
+	curve::Reader<std::string> animation_path;
 
 	/**
 	 * Animation information for the layers.
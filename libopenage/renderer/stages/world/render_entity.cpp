@@ -1,4 +1,4 @@
-// Copyright 2022-2023 the openage authors. See copying.md for legal info.
+// Copyright 2022-2026 the openage authors. See copying.md for legal info.
 
 #include "render_entity.h"
 
@@ -37,6 +37,11 @@ void WorldRenderEntity::update(const uint32_t ref_id,
 	                    this->last_update);
 	this->angle.sync(angle, this->last_update);
 	this->animation_path.set_last(time, animation_path);
+
+	this->position.publish();
+	this->angle.publish();
+	this->animation_path.publish();
+
 	this->changed = true;
 	this->last_update = time;
 }
@@ -50,6 +55,10 @@ void WorldRenderEntity::update(const uint32_t ref_id,
 	this->ref_id = ref_id;
 	this->position.set_last(time, position.to_scene3());
 	this->animation_path.set_last(time, animation_path);
+
+	this->position.publish();
+	this->animation_path.publish();
+
 	this->changed = true;
 	this->last_update = time;
 }
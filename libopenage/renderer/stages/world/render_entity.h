@@ -1,4 +1,4 @@
-// Copyright 2022-2024 the openage authors. See copying.md for legal info.
+// Copyright 2022-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -67,6 +67,9 @@ public:
 	/**
 	 * Get the position of the entity inside the game world.
 	 *
+	 * The curve may be changed by the gamestate at any time. Use a
+	 * reader (\p curve::BaseCurve::reader()) to sample it from the renderer.
+	 *
 	 * @return Position curve of the entity.
 	 */
 	const curve::Continuous<coord::scene3> &get_position();
@@ -74,6 +77,9 @@ public:
 	/**
 	 * Get the angle of the entity inside the game world.
 	 *
+	 * The curve may be changed by the gamestate at any time. Use a
+	 * reader (\p curve::BaseCurve::reader()) to sample it from the renderer.
+	 *
 	 * @return Angle curve of the entity.
 	 */
 	const curve::Segmented<coord::phys_angle_t> &get_angle();
@@ -81,6 +87,9 @@ public:
 	/**
 	 * Get the animation definition path.
 	 *
+	 * The curve may be changed by the gamestate at any time. Use a
+	 * reader (\p curve::BaseCurve::reader()) to sample it from the renderer.
+	 *
 	 * @return Path to the animation definition file.
 	 */
 	const curve::Discrete<std::string> &get_animation_path();
@@ -1,8 +1,10 @@
-// Copyright 2022-2024 the openage authors. See copying.md for legal info.
+// Copyright 2022-2026 the openage authors. See copying.md for legal info.
 
 #include "render_stage.h"
 
+#include "curve/interpolated.h"
 #include "renderer/camera/camera.h"
+#include "renderer/definitions.h"
 #include "renderer/opengl/context.h"
 #include "renderer/render_pass.h"
 #include "renderer/render_target.h"
@@ -94,7 +96,21 @@ void WorldRenderStage::update() {
 				obj->set_uniforms(std::move(transform_unifs));
 			}
 		}
-		obj->update_uniforms(current_time);
+
+		this->position_readers.push_back(&obj->get_position());
+		this->angle_readers.push_back(&obj->get_angle());
+	}
+
+	// sample the positions and angles of all objects at once
+	this->positions.resize(this->render_objects.size(), SCENE_ORIGIN);
+	this->angles.resize(this->render_objects.size());
+	curve::Interpolated<coord::scene3>::get_all(this->position_readers, current_time, this->positions);
+	curve::Interpolated<coord::phys_angle_t>::get_all(this->angle_readers, current_time, this->angles);
+	this->position_readers.clear();
+	this->angle_readers.clear();
+
+	for (size_t i = 0; i < this->render_objects.size(); ++i) {
+		this->render_objects[i]->update_uniforms(current_time, this->positions[i], this->angles[i]);
 	}
 }
 
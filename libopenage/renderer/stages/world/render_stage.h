@@ -1,4 +1,4 @@
-// Copyright 2022-2024 the openage authors. See copying.md for legal info.
+// Copyright 2022-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -6,6 +6,8 @@
 #include <shared_mutex>
 #include <vector>
 
+#include "coord/scene.h"
+#include "curve/reader.h"
 #include "util/path.h"
 
 namespace openage {
@@ -133,6 +135,20 @@ private:
 	 */
 	std::vector<std::shared_ptr<WorldObject>> render_objects;
 
+	/**
+	 * Position and angle readers of the render objects.
+	 *
+	 * Collected on every update to sample all objects at once.
+	 */
+	std::vector<curve::Reader<coord::scene3> *> position_readers;
+	std::vector<curve::Reader<coord::phys_angle_t> *> angle_readers;
+
+	/**
+	 * Sampled positions and angles of the render objects.
+	 */
+	std::vector<coord::scene3> positions;
+	std::vector<coord::phys_angle_t> angles;
+
 	/**
 	 * Shader for rendering the world objects.
 	 */
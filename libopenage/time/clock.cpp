@@ -1,7 +1,8 @@
-// Copyright 2022-2023 the openage authors. See copying.md for legal info.
+// Copyright 2022-2026 the openage authors. See copying.md for legal info.
 
 #include "clock.h"
 
+#include <algorithm>
 #include <thread>
 
 #include "log/log.h"
@@ -16,7 +17,8 @@ Clock::Clock() :
 	last_check{simclock_t::now()},
 	start_time{simclock_t::now()},
 	sim_time{0},
-	sim_real_time{0} {
+	sim_real_time{0},
+	wakeup_pending{false} {
 }
 
 ClockState Clock::get_state() {
@@ -25,9 +27,9 @@ ClockState Clock::get_state() {
 }
 
 void Clock::update_time() {
-	if (this->state == ClockState::RUNNING) {
-		std::unique_lock lock{this->mutex};
+	std::unique_lock lock{this->mutex};
 
+	if (this->state == ClockState::RUNNING) {
 		auto now = simclock_t::now();
 		auto passed = std::chrono::duration_cast<std::chrono::milliseconds>(now - this->last_check);
 		if (passed.count() == 0) {
@@ -54,14 +56,29 @@ time::time_t Clock::get_time() {
 	std::shared_lock lock{this->mutex};
 
 	// convert time unit from milliseconds to seconds
-	return this->sim_time / 1000;
+	return this->get_current_time(simclock_t::now(), false) / 1000;
 }
 
 time::time_t Clock::get_real_time() {
 	std::shared_lock lock{this->mutex};
 
 	// convert time unit from milliseconds to seconds
-	return this->sim_real_time / 1000;
+	return this->get_current_time(simclock_t::now(), true) / 1000;
+}
+
+time::time_t Clock::get_current_time(const timepoint_t &now, bool real) const {
+	time::time_t result = real ? this->sim_real_time : this->sim_time;
+	if (this->state != ClockState::RUNNING) {
+		return result;
+	}
+
+	// same as update_time(), without storing the result
+	auto passed = std::chrono::duration_cast<std::chrono::milliseconds>(now - this->last_check).count();
+	passed = std::clamp<decltype(passed)>(passed, 0, this->max_tick_time);
+	if (real) {
+		return result + passed;
+	}
+	return result + this->speed * passed;
 }
 
 speed_t Clock::get_speed() {
@@ -69,6 +86,11 @@ speed_t Clock::get_speed() {
 	return this->speed;
 }
 
+dt_ms_t Clock::get_max_tick_time() {
+	std::shared_lock lock{this->mutex};
+	return dt_ms_t{this->max_tick_time};
+}
+
 void Clock::set_speed(speed_t speed) {
 	this->update_time();
 
@@ -76,6 +98,9 @@ void Clock::set_speed(speed_t speed) {
 	this->speed = speed;
 
 	log::log(MSG(info) << "Clock speed set to " << this->speed);
+	lock.unlock();
+
+	this->wake();
 }
 
 void Clock::start() {
@@ -85,6 +110,9 @@ void Clock::start() {
 	this->start_time = now;
 	this->last_check = now;
 	this->state = ClockState::RUNNING;
+	lock.unlock();
+
+	this->wake();
 }
 
 void Clock::stop() {
@@ -98,6 +126,9 @@ void Clock::stop() {
 	log::log(MSG(info) << "Clock stopped at "
 	                   << this->sim_time << "ms (simulated) / "
 	                   << this->sim_real_time << "ms (real)");
+	lock.unlock();
+
+	this->wake();
 }
 
 void Clock::pause() {
@@ -111,6 +142,9 @@ void Clock::pause() {
 	log::log(MSG(info) << "Clock paused at "
 	                   << this->sim_time << "ms (simulated) / "
 	                   << this->sim_real_time << "ms (real)");
+	lock.unlock();
+
+	this->wake();
 }
 
 void Clock::resume() {
@@ -124,6 +158,50 @@ void Clock::resume() {
 	log::log(MSG(info) << "Clock resumed at "
 	                   << this->sim_time << "ms (simulated) / "
 	                   << this->sim_real_time << "ms (real)");
+	lock.unlock();
+
+	this->wake();
+}
+
+void Clock::wait_until(const time::time_t &time, const dt_ms_t &max_wait) {
+	auto deadline = simclock_t::now() + max_wait;
+
+	std::unique_lock lock{this->wakeup_mutex};
+	while (not this->wakeup_pending) {
+		auto now = simclock_t::now();
+		if (now >= deadline) {
+			break;
+		}
+
+		auto wake_at = deadline;
+		{
+			std::shared_lock state_lock{this->mutex};
+			if (this->state == ClockState::RUNNING and this->speed > 0) {
+				// real time until the simulation time reaches the requested time
+				double remaining = (time.to_double() * 1000
+				                    - this->get_current_time(now, false).to_double())
+				                   / this->speed.to_double();
+				if (remaining <= 0) {
+					break;
+				}
+				if (remaining < std::chrono::duration<double, std::milli>{deadline - now}.count()) {
+					wake_at = now + std::chrono::duration_cast<simclock_t::duration>(
+						std::chrono::duration<double, std::milli>{remaining});
+				}
+			}
+		}
+
+		this->wakeup_condition.wait_until(lock, wake_at);
+	}
+	this->wakeup_pending = false;
+}
+
+void Clock::wake() {
+	{
+		std::unique_lock lock{this->wakeup_mutex};
+		this->wakeup_pending = true;
+	}
+	this->wakeup_condition.notify_all();
 }
 
 } // namespace openage::time
@@ -1,8 +1,10 @@
-// Copyright 2022-2024 the openage authors. See copying.md for legal info.
+// Copyright 2022-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <shared_mutex>
 
 #include "time/time.h"
@@ -31,6 +33,11 @@ enum class ClockState {
  *
  * Time values have a precision of milliseconds which should
  * be accurate enough for all applications.
+ *
+ * The current time is computed when it is requested, so readers get
+ * an up-to-date time even if update_time() is called rarely. It must
+ * still be called more often than the maximum tick time, which limits
+ * how far the time advances at once.
  */
 class Clock {
 public:
@@ -74,6 +81,13 @@ public:
 	 */
 	speed_t get_speed();
 
+	/**
+	 * Get how far the clock advances at most between two time updates.
+	 *
+	 * @return Maximum real time per clock update.
+	 */
+	dt_ms_t get_max_tick_time();
+
 	/**
 	 * Set the speed of the clock.
 	 *
@@ -107,7 +121,39 @@ public:
 	 */
 	void resume();
 
+	/**
+	 * Block the calling thread until the simulation time reaches \p time,
+	 * \p max_wait real time has passed, or wake() is called.
+	 *
+	 * A wake() call that happens before this method is called makes it
+	 * return immediately, so the waiting thread can't miss wakeups.
+	 * While the clock is not running, only a wakeup or \p max_wait end
+	 * the wait. Intended for a single waiting thread, e.g. the simulation.
+	 * The clock must be updated meanwhile, e.g. by a TimeLoop.
+	 *
+	 * @param time Simulation time to wait for (in seconds).
+	 * @param max_wait Maximum real time to wait.
+	 */
+	void wait_until(const time::time_t &time, const dt_ms_t &max_wait);
+
+	/**
+	 * Wake up the thread waiting in wait_until(), e.g. because a new event
+	 * was scheduled. Called automatically when the clock state or speed
+	 * changes.
+	 */
+	void wake();
+
 private:
+	/**
+	 * Get the current simulation time (in milliseconds).
+	 *
+	 * Callers must hold the mutex.
+	 *
+	 * @param now Current point in real time.
+	 * @param real Whether the time is computed without speed adjustments.
+	 */
+	time::time_t get_current_time(const timepoint_t &now, bool real) const;
+
 	/**
 	 * Status of the clock (init, running, stopped, ...).
 	 */
@@ -148,6 +194,21 @@ private:
 	 * Mutex for protecting threaded access.
 	 */
 	std::shared_mutex mutex;
+
+	/**
+	 * Whether wake() was called since the last wait_until() returned.
+	 */
+	bool wakeup_pending;
+
+	/**
+	 * Mutex for protecting the wakeup flag.
+	 */
+	std::mutex wakeup_mutex;
+
+	/**
+	 * Notifies the thread in wait_until() about wakeups.
+	 */
+	std::condition_variable wakeup_condition;
 };
 
 } // namespace openage::time
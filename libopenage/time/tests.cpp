@@ -0,0 +1,98 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#include <cstddef>
+#include <vector>
+
+#include "testing/testing.h"
+#include "time/tick_scheduler.h"
+#include "time/time.h"
+
+
+namespace openage::time::tests {
+
+void tick_scheduler() {
+	const time_t tick_length = 0.25;
+
+	// ticks up to the target
+	{
+		TickScheduler ticks;
+		std::vector<time_t> executed;
+		auto record = [&](const time_t &t) { executed.push_back(t); };
+
+		TESTEQUALS(ticks.step(0.2, tick_length, 8, record), 0);
+		TESTEQUALS(ticks.get_time(), TIME_ZERO);
+
+		TESTEQUALS(ticks.step(1.1, tick_length, 8, record), 4);
+		TESTEQUALS(executed.size(), 4);
+		TESTEQUALS(executed[0], time_t{0.25});
+		TESTEQUALS(executed[3], time_t{1.0});
+		TESTEQUALS(ticks.get_time(), time_t{1.0});
+
+		// the next tick is exactly at the target
+		TESTEQUALS(ticks.step(1.25, tick_length, 8, record), 1);
+		TESTEQUALS(ticks.get_time(), time_t{1.25});
+	}
+
+	// the executed ticks don't depend on how the target advances
+	{
+		TickScheduler once;
+		TickScheduler often;
+		std::vector<time_t> once_ticks;
+		std::vector<time_t> often_ticks;
+
+		once.step(3.0, tick_length, 100, [&](const time_t &t) { once_ticks.push_back(t); });
+		for (time_t target : {0.1, 0.3, 0.9, 1.0, 1.7, 2.9, 3.0}) {
+			often.step(target, tick_length, 100, [&](const time_t &t) { often_ticks.push_back(t); });
+		}
+
+		TESTEQUALS(once_ticks.size(), 12);
+		TESTEQUALS(once_ticks == often_ticks, true);
+	}
+
+	// the catch-up cap limits the ticks, the backlog is dropped
+	{
+		TickScheduler ticks;
+		size_t count = 0;
+		auto counter = [&](const time_t &) { count += 1; };
+
+		TESTEQUALS(ticks.step(10.1, 1, 3, counter), 3);
+		TESTEQUALS(count, 3);
+		TESTEQUALS(ticks.get_time(), time_t{3});
+
+		// stays on the tick grid
+		TESTEQUALS(ticks.drop_backlog(10.1, 1), 7);
+		TESTEQUALS(ticks.get_time(), time_t{10});
+
+		// nothing left to drop
+		TESTEQUALS(ticks.drop_backlog(10.9, 1), 0);
+		TESTEQUALS(ticks.get_time(), time_t{10});
+
+		TESTEQUALS(ticks.step(11, 1, 3, counter), 1);
+		TESTEQUALS(ticks.get_time(), time_t{11});
+	}
+
+	// without a clock, the cap is the only limit
+	{
+		TickScheduler ticks{5};
+		size_t count = 0;
+		TESTEQUALS(ticks.step(TIME_MAX, tick_length, 6, [&](const time_t &) { count += 1; }), 6);
+		TESTEQUALS(count, 6);
+		TESTEQUALS(ticks.get_time(), time_t{6.5});
+	}
+
+	// variable steps move the tick grid
+	{
+		TickScheduler ticks;
+		ticks.set_time(0.125);
+		TESTEQUALS(ticks.step(0.7, tick_length, 8, [](const time_t &) {}), 2);
+		TESTEQUALS(ticks.get_time(), time_t{0.625});
+	}
+
+	{
+		TickScheduler ticks;
+		TESTTHROWS(ticks.step(1, TIME_ZERO, 8, [](const time_t &) {}));
+		TESTTHROWS(ticks.drop_backlog(1, TIME_ZERO));
+	}
+}
+
+} // namespace openage::time::tests
@@ -0,0 +1,56 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#include "tick_scheduler.h"
+
+#include "error/error.h"
+
+
+namespace openage::time {
+
+TickScheduler::TickScheduler(const time_t &start) :
+	tick_time{start} {}
+
+
+size_t TickScheduler::step(const time_t &target,
+                           const time_t &tick_length,
+                           size_t max_ticks,
+                           const std::function<void(const time_t &)> &tick) {
+	ENSURE(tick_length > TIME_ZERO, "tick length must be positive");
+
+	size_t executed = 0;
+	while (executed < max_ticks and this->tick_time + tick_length <= target) {
+		this->tick_time += tick_length;
+		tick(this->tick_time);
+		executed += 1;
+	}
+
+	return executed;
+}
+
+
+int64_t TickScheduler::drop_backlog(const time_t &target, const time_t &tick_length) {
+	ENSURE(tick_length > TIME_ZERO, "tick length must be positive");
+
+	if (target < this->tick_time + tick_length) {
+		return 0;
+	}
+
+	// stay on the tick grid, so that the remaining ticks are still
+	// a whole tick length apart
+	int64_t dropped = (target - this->tick_time).get_raw_value() / tick_length.get_raw_value();
+	this->tick_time += time_t::from_raw_value(dropped * tick_length.get_raw_value());
+
+	return dropped;
+}
+
+
+const time_t &TickScheduler::get_time() const {
+	return this->tick_time;
+}
+
+
+void TickScheduler::set_time(const time_t &time) {
+	this->tick_time = time;
+}
+
+} // namespace openage::time
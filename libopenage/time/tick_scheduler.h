@@ -0,0 +1,84 @@
+// Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "time/time.h"
+
+
+namespace openage::time {
+
+/**
+ * Splits the advance of a simulation into fixed-length ticks.
+ *
+ * Ticks are always a whole tick length apart, so the events that are
+ * processed in a tick don't depend on when the simulation loop gets
+ * to execute it.
+ *
+ * Not thread-safe, should only be used by the simulation loop.
+ */
+class TickScheduler {
+public:
+	/**
+	 * Create a new tick scheduler.
+	 *
+	 * @param start Time of the last executed tick.
+	 */
+	explicit TickScheduler(const time_t &start = TIME_ZERO);
+
+	~TickScheduler() = default;
+
+	/**
+	 * Execute the ticks up to \p target, but at most \p max_ticks of them.
+	 *
+	 * @param target Time up to which ticks are executed.
+	 * @param tick_length Simulated time per tick. Must be positive.
+	 * @param max_ticks Maximum number of executed ticks.
+	 * @param tick Called with the time of every executed tick.
+	 *
+	 * @return Number of executed ticks.
+	 */
+	size_t step(const time_t &target,
+	            const time_t &tick_length,
+	            size_t max_ticks,
+	            const std::function<void(const time_t &)> &tick);
+
+	/**
+	 * Drop the ticks that are still due at \p target without executing them.
+	 *
+	 * Moves the tick time forward to the last tick at or before \p target.
+	 * Events of the dropped ticks are processed by the next executed tick.
+	 *
+	 * @param target Time up to which ticks are dropped.
+	 * @param tick_length Simulated time per tick. Must be positive.
+	 *
+	 * @return Number of dropped ticks.
+	 */
+	int64_t drop_backlog(const time_t &target, const time_t &tick_length);
+
+	/**
+	 * Get the time of the last executed (or dropped) tick.
+	 *
+	 * @return Tick time.
+	 */
+	const time_t &get_time() const;
+
+	/**
+	 * Set the time of the last executed tick, e.g. after the simulation
+	 * was advanced without fixed ticks.
+	 *
+	 * @param time New tick time.
+	 */
+	void set_time(const time_t &time);
+
+private:
+	/**
+	 * Time of the last executed tick.
+	 */
+	time_t tick_time;
+};
+
+} // namespace openage::time
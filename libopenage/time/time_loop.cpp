@@ -1,27 +1,35 @@
-// Copyright 2021-2023 the openage authors. See copying.md for legal info.
+// Copyright 2021-2026 the openage authors. See copying.md for legal info.
 
 #include "time_loop.h"
 
 #include <mutex>
 
+#include "error/error.h"
 #include "log/log.h"
-#include "time/clock.h"
 
 
 namespace openage::time {
 
 TimeLoop::TimeLoop() :
-	running{false},
-	clock{std::make_shared<Clock>()} {}
+	TimeLoop{std::make_shared<Clock>()} {}
 
 TimeLoop::TimeLoop(const std::shared_ptr<Clock> clock) :
 	running{false},
-	clock{clock} {}
+	clock{clock},
+	mode{LoopMode::SLEEP},
+	update_interval{this->clock->get_max_tick_time() / 2} {}
 
 void TimeLoop::run() {
 	this->start();
 	while (this->running) {
 		this->clock->update_time();
+
+		std::unique_lock lock{this->mutex};
+		if (this->mode == LoopMode::SLEEP) {
+			this->wakeup_condition.wait_for(lock, this->update_interval, [this]() {
+				return not this->running or this->mode != LoopMode::SLEEP;
+			});
+		}
 	}
 	log::log(MSG(info) << "Time loop exited");
 }
@@ -42,10 +50,27 @@ void TimeLoop::stop() {
 	std::unique_lock lock{this->mutex};
 
 	this->running = false;
+	this->wakeup_condition.notify_all();
 
 	log::log(MSG(info) << "Time loop stopped");
 }
 
+void TimeLoop::set_mode(LoopMode mode) {
+	std::unique_lock lock{this->mutex};
+
+	this->mode = mode;
+	this->wakeup_condition.notify_all();
+}
+
+void TimeLoop::set_update_interval(const dt_ms_t &interval) {
+	ENSURE(interval > dt_ms_t::zero() and interval < this->clock->get_max_tick_time(),
+	       "time loop update interval must be positive and shorter than the maximum clock tick time, "
+	       "but got " << interval.count() << "ms");
+
+	std::unique_lock lock{this->mutex};
+	this->update_interval = interval;
+}
+
 const std::shared_ptr<Clock> TimeLoop::get_clock() {
 	std::shared_lock lock{this->mutex};
 
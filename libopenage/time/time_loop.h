@@ -1,13 +1,30 @@
-// Copyright 2021-2024 the openage authors. See copying.md for legal info.
+// Copyright 2021-2026 the openage authors. See copying.md for legal info.
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <memory>
 #include <shared_mutex>
 
+#include "time/clock.h"
+
 
 namespace openage::time {
-class Clock;
+
+/**
+ * How a loop thread waits for work.
+ */
+enum class LoopMode {
+	/**
+	 * Poll continuously. Lowest latency, but occupies a whole core.
+	 */
+	SPIN,
+	/**
+	 * Sleep until there is work, e.g. until the next event is due.
+	 */
+	SLEEP,
+};
 
 /**
  * Manages the passage of simulation time and real time.
@@ -42,6 +59,31 @@ public:
 	 */
 	void stop();
 
+	/**
+	 * Set how the loop waits between clock updates.
+	 *
+	 * In SLEEP mode (the default), the clock is updated every
+	 * \p update_interval and the thread sleeps in between. The clock computes
+	 * the current time when it is requested, so readers don't lose precision.
+	 * The loop can't sleep until it is woken up, because the clock limits
+	 * how far it advances between two updates to detect stalls of the
+	 * process, e.g. while debugging. A sleeping loop switches to a new mode
+	 * immediately.
+	 *
+	 * @param mode Loop mode.
+	 */
+	void set_mode(LoopMode mode);
+
+	/**
+	 * Set the real time between two clock updates in SLEEP mode.
+	 *
+	 * Must be shorter than the maximum tick time of the clock, so that
+	 * the clock advances with real time. Defaults to half of it.
+	 *
+	 * @param interval Time between two clock updates.
+	 */
+	void set_update_interval(const dt_ms_t &interval);
+
 	/**
 	 * Get the clock used by this time loop.
 	 *
@@ -53,13 +95,29 @@ private:
 	/**
 	 * State of the time loop.
 	 */
-	bool running;
+	std::atomic<bool> running;
 
 	/**
 	 * Manage time and speed inside the simulation.
 	 */
 	std::shared_ptr<Clock> clock;
 
+	/**
+	 * How the loop waits between clock updates.
+	 */
+	LoopMode mode;
+
+	/**
+	 * Real time between two clock updates in SLEEP mode. Must be shorter
+	 * than the maximum tick time of the clock.
+	 */
+	dt_ms_t update_interval;
+
+	/**
+	 * Interrupts the sleep of the loop when it is stopped or its mode changes.
+	 */
+	std::condition_variable_any wakeup_condition;
+
 	/**
 	 * Mutex for protecting threaded access.
 	 */
@@ -1,4 +1,4 @@
-# Copyright 2015-2024 the openage authors. See copying.md for legal info.
+# Copyright 2015-2026 the openage authors. See copying.md for legal info.
 #
 # pylint: disable=too-many-statements
 """
@@ -127,6 +127,11 @@ def main(argv=None):
         "codegen",
         parents=[global_cli]))
 
+    from .log.decode import init_subparser
+    init_subparser(subparsers.add_parser(
+        "log-decode",
+        parents=[global_cli]))
+
     args = cli.parse_args(argv)
 
     dll_manager = None
@@ -1,4 +1,4 @@
-# Copyright 2015-2023 the openage authors. See copying.md for legal info.
+# Copyright 2015-2026 the openage authors. See copying.md for legal info.
 #
 # pylint: disable=too-many-locals
 
@@ -30,6 +30,11 @@ def init_subparser(cli: ArgumentParser) -> None:
         "--modpacks", nargs="+", required=True,
         help="list of modpacks to load")
 
+    cli.add_argument(
+        "--binary-log", metavar="PATH",
+        help=("write debug log messages to compact binary files PATH.0, PATH.1, ...; "
+              "use 'openage log-decode' to read them"))
+
 
 def main(args, error):
     """
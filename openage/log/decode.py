@@ -0,0 +1,71 @@
+# Copyright 2026-2026 the openage authors. See copying.md for legal info.
+
+"""
+Converts binary log files to text.
+"""
+from __future__ import annotations
+import typing
+
+from . import info
+
+if typing.TYPE_CHECKING:
+    from argparse import ArgumentParser
+
+
+def init_subparser(cli: ArgumentParser) -> None:
+    """ Initializes the parser for log-decode-specific args. """
+    cli.set_defaults(entrypoint=main)
+
+    cli.add_argument(
+        "files", nargs="+",
+        help="binary log files (PATH.0, PATH.1, ...) in the order they were written")
+
+    cli.add_argument(
+        "--output", "-o", default="-",
+        help="text file to write, '-' for stdout (default)")
+
+    cli.add_argument(
+        "--level", choices=("spam", "dbg", "info", "warn", "err", "crit"),
+        help="only show messages with at least this level")
+
+    cli.add_argument(
+        "--source",
+        help="only show messages of the log source with this name")
+
+    cli.add_argument(
+        "--start", type=float,
+        help="only show messages logged after this time (seconds since the epoch)")
+
+    cli.add_argument(
+        "--end", type=float,
+        help="only show messages logged before this time (seconds since the epoch)")
+
+
+def main(args, error):
+    """
+    CLI entry point for decoding binary log files.
+    """
+    del error  # unused
+
+    from .log_cpp import decode_binary_log
+
+    # the file numbers have to be compared as numbers, PATH.10 comes after PATH.9
+    def file_number(path):
+        suffix = path.rpartition(".")[2]
+        return int(suffix) if suffix.isdigit() else -1
+
+    files = sorted(args.files, key=file_number)
+
+    count = decode_binary_log(
+        files,
+        args.output,
+        min_level=args.level,
+        source=args.source,
+        start=int(args.start * 1e9) if args.start is not None else None,
+        end=int(args.end * 1e9) if args.end is not None else None,
+    )
+
+    if args.output != "-":
+        info("decoded %d log messages to %s", count, args.output)
+
+    return 0
@@ -1,10 +1,12 @@
-# Copyright 2015-2018 the openage authors. See copying.md for legal info.
+# Copyright 2015-2026 the openage authors. See copying.md for legal info.
 
 """
 Translates Python log messages to C++ log messages.
 """
 
 from libcpp.memory cimport unique_ptr
+from libcpp.string cimport string
+from libcpp.vector cimport vector
 
 from libopenage.log.message cimport message
 from libopenage.log.level cimport (
@@ -21,6 +23,10 @@ from libopenage.log.level cimport (
 )
 
 from libopenage.log.named_logsource cimport NamedLogSource
+from libopenage.log.binary_log cimport (
+    binary_log_filter,
+    decode_binary_log as decode_binary_log_cpp
+)
 from libopenage.log.log cimport set_level as cpp_set_level
 
 import logging
@@ -85,3 +91,47 @@ def log(CPPLevel lvl, str msg, filename, function, lineno):
 
 def set_level(CPPLevel lvl):
     cpp_set_level(lvl.get())
+
+
+def decode_binary_log(files, output, min_level=None, source=None, start=None, end=None):
+    """
+    Decodes binary log files to the text format of the C++ file log sink.
+
+    files: paths of the log files, in the order they were written.
+    output: path of the text file, or "-" for stdout.
+    min_level: name of the lowest decoded level ("spam", "dbg", ...).
+    source: only decode messages of the log source with this name.
+    start, end: only decode messages in this time range (ns since the epoch).
+
+    Returns the number of decoded messages.
+    """
+    levels = {
+        "spam": CPPLevel.wrap(spam),
+        "dbg": CPPLevel.wrap(dbg),
+        "info": CPPLevel.wrap(info),
+        "warn": CPPLevel.wrap(warn),
+        "err": CPPLevel.wrap(err),
+        "crit": CPPLevel.wrap(crit),
+    }
+
+    cdef binary_log_filter log_filter
+    cdef vector[string] files_cpp
+    cdef string output_cpp = output.encode()
+    cdef size_t count
+
+    for path in files:
+        files_cpp.push_back(path.encode())
+
+    if min_level is not None:
+        log_filter.min_level = (<CPPLevel>levels[min_level]).value.get().numeric
+    if source is not None:
+        log_filter.source = source.encode()
+    if start is not None:
+        log_filter.start = start
+    if end is not None:
+        log_filter.end = end
+
+    with nogil:
+        count = decode_binary_log_cpp(files_cpp, output_cpp, log_filter)
+
+    return count
@@ -1,4 +1,4 @@
-# Copyright 2015-2023 the openage authors. See copying.md for legal info.
+# Copyright 2015-2026 the openage authors. See copying.md for legal info.
 
 from cpython.ref cimport PyObject
 from libcpp.string cimport string
@@ -37,6 +37,10 @@ def run_game(args, root_path):
         else:
             args_cpp.mods = vector[string]()
 
+        # binary log files
+        if args.binary_log is not None:
+            args_cpp.binary_log = args.binary_log.encode()
+
         # run the game!
         with nogil:
             result = run_game_cpp(args_cpp)
@@ -1,4 +1,4 @@
-# Copyright 2015-2023 the openage authors. See copying.md for legal info.
+# Copyright 2015-2026 the openage authors. See copying.md for legal info.
 
 """ Lists of all possible tests; enter your tests here. """
 
@@ -83,12 +83,30 @@ def tests_cpp():
     yield "openage::datastructure::tests::concurrent_queue"
     yield "openage::datastructure::tests::constexpr_map"
     yield "openage::datastructure::tests::pairing_heap"
+    yield "openage::datastructure::tests::pooled_pairing_heap"
+    yield ("openage::datastructure::tests::ring_buffer",
+           "single-producer ring buffer with concurrent consumers")
+    yield ("openage::datastructure::tests::work_stealing_deque",
+           "Chase-Lev deque with concurrent thieves")
     yield "openage::job::tests::test_job_manager"
+    yield ("openage::log::tests::async_logger",
+           "asynchronous logging with per-thread buffers")
+    yield ("openage::log::tests::binary_log",
+           "binary log files with rotation and decoding")
+    yield ("openage::log::tests::level_gate",
+           "disabled log statements don't evaluate their arguments")
     yield "openage::path::tests::path_node", "pathfinding"
+    yield "openage::path::tests::grid_pathfinder", "pathfinding on terrain grids"
+    yield ("openage::path::tests::hierarchical_pathfinder",
+           "hierarchical pathfinding with chunk portals")
+    yield ("openage::path::tests::flow_field",
+           "flow fields for group movement")
     yield "openage::pyinterface::tests::pyobject"
     yield "openage::pyinterface::tests::err_py_to_cpp"
     yield "openage::renderer::tests::font"
     yield "openage::renderer::tests::font_manager"
+    yield ("openage::renderer::resources::tests::asset_manager",
+           "asynchronous asset loading on job workers")
     yield "openage::rng::tests::run"
     yield "openage::util::tests::constinit_vector"
     yield "openage::util::tests::enum_"
@@ -102,6 +120,22 @@ def tests_cpp():
     yield "openage::curve::tests::container"
     yield "openage::curve::tests::curve_types"
     yield "openage::event::tests::eventtrigger"
+    yield ("openage::event::tests::loop_wakeup",
+           "event loop and clock wakeups of the sleeping simulation loop")
+    yield ("openage::event::tests::parallel_events",
+           "parallel event execution matches the sequential execution")
+    yield ("openage::gamestate::api::tests::ability_cache",
+           "cached ability values are read again after patches")
+    yield ("openage::gamestate::tests::activity_program",
+           "compilation of activity node graphs into programs")
+    yield ("openage::gamestate::tests::component_store",
+           "sparse set storage of game entity components")
+    yield ("openage::gamestate::tests::entity_factory",
+           "bulk creation and spawning of game entities")
+    yield ("openage::gamestate::tests::spatial_index",
+           "time-aware spatial queries over entity positions")
+    yield ("openage::time::tests::tick_scheduler",
+           "fixed-length simulation ticks with catch-up limit")
 
 
 def demos_cpp():
@@ -135,3 +169,17 @@ def benchmark_cpp():
 
     # TODO Add a real benchmark here!
     yield ("openage::test::benchmark", "Test the benchmark")
+    yield ("openage::curve::tests::benchmark_keyframe_lookup",
+           "keyframe lookup in curve containers of 10^3 to 10^6 keyframes")
+    yield ("openage::curve::tests::benchmark_keyframe_layout",
+           "interleaved vs. split keyframe storage for phys3 and string curves")
+    yield ("openage::job::tests::benchmark_job_manager",
+           "job throughput, parallel_for and task graph overhead")
+    yield ("openage::datastructure::tests::benchmark_pairing_heap",
+           "push/decrease/pop of shared_ptr vs. pooled pairing heaps")
+    yield ("openage::path::tests::benchmark_grid_pathfinder",
+           "paths per second of the grid pathfinder on a 256x256 map")
+    yield ("openage::path::tests::benchmark_hierarchical_pathfinder",
+           "paths per second of the hierarchical and the grid pathfinder on a 512x512 map")
+    yield ("openage::path::tests::benchmark_flow_field",
+           "group movement with flow fields and per-unit searches on a 512x512 map")